@@ -818,5 +818,206 @@ public void Bzip2_Encoder()
 				Assert.IsTrue(Enumerable.SequenceEqual(expected, dest.ToArray()));
 			}
 		}
+
+		[TestMethod(), TestCategory("Bzip2")]
+		public void Bzip2_ParallelCompression()
+		{
+			Bzip2Encoder encoder = new Bzip2Encoder();
+
+			// Parallel compression is disabled by default
+			Assert.AreEqual(1, encoder.MaximumThreads);
+			Assert.AreEqual(0, encoder.MaximumPendingBlocks);
+
+			try { encoder.MaximumThreads = -1; Assert.Fail("Property should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			try { encoder.MaximumPendingBlocks = -1; Assert.Fail("Property should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			// The output is a sequence of independent bzip2 streams that is the same regardless of the thread count
+			byte[] sampledata = Enumerable.Repeat(s_sampledata, 4).SelectMany(b => b).ToArray();
+
+			encoder.MaximumThreads = 2;
+			byte[] expected = encoder.Encode(sampledata);
+
+			encoder.MaximumThreads = 4;
+			encoder.MaximumPendingBlocks = 3;
+			byte[] compressed = encoder.Encode(sampledata);
+
+			Assert.IsTrue(Enumerable.SequenceEqual(expected, compressed));
+			Assert.IsTrue(compressed.Length < sampledata.Length);
+
+			using (Bzip2Reader reader = new Bzip2Reader(new MemoryStream(compressed)))
+			{
+				using (MemoryStream dest = new MemoryStream())
+				{
+					reader.CopyTo(dest);
+					Assert.IsTrue(Enumerable.SequenceEqual(sampledata, dest.ToArray()));
+					Assert.AreEqual(sampledata.Length, reader.Position);
+				}
+			}
+
+			// Trailing data that isn't a complete stream header is ignored, even if it starts with the same byte
+			foreach (byte[] trailer in new byte[][] { Encoding.ASCII.GetBytes("B"), Encoding.ASCII.GetBytes("BZ"), Encoding.ASCII.GetBytes("BZh0"), Encoding.ASCII.GetBytes("Bogus trailing data") })
+			{
+				foreach (int threads in new int[] { 1, 4 })
+				{
+					using (Bzip2Reader reader = new Bzip2Reader(new MemoryStream(compressed.Concat(trailer).ToArray()), threads, false))
+					using (MemoryStream dest = new MemoryStream())
+					{
+						reader.CopyTo(dest);
+						Assert.IsTrue(Enumerable.SequenceEqual(sampledata, dest.ToArray()));
+					}
+				}
+			}
+
+			// Check the public Bzip2Writer constructor, including a flush mid-stream and an empty stream
+			using (MemoryStream dest = new MemoryStream())
+			{
+				using (Bzip2Writer writer = new Bzip2Writer(dest, CompressionLevel.Fastest, 0, true))
+				{
+					writer.Write(s_sampledata, 0, s_sampledata.Length / 3);
+					writer.Flush();
+					writer.Write(s_sampledata, s_sampledata.Length / 3, s_sampledata.Length - (s_sampledata.Length / 3));
+					Assert.AreEqual(s_sampledata.Length, writer.Position);
+				}
+
+				dest.Position = 0;
+				using (Bzip2Reader reader = new Bzip2Reader(dest, true))
+				{
+					using (MemoryStream actual = new MemoryStream())
+					{
+						reader.CopyTo(actual);
+						Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata, actual.ToArray()));
+					}
+				}
+			}
+
+			Assert.AreEqual(0, new Bzip2Reader(new MemoryStream(encoder.Encode(new byte[0]))).Read(new byte[1], 0, 1));
+		}
+
+		[TestMethod(), TestCategory("Bzip2")]
+		public void Bzip2_ParallelDecompression()
+		{
+			// Check parameter validations
+			try { using (Bzip2Reader reader = new Bzip2Reader(new MemoryStream(), -1, false)) { }; Assert.Fail("Constructor should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			try { using (Bzip2Reader reader = new Bzip2Reader(new MemoryStream(), 2, -1, false)) { }; Assert.Fail("Constructor should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			// Generate two concatenated streams that each contain several blocks
+			byte[] sampledata = Enumerable.Repeat(s_sampledata, 4).SelectMany(b => b).ToArray();
+			byte[] stream = new Bzip2Encoder().Encode(sampledata);
+			byte[] compressed = stream.Concat(stream).ToArray();
+
+			// The parallel reader decodes blocks ahead using odd-sized reads
+			using (Bzip2Reader reader = new Bzip2Reader(new MemoryStream(compressed), 4, 3, false))
+			{
+				byte[] actual = new byte[sampledata.Length * 2];
+				int total = 0, read = 0;
+
+				while ((read = reader.Read(actual, total, Math.Min(77777, actual.Length - total))) > 0) total += read;
+
+				Assert.AreEqual(actual.Length, total);
+				Assert.AreEqual(actual.Length, reader.Position);
+				Assert.IsTrue(Enumerable.SequenceEqual(sampledata.Concat(sampledata), actual));
+				Assert.AreEqual(0, reader.Read(actual, 0, actual.Length));
+			}
+
+			// A stream created externally to this library
+			using (Bzip2Reader reader = new Bzip2Reader(Assembly.GetExecutingAssembly().GetManifestResourceStream("zuki.io.compression.test.thethreemusketeers.bz2"), 0, false))
+			{
+				using (MemoryStream dest = new MemoryStream())
+				{
+					reader.CopyTo(dest);
+					Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata, dest.ToArray()));
+				}
+			}
+
+			// Corrupt data inside of a block must fail the block CRC check
+			compressed = (byte[])stream.Clone();
+			compressed[compressed.Length / 2] ^= 0xFF;
+
+			try
+			{
+				using (Bzip2Reader reader = new Bzip2Reader(new MemoryStream(compressed), 4, false)) reader.CopyTo(new MemoryStream());
+				Assert.Fail("Read should have thrown an exception");
+			}
+			catch (Exception ex) { Assert.IsTrue((ex is Bzip2Exception) || (ex is InvalidDataException)); }
+		}
+
+		[TestMethod(), TestCategory("Bzip2")]
+		public void Bzip2_RandomAccess()
+		{
+			// Generate two concatenated streams that each contain several small blocks
+			Bzip2Encoder encoder = new Bzip2Encoder();
+			encoder.CompressionLevel = 1;
+
+			byte[] sampledata = Enumerable.Repeat(s_sampledata, 2).SelectMany(b => b).ToArray();
+			byte[] stream = encoder.Encode(sampledata);
+			byte[] compressed = stream.Concat(stream).ToArray();
+			byte[] expected = sampledata.Concat(sampledata).ToArray();
+
+			try { Bzip2Index.Build(null); Assert.Fail("Method call should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentNullException)); }
+
+			try { Bzip2Index.Load(new MemoryStream(new byte[16])); Assert.Fail("Method call should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(InvalidDataException)); }
+
+			// Build the index and round-trip it through a sidecar
+			Bzip2Index built = Bzip2Index.Build(new MemoryStream(compressed));
+			Assert.AreEqual(expected.Length, built.Length);
+			Assert.IsTrue(built.Count > 2);
+
+			Bzip2Index index;
+			using (MemoryStream sidecar = new MemoryStream())
+			{
+				built.Save(sidecar);
+				sidecar.Position = 0;
+				index = Bzip2Index.Load(sidecar);
+			}
+
+			Assert.AreEqual(built.Count, index.Count);
+			Assert.AreEqual(built.Length, index.Length);
+
+			try { using (Bzip2Reader reader = new Bzip2Reader(new MemoryStream(compressed), null, false)) { }; Assert.Fail("Constructor should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentNullException)); }
+
+			using (Bzip2Reader reader = new Bzip2Reader(new MemoryStream(compressed), index, false))
+			{
+				Assert.IsTrue(reader.CanSeek);
+				Assert.AreEqual(expected.Length, reader.Length);
+
+				Random random = new Random(1);
+				byte[] actual = new byte[4096];
+
+				for (int iteration = 0; iteration < 100; iteration++)
+				{
+					long position = random.Next(expected.Length);
+					Assert.AreEqual(position, reader.Seek(position, SeekOrigin.Begin));
+
+					int read = reader.Read(actual, 0, actual.Length);
+					Assert.AreEqual(Math.Min(actual.Length, expected.Length - position), read);
+					Assert.AreEqual(position + read, reader.Position);
+					Assert.IsTrue(Enumerable.SequenceEqual(expected.Skip((int)position).Take(read), actual.Take(read)));
+				}
+
+				reader.Seek(-10, SeekOrigin.End);
+				Assert.AreEqual(10, reader.Read(actual, 0, actual.Length));
+				Assert.AreEqual(0, reader.Read(actual, 0, actual.Length));
+
+				try { reader.Seek(-1, SeekOrigin.Begin); Assert.Fail("Method call should have thrown an exception"); }
+				catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(IOException)); }
+
+				// Reading from the beginning returns both of the streams
+				reader.Position = 0;
+				using (MemoryStream dest = new MemoryStream())
+				{
+					reader.CopyTo(dest);
+					Assert.IsTrue(Enumerable.SequenceEqual(expected, dest.ToArray()));
+				}
+			}
+		}
 	}
 }
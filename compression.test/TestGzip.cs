@@ -830,5 +830,673 @@ public void Gzip_Encoder()
 				Assert.IsTrue(Enumerable.SequenceEqual(expected, dest.ToArray()));
 			}
 		}
+
+		[TestMethod(), TestCategory("Gzip")]
+		public void Gzip_ParallelCompression()
+		{
+			GzipEncoder encoder = new GzipEncoder();
+
+			// Parallel compression is disabled by default
+			Assert.AreEqual(1, encoder.MaximumThreads);
+			Assert.AreEqual(0, encoder.MaximumPendingBlocks);
+
+			try { encoder.MaximumThreads = -1; Assert.Fail("Property should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			try { encoder.MaximumPendingBlocks = -1; Assert.Fail("Property should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			encoder.MaximumThreads = 4;
+			encoder.MaximumPendingBlocks = 3;
+
+			// The output is a single standard GZIP member that both GzipReader and the .NET GZipStream can read
+			byte[] compressed = encoder.Encode(s_sampledata);
+			Assert.IsTrue(compressed.Length < s_sampledata.Length);
+
+			using (GzipReader reader = new GzipReader(new MemoryStream(compressed)))
+			{
+				using (MemoryStream dest = new MemoryStream())
+				{
+					reader.CopyTo(dest);
+					Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata, dest.ToArray()));
+				}
+			}
+
+			using (GZipStream reader = new GZipStream(new MemoryStream(compressed), CompressionMode.Decompress))
+			{
+				using (MemoryStream dest = new MemoryStream())
+				{
+					reader.CopyTo(dest);
+					Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata, dest.ToArray()));
+				}
+			}
+
+			// Check the public GzipWriter constructor, including a flush mid-stream and an empty stream
+			using (MemoryStream dest = new MemoryStream())
+			{
+				using (GzipWriter writer = new GzipWriter(dest, CompressionLevel.Optimal, 0, true))
+				{
+					writer.Write(s_sampledata, 0, s_sampledata.Length / 3);
+					writer.Flush();
+					writer.Write(s_sampledata, s_sampledata.Length / 3, s_sampledata.Length - (s_sampledata.Length / 3));
+					Assert.AreEqual(s_sampledata.Length, writer.Position);
+				}
+
+				dest.Position = 0;
+				using (GzipReader reader = new GzipReader(dest, true))
+				{
+					using (MemoryStream actual = new MemoryStream())
+					{
+						reader.CopyTo(actual);
+						Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata, actual.ToArray()));
+					}
+				}
+			}
+
+			Assert.AreEqual(0, new GzipReader(new MemoryStream(encoder.Encode(new byte[0]))).Read(new byte[1], 0, 1));
+		}
+
+		[TestMethod(), TestCategory("Gzip")]
+		public void Gzip_MultipleMembers()
+		{
+			// Check parameter validations
+			try { using (GzipReader reader = new GzipReader(new MemoryStream(), -1, false)) { }; Assert.Fail("Constructor should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			try { using (GzipReader reader = new GzipReader(new MemoryStream(), 2, -1, false)) { }; Assert.Fail("Constructor should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			// Generate a stream that consists of many individually compressed GZIP members
+			byte[] sampledata = Enumerable.Repeat(s_sampledata, 4).SelectMany(b => b).ToArray();
+			GzipEncoder encoder = new GzipEncoder();
+
+			using (MemoryStream compressed = new MemoryStream())
+			{
+				for (int offset = 0; offset < sampledata.Length; offset += 100000)
+					encoder.Encode(sampledata, offset, Math.Min(100000, sampledata.Length - offset), compressed);
+
+				// The serial reader continues with each member after the first
+				compressed.Position = 0;
+				using (GzipReader reader = new GzipReader(compressed, true))
+				{
+					using (MemoryStream dest = new MemoryStream())
+					{
+						reader.CopyTo(dest);
+						Assert.IsTrue(Enumerable.SequenceEqual(sampledata, dest.ToArray()));
+					}
+				}
+
+				// The parallel reader decodes members ahead with a small window, using odd-sized reads
+				compressed.Position = 0;
+				using (GzipReader reader = new GzipReader(compressed, 4, 3, true))
+				{
+					byte[] actual = new byte[sampledata.Length];
+					int total = 0, read = 0;
+
+					while ((read = reader.Read(actual, total, Math.Min(77777, actual.Length - total))) > 0)
+					{
+						total += read;
+						Assert.AreEqual(total, reader.Position);
+					}
+
+					Assert.AreEqual(sampledata.Length, total);
+					Assert.IsTrue(Enumerable.SequenceEqual(sampledata, actual));
+					Assert.AreEqual(0, reader.Read(actual, 0, actual.Length));
+				}
+			}
+
+			// The position counts the decompressed data of every member, with both the serial and parallel readers
+			byte[] twomembers = encoder.Encode(s_sampledata).Concat(encoder.Encode(s_sampledata)).ToArray();
+			foreach (int threads in new int[] { 1, 4 })
+			{
+				using (GzipReader reader = new GzipReader(new MemoryStream(twomembers), threads, false))
+				{
+					byte[] actual = new byte[77777];
+					long total = 0;
+					int read = 0;
+
+					Assert.AreEqual(0, reader.Position);
+					while ((read = reader.Read(actual, 0, actual.Length)) > 0)
+					{
+						total += read;
+						Assert.AreEqual(total, reader.Position);
+					}
+
+					Assert.AreEqual(s_sampledata.Length * 2, total);
+				}
+			}
+
+			// A single member stream can also be read by the parallel reader
+			using (GzipReader reader = new GzipReader(new MemoryStream(encoder.Encode(s_sampledata)), 0, false))
+			{
+				using (MemoryStream dest = new MemoryStream())
+				{
+					reader.CopyTo(dest);
+					Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata, dest.ToArray()));
+				}
+			}
+		}
+
+		[TestMethod(), TestCategory("Gzip")]
+		public void Gzip_SpeculativeDecompression()
+		{
+			// Generate a single member that is too large to be inflated by a single thread
+			byte[] sampledata = Enumerable.Repeat(s_sampledata, 16).SelectMany(b => b).ToArray();
+			GzipEncoder encoder = new GzipEncoder();
+
+			// The member is split into chunks that are inflated speculatively, using odd-sized reads
+			using (GzipReader reader = new GzipReader(new MemoryStream(encoder.Encode(sampledata)), 4, 3, false))
+			{
+				byte[] actual = new byte[sampledata.Length];
+				int total = 0, read = 0;
+
+				while ((read = reader.Read(actual, total, Math.Min(77777, actual.Length - total))) > 0)
+				{
+					total += read;
+					Assert.AreEqual(total, reader.Position);
+				}
+
+				Assert.AreEqual(sampledata.Length, total);
+				Assert.IsTrue(Enumerable.SequenceEqual(sampledata, actual));
+				Assert.AreEqual(0, reader.Read(actual, 0, actual.Length));
+			}
+
+			// Stored blocks can't be located speculatively, the member falls back to being inflated serially
+			encoder.CompressionLevel = GzipCompressionLevel.None;
+			using (GzipReader reader = new GzipReader(new MemoryStream(encoder.Encode(sampledata)), 4, false))
+			{
+				using (MemoryStream dest = new MemoryStream())
+				{
+					reader.CopyTo(dest);
+					Assert.IsTrue(Enumerable.SequenceEqual(sampledata, dest.ToArray()));
+				}
+			}
+		}
+
+		[TestMethod(), TestCategory("Gzip")]
+		public void Gzip_IndexedSeek()
+		{
+			// Generate a stream of multiple members so that checkpoints land in each of them
+			byte[] sampledata = Enumerable.Repeat(s_sampledata, 4).SelectMany(b => b).ToArray();
+			GzipEncoder encoder = new GzipEncoder();
+
+			using (MemoryStream compressed = new MemoryStream())
+			{
+				foreach (byte[] member in Enumerable.Repeat(s_sampledata, 4).Select(b => encoder.Encode(b))) compressed.Write(member, 0, member.Length);
+
+				// Check parameter validations
+				try { GzipIndex.Build(null); Assert.Fail("Method should have thrown an exception"); }
+				catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentNullException)); }
+
+				try { GzipIndex.Build(compressed, 1024); Assert.Fail("Method should have thrown an exception"); }
+				catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+				try { GzipIndex.Load(new MemoryStream(new byte[16])); Assert.Fail("Method should have thrown an exception"); }
+				catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(InvalidDataException)); }
+
+				// Build the index and round-trip it through the sidecar format
+				compressed.Position = 0;
+				GzipIndex built = GzipIndex.Build(compressed, 65536);
+				Assert.AreEqual(sampledata.Length, built.Length);
+				Assert.AreEqual(compressed.Length, built.CompressedLength);
+				Assert.IsTrue(built.Count > 1);
+
+				GzipIndex index;
+				using (MemoryStream sidecar = new MemoryStream())
+				{
+					built.Save(sidecar);
+					Assert.IsTrue(sidecar.Length < built.Count * 32768);
+
+					sidecar.Position = 0;
+					index = GzipIndex.Load(sidecar);
+				}
+
+				Assert.AreEqual(built.Count, index.Count);
+				Assert.AreEqual(built.Spacing, index.Spacing);
+
+				// A reader without an index still cannot seek
+				compressed.Position = 0;
+				using (GzipReader reader = new GzipReader(compressed, true))
+				{
+					Assert.IsFalse(reader.CanSeek);
+					try { reader.Seek(0, SeekOrigin.Begin); Assert.Fail("Method should have thrown an exception"); }
+					catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(NotSupportedException)); }
+				}
+
+				// Seek to positions backwards and forwards throughout the stream and compare the data
+				compressed.Position = 0;
+				using (GzipReader reader = new GzipReader(compressed, index, true))
+				{
+					Assert.IsTrue(reader.CanSeek);
+					Assert.AreEqual(sampledata.Length, reader.Length);
+
+					Random random = new Random(1);
+					byte[] actual = new byte[4096];
+
+					for (int iteration = 0; iteration < 100; iteration++)
+					{
+						long position = random.Next(sampledata.Length);
+						Assert.AreEqual(position, reader.Seek(position, SeekOrigin.Begin));
+
+						int read = reader.Read(actual, 0, actual.Length);
+						Assert.AreEqual(Math.Min(actual.Length, sampledata.Length - position), read);
+						Assert.AreEqual(position + read, reader.Position);
+						Assert.IsTrue(Enumerable.SequenceEqual(sampledata.Skip((int)position).Take(read), actual.Take(read)));
+					}
+
+					// Seeking relative to the end and beyond the end of the stream
+					reader.Seek(-10, SeekOrigin.End);
+					Assert.AreEqual(10, reader.Read(actual, 0, actual.Length));
+					Assert.AreEqual(0, reader.Read(actual, 0, actual.Length));
+
+					reader.Position = sampledata.Length + 100;
+					Assert.AreEqual(0, reader.Read(actual, 0, actual.Length));
+
+					// Seeking back to the beginning restores the entire stream
+					reader.Position = 0;
+					using (MemoryStream dest = new MemoryStream())
+					{
+						reader.CopyTo(dest);
+						Assert.IsTrue(Enumerable.SequenceEqual(sampledata, dest.ToArray()));
+					}
+
+					try { reader.Seek(-1, SeekOrigin.Begin); Assert.Fail("Method should have thrown an exception"); }
+					catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(IOException)); }
+				}
+			}
+		}
+
+		[TestMethod(), TestCategory("Gzip")]
+		public void Gzip_Bgzf()
+		{
+			// Generate enough data to span many BGZF blocks
+			byte[] sampledata = Enumerable.Repeat(s_sampledata, 4).SelectMany(b => b).ToArray();
+
+			using (MemoryStream compressed = new MemoryStream())
+			using (MemoryStream sidecar = new MemoryStream())
+			{
+				// Check parameter validations
+				try { using (BgzfWriter writer = new BgzfWriter(compressed, null, CompressionLevel.Optimal, 1, true)) { }; Assert.Fail("Method should have thrown an exception"); }
+				catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentNullException)); }
+
+				try { using (BgzfWriter writer = new BgzfWriter(compressed, CompressionLevel.Optimal, -1, true)) { }; Assert.Fail("Method should have thrown an exception"); }
+				catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+				// Parallel compression generates exactly the same blocks as serial compression
+				using (BgzfWriter writer = new BgzfWriter(compressed, sidecar, CompressionLevel.Optimal, 4, true)) writer.Write(sampledata);
+
+				using (MemoryStream serial = new MemoryStream())
+				{
+					using (BgzfWriter writer = new BgzfWriter(serial, CompressionLevel.Optimal, true)) writer.Write(sampledata);
+					Assert.IsTrue(Enumerable.SequenceEqual(compressed.ToArray(), serial.ToArray()));
+				}
+
+				// Every block is a GZIP member, so the output is readable as a plain multi-member GZIP stream
+				compressed.Position = 0;
+				using (GzipReader reader = new GzipReader(compressed, true))
+				using (MemoryStream dest = new MemoryStream())
+				{
+					reader.CopyTo(dest);
+					Assert.IsTrue(Enumerable.SequenceEqual(sampledata, dest.ToArray()));
+				}
+
+				// The index written by the writer matches the one built by scanning the blocks
+				compressed.Position = 0;
+				BgzfIndex built = BgzfIndex.Build(compressed);
+				Assert.AreEqual((sampledata.Length - 1) / 0xFF00, built.Count);
+				Assert.AreEqual(8 + (built.Count * 16), sidecar.Length);
+
+				sidecar.Position = 0;
+				BgzfIndex index = BgzfIndex.Load(sidecar);
+				Assert.AreEqual(built.Count, index.Count);
+
+				// Parallel decompression
+				compressed.Position = 0;
+				using (BgzfReader reader = new BgzfReader(compressed, 4, true))
+				using (MemoryStream dest = new MemoryStream())
+				{
+					Assert.IsFalse(reader.CanSeek);
+					reader.CopyTo(dest);
+					Assert.IsTrue(Enumerable.SequenceEqual(sampledata, dest.ToArray()));
+				}
+
+				// Virtual offsets can be saved and restored without an index
+				compressed.Position = 0;
+				using (BgzfReader reader = new BgzfReader(compressed, 4, true))
+				{
+					byte[] expected = new byte[100000];
+					byte[] actual = new byte[100000];
+
+					Assert.AreEqual(0, reader.VirtualPosition);
+					Assert.AreEqual(70000, reader.Read(expected, 0, 70000));
+
+					long voffset = reader.VirtualPosition;
+					Assert.AreEqual(70000 - 0xFF00, voffset & 0xFFFF);
+
+					Assert.AreEqual(expected.Length, reader.Read(expected, 0, expected.Length));
+					reader.VirtualPosition = voffset;
+					Assert.AreEqual(voffset, reader.VirtualPosition);
+					Assert.AreEqual(actual.Length, reader.Read(actual, 0, actual.Length));
+					Assert.IsTrue(Enumerable.SequenceEqual(expected, actual));
+				}
+
+				// Seek to positions backwards and forwards throughout the stream and compare the data
+				compressed.Position = 0;
+				using (BgzfReader reader = new BgzfReader(compressed, index, true))
+				{
+					Assert.IsTrue(reader.CanSeek);
+					Assert.AreEqual(sampledata.Length, reader.Length);
+
+					Random random = new Random(1);
+					byte[] actual = new byte[4096];
+
+					for (int iteration = 0; iteration < 100; iteration++)
+					{
+						long position = random.Next(sampledata.Length);
+						Assert.AreEqual(position, reader.Seek(position, SeekOrigin.Begin));
+
+						int read = reader.Read(actual, 0, actual.Length);
+						Assert.AreEqual(Math.Min(actual.Length, sampledata.Length - position), read);
+						Assert.AreEqual(position + read, reader.Position);
+						Assert.IsTrue(Enumerable.SequenceEqual(sampledata.Skip((int)position).Take(read), actual.Take(read)));
+					}
+
+					// Virtual offsets of indexed blocks also move the decompressed position
+					reader.VirtualPosition = 100;
+					Assert.AreEqual(100, reader.Position);
+
+					// A virtual offset has to refer to the start of a block
+					try { reader.VirtualPosition = (1L << 16); Assert.Fail("Method should have thrown an exception"); }
+					catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentException)); }
+
+					reader.Seek(-10, SeekOrigin.End);
+					Assert.AreEqual(10, reader.Read(actual, 0, actual.Length));
+					Assert.AreEqual(0, reader.Read(actual, 0, actual.Length));
+
+					reader.Position = 0;
+					using (MemoryStream dest = new MemoryStream())
+					{
+						reader.CopyTo(dest);
+						Assert.IsTrue(Enumerable.SequenceEqual(sampledata, dest.ToArray()));
+					}
+
+					try { reader.Seek(-1, SeekOrigin.Begin); Assert.Fail("Method should have thrown an exception"); }
+					catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(IOException)); }
+				}
+			}
+
+			// Blocks from other writers can hold the full 64KiB of data, the virtual offset at the end of such a block refers to the next block
+			Func<byte[], uint> crc32 = (data) =>
+			{
+				uint crc = 0xFFFFFFFF;
+				foreach (byte b in data) { crc ^= b; for (int bit = 0; bit < 8; bit++) crc = (crc >> 1) ^ (0xEDB88320 & (uint)-(int)(crc & 1)); }
+				return ~crc;
+			};
+
+			Func<byte[], byte[]> makeblock = (data) =>
+			{
+				using (MemoryStream deflated = new MemoryStream())
+				{
+					using (DeflateStream deflate = new DeflateStream(deflated, CompressionMode.Compress, true)) deflate.Write(data, 0, data.Length);
+
+					int blocksize = 18 + (int)deflated.Length + 8;
+					using (MemoryStream block = new MemoryStream())
+					using (BinaryWriter writer = new BinaryWriter(block))
+					{
+						writer.Write(new byte[] { 0x1F, 0x8B, 0x08, 0x04, 0, 0, 0, 0, 0, 0xFF, 6, 0, (byte)'B', (byte)'C', 2, 0 });
+						writer.Write((ushort)(blocksize - 1));
+						writer.Write(deflated.ToArray());
+						writer.Write(crc32(data));
+						writer.Write((uint)data.Length);
+						return block.ToArray();
+					}
+				}
+			};
+
+			byte[] fullblock = sampledata.Take(65536).ToArray();
+			byte[] nextblock = sampledata.Skip(65536).Take(100).ToArray();
+			byte[] first = makeblock(fullblock);
+			byte[] bgzf = first.Concat(makeblock(nextblock)).Concat(makeblock(new byte[0])).ToArray();
+
+			using (BgzfReader reader = new BgzfReader(new MemoryStream(bgzf)))
+			{
+				byte[] actual = new byte[65536];
+				Assert.AreEqual(actual.Length, reader.Read(actual, 0, actual.Length));
+				Assert.IsTrue(Enumerable.SequenceEqual(fullblock, actual));
+
+				long voffset = reader.VirtualPosition;
+				Assert.AreEqual((long)first.Length << 16, voffset);
+
+				Assert.AreEqual(nextblock.Length, reader.Read(actual, 0, actual.Length));
+				reader.VirtualPosition = voffset;
+				Assert.AreEqual(nextblock.Length, reader.Read(actual, 0, actual.Length));
+				Assert.IsTrue(Enumerable.SequenceEqual(nextblock, actual.Take(nextblock.Length)));
+			}
+
+			// Virtual offsets of blocks missing from the index are located from the last indexed block before them
+			using (BgzfReader reader = new BgzfReader(new MemoryStream(bgzf), BgzfIndex.Load(new MemoryStream(new byte[8])), false))
+			{
+				byte[] actual = new byte[65536];
+
+				reader.VirtualPosition = ((long)first.Length << 16) | 5;
+				Assert.AreEqual(fullblock.Length + 5, reader.Position);
+
+				// A virtual offset that falls between blocks is rejected and leaves the reader where it was
+				try { reader.VirtualPosition = ((long)first.Length + 1) << 16; Assert.Fail("Method should have thrown an exception"); }
+				catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentException)); }
+
+				Assert.AreEqual(fullblock.Length + 5, reader.Position);
+				Assert.AreEqual(nextblock.Length - 5, reader.Read(actual, 0, actual.Length));
+				Assert.IsTrue(Enumerable.SequenceEqual(nextblock.Skip(5), actual.Take(nextblock.Length - 5)));
+			}
+		}
+
+		[TestMethod(), TestCategory("Gzip")]
+		public void Gzip_IndexOnWrite()
+		{
+			byte[] sampledata = Enumerable.Repeat(s_sampledata, 4).SelectMany(b => b).ToArray();
+
+			// Check parameter validations
+			try { using (GzipWriter writer = new GzipWriter(new MemoryStream(), null, 65536, CompressionLevel.Optimal, 1, false)) { }; Assert.Fail("Method should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentNullException)); }
+
+			try { using (GzipWriter writer = new GzipWriter(new MemoryStream(), new MemoryStream(), 1024, CompressionLevel.Optimal, 1, false)) { }; Assert.Fail("Method should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			// Access points are recorded with both serial and parallel compression
+			foreach (int threads in new int[] { 1, 4 })
+			{
+				using (MemoryStream compressed = new MemoryStream())
+				using (MemoryStream sidecar = new MemoryStream())
+				{
+					using (GzipWriter writer = new GzipWriter(compressed, sidecar, 65536, CompressionLevel.Optimal, threads, true))
+					{
+						// Write in odd-sized pieces so that access points fall in the middle of writes
+						for (int offset = 0; offset < sampledata.Length; offset += 10000)
+							writer.Write(sampledata, offset, Math.Min(10000, sampledata.Length - offset));
+					}
+
+					// The output is still a single standard GZIP member
+					compressed.Position = 0;
+					using (GZipStream reader = new GZipStream(compressed, CompressionMode.Decompress, true))
+					using (MemoryStream dest = new MemoryStream())
+					{
+						reader.CopyTo(dest);
+						Assert.IsTrue(Enumerable.SequenceEqual(sampledata, dest.ToArray()));
+					}
+
+					// The index doesn't carry any history windows
+					sidecar.Position = 0;
+					GzipIndex index = GzipIndex.Load(sidecar);
+					Assert.AreEqual(sampledata.Length, index.Length);
+					Assert.AreEqual(compressed.Length, index.CompressedLength);
+					Assert.IsTrue(index.Count >= sampledata.Length / (threads == 1 ? 65536 : 131072));
+					Assert.IsTrue(sidecar.Length < index.Count * 64);
+
+					// Seek to positions backwards and forwards throughout the stream and compare the data
+					compressed.Position = 0;
+					using (GzipReader reader = new GzipReader(compressed, index, true))
+					{
+						Random random = new Random(1);
+						byte[] actual = new byte[4096];
+
+						for (int iteration = 0; iteration < 100; iteration++)
+						{
+							long position = random.Next(sampledata.Length);
+							Assert.AreEqual(position, reader.Seek(position, SeekOrigin.Begin));
+
+							int read = reader.Read(actual, 0, actual.Length);
+							Assert.AreEqual(Math.Min(actual.Length, sampledata.Length - position), read);
+							Assert.IsTrue(Enumerable.SequenceEqual(sampledata.Skip((int)position).Take(read), actual.Take(read)));
+						}
+
+						reader.Seek(-10, SeekOrigin.End);
+						Assert.AreEqual(10, reader.Read(actual, 0, actual.Length));
+						Assert.AreEqual(0, reader.Read(actual, 0, actual.Length));
+
+						reader.Position = 0;
+						using (MemoryStream dest = new MemoryStream())
+						{
+							reader.CopyTo(dest);
+							Assert.IsTrue(Enumerable.SequenceEqual(sampledata, dest.ToArray()));
+						}
+					}
+				}
+			}
+		}
+
+		[TestMethod(), TestCategory("Gzip")]
+		public void Gzip_ContainerFormats()
+		{
+			byte[] sampledata = s_sampledata;
+
+			foreach (int threads in new int[] { 1, 4 })
+			{
+				// Raw deflate data must be readable by DeflateStream
+				using (MemoryStream compressed = new MemoryStream())
+				{
+					GzipEncoder encoder = new GzipEncoder();
+					encoder.ContainerFormat = GzipContainerFormat.Raw;
+					encoder.MaximumThreads = threads;
+					encoder.Encode(sampledata, compressed);
+
+					compressed.Position = 0;
+					using (DeflateStream reader = new DeflateStream(compressed, CompressionMode.Decompress, true))
+					using (MemoryStream dest = new MemoryStream())
+					{
+						reader.CopyTo(dest);
+						Assert.IsTrue(Enumerable.SequenceEqual(sampledata, dest.ToArray()));
+					}
+
+					compressed.Position = 0;
+					using (GzipReader reader = new GzipReader(compressed, GzipContainerFormat.Raw, true))
+					using (MemoryStream dest = new MemoryStream())
+					{
+						reader.CopyTo(dest);
+						Assert.IsTrue(Enumerable.SequenceEqual(sampledata, dest.ToArray()));
+					}
+				}
+
+				// zlib data with a smaller window, the header must pass the FCHECK test and carry the window size
+				using (MemoryStream compressed = new MemoryStream())
+				{
+					GzipEncoder encoder = new GzipEncoder();
+					encoder.ContainerFormat = GzipContainerFormat.Zlib;
+					encoder.WindowSize = 10;
+					encoder.MaximumThreads = threads;
+					encoder.Encode(sampledata, compressed);
+
+					byte[] header = compressed.ToArray();
+					Assert.AreEqual(0x28, header[0]);
+					Assert.AreEqual(0, ((header[0] << 8) | header[1]) % 31);
+
+					foreach (GzipContainerFormat format in new GzipContainerFormat[] { GzipContainerFormat.Zlib, GzipContainerFormat.AutoDetect })
+					{
+						compressed.Position = 0;
+						using (GzipReader reader = new GzipReader(compressed, format, true))
+						using (MemoryStream dest = new MemoryStream())
+						{
+							reader.CopyTo(dest);
+							Assert.IsTrue(Enumerable.SequenceEqual(sampledata, dest.ToArray()));
+						}
+					}
+				}
+			}
+
+			// Auto-detection also accepts GZIP data
+			using (MemoryStream compressed = new MemoryStream())
+			{
+				using (GzipWriter writer = new GzipWriter(compressed, GzipContainerFormat.Gzip, CompressionLevel.Optimal, true)) writer.Write(sampledata);
+
+				compressed.Position = 0;
+				using (GzipReader reader = new GzipReader(compressed, GzipContainerFormat.AutoDetect, true))
+				using (MemoryStream dest = new MemoryStream())
+				{
+					reader.CopyTo(dest);
+					Assert.IsTrue(Enumerable.SequenceEqual(sampledata, dest.ToArray()));
+				}
+			}
+
+			// AutoDetect is only valid for decompression and the window can't be smaller than 512 bytes
+			using (MemoryStream compressed = new MemoryStream())
+			{
+				try { using (new GzipWriter(compressed, GzipContainerFormat.AutoDetect, CompressionLevel.Optimal, true)) { } Assert.Fail("Constructor should have thrown an exception"); }
+				catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+				try { new GzipEncoder().WindowSize = 8; Assert.Fail("Property should have thrown an exception"); }
+				catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+			}
+		}
+
+		[TestMethod(), TestCategory("Gzip")]
+		public void Gzip_PresetDictionary()
+		{
+			// Small messages that share most of their content with the dictionary
+			byte[] dictionarydata = Encoding.ASCII.GetBytes("{\"id\":0,\"name\":\"\",\"status\":\"active\",\"tags\":[\"alpha\",\"beta\"],\"owner\":{\"id\":0,\"email\":\"\"}}");
+			byte[] message = Encoding.ASCII.GetBytes("{\"id\":12345,\"name\":\"musketeer\",\"status\":\"active\",\"tags\":[\"alpha\",\"beta\"],\"owner\":{\"id\":42,\"email\":\"athos@example.com\"}}");
+
+			using (GzipDictionary dictionary = new GzipDictionary(dictionarydata))
+			{
+				foreach (GzipContainerFormat format in new GzipContainerFormat[] { GzipContainerFormat.Zlib, GzipContainerFormat.Raw })
+				{
+					GzipEncoder encoder = new GzipEncoder();
+					encoder.ContainerFormat = format;
+					byte[] plain = encoder.Encode(message);
+
+					// The cached dictionary state is reused by each stream; serial and parallel output must both decode
+					encoder.Dictionary = dictionary;
+					foreach (int threads in new int[] { 1, 1, 4 })
+					{
+						encoder.MaximumThreads = threads;
+						byte[] compressed = encoder.Encode(message);
+						Assert.IsTrue(compressed.Length < plain.Length);
+
+						using (GzipReader reader = new GzipReader(new MemoryStream(compressed), format, dictionary, false))
+						using (MemoryStream dest = new MemoryStream())
+						{
+							reader.CopyTo(dest);
+							Assert.IsTrue(Enumerable.SequenceEqual(message, dest.ToArray()));
+						}
+					}
+				}
+
+				// A zlib stream with a preset dictionary can't be read without it
+				using (MemoryStream compressed = new MemoryStream())
+				{
+					using (GzipWriter writer = new GzipWriter(compressed, GzipContainerFormat.Zlib, dictionary, CompressionLevel.Optimal, true)) writer.Write(message);
+
+					compressed.Position = 0;
+					using (GzipReader reader = new GzipReader(compressed, GzipContainerFormat.AutoDetect, true))
+					{
+						try { reader.CopyTo(new MemoryStream()); Assert.Fail("Read should have thrown an exception"); }
+						catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(GzipException)); }
+					}
+
+					// GZIP streams do not support preset dictionaries
+					try { using (new GzipWriter(compressed, GzipContainerFormat.Gzip, dictionary, CompressionLevel.Optimal, true)) { } Assert.Fail("Constructor should have thrown an exception"); }
+					catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentException)); }
+				}
+			}
+		}
 	}
 }
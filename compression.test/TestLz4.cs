@@ -802,5 +802,459 @@ public void Lz4_Encoder()
 				Assert.IsTrue(Enumerable.SequenceEqual(expected, dest.ToArray()));
 			}
 		}
+
+		[TestMethod(), TestCategory("Lz4")]
+		public void Lz4_ParallelCompression()
+		{
+			Lz4Encoder encoder = new Lz4Encoder();
+
+			// Parallel compression is disabled by default
+			Assert.AreEqual(1, encoder.MaximumThreads);
+			Assert.AreEqual(0, encoder.MaximumPendingBlocks);
+
+			try { encoder.MaximumThreads = -1; Assert.Fail("Property access should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			try { encoder.MaximumPendingBlocks = -1; Assert.Fail("Property access should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			// Compress independent blocks in parallel with a small in-flight limit and checksum
+			encoder.BlockMode = Lz4BlockMode.Independent;
+			encoder.BlockSize = Lz4BlockSize.Maximum64KiB;
+			encoder.ContentChecksum = Lz4ContentChecksum.Enabled;
+			encoder.MaximumThreads = 4;
+			encoder.MaximumPendingBlocks = 3;
+
+			// The output must be a standard frame that the serial Lz4Reader can decompress
+			using (MemoryStream compressed = new MemoryStream(encoder.Encode(s_sampledata)))
+			{
+				using (Lz4Reader reader = new Lz4Reader(compressed))
+				{
+					using (MemoryStream dest = new MemoryStream())
+					{
+						reader.CopyTo(dest);
+						Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata, dest.ToArray()));
+					}
+				}
+			}
+
+			// Check the public Lz4Writer constructor, including a flush mid-stream
+			using (MemoryStream compressed = new MemoryStream())
+			{
+				using (Lz4Writer writer = new Lz4Writer(compressed, CompressionLevel.Optimal, 0, true))
+				{
+					writer.Write(s_sampledata, 0, s_sampledata.Length / 2);
+					writer.Flush();
+					writer.Write(s_sampledata, s_sampledata.Length / 2, s_sampledata.Length - (s_sampledata.Length / 2));
+				}
+
+				compressed.Position = 0;
+				using (Lz4Reader reader = new Lz4Reader(compressed, true))
+				{
+					using (MemoryStream dest = new MemoryStream())
+					{
+						reader.CopyTo(dest);
+						Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata, dest.ToArray()));
+					}
+				}
+			}
+		}
+
+		[TestMethod(), TestCategory("Lz4")]
+		public void Lz4_ParallelDecompression()
+		{
+			Lz4Encoder encoder = new Lz4Encoder();
+			encoder.BlockMode = Lz4BlockMode.Independent;
+			encoder.BlockSize = Lz4BlockSize.Maximum64KiB;
+			encoder.ContentChecksum = Lz4ContentChecksum.Enabled;
+
+			try { using (Lz4Reader reader = new Lz4Reader(new MemoryStream(), -1, false)) Assert.Fail("Method call should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			// Independent block frames are decompressed in parallel with a bounded reorder window
+			using (Lz4Reader reader = new Lz4Reader(new MemoryStream(encoder.Encode(s_sampledata)), 4, 3, false))
+			{
+				using (MemoryStream dest = new MemoryStream())
+				{
+					reader.CopyTo(dest);
+					Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata, dest.ToArray()));
+				}
+			}
+
+			// Linked block frames fall back to serial decompression
+			using (Lz4Reader reader = new Lz4Reader(Assembly.GetExecutingAssembly().GetManifestResourceStream("zuki.io.compression.test.thethreemusketeers.lz4"), 0, false))
+			{
+				using (MemoryStream dest = new MemoryStream())
+				{
+					reader.CopyTo(dest);
+					Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata, dest.ToArray()));
+				}
+			}
+		}
+
+		[TestMethod(), TestCategory("Lz4")]
+		public void Lz4_RandomAccess()
+		{
+			Lz4Encoder encoder = new Lz4Encoder();
+			encoder.BlockMode = Lz4BlockMode.Independent;
+			encoder.BlockSize = Lz4BlockSize.Maximum64KiB;
+			encoder.ContentChecksum = Lz4ContentChecksum.Enabled;
+
+			// Generate a stream of two concatenated frames
+			byte[] frame = encoder.Encode(s_sampledata);
+			byte[] compressed = frame.Concat(frame).ToArray();
+			byte[] expected = s_sampledata.Concat(s_sampledata).ToArray();
+
+			try { Lz4Index.Build(null); Assert.Fail("Method call should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentNullException)); }
+
+			try { Lz4Index.Load(new MemoryStream(new byte[16])); Assert.Fail("Method call should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(InvalidDataException)); }
+
+			// Linked blocks cannot be entered mid-stream and cannot be indexed
+			encoder.BlockMode = Lz4BlockMode.Linked;
+			try { Lz4Index.Build(new MemoryStream(encoder.Encode(s_sampledata))); Assert.Fail("Method call should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(NotSupportedException)); }
+
+			// Build the index and round-trip it through a sidecar
+			Lz4Index built = Lz4Index.Build(new MemoryStream(compressed));
+			Assert.AreEqual(expected.Length, built.Length);
+			Assert.IsTrue(built.Count > 2);
+
+			Lz4Index index;
+			using (MemoryStream sidecar = new MemoryStream())
+			{
+				built.Save(sidecar);
+				sidecar.Position = 0;
+				index = Lz4Index.Load(sidecar);
+			}
+
+			Assert.AreEqual(built.Count, index.Count);
+			Assert.AreEqual(built.Length, index.Length);
+
+			// A stream without an index cannot seek
+			using (Lz4Reader reader = new Lz4Reader(new MemoryStream(compressed)))
+			{
+				Assert.IsFalse(reader.CanSeek);
+				try { reader.Seek(0, SeekOrigin.Begin); Assert.Fail("Method call should have thrown an exception"); }
+				catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(NotSupportedException)); }
+			}
+
+			// The index can be supplied from a sidecar or appended to the stream as a skippable frame
+			using (MemoryStream appended = new MemoryStream())
+			{
+				appended.Write(compressed, 0, compressed.Length);
+				index.Save(appended);
+
+				foreach (Lz4Reader reader in new Lz4Reader[] { new Lz4Reader(new MemoryStream(compressed), index, false), new Lz4Reader(new MemoryStream(appended.ToArray())) })
+				{
+					using (reader)
+					{
+						Assert.IsTrue(reader.CanSeek);
+						Assert.AreEqual(expected.Length, reader.Length);
+
+						Random random = new Random(1);
+						byte[] actual = new byte[4096];
+
+						for (int iteration = 0; iteration < 100; iteration++)
+						{
+							long position = random.Next(expected.Length);
+							Assert.AreEqual(position, reader.Seek(position, SeekOrigin.Begin));
+
+							int read = reader.Read(actual, 0, actual.Length);
+							Assert.AreEqual(Math.Min(actual.Length, expected.Length - position), read);
+							Assert.AreEqual(position + read, reader.Position);
+							Assert.IsTrue(Enumerable.SequenceEqual(expected.Skip((int)position).Take(read), actual.Take(read)));
+						}
+
+						reader.Seek(-10, SeekOrigin.End);
+						Assert.AreEqual(10, reader.Read(actual, 0, actual.Length));
+						Assert.AreEqual(0, reader.Read(actual, 0, actual.Length));
+
+						try { reader.Seek(-1, SeekOrigin.Begin); Assert.Fail("Method call should have thrown an exception"); }
+						catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(IOException)); }
+
+						// Reading from the beginning returns both of the frames
+						reader.Position = 0;
+						using (MemoryStream dest = new MemoryStream())
+						{
+							reader.CopyTo(dest);
+							Assert.IsTrue(Enumerable.SequenceEqual(expected, dest.ToArray()));
+						}
+					}
+				}
+			}
+		}
+
+		[TestMethod(), TestCategory("Lz4")]
+		public void Lz4_SeekableFrames()
+		{
+			Lz4Encoder encoder = new Lz4Encoder();
+
+			// Seekable output is disabled by default
+			Assert.AreEqual(0, encoder.FrameSize);
+
+			try { encoder.FrameSize = -1; Assert.Fail("Property should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			// The output is a series of independent frames followed by the seek table, the same regardless of the thread count
+			encoder.FrameSize = 65536;
+			encoder.ContentChecksum = Lz4ContentChecksum.Enabled;
+			byte[] compressed = encoder.Encode(s_sampledata);
+
+			encoder.MaximumThreads = 4;
+			Assert.IsTrue(Enumerable.SequenceEqual(compressed, encoder.Encode(s_sampledata)));
+
+			// The seek table is loaded automatically from a seekable base stream
+			using (Lz4Reader reader = new Lz4Reader(new MemoryStream(compressed)))
+			{
+				Assert.IsTrue(reader.CanSeek);
+				Assert.AreEqual(s_sampledata.Length, reader.Length);
+
+				Random random = new Random(1);
+				byte[] actual = new byte[4096];
+
+				for (int iteration = 0; iteration < 100; iteration++)
+				{
+					long position = random.Next(s_sampledata.Length);
+					Assert.AreEqual(position, reader.Seek(position, SeekOrigin.Begin));
+
+					int read = reader.Read(actual, 0, actual.Length);
+					Assert.AreEqual(Math.Min(actual.Length, s_sampledata.Length - position), read);
+					Assert.AreEqual(position + read, reader.Position);
+					Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata.Skip((int)position).Take(read), actual.Take(read)));
+				}
+
+				reader.Seek(-10, SeekOrigin.End);
+				Assert.AreEqual(10, reader.Read(actual, 0, actual.Length));
+				Assert.AreEqual(0, reader.Read(actual, 0, actual.Length));
+
+				try { reader.Seek(-1, SeekOrigin.Begin); Assert.Fail("Method call should have thrown an exception"); }
+				catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(IOException)); }
+
+				reader.Position = 0;
+				using (MemoryStream dest = new MemoryStream())
+				{
+					reader.CopyTo(dest);
+					Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata, dest.ToArray()));
+				}
+			}
+
+			// A base stream that cannot seek is decompressed frame by frame, skipping over the seek table
+			using (MemoryStream wrapped = new MemoryStream())
+			{
+				using (GZipStream gzip = new GZipStream(wrapped, CompressionMode.Compress, true)) gzip.Write(compressed, 0, compressed.Length);
+				wrapped.Position = 0;
+
+				using (Lz4Reader reader = new Lz4Reader(new GZipStream(wrapped, CompressionMode.Decompress)))
+				{
+					Assert.IsFalse(reader.CanSeek);
+					using (MemoryStream dest = new MemoryStream())
+					{
+						reader.CopyTo(dest);
+						Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata, dest.ToArray()));
+					}
+				}
+			}
+
+			// Parallel decompression continues through each concatenated frame, skipping over the seek table, and
+			// falls back to serial decompression when it reaches a frame that has linked blocks
+			encoder.BlockMode = Lz4BlockMode.Independent;
+			byte[] independent = encoder.Encode(s_sampledata);
+
+			Lz4Encoder linked = new Lz4Encoder();
+			byte[] concatenated = independent.Concat(independent).Concat(linked.Encode(s_sampledata)).ToArray();
+			byte[] expected = s_sampledata.Concat(s_sampledata).Concat(s_sampledata).ToArray();
+
+			using (MemoryStream wrapped = new MemoryStream())
+			{
+				using (GZipStream gzip = new GZipStream(wrapped, CompressionMode.Compress, true)) gzip.Write(concatenated, 0, concatenated.Length);
+				wrapped.Position = 0;
+
+				using (Lz4Reader reader = new Lz4Reader(new GZipStream(wrapped, CompressionMode.Decompress), 4, false))
+				{
+					using (MemoryStream dest = new MemoryStream())
+					{
+						reader.CopyTo(dest);
+						Assert.IsTrue(Enumerable.SequenceEqual(expected, dest.ToArray()));
+					}
+				}
+			}
+
+			// Data after the last frame only continues decompression when it starts with a complete frame magic number
+			byte[] linkedframe = linked.Encode(s_sampledata);
+			foreach (byte[] trailer in new byte[][] { new byte[] { 0x04 }, new byte[] { 0x04, 0x22, 0x4D }, new byte[] { 0x04, 0x00, 0x00, 0x00 }, new byte[] { 0x50, 0x00, 0x00, 0x00, 0x00 } })
+			{
+				using (Lz4Reader reader = new Lz4Reader(new MemoryStream(linkedframe.Concat(trailer).ToArray())))
+				{
+					using (MemoryStream dest = new MemoryStream())
+					{
+						reader.CopyTo(dest);
+						Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata, dest.ToArray()));
+					}
+				}
+			}
+
+			// The seek table doesn't prevent parallel decompression when reading from the start of the stream
+			using (Lz4Reader reader = new Lz4Reader(new MemoryStream(independent), 4, false))
+			{
+				Assert.IsTrue(reader.CanSeek);
+				Assert.AreEqual(s_sampledata.Length, reader.Length);
+
+				byte[] actual = new byte[4096];
+				using (MemoryStream dest = new MemoryStream())
+				{
+					int read;
+					while ((read = reader.Read(actual, 0, actual.Length)) > 0)
+					{
+						dest.Write(actual, 0, read);
+						Assert.AreEqual(dest.Length, reader.Position);
+					}
+
+					Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata, dest.ToArray()));
+				}
+
+				reader.Seek(1000, SeekOrigin.Begin);
+				Assert.AreEqual(actual.Length, reader.Read(actual, 0, actual.Length));
+				Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata.Skip(1000).Take(actual.Length), actual));
+			}
+
+			// Seekable output can also be written directly with Lz4Writer
+			try { using (Lz4Writer writer = new Lz4Writer(new MemoryStream(), CompressionLevel.Fastest, -1, 1, false)) Assert.Fail("Method call should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			using (MemoryStream written = new MemoryStream())
+			{
+				using (Lz4Writer writer = new Lz4Writer(written, CompressionLevel.Fastest, 65536, 4, true)) writer.Write(s_sampledata, 0, s_sampledata.Length);
+
+				written.Position = 0;
+				using (Lz4Reader reader = new Lz4Reader(written, true))
+				{
+					Assert.IsTrue(reader.CanSeek);
+					Assert.AreEqual(s_sampledata.Length, reader.Length);
+
+					byte[] actual = new byte[4096];
+					reader.Seek(s_sampledata.Length / 2, SeekOrigin.Begin);
+					Assert.AreEqual(actual.Length, reader.Read(actual, 0, actual.Length));
+					Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata.Skip(s_sampledata.Length / 2).Take(actual.Length), actual));
+				}
+			}
+
+			// An empty stream is a single empty frame and an empty seek table
+			using (Lz4Reader reader = new Lz4Reader(new MemoryStream(encoder.Encode(new byte[0]))))
+			{
+				Assert.IsTrue(reader.CanSeek);
+				Assert.AreEqual(0, reader.Length);
+				Assert.AreEqual(0, reader.Read(new byte[16], 0, 16));
+			}
+		}
+
+		[TestMethod(), TestCategory("Lz4")]
+		public void Lz4_Dictionary()
+		{
+			// Small messages that share most of their content with the dictionary
+			byte[] dictionarydata = Encoding.ASCII.GetBytes("{\"id\":0,\"name\":\"\",\"status\":\"active\",\"tags\":[\"alpha\",\"beta\"],\"owner\":{\"id\":0,\"email\":\"\"}}");
+			byte[] message = Encoding.ASCII.GetBytes("{\"id\":12345,\"name\":\"musketeer\",\"status\":\"active\",\"tags\":[\"alpha\",\"beta\"],\"owner\":{\"id\":42,\"email\":\"athos@example.com\"}}");
+
+			using (Lz4Dictionary dictionary = new Lz4Dictionary(dictionarydata))
+			{
+				foreach (Lz4CompressionLevel level in new Lz4CompressionLevel[] { Lz4CompressionLevel.Fastest, Lz4CompressionLevel.Optimal })
+				{
+					Lz4Encoder encoder = new Lz4Encoder();
+					encoder.CompressionLevel = level;
+					encoder.BlockMode = Lz4BlockMode.Independent;
+
+					// The digested dictionary is shared by the serial, parallel block and seekable frame compressors
+					foreach (int framesize in new int[] { 0, 64 })
+					{
+						foreach (int threads in new int[] { 1, 4 })
+						{
+							encoder.FrameSize = framesize;
+							encoder.MaximumThreads = threads;
+
+							encoder.Dictionary = null;
+							byte[] plain = encoder.Encode(message);
+
+							encoder.Dictionary = dictionary;
+							byte[] compressed = encoder.Encode(message);
+							Assert.IsTrue(compressed.Length < plain.Length);
+
+							using (Lz4Reader reader = new Lz4Reader(new MemoryStream(compressed), dictionary, false))
+							using (MemoryStream dest = new MemoryStream())
+							{
+								reader.CopyTo(dest);
+								Assert.IsTrue(Enumerable.SequenceEqual(message, dest.ToArray()));
+							}
+
+							// The dictionary is also used to decode the blocks located by a random access index
+							using (Lz4Reader reader = new Lz4Reader(new MemoryStream(compressed), Lz4Index.Build(new MemoryStream(compressed)), dictionary, false))
+							using (MemoryStream dest = new MemoryStream())
+							{
+								reader.Seek(70, SeekOrigin.Begin);
+								reader.CopyTo(dest);
+								Assert.IsTrue(Enumerable.SequenceEqual(message.Skip(70), dest.ToArray()));
+							}
+						}
+					}
+				}
+
+				// Frames with a dictionary identifier span many indexed blocks, each of which is decoded with the dictionary
+				byte[] data = Enumerable.Range(0, 4096).SelectMany(i => message.Concat(BitConverter.GetBytes(i))).ToArray();
+
+				Lz4Encoder blockencoder = new Lz4Encoder();
+				blockencoder.BlockMode = Lz4BlockMode.Independent;
+				blockencoder.BlockSize = Lz4BlockSize.Maximum64KiB;
+				blockencoder.Dictionary = dictionary;
+
+				byte[] encoded = blockencoder.Encode(data);
+				Lz4Index index = Lz4Index.Build(new MemoryStream(encoded));
+				Assert.AreEqual(data.Length, index.Length);
+				Assert.IsTrue(index.Count > 1);
+
+				using (Lz4Reader reader = new Lz4Reader(new MemoryStream(encoded), index, dictionary, false))
+				{
+					Random random = new Random(1);
+					byte[] actual = new byte[4096];
+
+					for (int iteration = 0; iteration < 50; iteration++)
+					{
+						long position = random.Next(data.Length);
+						Assert.AreEqual(position, reader.Seek(position, SeekOrigin.Begin));
+
+						int read = reader.Read(actual, 0, actual.Length);
+						Assert.AreEqual(Math.Min(actual.Length, data.Length - position), read);
+						Assert.IsTrue(Enumerable.SequenceEqual(data.Skip((int)position).Take(read), actual.Take(read)));
+					}
+				}
+
+				// The index can be used to read the frame, but the dictionary is still required to decode its blocks
+				using (Lz4Reader reader = new Lz4Reader(new MemoryStream(encoded), index, false))
+				{
+					try { reader.CopyTo(new MemoryStream()); Assert.Fail("Read should have thrown an exception"); }
+					catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(InvalidDataException)); }
+				}
+
+				// The frame header carries the dictionary identifier, which must match the dictionary used to read it
+				using (MemoryStream compressed = new MemoryStream())
+				{
+					using (Lz4Writer writer = new Lz4Writer(compressed, dictionary, CompressionLevel.Optimal, true)) writer.Write(message, 0, message.Length);
+
+					compressed.Position = 0;
+					using (Lz4Reader reader = new Lz4Reader(compressed, true))
+					{
+						try { reader.CopyTo(new MemoryStream()); Assert.Fail("Read should have thrown an exception"); }
+						catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(InvalidDataException)); }
+					}
+
+					compressed.Position = 0;
+					using (Lz4Dictionary other = new Lz4Dictionary(Encoding.ASCII.GetBytes("a different dictionary")))
+					using (Lz4Reader reader = new Lz4Reader(compressed, other, true))
+					{
+						try { reader.CopyTo(new MemoryStream()); Assert.Fail("Read should have thrown an exception"); }
+						catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(InvalidDataException)); }
+					}
+				}
+			}
+		}
 	}
 }
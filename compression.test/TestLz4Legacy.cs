@@ -648,5 +648,259 @@ public void Lz4Legacy_Encoder()
 				Assert.IsTrue(Enumerable.SequenceEqual(expected, dest.ToArray()));
 			}
 		}
+
+		[TestMethod(), TestCategory("Lz4Legacy")]
+		public void Lz4Legacy_LargeWrite()
+		{
+			// A single write that spans more than one 8MiB legacy block has to be split across blocks in order
+			byte[] sampledata = Enumerable.Repeat(s_sampledata, 12).SelectMany(b => b).ToArray();
+			Assert.IsTrue(sampledata.Length > (8 << 20));
+
+			foreach (int threads in new int[] { 1, 4 })
+			{
+				using (MemoryStream compressed = new MemoryStream())
+				{
+					using (Lz4LegacyWriter writer = new Lz4LegacyWriter(compressed, CompressionLevel.Fastest, threads, true)) writer.Write(sampledata, 0, sampledata.Length);
+
+					compressed.Position = 0;
+					using (Lz4LegacyReader reader = new Lz4LegacyReader(compressed, true))
+					using (MemoryStream dest = new MemoryStream())
+					{
+						reader.CopyTo(dest);
+						Assert.IsTrue(Enumerable.SequenceEqual(sampledata, dest.ToArray()));
+					}
+				}
+			}
+		}
+
+		[TestMethod(), TestCategory("Lz4Legacy")]
+		public void Lz4Legacy_ParallelCompression()
+		{
+			Lz4LegacyEncoder encoder = new Lz4LegacyEncoder();
+
+			// Parallel compression is disabled by default
+			Assert.AreEqual(1, encoder.MaximumThreads);
+			Assert.AreEqual(0, encoder.MaximumPendingBlocks);
+
+			try { encoder.MaximumThreads = -1; Assert.Fail("Property access should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			try { encoder.MaximumPendingBlocks = -1; Assert.Fail("Property access should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			// Legacy blocks are 8MiB; repeat the sample data to span several of them
+			byte[] sampledata = Enumerable.Repeat(s_sampledata, 16).SelectMany(b => b).ToArray();
+			byte[] expected = encoder.Encode(sampledata);
+
+			// Blocks are compressed independently, the parallel output must match the serial output
+			encoder.MaximumThreads = 4;
+			encoder.MaximumPendingBlocks = 3;
+			Assert.IsTrue(Enumerable.SequenceEqual(expected, encoder.Encode(sampledata)));
+
+			// Check the public Lz4LegacyWriter constructor, including a flush mid-stream
+			using (MemoryStream compressed = new MemoryStream())
+			{
+				using (Lz4LegacyWriter writer = new Lz4LegacyWriter(compressed, CompressionLevel.Optimal, 0, true))
+				{
+					writer.Write(sampledata, 0, sampledata.Length / 2);
+					writer.Flush();
+					writer.Write(sampledata, sampledata.Length / 2, sampledata.Length - (sampledata.Length / 2));
+				}
+
+				compressed.Position = 0;
+				using (Lz4LegacyReader reader = new Lz4LegacyReader(compressed, true))
+				{
+					using (MemoryStream dest = new MemoryStream())
+					{
+						reader.CopyTo(dest);
+						Assert.IsTrue(Enumerable.SequenceEqual(sampledata, dest.ToArray()));
+					}
+				}
+			}
+		}
+
+		[TestMethod(), TestCategory("Lz4Legacy")]
+		public void Lz4Legacy_ParallelDecompression()
+		{
+			// Check parameter validations
+			try { using (Lz4LegacyReader reader = new Lz4LegacyReader(new MemoryStream(), -1, false)) { }; Assert.Fail("Constructor should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			try { using (Lz4LegacyReader reader = new Lz4LegacyReader(new MemoryStream(), 2, -1, false)) { }; Assert.Fail("Constructor should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			// Legacy blocks are 8MiB; repeat the sample data to span several of them
+			byte[] sampledata = Enumerable.Repeat(s_sampledata, 16).SelectMany(b => b).ToArray();
+			byte[] compressed = new Lz4LegacyEncoder().Encode(sampledata);
+
+			// Decompress with a small read-ahead limit, using reads that straddle block boundaries
+			using (Lz4LegacyReader reader = new Lz4LegacyReader(new MemoryStream(compressed), 4, 3, false))
+			{
+				byte[] actual = new byte[sampledata.Length];
+				int total = 0, read = 0;
+
+				while ((read = reader.Read(actual, total, Math.Min(3 << 20, actual.Length - total))) > 0) total += read;
+
+				Assert.AreEqual(sampledata.Length, total);
+				Assert.IsTrue(Enumerable.SequenceEqual(sampledata, actual));
+				Assert.AreEqual(0, reader.Read(actual, 0, actual.Length));
+			}
+
+			// Decompress a stream created externally to this library using the processor count
+			using (Lz4LegacyReader reader = new Lz4LegacyReader(Assembly.GetExecutingAssembly().GetManifestResourceStream("zuki.io.compression.test.thethreemusketeers.lz4-legacy"), 0, false))
+			{
+				using (MemoryStream dest = new MemoryStream())
+				{
+					reader.CopyTo(dest);
+					Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata, dest.ToArray()));
+				}
+			}
+		}
+
+		[TestMethod(), TestCategory("Lz4Legacy")]
+		public void Lz4Legacy_RandomAccess()
+		{
+			// Generate a stream with several full blocks and a short last block
+			byte[] expected = Enumerable.Repeat(s_sampledata, 14).SelectMany(b => b).ToArray();
+			byte[] compressed = new Lz4LegacyEncoder().Encode(expected);
+
+			try { Lz4LegacyIndex.Build(null); Assert.Fail("Method call should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentNullException)); }
+
+			try { using (Lz4LegacyReader reader = new Lz4LegacyReader(new MemoryStream(compressed), (Lz4LegacyIndex)null, false)) { }; Assert.Fail("Constructor should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentNullException)); }
+
+			// Building the index up front locates every block by hopping over the block headers
+			Lz4LegacyIndex built = Lz4LegacyIndex.Build(new MemoryStream(compressed));
+			Assert.IsTrue(built.IsComplete);
+			Assert.AreEqual((expected.Length + (8 << 20) - 1) / (8 << 20), built.Count);
+
+			// An empty index is filled in by the reader as blocks are needed
+			Lz4LegacyIndex lazy = new Lz4LegacyIndex();
+			Assert.IsFalse(lazy.IsComplete);
+			Assert.AreEqual(0, lazy.Count);
+
+			foreach (Lz4LegacyIndex index in new Lz4LegacyIndex[] { lazy, built })
+			{
+				using (Lz4LegacyReader reader = new Lz4LegacyReader(new MemoryStream(compressed), index, false))
+				{
+					Assert.IsTrue(reader.CanSeek);
+
+					// Reading the first block only locates the blocks that have been needed
+					byte[] actual = new byte[4096];
+					Assert.AreEqual(actual.Length, reader.Read(actual, 0, actual.Length));
+					Assert.IsTrue(Enumerable.SequenceEqual(expected.Take(actual.Length), actual));
+					if (index == lazy) Assert.IsFalse(lazy.IsComplete);
+
+					Assert.AreEqual(expected.Length, reader.Length);
+					Assert.IsTrue(index.IsComplete);
+
+					Random random = new Random(1);
+
+					for (int iteration = 0; iteration < 100; iteration++)
+					{
+						long position = random.Next(expected.Length);
+						Assert.AreEqual(position, reader.Seek(position, SeekOrigin.Begin));
+
+						int read = reader.Read(actual, 0, actual.Length);
+						Assert.AreEqual(Math.Min(actual.Length, expected.Length - position), read);
+						Assert.AreEqual(position + read, reader.Position);
+						Assert.IsTrue(Enumerable.SequenceEqual(expected.Skip((int)position).Take(read), actual.Take(read)));
+					}
+
+					reader.Seek(-10, SeekOrigin.End);
+					Assert.AreEqual(10, reader.Read(actual, 0, actual.Length));
+					Assert.AreEqual(0, reader.Read(actual, 0, actual.Length));
+
+					try { reader.Seek(-1, SeekOrigin.Begin); Assert.Fail("Method call should have thrown an exception"); }
+					catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(IOException)); }
+
+					reader.Position = 0;
+					using (MemoryStream dest = new MemoryStream())
+					{
+						reader.CopyTo(dest);
+						Assert.IsTrue(Enumerable.SequenceEqual(expected, dest.ToArray()));
+					}
+				}
+			}
+
+			// Only the last block of a legacy stream can be shorter than the block size; a block flushed before it
+			// was full still decodes sequentially, but doesn't match the index when it is read by position
+			using (MemoryStream flushed = new MemoryStream())
+			{
+				using (Lz4LegacyWriter writer = new Lz4LegacyWriter(flushed, CompressionLevel.Optimal, true))
+				{
+					writer.Write(expected, 0, 1000);
+					writer.Flush();
+					writer.Write(expected, 1000, expected.Length - 1000);
+				}
+
+				flushed.Position = 0;
+				using (Lz4LegacyReader reader = new Lz4LegacyReader(flushed, true))
+				{
+					using (MemoryStream dest = new MemoryStream())
+					{
+						reader.CopyTo(dest);
+						Assert.IsTrue(Enumerable.SequenceEqual(expected, dest.ToArray()));
+					}
+				}
+
+				flushed.Position = 0;
+				Lz4LegacyIndex index = Lz4LegacyIndex.Build(flushed);
+				Assert.AreEqual(((expected.Length - 1000) + (8 << 20) - 1) / (8 << 20) + 1, index.Count);
+
+				flushed.Position = 0;
+				using (Lz4LegacyReader reader = new Lz4LegacyReader(flushed, index, true))
+				{
+					try { reader.Read(new byte[4096], 0, 4096); Assert.Fail("Method call should have thrown an exception"); }
+					catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(InvalidDataException)); }
+				}
+			}
+		}
+
+		[TestMethod(), TestCategory("Lz4Legacy")]
+		public void Lz4Legacy_Dictionary()
+		{
+			byte[] dictionarydata = Encoding.ASCII.GetBytes("{\"id\":0,\"name\":\"\",\"status\":\"active\",\"tags\":[\"alpha\",\"beta\"],\"owner\":{\"id\":0,\"email\":\"\"}}");
+			byte[] message = Encoding.ASCII.GetBytes("{\"id\":12345,\"name\":\"musketeer\",\"status\":\"active\",\"tags\":[\"alpha\",\"beta\"],\"owner\":{\"id\":42,\"email\":\"athos@example.com\"}}");
+
+			using (Lz4Dictionary dictionary = new Lz4Dictionary(dictionarydata))
+			{
+				Lz4LegacyEncoder encoder = new Lz4LegacyEncoder();
+				byte[] plain = encoder.Encode(message);
+
+				// The legacy format has no dictionary identifier; the reader has to be given the same dictionary
+				encoder.Dictionary = dictionary;
+				foreach (int threads in new int[] { 1, 4 })
+				{
+					encoder.MaximumThreads = threads;
+					byte[] compressed = encoder.Encode(message);
+					Assert.IsTrue(compressed.Length < plain.Length);
+
+					using (Lz4LegacyReader reader = new Lz4LegacyReader(new MemoryStream(compressed), dictionary, false))
+					using (MemoryStream dest = new MemoryStream())
+					{
+						reader.CopyTo(dest);
+						Assert.IsTrue(Enumerable.SequenceEqual(message, dest.ToArray()));
+					}
+				}
+
+				try { using (Lz4LegacyReader reader = new Lz4LegacyReader(new MemoryStream(), (Lz4Dictionary)null, false)) { }; Assert.Fail("Constructor should have thrown an exception"); }
+				catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentNullException)); }
+
+				// The dictionary is also used to decode the blocks located by a random access index
+				encoder.MaximumThreads = 1;
+				using (Lz4LegacyReader reader = new Lz4LegacyReader(new MemoryStream(encoder.Encode(message)), new Lz4LegacyIndex(), dictionary, false))
+				using (MemoryStream dest = new MemoryStream())
+				{
+					reader.Seek(70, SeekOrigin.Begin);
+					reader.CopyTo(dest);
+					Assert.IsTrue(Enumerable.SequenceEqual(message.Skip(70), dest.ToArray()));
+				}
+
+				try { using (Lz4LegacyReader reader = new Lz4LegacyReader(new MemoryStream(), new Lz4LegacyIndex(), null, false)) { }; Assert.Fail("Constructor should have thrown an exception"); }
+				catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentNullException)); }
+			}
+		}
 	}
 }
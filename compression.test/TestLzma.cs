@@ -863,5 +863,168 @@ public void Lzma_Encoder()
 				Assert.IsTrue(Enumerable.SequenceEqual(expected, dest.ToArray()));          // length is known
 			}
 		}
+		[TestMethod(), TestCategory("Lzma")]
+		public void Lzma_Writer()
+		{
+			// Write the sample data in small pieces without a known length; the stream uses an end mark
+			using (MemoryStream dest = new MemoryStream())
+			{
+				using (LzmaWriter writer = new LzmaWriter(dest, CompressionLevel.Fastest, true))
+				{
+					for (int offset = 0; offset < s_sampledata.Length; offset += 1000)
+						writer.Write(s_sampledata, offset, Math.Min(1000, s_sampledata.Length - offset));
+
+					writer.Flush();
+					Assert.AreEqual(s_sampledata.Length, writer.Position);
+				}
+
+				// The header length is unknown (all bits set) and the compressed data should be smaller
+				Assert.IsTrue(dest.Length < s_sampledata.Length);
+				Assert.AreEqual(UInt64.MaxValue, BitConverter.ToUInt64(dest.ToArray(), 5));
+
+				dest.Position = 0;
+				using (LzmaReader reader = new LzmaReader(dest, true))
+				{
+					using (MemoryStream output = new MemoryStream())
+					{
+						reader.CopyTo(output);
+						Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata, output.ToArray()));
+					}
+				}
+			}
+
+			// A known length is recorded in the header and must be matched exactly
+			try { using (new LzmaWriter(new MemoryStream(), CompressionLevel.Optimal, -1, false)) { } Assert.Fail("Constructor should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			using (MemoryStream dest = new MemoryStream())
+			{
+				using (LzmaWriter writer = new LzmaWriter(dest, CompressionLevel.Optimal, s_sampledata.Length, true))
+				{
+					writer.Write(s_sampledata);
+
+					try { writer.Write(s_sampledata, 0, 1); Assert.Fail("Method should have thrown an exception"); }
+					catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(InvalidOperationException)); }
+				}
+
+				Assert.AreEqual((ulong)s_sampledata.Length, BitConverter.ToUInt64(dest.ToArray(), 5));
+
+				dest.Position = 0;
+				using (LzmaReader reader = new LzmaReader(dest, true))
+				{
+					using (MemoryStream output = new MemoryStream())
+					{
+						reader.CopyTo(output);
+						Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata, output.ToArray()));
+					}
+				}
+			}
+
+			// A write that exceeds the length is rejected by Write itself, disposal doesn't replace that exception
+			using (LzmaWriter writer = new LzmaWriter(new MemoryStream(), CompressionLevel.Optimal, 100, false))
+			{
+				writer.Write(s_sampledata, 0, 50);
+
+				try { writer.Write(s_sampledata, 50, 100); Assert.Fail("Method should have thrown an exception"); }
+				catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(InvalidOperationException)); }
+
+				Assert.AreEqual(50, writer.Position);
+			}
+
+			try
+			{
+				using (LzmaWriter writer = new LzmaWriter(new MemoryStream(), CompressionLevel.Optimal, s_sampledata.Length, false)) writer.Write(s_sampledata, 0, 100);
+				Assert.Fail("Disposal should have thrown an exception");
+			}
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(InvalidOperationException)); }
+		}
+
+		[TestMethod(), TestCategory("Lzma")]
+		public void Lzma_IndexedSeek()
+		{
+			byte[] sampledata = Enumerable.Repeat(s_sampledata, 4).SelectMany(b => b).ToArray();
+
+			// Use a dictionary smaller than the data so that the snapshots wrap around it
+			LzmaEncoder encoder = new LzmaEncoder();
+			encoder.DictionarySize = new LzmaDictionarySize(1 << 20);
+			byte[] compressed = encoder.Encode(sampledata);
+
+			// Check parameter validations
+			try { LzmaIndex.Build(new MemoryStream(compressed), 1024); Assert.Fail("Method should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			try { using (LzmaReader reader = new LzmaReader(new MemoryStream(compressed), null, false)) { }; Assert.Fail("Constructor should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentNullException)); }
+
+			// Build the index and round-trip it through the sidecar format
+			LzmaIndex index = LzmaIndex.Build(new MemoryStream(compressed), 1 << 20);
+			Assert.AreEqual(sampledata.Length, index.Length);
+			Assert.IsTrue(index.Count >= (sampledata.Length >> 20) - 1);
+
+			using (MemoryStream sidecar = new MemoryStream())
+			{
+				index.Save(sidecar);
+				sidecar.Position = 0;
+				index = LzmaIndex.Load(sidecar);
+				Assert.AreEqual(sampledata.Length, index.Length);
+			}
+
+			// Seek to positions backwards and forwards throughout the stream and compare the data
+			using (LzmaReader reader = new LzmaReader(new MemoryStream(compressed), index, false))
+			{
+				Assert.IsTrue(reader.CanSeek);
+				Assert.AreEqual(sampledata.Length, reader.Length);
+
+				Random random = new Random(1);
+				byte[] actual = new byte[4096];
+
+				for (int iteration = 0; iteration < 100; iteration++)
+				{
+					long position = random.Next(sampledata.Length);
+					Assert.AreEqual(position, reader.Seek(position, SeekOrigin.Begin));
+
+					int read = reader.Read(actual, 0, actual.Length);
+					Assert.AreEqual(Math.Min(actual.Length, sampledata.Length - position), read);
+					Assert.IsTrue(Enumerable.SequenceEqual(sampledata.Skip((int)position).Take(read), actual.Take(read)));
+				}
+
+				reader.Seek(-10, SeekOrigin.End);
+				Assert.AreEqual(10, reader.Read(actual, 0, actual.Length));
+				Assert.AreEqual(0, reader.Read(actual, 0, actual.Length));
+
+				// Seeking back to the start decompresses the entire stream again
+				reader.Position = 0;
+				using (MemoryStream dest = new MemoryStream())
+				{
+					reader.CopyTo(dest);
+					Assert.IsTrue(Enumerable.SequenceEqual(sampledata, dest.ToArray()));
+				}
+
+				try { reader.Seek(-1, SeekOrigin.Begin); Assert.Fail("Method should have thrown an exception"); }
+				catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(IOException)); }
+			}
+
+			// A sidecar with an out of range decoder state in each checkpoint is rejected when a checkpoint is restored
+			using (MemoryStream sidecar = new MemoryStream())
+			{
+				index.Save(sidecar);
+				byte[] corrupt = sidecar.ToArray();
+
+				int offset = 28;
+				for (int checkpoint = 0; checkpoint < BitConverter.ToInt32(corrupt, 24); checkpoint++)
+				{
+					// The decoder state follows the dictionary size, probability count, range, code, dictionary position,
+					// processed position and dictionary check size in the serialized decoder variables
+					Array.Copy(BitConverter.GetBytes(12), 0, corrupt, offset + 28 + 36, 4);
+					offset += 28 + BitConverter.ToInt32(corrupt, offset + 16) + BitConverter.ToInt32(corrupt, offset + 24);
+				}
+
+				using (LzmaReader reader = new LzmaReader(new MemoryStream(compressed), LzmaIndex.Load(new MemoryStream(corrupt)), false))
+				{
+					try { reader.Seek(-10, SeekOrigin.End); reader.Read(new byte[10], 0, 10); Assert.Fail("Method should have thrown an exception"); }
+					catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(InvalidDataException)); }
+				}
+			}
+		}
 	}
 }
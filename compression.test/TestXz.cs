@@ -801,5 +801,261 @@ public void Xz_EncoderCheckSHA256()
 				}
 			}
 		}
+		[TestMethod(), TestCategory("Xz")]
+		public void Xz_ParallelCompression()
+		{
+			XzEncoder encoder = new XzEncoder();
+
+			// Parallel block compression is disabled by default
+			Assert.AreEqual(0, encoder.MaximumPendingBlocks);
+
+			try { encoder.MaximumPendingBlocks = -1; Assert.Fail("Property should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			// A total thread count larger than the threads per block compresses independent XZ blocks concurrently
+			byte[] sampledata = Enumerable.Repeat(s_sampledata, 4).SelectMany(b => b).ToArray();
+
+			encoder.BlockSize = 262144;
+			encoder.ThreadsPerBlock = 1;
+			encoder.UseMultipleThreads = false;
+			encoder.MaximumThreads = 4;
+			encoder.MaximumPendingBlocks = 3;
+			byte[] compressed = encoder.Encode(sampledata);
+
+			Assert.IsTrue(compressed.Length < sampledata.Length);
+
+			using (XzReader reader = new XzReader(new MemoryStream(compressed)))
+			{
+				using (MemoryStream dest = new MemoryStream())
+				{
+					reader.CopyTo(dest);
+					Assert.IsTrue(Enumerable.SequenceEqual(sampledata, dest.ToArray()));
+				}
+			}
+
+			// Check the public XzWriter constructor, including a flush mid-stream and an empty stream
+			using (MemoryStream dest = new MemoryStream())
+			{
+				using (XzWriter writer = new XzWriter(dest, System.IO.Compression.CompressionLevel.Fastest, 0, true))
+				{
+					writer.Write(sampledata, 0, sampledata.Length / 3);
+					writer.Flush();
+					writer.Write(sampledata, sampledata.Length / 3, sampledata.Length - (sampledata.Length / 3));
+					Assert.AreEqual(sampledata.Length, writer.Position);
+				}
+
+				dest.Position = 0;
+				using (XzReader reader = new XzReader(dest, true))
+				{
+					using (MemoryStream output = new MemoryStream())
+					{
+						reader.CopyTo(output);
+						Assert.IsTrue(Enumerable.SequenceEqual(sampledata, output.ToArray()));
+					}
+				}
+			}
+
+			// With four threads, whole blocks are queued rather than written; two full 8MiB blocks must both
+			// still be in flight after they have been written, leaving only the stream header in the output
+			byte[] blockdata = Enumerable.Repeat(s_sampledata, ((16 << 20) / s_sampledata.Length) + 1).SelectMany(b => b).Take(16 << 20).ToArray();
+			using (MemoryStream dest = new MemoryStream())
+			{
+				using (XzWriter writer = new XzWriter(dest, System.IO.Compression.CompressionLevel.Fastest, 4, true))
+				{
+					writer.Write(blockdata, 0, blockdata.Length);
+					Assert.AreEqual(12, dest.Length);
+				}
+
+				dest.Position = 0;
+				using (XzReader reader = new XzReader(dest, true))
+				{
+					using (MemoryStream output = new MemoryStream())
+					{
+						reader.CopyTo(output);
+						Assert.IsTrue(Enumerable.SequenceEqual(blockdata, output.ToArray()));
+					}
+				}
+			}
+
+			using (MemoryStream dest = new MemoryStream())
+			{
+				using (XzWriter writer = new XzWriter(dest, true)) { }
+
+				dest.Position = 0;
+				using (XzReader reader = new XzReader(dest, true))
+				{
+					using (MemoryStream output = new MemoryStream())
+					{
+						reader.CopyTo(output);
+						Assert.AreEqual(0, output.Length);
+					}
+				}
+			}
+		}
+		[TestMethod(), TestCategory("Xz")]
+		public void Xz_ParallelDecompression()
+		{
+			try { using (new XzReader(new MemoryStream(), -1, false)) { } Assert.Fail("Constructor should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			try { using (new XzReader(new MemoryStream(), 2, -1, false)) { } Assert.Fail("Constructor should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			// Generate a multi-block stream and append a second copy of it, separated by stream padding
+			byte[] sampledata = Enumerable.Repeat(s_sampledata, 4).SelectMany(b => b).ToArray();
+
+			XzEncoder encoder = new XzEncoder();
+			encoder.BlockSize = 262144;
+			encoder.ThreadsPerBlock = 1;
+			encoder.UseMultipleThreads = false;
+			encoder.MaximumThreads = 4;
+
+			byte[] stream = encoder.Encode(sampledata);
+			byte[] compressed = stream.Concat(new byte[4]).Concat(stream).ToArray();
+			byte[] expected = sampledata.Concat(sampledata).ToArray();
+
+			// Seekable streams are decoded in parallel using the index, with and without a limit on pending blocks
+			foreach (int maxpending in new int[] { 0, 1, 3 })
+			{
+				using (XzReader reader = new XzReader(new MemoryStream(compressed), 0, maxpending, false))
+				{
+					using (MemoryStream dest = new MemoryStream())
+					{
+						reader.CopyTo(dest);
+						Assert.IsTrue(Enumerable.SequenceEqual(expected, dest.ToArray()));
+					}
+				}
+			}
+
+			// A corrupted block is reported while decoding rather than when reading the index
+			byte[] corrupt = (byte[])stream.Clone();
+			corrupt[corrupt.Length / 2] ^= 0xFF;
+
+			try
+			{
+				using (XzReader reader = new XzReader(new MemoryStream(corrupt), 4, false))
+				{
+					using (MemoryStream dest = new MemoryStream()) reader.CopyTo(dest);
+				}
+				Assert.Fail("Decompressing corrupt data should have thrown an exception");
+			}
+			catch (Exception ex) { Assert.IsTrue((ex is LzmaException) || (ex is InvalidDataException)); }
+		}
+
+		[TestMethod(), TestCategory("Xz")]
+		public void Xz_RandomAccess()
+		{
+			// Generate a multi-block stream and append a second copy of it, separated by stream padding
+			byte[] sampledata = Enumerable.Repeat(s_sampledata, 4).SelectMany(b => b).ToArray();
+
+			XzEncoder encoder = new XzEncoder();
+			encoder.BlockSize = 262144;
+			encoder.ThreadsPerBlock = 1;
+			encoder.UseMultipleThreads = false;
+
+			byte[] stream = encoder.Encode(sampledata);
+			byte[] compressed = stream.Concat(new byte[4]).Concat(stream).ToArray();
+			byte[] expected = sampledata.Concat(sampledata).ToArray();
+
+			// Random access is available with and without parallel decoding
+			foreach (int threads in new int[] { 1, 4 })
+			{
+				using (XzReader reader = new XzReader(new MemoryStream(compressed), threads, false))
+				{
+					Assert.IsTrue(reader.CanSeek);
+					Assert.AreEqual(expected.Length, reader.Length);
+					Assert.AreEqual(0, reader.Position);
+
+					Random random = new Random(1);
+					byte[] actual = new byte[4096];
+
+					for (int iteration = 0; iteration < 100; iteration++)
+					{
+						long position = random.Next(expected.Length);
+						Assert.AreEqual(position, reader.Seek(position, SeekOrigin.Begin));
+
+						int read = reader.Read(actual, 0, actual.Length);
+						Assert.AreEqual(Math.Min(actual.Length, expected.Length - position), read);
+						Assert.AreEqual(position + read, reader.Position);
+						Assert.IsTrue(Enumerable.SequenceEqual(expected.Skip((int)position).Take(read), actual.Take(read)));
+					}
+
+					// Seeking relative to the current position and the end of the stream
+					reader.Position = 1000;
+					Assert.AreEqual(500, reader.Seek(-500, SeekOrigin.Current));
+					reader.Seek(-10, SeekOrigin.End);
+					Assert.AreEqual(10, reader.Read(actual, 0, actual.Length));
+					Assert.AreEqual(0, reader.Read(actual, 0, actual.Length));
+
+					try { reader.Seek(-1, SeekOrigin.Begin); Assert.Fail("Method call should have thrown an exception"); }
+					catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(IOException)); }
+
+					// Seeking back to the beginning restores the entire stream
+					reader.Position = 0;
+					using (MemoryStream dest = new MemoryStream())
+					{
+						reader.CopyTo(dest);
+						Assert.IsTrue(Enumerable.SequenceEqual(expected, dest.ToArray()));
+					}
+				}
+			}
+		}
+
+		[TestMethod(), TestCategory("Xz")]
+		public void Xz_RandomAccessLargeBlock()
+		{
+			// A small multi-block stream followed by a stream with a single block that is too large to
+			// be decoded as a whole
+			XzEncoder encoder = new XzEncoder();
+			encoder.BlockSize = 262144;
+			encoder.ThreadsPerBlock = 1;
+			encoder.UseMultipleThreads = false;
+
+			byte[] small = encoder.Encode(s_sampledata);
+
+			encoder = new XzEncoder();
+			encoder.UseMultipleThreads = false;
+
+			byte[] large = encoder.Encode(new byte[300 << 20]);
+			byte[] compressed = small.Concat(large).ToArray();
+			long length = s_sampledata.Length + (300L << 20);
+
+			foreach (int threads in new int[] { 1, 4 })
+			{
+				using (XzReader reader = new XzReader(new MemoryStream(compressed), threads, false))
+				{
+					// The index is kept for the large block
+					Assert.IsTrue(reader.CanSeek);
+					Assert.AreEqual(length, reader.Length);
+
+					byte[] actual = new byte[s_sampledata.Length];
+
+					// Data from the small stream is followed by the start of the large block
+					Assert.AreEqual(actual.Length, reader.Read(actual, 0, actual.Length));
+					Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata, actual));
+
+					actual = new byte[65536];
+					Assert.AreEqual(actual.Length, reader.Read(actual, 0, actual.Length));
+					Assert.IsTrue(actual.All(b => b == 0));
+
+					// Seeking forwards and backwards within the large block
+					foreach (long position in new long[] { length - 100000, s_sampledata.Length + (100L << 20), length - 10 })
+					{
+						reader.Position = position;
+						int read = reader.Read(actual, 0, actual.Length);
+						Assert.AreEqual(Math.Min(actual.Length, length - position), read);
+						Assert.AreEqual(position + read, reader.Position);
+						Assert.IsTrue(actual.Take(read).All(b => b == 0));
+					}
+
+					Assert.AreEqual(0, reader.Read(actual, 0, actual.Length));
+
+					// Seeking back into the small stream
+					reader.Position = 100;
+					Assert.AreEqual(actual.Length, reader.Read(actual, 0, actual.Length));
+					Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata.Skip(100).Take(actual.Length), actual));
+				}
+			}
+		}
 	}
 }
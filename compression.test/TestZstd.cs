@@ -0,0 +1,410 @@
+﻿//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+using System;
+using System.IO;
+using System.IO.Compression;
+using System.Linq;
+using System.Reflection;
+using System.Runtime.Serialization.Formatters.Binary;
+using System.Text;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace zuki.io.compression.test
+{
+	[TestClass()]
+	public class TestZstd
+	{
+		static byte[] s_sampledata;
+
+		[ClassInitialize()]
+		public static void ClassInit(TestContext context)
+		{
+			// Load the sample data into a byte[] array to use for the unit tests
+			using (StreamReader reader = new StreamReader(Assembly.GetExecutingAssembly().GetManifestResourceStream("zuki.io.compression.test.thethreemusketeers.txt")))
+			{
+				s_sampledata = Encoding.ASCII.GetBytes(reader.ReadToEnd());
+			}
+		}
+
+		[TestMethod(), TestCategory("Zstd")]
+		public void Zstd_CompressExternal()
+		{
+			// This method generates an output file that can be tested externally; "thethreemusketeers.txt" is
+			// set to Copy Always to the output directory, it can be diffed after running the external tool
+			using (ZstdWriter writer = new ZstdWriter(File.Create(Path.Combine(Environment.CurrentDirectory, "thethreemusketeers.zst"))))
+			{
+				writer.Write(s_sampledata);
+				writer.Flush();
+			}
+		}
+
+		[TestMethod(), TestCategory("Zstd")]
+		public void Zstd_CompressDecompress()
+		{
+			// Start with a MemoryStream created from the sample data
+			using (MemoryStream source = new MemoryStream(s_sampledata))
+			{
+				using (MemoryStream dest = new MemoryStream())
+				{
+					// Compress the data into the destination memory stream instance
+					using (ZstdWriter compressor = new ZstdWriter(dest, CompressionLevel.Optimal, true)) source.CopyTo(compressor);
+
+					// The compressed data should be smaller than the source data
+					Assert.IsTrue(dest.Length < source.Length);
+
+					source.SetLength(0);            // Clear the source stream
+					dest.Position = 0;              // Reset the destination stream
+
+					// Decompress the data back into the source memory stream
+					using (ZstdReader decompressor = new ZstdReader(dest, true)) decompressor.CopyTo(source);
+
+					// Ensure that the original data has been restored
+					Assert.AreEqual(source.Length, s_sampledata.Length);
+					Assert.IsTrue(s_sampledata.SequenceEqual(source.ToArray()));
+				}
+			}
+		}
+
+		[TestMethod(), TestCategory("Zstd")]
+		public void Zstd_CompressionLevel()
+		{
+			using (MemoryStream source = new MemoryStream(s_sampledata))
+			{
+				long fastest, optimal;          // Size of compressed streams
+
+				// CompressionLevel.NoCompression is not valid
+				try { using (ZstdWriter stream = new ZstdWriter(source, CompressionLevel.NoCompression)) Assert.Fail("Method call should have thrown an exception"); }
+				catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+				// Compress using CompressionLevel.Fastest
+				using (MemoryStream compressed = new MemoryStream())
+				{
+					using (ZstdWriter compressor = new ZstdWriter(compressed, CompressionLevel.Fastest, true)) compressor.Write(s_sampledata);
+					fastest = compressed.Length;
+				}
+
+				// Compress using CompressionLevel.Optimal
+				using (MemoryStream compressed = new MemoryStream())
+				{
+					using (ZstdWriter compressor = new ZstdWriter(compressed, CompressionLevel.Optimal, true)) compressor.Write(s_sampledata);
+					optimal = compressed.Length;
+				}
+
+				// Optimal compression should result in a smaller output stream than fastest
+				// and fastest should result in a smaller output stream than uncompressed
+				Assert.IsTrue(optimal < fastest);
+				Assert.IsTrue(fastest < source.Length);
+			}
+		}
+
+		[TestMethod(), TestCategory("Zstd")]
+		public void Zstd_ReaderDispose()
+		{
+			byte[] buffer = new byte[8192];         // 8KiB data buffer
+
+			// Create a dummy stream and immediately dispose of it
+			ZstdReader stream = new ZstdReader(new MemoryStream(s_sampledata));
+			stream.Dispose();
+
+			// Test double dispose
+			stream.Dispose();
+
+			// All properties and methods should throw an ObjectDisposedException
+			try { var bs = stream.BaseStream; Assert.Fail("Property access should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ObjectDisposedException)); }
+
+			try { var b = stream.CanRead; Assert.Fail("Property access should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ObjectDisposedException)); }
+
+			try { var l = stream.Position; Assert.Fail("Property access should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ObjectDisposedException)); }
+
+			try { stream.Read(buffer, 0, 8192); Assert.Fail("Method call should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ObjectDisposedException)); }
+
+			try { stream.Seek(0, SeekOrigin.Current); Assert.Fail("Method call should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ObjectDisposedException)); }
+
+			// Ensure that an underlying stream is disposed of properly if leaveopen is not set
+			MemoryStream ms = new MemoryStream(s_sampledata);
+			using (ZstdReader decompressor = new ZstdReader(ms)) { }
+			try { ms.Read(buffer, 0, 8192); Assert.Fail("Method call should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ObjectDisposedException)); }
+
+			// Ensure that an underlying stream is not disposed of if leaveopen is set
+			ms = new MemoryStream(s_sampledata);
+			using (ZstdReader decompressor = new ZstdReader(ms, true)) { }
+			ms.Read(buffer, 0, 8192);
+			ms.Dispose();
+		}
+
+		[TestMethod(), TestCategory("Zstd")]
+		public void Zstd_WriterDispose()
+		{
+			byte[] buffer = new byte[8192];         // 8KiB data buffer
+
+			// Create a dummy stream and immediately dispose of it
+			ZstdWriter stream = new ZstdWriter(new MemoryStream(), CompressionLevel.Optimal);
+			stream.Dispose();
+
+			// Test double dispose
+			stream.Dispose();
+
+			// All properties and methods should throw an ObjectDisposedException
+			try { var bs = stream.BaseStream; Assert.Fail("Property access should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ObjectDisposedException)); }
+
+			try { var b = stream.CanWrite; Assert.Fail("Property access should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ObjectDisposedException)); }
+
+			try { stream.Flush(); Assert.Fail("Method call should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ObjectDisposedException)); }
+
+			try { stream.Write(buffer); Assert.Fail("Method call should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ObjectDisposedException)); }
+
+			try { stream.Write(buffer, 0, 8192); Assert.Fail("Method call should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ObjectDisposedException)); }
+
+			// Ensure that an underlying stream is disposed of properly if leaveopen is not set
+			MemoryStream ms = new MemoryStream();
+			using (ZstdWriter compressor = new ZstdWriter(ms, CompressionLevel.Fastest)) { }
+			try { ms.Write(buffer, 0, 8192); Assert.Fail("Method call should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ObjectDisposedException)); }
+
+			// Ensure that an underlying stream is not disposed of if leaveopen is set
+			ms = new MemoryStream();
+			using (ZstdWriter compressor = new ZstdWriter(ms, CompressionLevel.Fastest, true)) { }
+			ms.Write(buffer, 0, 8192);
+			ms.Dispose();
+		}
+
+		[TestMethod(), TestCategory("Zstd")]
+		public void Zstd_Read()
+		{
+			byte[] compressed = new ZstdEncoder().Encode(s_sampledata);
+
+			// Concatenated frames are decompressed as a single stream
+			using (MemoryStream concatenated = new MemoryStream())
+			{
+				concatenated.Write(compressed, 0, compressed.Length);
+				concatenated.Write(compressed, 0, compressed.Length);
+				concatenated.Position = 0;
+
+				using (ZstdReader reader = new ZstdReader(concatenated))
+				using (MemoryStream dest = new MemoryStream())
+				{
+					reader.CopyTo(dest);
+					Assert.AreEqual(s_sampledata.Length * 2, reader.Position);
+					Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata.Concat(s_sampledata), dest.ToArray()));
+					Assert.AreEqual(0, reader.Read(new byte[1], 0, 1));
+				}
+			}
+
+			// A stream that doesn't end on a frame boundary is invalid
+			using (ZstdReader reader = new ZstdReader(new MemoryStream(compressed, 0, compressed.Length - 10)))
+			{
+				try { reader.CopyTo(Stream.Null); Assert.Fail("Method call should have thrown an exception"); }
+				catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(InvalidDataException)); }
+			}
+		}
+
+		[TestMethod(), TestCategory("Zstd")]
+		public void Zstd_ZstdException()
+		{
+			byte[] compressed = new ZstdEncoder().Encode(s_sampledata);
+			byte[] buffer = new byte[8192];
+			ZstdException thrown = null;
+			ZstdException deserialized = null;
+
+			// Attempting to read from the middle of the compressed stream should throw a ZstdException
+			using (ZstdReader decompressor = new ZstdReader(new MemoryStream(compressed, compressed.Length / 2, compressed.Length / 2)))
+			{
+				try { decompressor.Read(buffer, 0, 8192); Assert.Fail("Method call should have thrown an exception"); }
+				catch (ZstdException ex) { thrown = ex; }
+			}
+
+			Assert.IsNotNull(thrown);
+
+			// Check the error code property
+			Assert.AreEqual(-10, (int)thrown.ErrorCode);		// ZSTD_error_prefix_unknown (10)
+
+			// Serialize and de-serialize the exception with a BinaryFormatter
+			BinaryFormatter formatter = new BinaryFormatter();
+			using (MemoryStream memstream = new MemoryStream())
+			{
+				formatter.Serialize(memstream, thrown);
+				memstream.Seek(0, 0);
+				deserialized = (ZstdException)formatter.Deserialize(memstream);
+			}
+
+			// Check that the exceptions are equivalent
+			Assert.AreEqual(thrown.ErrorCode, deserialized.ErrorCode);
+			Assert.AreEqual(thrown.StackTrace, deserialized.StackTrace);
+			Assert.AreEqual(thrown.ToString(), deserialized.ToString());
+		}
+
+		[TestMethod(), TestCategory("Zstd")]
+		public void Zstd_ZstdCompressionLevel()
+		{
+			// Constructors
+			var level = new ZstdCompressionLevel(5);
+			Assert.AreEqual(5, level);
+
+			level = new ZstdCompressionLevel(CompressionLevel.Fastest);
+			Assert.AreEqual(1, level);
+
+			level = new ZstdCompressionLevel(CompressionLevel.Optimal);
+			Assert.AreEqual(19, level);
+
+			// Negative levels are valid and favor speed over ratio
+			level = new ZstdCompressionLevel(-5);
+			Assert.AreEqual(-5, level);
+
+			try { level = new ZstdCompressionLevel(CompressionLevel.NoCompression); Assert.Fail("Constructor should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			try { level = new ZstdCompressionLevel(23); Assert.Fail("Constructor should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			// Implicit conversion and equality
+			level = 8;
+			Assert.IsTrue(new ZstdCompressionLevel(8) == level);
+			Assert.IsTrue(new ZstdCompressionLevel(3) != level);
+			Assert.IsTrue(new ZstdCompressionLevel(2).Equals(new ZstdCompressionLevel(2)));
+			Assert.IsFalse(((object)level).Equals(null));
+			Assert.IsFalse(String.IsNullOrEmpty(level.ToString()));
+		}
+
+		[TestMethod(), TestCategory("Zstd")]
+		public void Zstd_ZstdWindowSize()
+		{
+			// Constructors
+			var size = new ZstdWindowSize(20);
+			Assert.AreEqual(20, size);
+
+			size = new ZstdWindowSize(0);
+			Assert.AreEqual(ZstdWindowSize.Default, size);
+
+			try { size = new ZstdWindowSize(9); Assert.Fail("Constructor should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			try { size = new ZstdWindowSize(32); Assert.Fail("Constructor should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			// Implicit conversion and equality
+			size = 24;
+			Assert.IsTrue(new ZstdWindowSize(24) == size);
+			Assert.IsTrue(new ZstdWindowSize(23) != size);
+			Assert.IsTrue(ZstdWindowSize.Minimum != ZstdWindowSize.Maximum);
+			Assert.IsFalse(((object)size).Equals(null));
+			Assert.IsFalse(String.IsNullOrEmpty(size.ToString()));
+		}
+
+		[TestMethod(), TestCategory("Zstd")]
+		public void Zstd_Encoder()
+		{
+			// The ZstdEncoder is just a wrapper around ZstdWriter that provides 
+			// more complete control over the compression/encoder parameters
+			ZstdEncoder encoder = new ZstdEncoder();
+
+			// Check the default values
+			Assert.AreEqual(ZstdCompressionLevel.Default, encoder.CompressionLevel);
+			Assert.AreEqual(true, encoder.ContentChecksum);
+			Assert.AreEqual(1, encoder.MaximumThreads);
+			Assert.AreEqual(ZstdWindowSize.Default, encoder.WindowSize);
+
+			try { encoder.MaximumThreads = -1; Assert.Fail("Property access should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+			// A larger window than the decoder accepts by default must still be readable
+			encoder.CompressionLevel = ZstdCompressionLevel.Fastest;
+			encoder.ContentChecksum = false;
+			encoder.WindowSize = ZstdWindowSize.Maximum;
+
+			byte[] actual = encoder.Encode(s_sampledata);
+			using (ZstdReader reader = new ZstdReader(new MemoryStream(actual)))
+			using (MemoryStream dest = new MemoryStream())
+			{
+				reader.CopyTo(dest);
+				Assert.IsTrue(Enumerable.SequenceEqual(s_sampledata, dest.ToArray()));
+			}
+
+			// Check all of the Encoder methods work and encode as expected
+			byte[] expected = encoder.Encode(s_sampledata);
+			CollectionAssert.AreEqual(expected, encoder.Encode(new MemoryStream(s_sampledata)));
+			CollectionAssert.AreEqual(expected, encoder.Encode(s_sampledata, 0, s_sampledata.Length));
+
+			using (MemoryStream dest = new MemoryStream())
+			{
+				encoder.Encode(s_sampledata, dest);
+				CollectionAssert.AreEqual(expected, dest.ToArray());
+			}
+
+			try { actual = encoder.Encode((byte[])null); Assert.Fail("Method call should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentNullException)); }
+
+			try { encoder.Encode(s_sampledata, null); Assert.Fail("Method call should have thrown an exception"); }
+			catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentNullException)); }
+		}
+
+		[TestMethod(), TestCategory("Zstd")]
+		public void Zstd_ParallelCompression()
+		{
+			byte[] sampledata = Enumerable.Repeat(s_sampledata, 8).SelectMany(b => b).ToArray();
+
+			// Worker threads still produce a single standard frame
+			ZstdEncoder encoder = new ZstdEncoder();
+			encoder.MaximumThreads = 4;
+
+			using (ZstdReader reader = new ZstdReader(new MemoryStream(encoder.Encode(sampledata))))
+			using (MemoryStream dest = new MemoryStream())
+			{
+				reader.CopyTo(dest);
+				Assert.IsTrue(Enumerable.SequenceEqual(sampledata, dest.ToArray()));
+			}
+
+			// Check the public ZstdWriter constructor, including a flush mid-stream
+			using (MemoryStream compressed = new MemoryStream())
+			{
+				try { using (ZstdWriter writer = new ZstdWriter(compressed, CompressionLevel.Optimal, -1, true)) { }; Assert.Fail("Constructor should have thrown an exception"); }
+				catch (Exception ex) { Assert.IsInstanceOfType(ex, typeof(ArgumentOutOfRangeException)); }
+
+				using (ZstdWriter writer = new ZstdWriter(compressed, CompressionLevel.Fastest, 0, true))
+				{
+					writer.Write(sampledata, 0, sampledata.Length / 2);
+					writer.Flush();
+					writer.Write(sampledata, sampledata.Length / 2, sampledata.Length - (sampledata.Length / 2));
+				}
+
+				compressed.Position = 0;
+				using (ZstdReader reader = new ZstdReader(compressed, true))
+				using (MemoryStream dest = new MemoryStream())
+				{
+					reader.CopyTo(dest);
+					Assert.IsTrue(Enumerable.SequenceEqual(sampledata, dest.ToArray()));
+				}
+			}
+		}
+	}
+}
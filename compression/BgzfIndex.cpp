@@ -0,0 +1,227 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "BgzfIndex.h"
+
+#include "BgzfReader.h"
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+using namespace System::Text;
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// BgzfIndex Constructor (internal)
+//
+// Arguments:
+//
+//	entries		- Index entries, not including the first block
+
+BgzfIndex::BgzfIndex(List<Entry^>^ entries)
+{
+	if(Object::ReferenceEquals(entries, nullptr)) throw gcnew ArgumentNullException("entries");
+
+	// The first block always starts at the beginning of the stream and is implied
+	m_entries = gcnew List<Entry^>(entries->Count + 1);
+	m_entries->Add(gcnew Entry(0, 0));
+	m_entries->AddRange(entries);
+}
+
+//---------------------------------------------------------------------------
+// BgzfIndex::Build (static)
+//
+// Builds an index by scanning the block headers of a BGZF stream
+//
+// Arguments:
+//
+//	stream		- Stream containing the BGZF data to be indexed
+
+BgzfIndex^ BgzfIndex::Build(Stream^ stream)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+
+	List<Entry^>^ entries = gcnew List<Entry^>();
+	__int64 compressed = 0;					// Compressed offset of the block
+	__int64 uncompressed = 0;				// Decompressed offset of the block
+
+	// Every block records its own compressed (BSIZE) and decompressed (ISIZE) lengths, so
+	// the entire stream can be indexed without inflating any of the data
+	for(array<unsigned __int8>^ block = BgzfReader::ReadBlock(stream); block; block = BgzfReader::ReadBlock(stream)) {
+
+		// Empty blocks, including the end-of-file marker, are not indexed
+		int length = BgzfReader::GetBlockLength(block);
+		if((length > 0) && (compressed > 0)) entries->Add(gcnew Entry(compressed, uncompressed));
+
+		compressed += block->Length;
+		uncompressed += length;
+	}
+
+	return gcnew BgzfIndex(entries);
+}
+
+//---------------------------------------------------------------------------
+// BgzfIndex::Count::get
+//
+// Gets the number of blocks in the index, not including the first block
+
+int BgzfIndex::Count::get(void)
+{
+	return m_entries->Count - 1;
+}
+
+//---------------------------------------------------------------------------
+// BgzfIndex::Find (internal)
+//
+// Locates the last block that starts at or before a decompressed data offset
+//
+// Arguments:
+//
+//	position	- Decompressed data offset
+
+BgzfIndex::Entry^ BgzfIndex::Find(__int64 position)
+{
+	int low = 0;
+	int high = m_entries->Count - 1;
+
+	// Binary search for the last entry that doesn't start after the position
+	while(low < high) {
+
+		int middle = low + ((high - low + 1) >> 1);
+		if(m_entries[middle]->Uncompressed <= position) low = middle;
+		else high = middle - 1;
+	}
+
+	return m_entries[low];
+}
+
+//---------------------------------------------------------------------------
+// BgzfIndex::FindAddress (internal)
+//
+// Locates the last block that starts at or before a compressed data offset
+//
+// Arguments:
+//
+//	address		- Compressed data offset
+
+BgzfIndex::Entry^ BgzfIndex::FindAddress(__int64 address)
+{
+	int low = 0;
+	int high = m_entries->Count - 1;
+
+	// Binary search for the last entry that doesn't start after the address
+	while(low < high) {
+
+		int middle = low + ((high - low + 1) >> 1);
+		if(m_entries[middle]->Compressed <= address) low = middle;
+		else high = middle - 1;
+	}
+
+	return m_entries[low];
+}
+
+//---------------------------------------------------------------------------
+// BgzfIndex::Load (static)
+//
+// Loads an index from a ".gzi" formatted stream
+//
+// Arguments:
+//
+//	stream		- Stream to read the index from
+
+BgzfIndex^ BgzfIndex::Load(Stream^ stream)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+
+	msclr::auto_handle<BinaryReader> reader(gcnew BinaryReader(stream, Encoding::UTF8, true));
+
+	try {
+
+		// The ".gzi" format is a little endian 64-bit count followed by that many pairs of
+		// 64-bit compressed and decompressed offsets; there is no signature or version
+		unsigned __int64 count = reader->ReadUInt64();
+		if(count >= Int32::MaxValue) throw gcnew InvalidDataException();
+
+		List<Entry^>^ entries = gcnew List<Entry^>(static_cast<int>(count));
+		for(int index = 0; index < static_cast<int>(count); index++) {
+
+			unsigned __int64 compressed = reader->ReadUInt64();
+			unsigned __int64 uncompressed = reader->ReadUInt64();
+
+			// Entries must be in order and after the implied entry for the first block
+			Entry^ previous = (index == 0) ? gcnew Entry(0, 0) : entries[index - 1];
+			if((compressed > Int64::MaxValue) || (uncompressed > Int64::MaxValue)) throw gcnew InvalidDataException();
+			if((static_cast<__int64>(compressed) < previous->Compressed) || (static_cast<__int64>(uncompressed) < previous->Uncompressed)) throw gcnew InvalidDataException();
+
+			entries->Add(gcnew Entry(static_cast<__int64>(compressed), static_cast<__int64>(uncompressed)));
+		}
+
+		return gcnew BgzfIndex(entries);
+	}
+
+	catch(EndOfStreamException^) { throw gcnew InvalidDataException(); }
+}
+
+//---------------------------------------------------------------------------
+// BgzfIndex::Save
+//
+// Writes the index to a stream in ".gzi" format
+//
+// Arguments:
+//
+//	stream		- Stream to write the index into
+
+void BgzfIndex::Save(Stream^ stream)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+
+	msclr::auto_handle<BinaryWriter> writer(gcnew BinaryWriter(stream, Encoding::UTF8, true));
+
+	// The implied entry for the first block is not written
+	writer->Write(static_cast<unsigned __int64>(m_entries->Count - 1));
+	for(int index = 1; index < m_entries->Count; index++) {
+
+		writer->Write(static_cast<unsigned __int64>(m_entries[index]->Compressed));
+		writer->Write(static_cast<unsigned __int64>(m_entries[index]->Uncompressed));
+	}
+
+	writer->Flush();
+}
+
+//---------------------------------------------------------------------------
+// BgzfIndex::Entry Constructor
+//
+// Arguments:
+//
+//	compressed		- Compressed data offset of the block
+//	uncompressed	- Decompressed data offset of the block
+
+BgzfIndex::Entry::Entry(__int64 compressed, __int64 uncompressed) : Compressed(compressed), Uncompressed(uncompressed)
+{
+}
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
@@ -0,0 +1,129 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#ifndef __BGZFINDEX_H_
+#define __BGZFINDEX_H_
+#pragma once
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::IO;
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// Class BgzfIndex
+//
+// Random access index of a BGZF stream, compatible with the ".gzi" files
+// generated by "bgzip -i".  Each entry records the compressed offset of a
+// BGZF block along with the decompressed offset of its first byte; since
+// every block is an independent GZIP member no history is required to
+// resume decompression at any of them
+//---------------------------------------------------------------------------
+
+public ref class BgzfIndex
+{
+public:
+
+	//-----------------------------------------------------------------------
+	// Member Functions
+
+	// Build (static)
+	//
+	// Builds an index by scanning the block headers of a BGZF stream
+	static BgzfIndex^ Build(Stream^ stream);
+
+	// Load (static)
+	//
+	// Loads an index from a ".gzi" formatted stream
+	static BgzfIndex^ Load(Stream^ stream);
+
+	// Save
+	//
+	// Writes the index to a stream in ".gzi" format
+	void Save(Stream^ stream);
+
+	//-----------------------------------------------------------------------
+	// Properties
+
+	// Count
+	//
+	// Gets the number of blocks in the index, not including the first block
+	property int Count
+	{
+		int get(void);
+	}
+
+internal:
+
+	// Entry
+	//
+	// Compressed and decompressed offsets of the start of a BGZF block
+	ref class Entry
+	{
+	public:
+
+		// Instance Constructor
+		//
+		Entry(__int64 compressed, __int64 uncompressed);
+
+		//-------------------------------------------------------------------
+		// Fields
+
+		initonly __int64			Compressed;			// Compressed data offset
+		initonly __int64			Uncompressed;		// Decompressed data offset
+	};
+
+	// Instance Constructor
+	//
+	BgzfIndex(List<Entry^>^ entries);
+
+	//-----------------------------------------------------------------------
+	// Internal Member Functions
+
+	// Find
+	//
+	// Locates the last block that starts at or before a decompressed data offset
+	Entry^ Find(__int64 position);
+
+	// FindAddress
+	//
+	// Locates the last block that starts at or before a compressed data offset
+	Entry^ FindAddress(__int64 address);
+
+private:
+
+	//-----------------------------------------------------------------------
+	// Member Variables
+
+	initonly List<Entry^>^		m_entries;			// Index entries
+};
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
+
+#endif	// __BGZFINDEX_H_
@@ -0,0 +1,700 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "BgzfReader.h"
+
+#include "GzipException.h"
+#include "GzipReader.h"
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// BgzfReader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+
+BgzfReader::BgzfReader(Stream^ stream) : BgzfReader(stream, false)
+{
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+BgzfReader::BgzfReader(Stream^ stream, bool leaveopen) : BgzfReader(stream, 1, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	index		- Random access index of the compressed data
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+BgzfReader::BgzfReader(Stream^ stream, BgzfIndex^ index, bool leaveopen) : BgzfReader(stream, 1, 0, leaveopen)
+{
+	if(Object::ReferenceEquals(index, nullptr)) throw gcnew ArgumentNullException("index");
+	if(!stream->CanSeek) throw gcnew ArgumentException("The base stream must support seeking", "stream");
+
+	m_index = index;
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	threads		- Number of threads to use for decompression (zero = processor count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+BgzfReader::BgzfReader(Stream^ stream, int threads, bool leaveopen) : BgzfReader(stream, threads, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	threads		- Number of threads to use for decompression (zero = processor count)
+//	maxpending	- Maximum number of blocks read ahead (zero = twice the thread count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+BgzfReader::BgzfReader(Stream^ stream, int threads, int maxpending, bool leaveopen) : m_disposed(false), m_stream(stream), 
+	m_leaveopen(leaveopen), m_outpos(0), m_outavail(0), m_outaddress(0), m_outnext(0), m_address(0), m_endofstream(false), 
+	m_basepos(0), m_position(0), m_length(-1)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+	if(threads < 0) throw gcnew ArgumentOutOfRangeException("threads");
+	if(maxpending < 0) throw gcnew ArgumentOutOfRangeException("maxpending");
+
+	// Virtual offsets are relative to the current position of the base stream
+	if(stream->CanSeek) m_basepos = stream->Position;
+
+	// BGZF blocks are always independent and can be decompressed in parallel; zero threads
+	// indicates the processor count and zero pending blocks indicates twice the thread count
+	if(threads == 0) threads = Environment::ProcessorCount;
+	if(threads > 1) m_pending = gcnew TaskQueue<Block^>(threads, (maxpending == 0) ? threads * 2 : maxpending);
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader Destructor
+
+BgzfReader::~BgzfReader()
+{
+	if(m_disposed) return;
+
+	// Wait for and discard any blocks still being decompressed
+	if(m_pending) delete m_pending;
+
+	// Optionally dispose of the input stream instance
+	if(!m_leaveopen) delete m_stream;
+	
+	m_disposed = true;
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader::BaseStream::get
+//
+// Accesses the underlying base stream instance
+
+Stream^ BgzfReader::BaseStream::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return m_stream;
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader::CanRead::get
+//
+// Gets a value indicating whether the current stream supports reading
+
+bool BgzfReader::CanRead::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return m_stream->CanRead;
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader::CanSeek::get
+//
+// Gets a value indicating whether the current stream supports seeking
+
+bool BgzfReader::CanSeek::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return (m_index != nullptr);
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader::CanWrite::get
+//
+// Gets a value indicating whether the current stream supports writing
+
+bool BgzfReader::CanWrite::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return false;
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader::DecompressBlock (private, static)
+//
+// Decompresses a single BGZF block and verifies its trailer
+//
+// Arguments:
+//
+//	state		- Block instance to be decompressed
+
+BgzfReader::Block^ BgzfReader::DecompressBlock(Object^ state)
+{
+	z_stream					zstream;		// Local inflate stream state
+
+	Block^ block = safe_cast<Block^>(state);
+	array<unsigned __int8>^ in = block->Input;
+
+	// The deflate data follows the fixed header and the extra field, the CRC-32 and ISIZE follow it
+	int start = 12 + (in[10] | (in[11] << 8));
+	int length = GetBlockLength(in);
+	unsigned int checksum = GzipReader::ReadLE32(in, in->Length - 8);
+
+	// The output buffer has room for one extra byte to detect data beyond the recorded length
+	block->Output = gcnew array<unsigned __int8>(length + 1);
+
+	GzipReader::InitInflate(&zstream, -MAX_WBITS);
+
+	try {
+
+		pin_ptr<unsigned __int8> pinin = &in[0];
+		pin_ptr<unsigned __int8> pinout = &block->Output[0];
+
+		zstream.next_in = reinterpret_cast<Bytef*>(&pinin[start]);
+		zstream.avail_in = in->Length - start - 8;
+		zstream.next_out = reinterpret_cast<Bytef*>(pinout);
+		zstream.avail_out = block->Output->Length;
+
+		// The entire block must inflate to exactly the length and checksum recorded in the trailer
+		int result = inflate(&zstream, Z_FINISH);
+		if(result != Z_STREAM_END) throw gcnew GzipException((result == Z_OK) ? Z_BUF_ERROR : result);
+		if((zstream.total_out != static_cast<uLong>(length)) || (crc32(0L, reinterpret_cast<Bytef*>(pinout), length) != checksum)) 
+			throw gcnew GzipException(Z_DATA_ERROR);
+
+		block->OutputLength = length;
+	}
+
+	finally { inflateEnd(&zstream); }
+
+	return block;
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader::Flush
+//
+// Clears all buffers for this stream and causes any buffered data to be written
+//
+// Arguments:
+//
+//	NONE
+
+void BgzfReader::Flush(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	m_stream->Flush();
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader::GetBlockLength (internal, static)
+//
+// Gets the decompressed length of a BGZF block from its trailer
+//
+// Arguments:
+//
+//	block		- Entire BGZF block read by ReadBlock
+
+int BgzfReader::GetBlockLength(array<unsigned __int8>^ block)
+{
+	if(Object::ReferenceEquals(block, nullptr)) throw gcnew ArgumentNullException("block");
+
+	// ISIZE is the last 4 bytes of the block, ReadBlock has already checked the range
+	return static_cast<int>(GzipReader::ReadLE32(block, block->Length - 4));
+}
+
+//--------------------------------------------------------------------------
+// BgzfReader::Length::get
+//
+// Gets the length in bytes of the stream
+
+__int64 BgzfReader::Length::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	// The length of the stream is only known when there is an index
+	if(!m_index) throw gcnew NotSupportedException();
+
+	msclr::lock lock(m_lock);
+
+	// A ".gzi" index doesn't record the length of the stream, the blocks after the last
+	// entry are scanned and their lengths are added to the offset of that entry
+	if(m_length < 0) {
+
+		BgzfIndex::Entry^ last = m_index->Find(Int64::MaxValue);
+		__int64 length = last->Uncompressed;
+
+		// The base stream position is restored for the benefit of the next block read
+		__int64 position = m_stream->Position;
+		m_stream->Position = m_basepos + last->Compressed;
+
+		for(array<unsigned __int8>^ block = ReadBlock(m_stream); block; block = ReadBlock(m_stream)) length += GetBlockLength(block);
+
+		m_stream->Position = position;
+		m_length = length;
+	}
+
+	return m_length;
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader::NextBlock (private)
+//
+// Loads the next block that contains any data into the output buffer
+//
+// Arguments:
+//
+//	NONE
+
+bool BgzfReader::NextBlock(void)
+{
+	Block^ block = nullptr;
+
+	// Empty blocks, including the end-of-file marker block, are skipped over
+	do {
+
+		// Parallel decompression reads ahead from the base stream and returns the blocks in order
+		if(m_pending) {
+
+			QueueBlocks();
+			if(m_pending->IsEmpty) return false;
+
+			block = m_pending->Dequeue();
+		}
+
+		else {
+
+			array<unsigned __int8>^ in = ReadBlock(m_stream);
+			if(Object::ReferenceEquals(in, nullptr)) return false;
+
+			block = DecompressBlock(gcnew Block(m_address, in));
+			m_address += in->Length;
+		}
+
+	} while(block->OutputLength == 0);
+
+	m_out = block->Output;
+	m_outaddress = block->Address;
+	m_outnext = block->Address + block->Input->Length;
+	m_outpos = 0;
+	m_outavail = block->OutputLength;
+
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader::Position::get
+//
+// Gets the current position within the stream
+
+__int64 BgzfReader::Position::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	if(!m_index) throw gcnew NotSupportedException();
+
+	msclr::lock lock(m_lock);
+	return m_position;
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader::Position::set
+//
+// Sets the current position within the stream
+
+void BgzfReader::Position::set(__int64 value)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	if(value < 0) throw gcnew ArgumentOutOfRangeException("value");
+	Seek(value, SeekOrigin::Begin);
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader::QueueBlocks (private)
+//
+// Reads ahead and queues blocks for decompression
+//
+// Arguments:
+//
+//	NONE
+
+void BgzfReader::QueueBlocks(void)
+{
+	while((!m_endofstream) && (!m_pending->IsFull)) {
+
+		// Read the next entire block of compressed data from the input stream
+		array<unsigned __int8>^ in = ReadBlock(m_stream);
+		if(Object::ReferenceEquals(in, nullptr)) { m_endofstream = true; break; }
+
+		m_pending->Enqueue(gcnew Func<Object^, Block^>(&BgzfReader::DecompressBlock), gcnew Block(m_address, in));
+		m_address += in->Length;
+	}
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader::Read
+//
+// Reads a sequence of bytes from the current stream and advances the position within the stream
+//
+// Arguments:
+//
+//	buffer		- Destination data buffer
+//	offset		- Offset within buffer to begin copying data
+//	count		- Maximum number of bytes to write into the destination buffer
+
+int BgzfReader::Read(array<unsigned __int8>^ buffer, int offset, int count)
+{
+	int							out = 0;			// Total bytes read from the stream
+
+	CHECK_DISPOSED(m_disposed);
+
+	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
+	if(offset < 0) throw gcnew ArgumentOutOfRangeException("offset");
+	if(count < 0) throw gcnew ArgumentOutOfRangeException("count");
+	if((offset + count) > buffer->Length) throw gcnew ArgumentException("The sum of offset and count is larger than the buffer length");
+
+	if(count == 0) return 0;				// No output buffer to read into
+
+	msclr::lock lock(m_lock);				// Serialize access to the buffer
+
+	while(count > 0) {
+
+		// If there is no more output data available, move on to the next block
+		if((m_outavail == 0) && (!NextBlock())) break;
+
+		// Copy data from the decompressed block into the output buffer
+		int next = Math::Min(m_outavail, count);
+		Array::Copy(m_out, m_outpos, buffer, offset, next);
+
+		m_outpos += next;					// Move offset into the decompressed block
+		m_outavail -= next;					// Reduce length of the decompressed block
+		m_position += next;					// Move the stream position
+		offset += next;						// Move offset into the caller's buffer
+		out += next;						// Increment the amount of data written to the caller
+		count -= next;						// Decrement the amount of data still to read
+	}
+
+	return out;
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader::ReadBlock (internal, static)
+//
+// Reads an entire BGZF block from a stream without decompressing it
+//
+// Arguments:
+//
+//	stream		- Stream instance from which to read the block
+
+array<unsigned __int8>^ BgzfReader::ReadBlock(Stream^ stream)
+{
+	int							blocksize = -1;		// Total size of the block
+
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+
+	// The stream may only end cleanly on a block boundary
+	array<unsigned __int8>^ header = gcnew array<unsigned __int8>(12);
+	int read = ReadBuffer(stream, header, 0, 12);
+	if(read == 0) return nullptr;
+	else if(read != 12) throw gcnew InvalidDataException();
+
+	// A BGZF block is a GZIP member with only the FEXTRA flag (FTEXT is ignored) set
+	if((header[0] != 0x1F) || (header[1] != 0x8B) || (header[2] != Z_DEFLATED) || ((header[3] & 0xFE) != 0x04)) throw gcnew InvalidDataException();
+
+	int xlen = header[10] | (header[11] << 8);
+	array<unsigned __int8>^ extra = gcnew array<unsigned __int8>(xlen);
+	if(ReadBuffer(stream, extra, 0, xlen) != xlen) throw gcnew InvalidDataException();
+
+	// Locate the "BC" subfield in the extra field, it contains the total block size minus one
+	for(int pos = 0; pos + 4 <= xlen; pos += 4 + (extra[pos + 2] | (extra[pos + 3] << 8))) {
+
+		if((extra[pos] == 'B') && (extra[pos + 1] == 'C') && (extra[pos + 2] == 2) && (extra[pos + 3] == 0) && (pos + 6 <= xlen)) 
+			blocksize = (extra[pos + 4] | (extra[pos + 5] << 8)) + 1;
+	}
+
+	// The block has to be large enough for the header, extra field and the 8 byte trailer
+	if((blocksize < 0) || (blocksize < 12 + xlen + 8)) throw gcnew InvalidDataException();
+
+	array<unsigned __int8>^ block = gcnew array<unsigned __int8>(blocksize);
+	Array::Copy(header, 0, block, 0, 12);
+	Array::Copy(extra, 0, block, 12, xlen);
+
+	int remaining = blocksize - 12 - xlen;
+	if(ReadBuffer(stream, block, 12 + xlen, remaining) != remaining) throw gcnew InvalidDataException();
+
+	// The decompressed data in a single block can never exceed the maximum block size
+	unsigned int length = GetBlockLength(block);
+	if(length > MAX_BLOCK_SIZE) throw gcnew InvalidDataException();
+
+	return block;
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader::ReadBuffer (private, static)
+//
+// Reads an exact number of bytes from a stream
+//
+// Arguments:
+//
+//	stream		- Stream instance from which to read the data
+//	buffer		- Destination data buffer
+//	offset		- Offset within buffer to begin copying data
+//	count		- Number of bytes to read from the stream
+
+int BgzfReader::ReadBuffer(Stream^ stream, array<unsigned __int8>^ buffer, int offset, int count)
+{
+	int read = 0;					// Total bytes read from the stream
+
+	// Stream::Read() can return less data than requested, keep reading until done
+	while(read < count) {
+
+		int next = stream->Read(buffer, offset + read, count - read);
+		if(next == 0) break;
+
+		read += next;
+	}
+
+	return read;
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader::Reposition (private)
+//
+// Moves to a compressed block offset and skips into the decompressed data
+//
+// Arguments:
+//
+//	address		- Compressed offset of the block to move to
+//	skip		- Number of decompressed bytes to skip from the block
+
+void BgzfReader::Reposition(__int64 address, __int64 skip)
+{
+	// Any blocks that were read ahead from the previous position are discarded
+	if(m_pending) m_pending->Clear();
+
+	m_stream->Position = m_basepos + address;
+	m_address = m_outaddress = m_outnext = address;
+	m_outpos = m_outavail = 0;
+	m_endofstream = false;
+
+	// Decompress blocks from the new address until the one that contains the target offset;
+	// an offset at the very end of a block leaves that block loaded with nothing available
+	while(skip > 0) {
+
+		if((m_outavail == 0) && (!NextBlock())) break;
+
+		int next = static_cast<int>(Math::Min(static_cast<__int64>(m_outavail), skip));
+		m_outpos += next;
+		m_outavail -= next;
+		skip -= next;
+	}
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader::Seek
+//
+// Sets the position within the current stream
+//
+// Arguments:
+//
+//	offset		- Byte offset relative to origin
+//	origin		- Reference point used to obtain the new position
+
+__int64 BgzfReader::Seek(__int64 offset, SeekOrigin origin)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	// Seeking within the decompressed data is only supported when there is an index
+	if(!m_index) throw gcnew NotSupportedException();
+
+	msclr::lock lock(m_lock);
+
+	// Convert the offset into an absolute position within the decompressed data
+	__int64 position = offset;
+	if(origin == SeekOrigin::Current) position += m_position;
+	else if(origin == SeekOrigin::End) position += Length;
+	else if(origin != SeekOrigin::Begin) throw gcnew ArgumentOutOfRangeException("origin");
+
+	if(position < 0) throw gcnew IOException("An attempt was made to move the position before the beginning of the stream");
+
+	// Move to the last indexed block at or before the new position and skip into it
+	BgzfIndex::Entry^ entry = m_index->Find(position);
+	Reposition(entry->Compressed, position - entry->Uncompressed);
+	m_position = position;
+
+	return m_position;
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader::SetLength
+//
+// Sets the length of the current stream
+//
+// Arguments:
+//
+//	value		- Desired length of the current stream in bytes
+
+void BgzfReader::SetLength(__int64 value)
+{
+	UNREFERENCED_PARAMETER(value);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader::VirtualPosition::get
+//
+// Gets the current position as a BGZF virtual offset
+
+__int64 BgzfReader::VirtualPosition::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	msclr::lock lock(m_lock);
+
+	// Once a block has been consumed the position remains at the end of that block, unless the
+	// block is the maximum size; that offset can't be represented and refers to the next block
+	if(m_outpos >= MAX_BLOCK_SIZE) return (m_outnext << 16);
+	return (m_outaddress << 16) | m_outpos;
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader::VirtualPosition::set
+//
+// Sets the current position as a BGZF virtual offset
+
+void BgzfReader::VirtualPosition::set(__int64 value)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	if(value < 0) throw gcnew ArgumentOutOfRangeException("value");
+
+	// Virtual offsets can be used without an index, but the base stream has to be seekable
+	if(!m_stream->CanSeek) throw gcnew NotSupportedException();
+
+	msclr::lock lock(m_lock);
+
+	__int64 address = value >> 16;
+	int skip = static_cast<int>(value & 0xFFFF);
+
+	// With an index the decompressed position starts from the last indexed block at or before the
+	// address, the lengths of any blocks between that one and the address are read from the stream
+	__int64 position = 0;
+	if(m_index) {
+
+		BgzfIndex::Entry^ entry = m_index->FindAddress(address);
+		__int64 blockaddress = entry->Compressed;
+		position = entry->Uncompressed;
+
+		// The base stream position is restored for the benefit of the next block read if this fails
+		__int64 streampos = m_stream->Position;
+		m_stream->Position = m_basepos + blockaddress;
+		while(blockaddress < address) {
+
+			array<unsigned __int8>^ block = ReadBlock(m_stream);
+			if(Object::ReferenceEquals(block, nullptr)) break;
+
+			blockaddress += block->Length;
+			position += GetBlockLength(block);
+		}
+
+		if(blockaddress != address) {
+
+			m_stream->Position = streampos;
+			throw gcnew ArgumentException("The virtual offset does not refer to the start of a block", "value");
+		}
+	}
+
+	Reposition(address, skip);
+	if(m_index) m_position = position + skip;
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader::Write
+//
+// Writes a sequence of bytes to the current stream and advances the current position
+//
+// Arguments:
+//
+//	buffer		- Source data buffer 
+//	offset		- Offset within buffer to begin copying from
+//	count		- Maximum number of bytes to read from the source buffer
+
+void BgzfReader::Write(array<unsigned __int8>^ buffer, int offset, int count)
+{
+	UNREFERENCED_PARAMETER(buffer);
+	UNREFERENCED_PARAMETER(offset);
+	UNREFERENCED_PARAMETER(count);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// BgzfReader::Block Constructor
+//
+// Arguments:
+//
+//	address		- Compressed offset of the block
+//	input		- Entire compressed block
+
+BgzfReader::Block::Block(__int64 address, array<unsigned __int8>^ input) : Address(address), Input(input), OutputLength(0)
+{
+}
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
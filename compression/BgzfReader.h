@@ -0,0 +1,251 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#ifndef __BGZFREADER_H_
+#define __BGZFREADER_H_
+#pragma once
+
+#include <zlib.h>
+#include "BgzfIndex.h"
+#include "TaskQueue.h"
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+using namespace System;
+using namespace System::IO;
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// Class BgzfReader
+//
+// Blocked GZIP (BGZF) decompression stream implementation.  Every block is
+// an independent GZIP member that records its own compressed length, which
+// allows blocks to be decompressed in parallel and to be addressed by the
+// "virtual offsets" used by BGZF-aware formats
+//---------------------------------------------------------------------------
+
+public ref class BgzfReader : public Stream
+{
+public:
+
+	// Instance Constructors
+	//
+	BgzfReader(Stream^ stream);
+	BgzfReader(Stream^ stream, bool leaveopen);
+	BgzfReader(Stream^ stream, BgzfIndex^ index, bool leaveopen);
+	BgzfReader(Stream^ stream, int threads, bool leaveopen);
+	BgzfReader(Stream^ stream, int threads, int maxpending, bool leaveopen);
+
+	//-----------------------------------------------------------------------
+	// Member Functions
+
+	// Flush (Stream)
+	//
+	// Clears all buffers for this stream and causes any buffered data to be written
+	virtual void Flush(void) override;
+
+	// Read (Stream)
+	//
+	// Reads a sequence of bytes from the current stream and advances the position within the stream
+	virtual int Read(array<unsigned __int8>^ buffer, int offset, int count) override;
+
+	// Seek (Stream)
+	//
+	// Sets the position within the current stream
+	virtual __int64 Seek(__int64 offset, SeekOrigin origin) override;
+
+	// SetLength (Stream)
+	//
+	// Sets the length of the current stream
+	virtual void SetLength(__int64 value) override;
+
+	// Write (Stream)
+	//
+	// Writes a sequence of bytes to the current stream and advances the current position
+	virtual void Write(array<unsigned __int8>^ buffer, int offset, int count) override;
+
+	//-----------------------------------------------------------------------
+	// Properties
+
+	// BaseStream
+	//
+	// Exposes the underlying base stream instance
+	property Stream^ BaseStream
+	{
+		Stream^ get(void);
+	}
+
+	// CanRead (Stream)
+	//
+	// Gets a value indicating whether the current stream supports reading
+	property bool CanRead
+	{
+		virtual bool get(void) override;
+	}
+
+	// CanSeek (Stream)
+	//
+	// Gets a value indicating whether the current stream supports seeking
+	property bool CanSeek
+	{
+		virtual bool get(void) override;
+	}
+
+	// CanWrite (Stream)
+	//
+	// Gets a value indicating whether the current stream supports writing
+	property bool CanWrite
+	{
+		virtual bool get(void) override;
+	}
+
+	// Length (Stream)
+	//
+	// Gets the length in bytes of the stream
+	property __int64 Length
+	{
+		virtual __int64 get(void) override;
+	}
+
+	// Position (Stream)
+	//
+	// Gets or sets the current position within the stream
+	property __int64 Position
+	{
+		virtual __int64 get(void) override;
+		void set(__int64 value) override;
+	}
+
+	// VirtualPosition
+	//
+	// Gets or sets the current position as a BGZF virtual offset, the compressed
+	// offset of the block shifted left 16 bits combined with the offset within it
+	property __int64 VirtualPosition
+	{
+		__int64 get(void);
+		void set(__int64 value);
+	}
+
+internal:
+
+	// MAX_BLOCK_SIZE
+	//
+	// Maximum size of a BGZF block, both compressed and decompressed
+	static const int MAX_BLOCK_SIZE = 65536;
+
+	//-----------------------------------------------------------------------
+	// Internal Member Functions
+
+	// GetBlockLength (static)
+	//
+	// Gets the decompressed length of a BGZF block from its trailer
+	static int GetBlockLength(array<unsigned __int8>^ block);
+
+	// ReadBlock (static)
+	//
+	// Reads an entire BGZF block from a stream without decompressing it
+	static array<unsigned __int8>^ ReadBlock(Stream^ stream);
+
+private:
+
+	// Destructor
+	//
+	~BgzfReader();
+
+	// Block
+	//
+	// Compressed and decompressed data for a single BGZF block
+	ref class Block
+	{
+	public:
+
+		// Instance Constructor
+		//
+		Block(__int64 address, array<unsigned __int8>^ input);
+
+		//-------------------------------------------------------------------
+		// Fields
+
+		initonly __int64					Address;		// Compressed block offset
+		initonly array<unsigned __int8>^	Input;			// Compressed block data
+		array<unsigned __int8>^				Output;			// Decompressed block data
+		int									OutputLength;	// Length of the output data
+	};
+
+	//-----------------------------------------------------------------------
+	// Private Member Functions
+
+	// DecompressBlock (static)
+	//
+	// Decompresses a single BGZF block and verifies its trailer
+	static Block^ DecompressBlock(Object^ state);
+
+	// NextBlock
+	//
+	// Loads the next block that contains any data into the output buffer
+	bool NextBlock(void);
+
+	// QueueBlocks
+	//
+	// Reads ahead and queues blocks for decompression
+	void QueueBlocks(void);
+
+	// ReadBuffer (static)
+	//
+	// Reads an exact number of bytes from a stream
+	static int ReadBuffer(Stream^ stream, array<unsigned __int8>^ buffer, int offset, int count);
+
+	// Reposition
+	//
+	// Moves to a compressed block offset and skips into the decompressed data
+	void Reposition(__int64 address, __int64 skip);
+
+	//-----------------------------------------------------------------------
+	// Member Variables
+
+	bool							m_disposed;			// Object disposal flag
+	Stream^							m_stream;			// Base Stream instance
+	bool							m_leaveopen;		// Flag to leave base stream open
+	array<unsigned __int8>^			m_out;				// Output data buffer
+	int								m_outpos;			// Position within the buffer
+	int								m_outavail;			// Available data in the buffer
+	__int64							m_outaddress;		// Block offset of the output buffer
+	__int64							m_outnext;			// Block offset after the output buffer
+	__int64							m_address;			// Block offset of the next block
+	bool							m_endofstream;		// Flag if all blocks have been read
+	TaskQueue<Block^>^				m_pending;			// Pending block decompressions
+	BgzfIndex^						m_index;			// Optional random access index
+	__int64							m_basepos;			// Base stream offset of the data
+	__int64							m_position;			// Position within decompressed data
+	__int64							m_length;			// Decompressed length, if known
+
+	Object^	m_lock = gcnew Object();		// Synchronization object
+};
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
+
+#endif	// __BGZFREADER_H_
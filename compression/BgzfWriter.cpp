@@ -0,0 +1,566 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "BgzfWriter.h"
+
+#include "BgzfReader.h"
+#include "GzipException.h"
+#include "GzipWriter.h"
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// BgzfWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+
+BgzfWriter::BgzfWriter(Stream^ stream) : 
+	BgzfWriter(stream, nullptr, GzipCompressionLevel::Default, GzipCompressionStrategy::Default, GzipMemoryUsageLevel::Default, 1, 0, false)
+{
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	level		- Indicates whether to emphasize speed or compression efficiency
+
+BgzfWriter::BgzfWriter(Stream^ stream, Compression::CompressionLevel level) : 
+	BgzfWriter(stream, nullptr, GzipCompressionLevel(level), GzipCompressionStrategy::Default, GzipMemoryUsageLevel::Default, 1, 0, false)
+{
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+BgzfWriter::BgzfWriter(Stream^ stream, bool leaveopen) : 
+	BgzfWriter(stream, nullptr, GzipCompressionLevel::Default, GzipCompressionStrategy::Default, GzipMemoryUsageLevel::Default, 1, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	level		- Indicates the level of compression to use
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+BgzfWriter::BgzfWriter(Stream^ stream, Compression::CompressionLevel level, bool leaveopen) : 
+	BgzfWriter(stream, nullptr, GzipCompressionLevel(level), GzipCompressionStrategy::Default, GzipMemoryUsageLevel::Default, 1, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	level		- Indicates the level of compression to use
+//	threads		- Number of threads to use for compression (zero = processor count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+BgzfWriter::BgzfWriter(Stream^ stream, Compression::CompressionLevel level, int threads, bool leaveopen) : 
+	BgzfWriter(stream, nullptr, GzipCompressionLevel(level), GzipCompressionStrategy::Default, GzipMemoryUsageLevel::Default, threads, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	index		- The stream the ".gzi" index is written to when disposed
+//	level		- Indicates the level of compression to use
+//	threads		- Number of threads to use for compression (zero = processor count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+BgzfWriter::BgzfWriter(Stream^ stream, Stream^ index, Compression::CompressionLevel level, int threads, bool leaveopen) : 
+	BgzfWriter(stream, index, GzipCompressionLevel(level), GzipCompressionStrategy::Default, GzipMemoryUsageLevel::Default, threads, 0, leaveopen)
+{
+	if(Object::ReferenceEquals(index, nullptr)) throw gcnew ArgumentNullException("index");
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter Constructor (internal)
+//
+// Arguments:
+//
+//	stream			- The stream the compressed data is written to
+//	index			- Optional stream the ".gzi" index is written to when disposed
+//	level			- Indicates the level of compression to use
+//	strategy		- Indicates the compression strategy to use
+//	maxmem			- Indicates the maximum memory to use during encoding
+//	threads			- Number of threads to use for compression (zero = processor count)
+//	maxpending		- Maximum number of blocks in flight (zero = twice the thread count)
+//	leaveopen		- Flag to leave the base stream open after disposal
+
+BgzfWriter::BgzfWriter(Stream^ stream, Stream^ index, GzipCompressionLevel level, GzipCompressionStrategy strategy, GzipMemoryUsageLevel maxmem, 
+	int threads, int maxpending, bool leaveopen) : m_disposed(false), m_stream(stream), m_indexstream(index), m_leaveopen(leaveopen), 
+	m_level(level), m_strategy(static_cast<int>(strategy)), m_maxmem(maxmem), m_inpos(0), m_totalin(0), m_totalout(0), m_blockpos(0)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+	if(threads < 0) throw gcnew ArgumentOutOfRangeException("threads");
+	if(maxpending < 0) throw gcnew ArgumentOutOfRangeException("maxpending");
+
+	m_in = gcnew array<unsigned __int8>(BLOCK_SIZE);
+
+	// The index entries are only collected when there is somewhere to write them
+	if(!Object::ReferenceEquals(index, nullptr)) m_entries = gcnew List<BgzfIndex::Entry^>();
+
+	// BGZF blocks are always independent and can be compressed in parallel; zero threads
+	// indicates the processor count and zero pending blocks indicates twice the thread count
+	if(threads == 0) threads = Environment::ProcessorCount;
+	if(threads > 1) m_pending = gcnew TaskQueue<Block^>(threads, (maxpending == 0) ? threads * 2 : maxpending);
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter Destructor
+
+BgzfWriter::~BgzfWriter()
+{
+	if(m_disposed) return;
+
+	msclr::lock lock(m_lock);
+
+	// Compress any remaining input data and wait for all of the blocks to be written
+	QueueBlock();
+	if(m_pending) {
+
+		WritePendingBlocks(true);
+		delete m_pending;
+	}
+
+	// BGZF streams are terminated with an empty block to allow truncation to be detected, the empty
+	// deflate data is a single fixed Huffman block and the CRC-32 and ISIZE of no data are zero
+	m_stream->Write(CreateBlockHeader(HEADER_SIZE + 2 + TRAILER_SIZE), 0, HEADER_SIZE);
+	m_stream->Write(gcnew array<unsigned __int8>{ 0x03, 0x00, 0, 0, 0, 0, 0, 0, 0, 0 }, 0, 2 + TRAILER_SIZE);
+
+	// The index is written after all of the blocks; the index stream is always left open
+	if(m_entries) (gcnew BgzfIndex(m_entries))->Save(m_indexstream);
+
+	if(!m_leaveopen) delete m_stream;		// Optionally dispose of the base stream
+	
+	m_disposed = true;
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter::BaseStream::get
+//
+// Accesses the underlying base stream instance
+
+Stream^ BgzfWriter::BaseStream::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return m_stream;
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter::CanRead::get
+//
+// Gets a value indicating whether the current stream supports reading
+
+bool BgzfWriter::CanRead::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return false;
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter::CanSeek::get
+//
+// Gets a value indicating whether the current stream supports seeking
+
+bool BgzfWriter::CanSeek::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return false;
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter::CanWrite::get
+//
+// Gets a value indicating whether the current stream supports writing
+
+bool BgzfWriter::CanWrite::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return m_stream->CanWrite;
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter::CompressBlock (private)
+//
+// Compresses a single block of input data into a complete BGZF block
+//
+// Arguments:
+//
+//	state		- Block instance to be compressed
+
+BgzfWriter::Block^ BgzfWriter::CompressBlock(Object^ state)
+{
+	z_stream					zstream;		// Local deflate stream state
+
+	Block^ block = safe_cast<Block^>(state);
+
+	// Each block is compressed as raw deflate data, the GZIP header and trailer are generated here
+	GzipWriter::InitDeflate(&zstream, m_level, -MAX_WBITS, m_maxmem, m_strategy);
+	int result = Z_OK;
+
+	try {
+
+		// The output buffer is the largest possible block, BSIZE is only 16 bits
+		block->Output = gcnew array<unsigned __int8>(BgzfReader::MAX_BLOCK_SIZE);
+		pin_ptr<unsigned __int8> pinout = &block->Output[0];
+
+		pin_ptr<unsigned __int8> pinin = &block->Input[0];
+
+		zstream.next_in = reinterpret_cast<Bytef*>(pinin);
+		zstream.avail_in = block->Input->Length;
+		zstream.next_out = reinterpret_cast<Bytef*>(&pinout[HEADER_SIZE]);
+		zstream.avail_out = block->Output->Length - HEADER_SIZE - TRAILER_SIZE;
+
+		result = deflate(&zstream, Z_FINISH);
+
+		// Incompressible input may not fit in the block, in which case it is stored instead; the
+		// overhead of stored deflate blocks is small enough that BLOCK_SIZE bytes will always fit
+		if((result == Z_OK) || (result == Z_BUF_ERROR)) {
+
+			result = deflateReset(&zstream);
+			if(result == Z_OK) result = deflateParams(&zstream, Z_NO_COMPRESSION, Z_DEFAULT_STRATEGY);
+			if(result != Z_OK) throw gcnew GzipException(result);
+
+			zstream.next_in = reinterpret_cast<Bytef*>(pinin);
+			zstream.avail_in = block->Input->Length;
+			zstream.next_out = reinterpret_cast<Bytef*>(&pinout[HEADER_SIZE]);
+			zstream.avail_out = block->Output->Length - HEADER_SIZE - TRAILER_SIZE;
+
+			result = deflate(&zstream, Z_FINISH);
+		}
+
+		if(result != Z_STREAM_END) throw gcnew GzipException((result == Z_OK) ? Z_BUF_ERROR : result);
+
+		int length = HEADER_SIZE + static_cast<int>(zstream.total_out) + TRAILER_SIZE;
+		unsigned int checksum = crc32(0L, reinterpret_cast<Bytef*>(pinin), block->Input->Length);
+
+		// GZIP member header and the trailer with the CRC-32 and length of the input data
+		Array::Copy(CreateBlockHeader(length), block->Output, HEADER_SIZE);
+		GzipWriter::WriteLE32(block->Output, length - 8, checksum);
+		GzipWriter::WriteLE32(block->Output, length - 4, static_cast<unsigned int>(block->Input->Length));
+
+		block->OutputLength = length;
+	}
+
+	finally { deflateEnd(&zstream); }
+
+	return block;
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter::CreateBlockHeader (private, static)
+//
+// Creates the GZIP member header of a BGZF block
+//
+// Arguments:
+//
+//	length		- Total length of the compressed block
+
+array<unsigned __int8>^ BgzfWriter::CreateBlockHeader(int length)
+{
+	// The "BC" extra subfield contains the total block size minus one
+	return GzipWriter::CreateHeader(0, 0xFF, gcnew array<unsigned __int8>{ 'B', 'C', 0x02, 0x00, 
+		static_cast<unsigned __int8>((length - 1) & 0xFF), static_cast<unsigned __int8>(((length - 1) >> 8) & 0xFF) });
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter::Flush
+//
+// Clears all buffers for this stream and causes any buffered data to be written
+//
+// Arguments:
+//
+//	NONE
+
+void BgzfWriter::Flush(void)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	msclr::lock lock(m_lock);
+
+	// The current block is ended early, the next block starts with the next write
+	QueueBlock();
+	if(m_pending) WritePendingBlocks(true);
+
+	m_stream->Flush();
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter::Length::get
+//
+// Gets the length in bytes of the stream
+
+__int64 BgzfWriter::Length::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter::Position::get
+//
+// Gets the current position within the stream
+
+__int64 BgzfWriter::Position::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	msclr::lock lock(m_lock);
+	return m_totalin + m_inpos;
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter::Position::set
+//
+// Sets the current position within the stream
+
+void BgzfWriter::Position::set(__int64 value)
+{
+	UNREFERENCED_PARAMETER(value);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter::QueueBlock (private)
+//
+// Compresses or queues the contents of the input buffer as a BGZF block
+//
+// Arguments:
+//
+//	NONE
+
+void BgzfWriter::QueueBlock(void)
+{
+	msclr::lock lock(m_lock);
+
+	// Empty blocks are never written, the end-of-file marker is the only one
+	if(m_inpos == 0) return;
+
+	// A partial block is trimmed to the actual length of the data
+	array<unsigned __int8>^ input = m_in;
+	if(m_inpos < input->Length) Array::Resize<unsigned __int8>(input, m_inpos);
+
+	m_totalin += input->Length;
+	m_inpos = 0;
+
+	// Without parallel compression the block is compressed and written immediately
+	if(!m_pending) { WriteBlock(CompressBlock(gcnew Block(input))); return; }
+
+	// Make room in the queue for the block and start compressing it
+	WritePendingBlocks(false);
+	m_pending->Enqueue(gcnew Func<Object^, Block^>(this, &BgzfWriter::CompressBlock), gcnew Block(input));
+
+	// The queued buffer now belongs to the worker, a new one is needed for the next block
+	if(Object::ReferenceEquals(input, m_in)) m_in = gcnew array<unsigned __int8>(BLOCK_SIZE);
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter::Read
+//
+// Reads a sequence of bytes from the current stream and advances the position within the stream
+//
+// Arguments:
+//
+//	buffer		- Destination data buffer
+//	offset		- Offset within buffer to begin copying data
+//	count		- Maximum number of bytes to write into the destination buffer
+
+int BgzfWriter::Read(array<unsigned __int8>^ buffer, int offset, int count)
+{
+	UNREFERENCED_PARAMETER(buffer);
+	UNREFERENCED_PARAMETER(offset);
+	UNREFERENCED_PARAMETER(count);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter::Seek
+//
+// Sets the position within the current stream
+//
+// Arguments:
+//
+//	offset		- Byte offset relative to origin
+//	origin		- Reference point used to obtain the new position
+
+__int64 BgzfWriter::Seek(__int64 offset, SeekOrigin origin)
+{
+	UNREFERENCED_PARAMETER(offset);
+	UNREFERENCED_PARAMETER(origin);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter::SetLength
+//
+// Sets the length of the current stream
+//
+// Arguments:
+//
+//	value		- Desired length of the current stream in bytes
+
+void BgzfWriter::SetLength(__int64 value)
+{
+	UNREFERENCED_PARAMETER(value);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter::Write
+//
+// Writes a sequence of bytes to the current stream and advances the current position
+//
+// Arguments:
+//
+//	buffer		- Source data buffer 
+
+void BgzfWriter::Write(array<unsigned __int8>^ buffer)
+{
+	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
+
+	CHECK_DISPOSED(m_disposed);
+	Write(buffer, 0, buffer->Length);
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter::Write
+//
+// Writes a sequence of bytes to the current stream and advances the current position
+//
+// Arguments:
+//
+//	buffer		- Source data buffer 
+//	offset		- Offset within buffer to begin copying from
+//	count		- Maximum number of bytes to read from the source buffer
+
+void BgzfWriter::Write(array<unsigned __int8>^ buffer, int offset, int count)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
+	if(offset < 0) throw gcnew ArgumentOutOfRangeException("offset");
+	if(count < 0) throw gcnew ArgumentOutOfRangeException("count");
+	if((offset + count) > buffer->Length) throw gcnew ArgumentException("The sum of offset and count is larger than the buffer length");
+
+	msclr::lock lock(m_lock);
+
+	// Input data is buffered and compressed in fixed-size blocks
+	while(count > 0) {
+
+		int next = Math::Min(m_in->Length - m_inpos, count);
+		Array::Copy(buffer, offset, m_in, m_inpos, next);
+
+		m_inpos += next;				// Increment length of buffer
+		offset += next;					// Move offset into the source buffer
+		count -= next;					// Decrement bytes remaining
+
+		if(m_inpos == m_in->Length) QueueBlock();
+	}
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter::WriteBlock (private)
+//
+// Writes a compressed block to the base stream and adds it to the index
+//
+// Arguments:
+//
+//	block		- Compressed block to be written
+
+void BgzfWriter::WriteBlock(Block^ block)
+{
+	msclr::lock lock(m_lock);
+
+	// The first block of the stream is implied by the index and is not recorded
+	if((m_entries) && (m_totalout > 0)) m_entries->Add(gcnew BgzfIndex::Entry(m_totalout, m_blockpos));
+
+	m_stream->Write(block->Output, 0, block->OutputLength);
+
+	m_totalout += block->OutputLength;
+	m_blockpos += block->Input->Length;
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter::WritePendingBlocks (private)
+//
+// Writes completed blocks from the compression queue to the base stream
+//
+// Arguments:
+//
+//	all			- Flag to write all pending blocks rather than just make room
+
+void BgzfWriter::WritePendingBlocks(bool all)
+{
+	msclr::lock lock(m_lock);
+
+	// Wait for the oldest blocks to finish compressing and write them in order
+	while((all) ? !m_pending->IsEmpty : m_pending->IsFull) WriteBlock(m_pending->Dequeue());
+}
+
+//---------------------------------------------------------------------------
+// BgzfWriter::Block Constructor
+//
+// Arguments:
+//
+//	input		- Uncompressed input data
+
+BgzfWriter::Block::Block(array<unsigned __int8>^ input) : Input(input), OutputLength(0)
+{
+}
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
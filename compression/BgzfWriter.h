@@ -0,0 +1,252 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#ifndef __BGZFWRITER_H_
+#define __BGZFWRITER_H_
+#pragma once
+
+#include <zlib.h>
+#include "BgzfIndex.h"
+#include "GzipCompressionLevel.h"
+#include "GzipCompressionStrategy.h"
+#include "GzipMemoryUsageLevel.h"
+#include "TaskQueue.h"
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::IO;
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// Class BgzfWriter
+//
+// Blocked GZIP (BGZF) compression stream implementation.  The output is a
+// series of independent GZIP members of no more than 64KiB each, readable by
+// any GZIP decompressor, followed by the standard end-of-file marker block.
+// An optional ".gzi" index of the blocks can be written to a separate stream
+//---------------------------------------------------------------------------
+
+public ref class BgzfWriter : public Stream
+{
+public:
+
+	// Instance Constructors
+	//
+	BgzfWriter(Stream^ stream);
+	BgzfWriter(Stream^ stream, Compression::CompressionLevel level);
+	BgzfWriter(Stream^ stream, bool leaveopen);
+	BgzfWriter(Stream^ stream, Compression::CompressionLevel level, bool leaveopen);
+	BgzfWriter(Stream^ stream, Compression::CompressionLevel level, int threads, bool leaveopen);
+	BgzfWriter(Stream^ stream, Stream^ index, Compression::CompressionLevel level, int threads, bool leaveopen);
+
+	//-----------------------------------------------------------------------
+	// Member Functions
+
+	// Flush (Stream)
+	//
+	// Clears all buffers for this stream and causes any buffered data to be written
+	virtual void Flush(void) override;
+
+	// Read (Stream)
+	//
+	// Reads a sequence of bytes from the current stream and advances the position within the stream
+	virtual int Read(array<unsigned __int8>^ buffer, int offset, int count) override;
+
+	// Seek (Stream)
+	//
+	// Sets the position within the current stream
+	virtual __int64 Seek(__int64 offset, SeekOrigin origin) override;
+
+	// SetLength (Stream)
+	//
+	// Sets the length of the current stream
+	virtual void SetLength(__int64 value) override;
+
+	// Write
+	//
+	// Writes a sequence of bytes to the current stream and advances the current position
+	void Write(array<unsigned __int8>^ buffer);
+
+	// Write (Stream)
+	//
+	// Writes a sequence of bytes to the current stream and advances the current position
+	virtual void Write(array<unsigned __int8>^ buffer, int offset, int count) override;
+
+	//-----------------------------------------------------------------------
+	// Properties
+
+	// BaseStream
+	//
+	// Exposes the underlying base stream instance
+	property Stream^ BaseStream
+	{
+		Stream^ get(void);
+	}
+
+	// CanRead (Stream)
+	//
+	// Gets a value indicating whether the current stream supports reading
+	property bool CanRead
+	{
+		virtual bool get(void) override;
+	}
+
+	// CanSeek (Stream)
+	//
+	// Gets a value indicating whether the current stream supports seeking
+	property bool CanSeek
+	{
+		virtual bool get(void) override;
+	}
+
+	// CanWrite (Stream)
+	//
+	// Gets a value indicating whether the current stream supports writing
+	property bool CanWrite
+	{
+		virtual bool get(void) override;
+	}
+
+	// Length (Stream)
+	//
+	// Gets the length in bytes of the stream
+	property __int64 Length
+	{
+		virtual __int64 get(void) override;
+	}
+
+	// Position (Stream)
+	//
+	// Gets or sets the current position within the stream
+	property __int64 Position
+	{
+		virtual __int64 get(void) override;
+		void set(__int64 value) override;
+	}
+
+internal:
+
+	// Instance Constructor
+	//
+	BgzfWriter(Stream^ stream, Stream^ index, GzipCompressionLevel level, GzipCompressionStrategy strategy, GzipMemoryUsageLevel maxmem, 
+		int threads, int maxpending, bool leaveopen);
+
+private:
+
+	// Destructor
+	//
+	~BgzfWriter();
+
+	// BLOCK_SIZE
+	//
+	// Amount of input data compressed into each block; this is the same as
+	// bgzip uses and leaves room for incompressible data in a 64KiB block
+	static const int BLOCK_SIZE = 0xFF00;
+
+	// HEADER_SIZE
+	//
+	// Size of the GZIP member header, including the "BC" extra subfield
+	static const int HEADER_SIZE = 18;
+
+	// TRAILER_SIZE
+	//
+	// Size of the GZIP member trailer (CRC-32 and ISIZE)
+	static const int TRAILER_SIZE = 8;
+
+	// Block
+	//
+	// Input and output data for a single BGZF block
+	ref class Block
+	{
+	public:
+
+		// Instance Constructor
+		//
+		Block(array<unsigned __int8>^ input);
+
+		//-------------------------------------------------------------------
+		// Fields
+
+		initonly array<unsigned __int8>^	Input;			// Uncompressed input data
+		array<unsigned __int8>^				Output;			// Entire compressed block
+		int									OutputLength;	// Length of the output data
+	};
+
+	//-----------------------------------------------------------------------
+	// Private Member Functions
+
+	// CompressBlock
+	//
+	// Compresses a single block of input data into a complete BGZF block
+	Block^ CompressBlock(Object^ state);
+
+	// CreateBlockHeader (static)
+	//
+	// Creates the GZIP member header of a BGZF block
+	static array<unsigned __int8>^ CreateBlockHeader(int length);
+
+	// QueueBlock
+	//
+	// Compresses or queues the contents of the input buffer as a BGZF block
+	void QueueBlock(void);
+
+	// WriteBlock
+	//
+	// Writes a compressed block to the base stream and adds it to the index
+	void WriteBlock(Block^ block);
+
+	// WritePendingBlocks
+	//
+	// Writes completed blocks from the compression queue to the base stream
+	void WritePendingBlocks(bool all);
+
+	//-----------------------------------------------------------------------
+	// Member Variables
+
+	bool							m_disposed;		// Object disposal flag
+	Stream^							m_stream;		// Base Stream instance
+	Stream^							m_indexstream;	// Optional ".gzi" index stream
+	bool							m_leaveopen;	// Flag to leave base stream open
+	initonly int					m_level;		// Compression level
+	initonly int					m_strategy;		// Compression strategy
+	initonly int					m_maxmem;		// Memory usage level
+	TaskQueue<Block^>^				m_pending;		// Pending block compressions
+	array<unsigned __int8>^			m_in;			// Input data buffer
+	int								m_inpos;		// Position within the input buffer
+	__int64							m_totalin;		// Total queued input data
+	__int64							m_totalout;		// Total output data written
+	__int64							m_blockpos;		// Input offset of the next block
+	List<BgzfIndex::Entry^>^		m_entries;		// Block index entries
+
+	Object^	m_lock = gcnew Object();		// Synchronization object
+};
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
+
+#endif	// __BGZFWRITER_H_
@@ -77,7 +77,7 @@ namespace zuki::io::compression {
 //	NONE
 
 Bzip2Encoder::Bzip2Encoder() : m_buffersize(Bzip2Writer::DEFAULT_BUFFER_SIZE), m_level(Bzip2CompressionLevel::Default), 
-	m_workfactor(Bzip2WorkFactor::Default)
+	m_workfactor(Bzip2WorkFactor::Default), m_maxpending(0), m_threads(1)
 {
 }
 
@@ -195,7 +195,7 @@ void Bzip2Encoder::Encode(Stream^ instream, Stream^ outstream)
 	if(Object::ReferenceEquals(instream, nullptr)) throw gcnew ArgumentNullException("instream");
 	if(Object::ReferenceEquals(outstream, nullptr)) throw gcnew ArgumentNullException("outstream");
 
-	msclr::auto_handle<Bzip2Writer> writer(gcnew Bzip2Writer(outstream, m_level, m_workfactor, m_buffersize, true));
+	msclr::auto_handle<Bzip2Writer> writer(gcnew Bzip2Writer(outstream, m_level, m_workfactor, m_buffersize, m_threads, m_maxpending, true));
 	instream->CopyTo(writer.get());
 }
 
@@ -214,7 +214,7 @@ void Bzip2Encoder::Encode(array<unsigned __int8>^ buffer, Stream^ outstream)
 	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
 	if(Object::ReferenceEquals(outstream, nullptr)) throw gcnew ArgumentNullException("outstream");
 
-	msclr::auto_handle<Bzip2Writer> writer(gcnew Bzip2Writer(outstream, m_level, m_workfactor, m_buffersize, true));
+	msclr::auto_handle<Bzip2Writer> writer(gcnew Bzip2Writer(outstream, m_level, m_workfactor, m_buffersize, m_threads, m_maxpending, true));
 	writer->Write(buffer, 0, buffer->Length);
 }
 
@@ -235,10 +235,52 @@ void Bzip2Encoder::Encode(array<unsigned __int8>^ buffer, int offset, int count,
 	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
 	if(Object::ReferenceEquals(outstream, nullptr)) throw gcnew ArgumentNullException("outstream");
 
-	msclr::auto_handle<Bzip2Writer> writer(gcnew Bzip2Writer(outstream, m_level, m_workfactor, m_buffersize, true));
+	msclr::auto_handle<Bzip2Writer> writer(gcnew Bzip2Writer(outstream, m_level, m_workfactor, m_buffersize, m_threads, m_maxpending, true));
 	writer->Write(buffer, offset, count);
 }
 
+//---------------------------------------------------------------------------
+// Bzip2Encoder::MaximumPendingBlocks::get
+//
+// Gets the maximum number of blocks in flight during parallel compression
+
+int Bzip2Encoder::MaximumPendingBlocks::get(void)
+{
+	return m_maxpending;
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Encoder::MaximumPendingBlocks::set
+//
+// Sets the maximum number of blocks in flight during parallel compression
+
+void Bzip2Encoder::MaximumPendingBlocks::set(int value)
+{
+	if(value < 0) throw gcnew ArgumentOutOfRangeException("value");
+	m_maxpending = value;
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Encoder::MaximumThreads::get
+//
+// Gets the number of threads to use for parallel block compression
+
+int Bzip2Encoder::MaximumThreads::get(void)
+{
+	return m_threads;
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Encoder::MaximumThreads::set
+//
+// Sets the number of threads to use for parallel block compression
+
+void Bzip2Encoder::MaximumThreads::set(int value)
+{
+	if(value < 0) throw gcnew ArgumentOutOfRangeException("value");
+	m_threads = value;
+}
+
 //---------------------------------------------------------------------------
 // Bzip2Encoder::WorkFactor::get
 //
@@ -144,6 +144,24 @@ public:
 		void set(Bzip2CompressionLevel value);
 	} 
 
+	// MaximumPendingBlocks
+	//
+	// Gets/sets the maximum number of blocks in flight during parallel compression
+	property int MaximumPendingBlocks
+	{
+		int get(void);
+		void set(int value);
+	}
+
+	// MaximumThreads
+	//
+	// Gets/sets the number of threads to use for parallel block compression
+	property int MaximumThreads
+	{
+		int get(void);
+		void set(int value);
+	}
+
 	// WorkFactor
 	//
 	// Gets/sets the bzip2 compression work factor
@@ -161,6 +179,8 @@ private:
 	int							m_buffersize;			// Size of the compression buffer
 	Bzip2CompressionLevel		m_level;				// Compression level
 	Bzip2WorkFactor				m_workfactor;			// Work factor
+	int							m_maxpending;			// Maximum pending blocks
+	int							m_threads;				// Number of compression threads
 };
 
 //---------------------------------------------------------------------------
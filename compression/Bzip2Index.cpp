@@ -0,0 +1,397 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// This program, "bzip2", the associated library "libbzip2", and all
+// documentation, are copyright (C) 1996-2010 Julian R Seward.  All
+// rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+// 
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 
+// 2. The origin of this software must not be misrepresented; you must 
+//    not claim that you wrote the original software.  If you use this 
+//    software in a product, an acknowledgment in the product 
+//    documentation would be appreciated but is not required.
+// 
+// 3. Altered source versions must be plainly marked as such, and must
+//    not be misrepresented as being the original software.
+// 
+// 4. The name of the author may not be used to endorse or promote 
+//    products derived from this software without specific prior written 
+//    permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// Julian Seward, jseward@bzip.org
+// bzip2/libbzip2 version 1.0.6 of 6 September 2010
+//---------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "Bzip2Index.h"
+
+#include "Bzip2Exception.h"
+#include "Bzip2Reader.h"
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+using namespace System::Text;
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// Bzip2Index Constructor (internal)
+//
+// Arguments:
+//
+//	entries		- List of index entries
+
+Bzip2Index::Bzip2Index(List<Entry^>^ entries) : m_entries(entries), 
+	m_length((entries->Count == 0) ? 0 : entries[entries->Count - 1]->Position + entries[entries->Count - 1]->Length)
+{
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Index::Build (static)
+//
+// Builds an index by locating and decoding each block of a BZIP2 stream
+//
+// Arguments:
+//
+//	stream		- Stream containing the BZIP2 data to be indexed
+
+Bzip2Index^ Bzip2Index::Build(Stream^ stream)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+
+	List<Entry^>^ entries = gcnew List<Entry^>();
+
+	array<unsigned __int8>^ window = nullptr;	// Compressed data window
+	__int64 windowbase = 0;						// Stream offset of the window
+	int windowlen = 0;							// Length of the data in the window
+	__int64 next = 0;							// Bit offset of the next header or marker
+	__int64 position = 0;						// Decompressed offset of the next block
+	bool instream = false;						// Flag if a stream header was read
+	unsigned int streamcrc = 0;					// Combined CRC of the stream blocks
+
+	while(true) {
+
+		// Each stream starts with a byte-aligned header ("BZh" and the block size); anything
+		// other than another stream header after the first stream is ignored
+		if(!instream) {
+
+			bool header = FillWindow(stream, window, windowbase, windowlen, next >> 3, 4);
+
+			int pos = static_cast<int>((next >> 3) - windowbase);
+			if((header) && ((window[pos] != 'B') || (window[pos + 1] != 'Z') || (window[pos + 2] != 'h') || 
+				(window[pos + 3] < '1') || (window[pos + 3] > '9'))) header = false;
+
+			if(!header) {
+
+				// The first stream must be present and valid, an empty stream is invalid
+				if((next == 0) && (windowlen < 4)) throw gcnew InvalidDataException();
+				if(next == 0) throw gcnew Bzip2Exception(BZ_DATA_ERROR_MAGIC);
+				break;
+			}
+
+			next += 32;
+			instream = true;
+			streamcrc = 0;
+			continue;
+		}
+
+		// Every block and the end of stream marker are followed by a 32-bit CRC
+		if(!FillWindow(stream, window, windowbase, windowlen, next >> 3, 11)) throw gcnew InvalidDataException();
+
+		// The end of stream marker is followed by the combined CRC of all the blocks and padding
+		// to the next byte boundary, where another stream may begin
+		unsigned __int64 magic = Bzip2Reader::ReadBits(window, next - (windowbase * 8), 48);
+		if(magic == Bzip2Reader::STREAM_END_MAGIC) {
+
+			if(Bzip2Reader::ReadBits(window, next - (windowbase * 8) + 48, 32) != streamcrc) throw gcnew Bzip2Exception(BZ_DATA_ERROR);
+
+			next = ((next + 80 + 7) >> 3) << 3;
+			instream = false;
+			continue;
+		}
+
+		if(magic != Bzip2Reader::BLOCK_MAGIC) throw gcnew Bzip2Exception(BZ_DATA_ERROR);
+
+		// A magic number can occur by chance inside the compressed data, so the end of the block
+		// is the first following marker at which the block can actually be decoded
+		Bzip2Reader::Block^ block = nullptr;
+		__int64 end = next;
+
+		while((!block) || (!block->Complete)) {
+
+			bool final = false;
+			__int64 marker = Bzip2Reader::FindMarker(window, windowlen, end + 1 - (windowbase * 8), final);
+
+			if(marker < 0) {
+
+				// Read more data into the window if possible, otherwise the block is corrupt
+				if(ReadWindow(stream, window, windowbase, windowlen, next >> 3)) continue;
+				throw gcnew Bzip2Exception(BZ_DATA_ERROR);
+			}
+
+			end = marker + (windowbase * 8);
+			block = Bzip2Reader::DecodeBlock(gcnew Bzip2Reader::Block(window, windowbase, next, end, final));
+		}
+
+		entries->Add(gcnew Entry(next, static_cast<int>(end - next), position, block->OutputLength));
+
+		// Combine the block CRC into the stream CRC the same way the encoder does
+		streamcrc = ((streamcrc << 1) | (streamcrc >> 31)) ^ block->Checksum;
+		position += block->OutputLength;
+		next = end;
+	}
+
+	return gcnew Bzip2Index(entries);
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Index::Count::get
+//
+// Gets the number of blocks in the index
+
+int Bzip2Index::Count::get(void)
+{
+	return m_entries->Count;
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Index::default[int]::get (internal)
+//
+// Gets the entry at the specified index
+
+Bzip2Index::Entry^ Bzip2Index::default::get(int index)
+{
+	return m_entries[index];
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Index::FillWindow (private, static)
+//
+// Ensures that a range of the stream is available in the compressed data window
+//
+// Arguments:
+//
+//	stream		- Stream containing the BZIP2 data
+//	window		- Compressed data window
+//	windowbase	- Stream offset of the window
+//	windowlen	- Length of the data in the window
+//	position	- Stream offset of the first byte required
+//	length		- Number of bytes required
+
+bool Bzip2Index::FillWindow(Stream^ stream, array<unsigned __int8>^% window, __int64% windowbase, int% windowlen, __int64 position, int length)
+{
+	while(windowbase + windowlen < position + length) {
+
+		if(!ReadWindow(stream, window, windowbase, windowlen, position)) return false;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Index::Find (internal)
+//
+// Locates the index of the entry that contains a decompressed data offset
+//
+// Arguments:
+//
+//	position	- Decompressed data offset
+
+int Bzip2Index::Find(__int64 position)
+{
+	int low = 0;
+	int high = m_entries->Count - 1;
+
+	// Binary search for the last entry that doesn't start after the position
+	while(low < high) {
+
+		int middle = low + ((high - low + 1) >> 1);
+		if(m_entries[middle]->Position <= position) low = middle;
+		else high = middle - 1;
+	}
+
+	return low;
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Index::Length::get
+//
+// Gets the decompressed length of the indexed BZIP2 stream
+
+__int64 Bzip2Index::Length::get(void)
+{
+	return m_length;
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Index::Load (static)
+//
+// Loads an index previously written with Save
+//
+// Arguments:
+//
+//	stream		- Stream to read the index from
+
+Bzip2Index^ Bzip2Index::Load(Stream^ stream)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+
+	msclr::auto_handle<BinaryReader> reader(gcnew BinaryReader(stream, Encoding::UTF8, true));
+
+	try {
+
+		// Check the signature and version of the serialized index
+		if(reader->ReadUInt32() != MAGIC) throw gcnew InvalidDataException();
+		if(reader->ReadInt32() != VERSION) throw gcnew InvalidDataException();
+
+		__int64 length = reader->ReadInt64();
+		int count = reader->ReadInt32();
+		if((length < 0) || (count < 0)) throw gcnew InvalidDataException();
+
+		List<Entry^>^ entries = gcnew List<Entry^>(count);
+		__int64 position = 0;
+
+		for(int index = 0; index < count; index++) {
+
+			__int64 bitoffset = reader->ReadInt64();
+			int bitlength = reader->ReadInt32();
+			int blocklength = reader->ReadInt32();
+
+			// Blocks must be in order and can't overlap; the decompressed offsets are implied
+			__int64 previous = (index == 0) ? 0 : entries[index - 1]->BitOffset + entries[index - 1]->BitLength;
+			if((bitoffset < previous) || (bitlength < 80) || (blocklength < 0)) throw gcnew InvalidDataException();
+
+			entries->Add(gcnew Entry(bitoffset, bitlength, position, blocklength));
+			position += blocklength;
+		}
+
+		// The decompressed length must match the sum of the block lengths
+		if(position != length) throw gcnew InvalidDataException();
+
+		return gcnew Bzip2Index(entries);
+	}
+
+	catch(EndOfStreamException^) { throw gcnew InvalidDataException(); }
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Index::ReadWindow (private, static)
+//
+// Reads more compressed data into the compressed data window
+//
+// Arguments:
+//
+//	stream		- Stream containing the BZIP2 data
+//	window		- Compressed data window
+//	windowbase	- Stream offset of the window
+//	windowlen	- Length of the data in the window
+//	retain		- Stream offset of the first window byte that must be retained
+
+bool Bzip2Index::ReadWindow(Stream^ stream, array<unsigned __int8>^% window, __int64% windowbase, int% windowlen, __int64 retain)
+{
+	if(!window) window = gcnew array<unsigned __int8>(WINDOW_SIZE);
+
+	// A block can't be larger than the window, so a window full of retained data is corrupt
+	int keep = windowlen - static_cast<int>(retain - windowbase);
+	if(keep >= WINDOW_SIZE) return false;
+
+	// Nothing decoded from the window is kept, so the retained data is shifted in place
+	if(keep > 0) Array::Copy(window, static_cast<int>(retain - windowbase), window, 0, keep);
+
+	int read = 0, next = 0;
+	while((keep + read < WINDOW_SIZE) && ((next = stream->Read(window, keep + read, WINDOW_SIZE - keep - read)) > 0)) read += next;
+
+	windowbase = retain;
+	windowlen = keep + read;
+
+	return (read > 0);
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Index::Save
+//
+// Writes the index to a stream
+//
+// Arguments:
+//
+//	stream		- Stream to write the index into
+
+void Bzip2Index::Save(Stream^ stream)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+
+	msclr::auto_handle<BinaryWriter> writer(gcnew BinaryWriter(stream, Encoding::UTF8, true));
+
+	writer->Write(MAGIC);
+	writer->Write(VERSION);
+	writer->Write(m_length);
+	writer->Write(m_entries->Count);
+
+	for each(Entry^ entry in m_entries) {
+
+		writer->Write(entry->BitOffset);
+		writer->Write(entry->BitLength);
+		writer->Write(entry->Length);
+	}
+
+	writer->Flush();
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Index::Entry Constructor
+//
+// Arguments:
+//
+//	bitoffset	- Compressed data bit offset of the block magic number
+//	bitlength	- Compressed data length of the block in bits
+//	position	- Decompressed data offset of the block
+//	length		- Decompressed data length of the block
+
+Bzip2Index::Entry::Entry(__int64 bitoffset, int bitlength, __int64 position, int length) : 
+	BitOffset(bitoffset), BitLength(bitlength), Position(position), Length(length)
+{
+}
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
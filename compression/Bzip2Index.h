@@ -0,0 +1,213 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// This program, "bzip2", the associated library "libbzip2", and all
+// documentation, are copyright (C) 1996-2010 Julian R Seward.  All
+// rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+// 
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 
+// 2. The origin of this software must not be misrepresented; you must 
+//    not claim that you wrote the original software.  If you use this 
+//    software in a product, an acknowledgment in the product 
+//    documentation would be appreciated but is not required.
+// 
+// 3. Altered source versions must be plainly marked as such, and must
+//    not be misrepresented as being the original software.
+// 
+// 4. The name of the author may not be used to endorse or promote 
+//    products derived from this software without specific prior written 
+//    permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// Julian Seward, jseward@bzip.org
+// bzip2/libbzip2 version 1.0.6 of 6 September 2010
+//---------------------------------------------------------------------------
+
+#ifndef __BZIP2INDEX_H_
+#define __BZIP2INDEX_H_
+#pragma once
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::IO;
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// Class Bzip2Index
+//
+// Random access index of a BZIP2 stream.  Each entry records the bit offset
+// and length of a compressed block along with the offset and length of its
+// decompressed data; blocks do not depend on each other, which allows
+// Bzip2Reader to decode only the block that contains a requested position
+//---------------------------------------------------------------------------
+
+public ref class Bzip2Index
+{
+public:
+
+	//-----------------------------------------------------------------------
+	// Member Functions
+
+	// Build (static)
+	//
+	// Builds an index by locating and decoding each block of a BZIP2 stream
+	static Bzip2Index^ Build(Stream^ stream);
+
+	// Load (static)
+	//
+	// Loads an index previously written with Save
+	static Bzip2Index^ Load(Stream^ stream);
+
+	// Save
+	//
+	// Writes the index to a stream
+	void Save(Stream^ stream);
+
+	//-----------------------------------------------------------------------
+	// Properties
+
+	// Count
+	//
+	// Gets the number of blocks in the index
+	property int Count
+	{
+		int get(void);
+	}
+
+	// Length
+	//
+	// Gets the decompressed length of the indexed BZIP2 stream
+	property __int64 Length
+	{
+		__int64 get(void);
+	}
+
+internal:
+
+	// Entry
+	//
+	// Independently decodable block within the BZIP2 stream
+	ref class Entry
+	{
+	public:
+
+		// Instance Constructor
+		//
+		Entry(__int64 bitoffset, int bitlength, __int64 position, int length);
+
+		//-------------------------------------------------------------------
+		// Fields
+
+		initonly __int64			BitOffset;			// Compressed data bit offset
+		initonly int				BitLength;			// Compressed data length in bits
+		initonly __int64			Position;			// Decompressed data offset
+		initonly int				Length;				// Decompressed data length
+	};
+
+	// Instance Constructor
+	//
+	Bzip2Index(List<Entry^>^ entries);
+
+	//-----------------------------------------------------------------------
+	// Internal Member Functions
+
+	// Find
+	//
+	// Locates the index of the entry that contains a decompressed data offset
+	int Find(__int64 position);
+
+	//-----------------------------------------------------------------------
+	// Internal Properties
+
+	// default[int]
+	//
+	// Gets the entry at the specified index
+	property Entry^ default[int]
+	{
+		Entry^ get(int index);
+	}
+
+private:
+
+	// MAGIC
+	//
+	// Signature at the start of a serialized index ("BZIX")
+	static const unsigned int MAGIC = 0x58495A42;
+
+	// VERSION
+	//
+	// Version of the serialized index format
+	static const int VERSION = 1;
+
+	// WINDOW_SIZE
+	//
+	// Size of the compressed data window used to locate blocks, in bytes
+	static const int WINDOW_SIZE = (8 << 20);
+
+	//-----------------------------------------------------------------------
+	// Private Member Functions
+
+	// FillWindow (static)
+	//
+	// Ensures that a range of the stream is available in the compressed data window
+	static bool FillWindow(Stream^ stream, array<unsigned __int8>^% window, __int64% windowbase, int% windowlen, __int64 position, int length);
+
+	// ReadWindow (static)
+	//
+	// Reads more compressed data into the compressed data window
+	static bool ReadWindow(Stream^ stream, array<unsigned __int8>^% window, __int64% windowbase, int% windowlen, __int64 retain);
+
+	//-----------------------------------------------------------------------
+	// Member Variables
+
+	initonly List<Entry^>^		m_entries;			// Index entries
+	initonly __int64			m_length;			// Decompressed stream length
+};
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
+
+#endif	// __BZIP2INDEX_H_
@@ -88,9 +88,65 @@ Bzip2Reader::Bzip2Reader(Stream^ stream) : Bzip2Reader(stream, false)
 //	stream		- The stream the compressed or decompressed data is written to
 //	leaveopen	- Flag to leave the base stream open after disposal
 
-Bzip2Reader::Bzip2Reader(Stream^ stream, bool leaveopen) : m_disposed(false), m_stream(stream), m_leaveopen(leaveopen), m_inpos(0), m_finished(false)
+Bzip2Reader::Bzip2Reader(Stream^ stream, bool leaveopen) : Bzip2Reader(stream, 1, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Reader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	index		- Random access index of the compressed data
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+Bzip2Reader::Bzip2Reader(Stream^ stream, Bzip2Index^ index, bool leaveopen) : Bzip2Reader(stream, 1, 0, leaveopen)
+{
+	if(Object::ReferenceEquals(index, nullptr)) throw gcnew ArgumentNullException("index");
+	if(!stream->CanSeek) throw gcnew ArgumentException("The base stream must support seeking", "stream");
+
+	// Block offsets in the index are relative to the current position of the base stream
+	m_index = index;
+	m_basepos = stream->Position;
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Reader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	threads		- Number of threads to use for decompression (zero = processor count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+Bzip2Reader::Bzip2Reader(Stream^ stream, int threads, bool leaveopen) : Bzip2Reader(stream, threads, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Reader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	threads		- Number of threads to use for decompression (zero = processor count)
+//	maxpending	- Maximum number of blocks decoded ahead (zero = twice the thread count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+Bzip2Reader::Bzip2Reader(Stream^ stream, int threads, int maxpending, bool leaveopen) : m_disposed(false), m_stream(stream), 
+	m_leaveopen(leaveopen), m_inpos(0), m_finished(false), m_outbase(0), m_outpos(0), m_outavail(0), m_windowbase(0), m_windowlen(0), 
+	m_endofstream(false), m_scanbit(0), m_candidate(-1), m_next(0), m_instream(false), m_streamcrc(0), 
+	m_basepos(0), m_position(0), m_outentry(-1)
 {
 	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+	if(threads < 0) throw gcnew ArgumentOutOfRangeException("threads");
+	if(maxpending < 0) throw gcnew ArgumentOutOfRangeException("maxpending");
+
+	// Blocks can be located by their magic numbers and decoded in parallel; zero threads indicates
+	// the processor count and zero pending blocks indicates twice the thread count
+	if(threads == 0) threads = Environment::ProcessorCount;
+	if(threads > 1) m_pending = gcnew TaskQueue<Block^>(threads, (maxpending == 0) ? threads * 2 : maxpending);
 
 	// Allocate and initialize the unmanaged bz_stream structure
 	try { m_bzstream = new bz_stream; memset(m_bzstream, 0, sizeof(bz_stream)); }
@@ -110,6 +166,9 @@ Bzip2Reader::Bzip2Reader(Stream^ stream, bool leaveopen) : m_disposed(false), m_
 Bzip2Reader::~Bzip2Reader()
 {
 	if(m_disposed) return;
+
+	// Wait for and discard any blocks still being decoded
+	if(m_pending) delete m_pending;
 	
 	// Optionally dispose of the base stream
 	if(!m_leaveopen) delete m_stream;
@@ -165,7 +224,7 @@ bool Bzip2Reader::CanRead::get(void)
 bool Bzip2Reader::CanSeek::get(void)
 {
 	CHECK_DISPOSED(m_disposed);
-	return false;
+	return (m_index != nullptr);
 }
 
 //---------------------------------------------------------------------------
@@ -179,6 +238,192 @@ bool Bzip2Reader::CanWrite::get(void)
 	return false;
 }
 
+//---------------------------------------------------------------------------
+// Bzip2Reader::DecodeBlock (internal, static)
+//
+// Decodes a single compressed block by wrapping it in a synthetic stream
+//
+// Arguments:
+//
+//	state		- Block instance to be decoded
+
+Bzip2Reader::Block^ Bzip2Reader::DecodeBlock(Object^ state)
+{
+	bz_stream					bzstream;		// Local decompression stream state
+
+	Block^ block = safe_cast<Block^>(state);
+
+	// libbzip2 can only decode complete streams, so the block is wrapped in a synthetic stream that
+	// consists of a header, the block shifted to a byte boundary and an end of stream marker whose
+	// combined CRC is the block CRC; the decoder then verifies the block CRC for us
+	__int64 start = block->StartBit - (block->WindowBase * 8);
+	__int64 length = block->EndBit - block->StartBit;
+	if(length < 80) return block;
+
+	array<unsigned __int8>^ in = gcnew array<unsigned __int8>(4 + static_cast<int>((length + 80 + 7) / 8));
+	in[0] = 'B'; in[1] = 'Z'; in[2] = 'h'; in[3] = '9';
+
+	int offset = static_cast<int>(start >> 3);
+	int shift = static_cast<int>(start & 7);
+	int count = static_cast<int>((length + 7) / 8);
+
+	for(int index = 0; index < count; index++) {
+
+		int value = block->Window[offset + index] << shift;
+		if((shift > 0) && (offset + index + 1 < block->Window->Length)) value |= block->Window[offset + index + 1] >> (8 - shift);
+		in[4 + index] = static_cast<unsigned __int8>(value);
+	}
+
+	// The block CRC immediately follows the block magic number
+	block->Checksum = static_cast<unsigned int>(ReadBits(block->Window, start + 48, 32));
+
+	// Append the end of stream marker and CRC immediately after the block data
+	__int64 bit = 32 + length;
+	unsigned __int64 trailer[] = { STREAM_END_MAGIC, block->Checksum };
+	int bits[] = { 48, 32 };
+
+	for(int field = 0; field < 2; field++) {
+
+		for(int index = bits[field] - 1; index >= 0; index--, bit++) {
+
+			int pos = static_cast<int>(bit >> 3);
+			int mask = 0x80 >> static_cast<int>(bit & 7);
+			in[pos] = static_cast<unsigned __int8>(((trailer[field] >> index) & 1) ? (in[pos] | mask) : (in[pos] & ~mask));
+		}
+	}
+
+	memset(&bzstream, 0, sizeof(bz_stream));
+	int result = BZ2_bzDecompressInit(&bzstream, 0, 0);
+	if(result != BZ_OK) throw gcnew Bzip2Exception(result);
+
+	try {
+
+		pin_ptr<unsigned __int8> pinin = &in[0];
+		bzstream.next_in = reinterpret_cast<char*>(pinin);
+		bzstream.avail_in = in->Length;
+
+		// Start with an output buffer proportional to the input, it's grown as needed up to the limit
+		array<unsigned __int8>^ out = gcnew array<unsigned __int8>(Math::Min(PARALLEL_BLOCK_LIMIT, Math::Max(BUFFER_SIZE, in->Length * 4)));
+
+		do {
+
+			// Grow the output buffer if it has been filled, unless it's already at the limit
+			if(static_cast<int>(bzstream.total_out_lo32) == out->Length) {
+
+				if(out->Length == PARALLEL_BLOCK_LIMIT) break;
+				Array::Resize<unsigned __int8>(out, Math::Min(PARALLEL_BLOCK_LIMIT, out->Length * 2));
+			}
+
+			// The output buffer may have moved, reset the pointer based on the total output
+			pin_ptr<unsigned __int8> pinout = &out[0];
+			bzstream.next_out = reinterpret_cast<char*>(&pinout[bzstream.total_out_lo32]);
+			bzstream.avail_out = out->Length - static_cast<int>(bzstream.total_out_lo32);
+
+			result = BZ2_bzDecompress(&bzstream);
+
+		} while(result == BZ_OK);
+
+		// Only a block that decoded through the synthetic end of stream marker is complete; a false
+		// positive magic number, a truncated block or a CRC mismatch leaves it incomplete
+		if(result == BZ_STREAM_END) {
+
+			block->Complete = true;
+			block->Output = out;
+			block->OutputLength = static_cast<int>(bzstream.total_out_lo32);
+		}
+	}
+
+	finally { BZ2_bzDecompressEnd(&bzstream); }
+
+	return block;
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Reader::DecodeEntry (private)
+//
+// Decodes a single block located by the index
+//
+// Arguments:
+//
+//	entry		- Index entry to be decoded
+
+array<unsigned __int8>^ Bzip2Reader::DecodeEntry(Bzip2Index::Entry^ entry)
+{
+	// Read the bytes that contain the block, which starts and ends at arbitrary bit offsets
+	__int64 start = entry->BitOffset >> 3;
+	array<unsigned __int8>^ in = gcnew array<unsigned __int8>(static_cast<int>(((entry->BitOffset + entry->BitLength + 7) >> 3) - start));
+
+	m_stream->Position = m_basepos + start;
+
+	int read = 0, next = 0;
+	while((read < in->Length) && ((next = m_stream->Read(in, read, in->Length - read)) > 0)) read += next;
+	if(read < in->Length) throw gcnew InvalidDataException();
+
+	// The block must decode and produce exactly the length recorded in the index
+	Block^ block = DecodeBlock(gcnew Block(in, start, entry->BitOffset, entry->BitOffset + entry->BitLength, false));
+	if((!block->Complete) || (block->OutputLength != entry->Length)) throw gcnew Bzip2Exception(BZ_DATA_ERROR);
+
+	return block->Output;
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Reader::FillWindow (private)
+//
+// Ensures that a range of the stream is available in the read-ahead window
+//
+// Arguments:
+//
+//	position	- Stream offset of the first byte required
+//	length		- Number of bytes required
+
+bool Bzip2Reader::FillWindow(__int64 position, int length)
+{
+	// Everything from the next block to be returned is kept when reading more data
+	while(m_windowbase + m_windowlen < position + length) {
+
+		if((m_endofstream) || (!ReadWindow(m_next >> 3))) return false;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Reader::FindMarker (internal, static)
+//
+// Locates the next block or end of stream magic number in a window
+//
+// Arguments:
+//
+//	window		- Compressed data window
+//	length		- Length of the data in the window
+//	bit			- Window bit offset at which to start searching
+//	final		- Set to true if the marker is an end of stream marker
+
+__int64 Bzip2Reader::FindMarker(array<unsigned __int8>^ window, int length, __int64 bit, bool% final)
+{
+	unsigned __int64			value = 0;		// Bits read from the window
+
+	// Shift the window into a 64-bit value one byte at a time and check each of the 8 bit
+	// offsets that end in that byte; a marker is only reported if its 32-bit CRC is also available
+	for(int index = static_cast<int>(bit >> 3); index < length; index++) {
+
+		value = (value << 8) | window[index];
+
+		for(int shift = 7; shift >= 0; shift--) {
+
+			__int64 start = (static_cast<__int64>(index + 1) * 8) - 48 - shift;
+			if(start < bit) continue;
+			if(start + 80 > static_cast<__int64>(length) * 8) return -1;
+
+			unsigned __int64 magic = (value >> shift) & 0xFFFFFFFFFFFF;
+			if(magic == BLOCK_MAGIC) { final = false; return start; }
+			if(magic == STREAM_END_MAGIC) { final = true; return start; }
+		}
+	}
+
+	return -1;
+}
+
 //---------------------------------------------------------------------------
 // Bzip2Reader::Flush
 //
@@ -202,7 +447,10 @@ void Bzip2Reader::Flush(void)
 __int64 Bzip2Reader::Length::get(void)
 {
 	CHECK_DISPOSED(m_disposed);
-	throw gcnew NotSupportedException();
+
+	// The length of the stream is only known when there is an index
+	if(!m_index) throw gcnew NotSupportedException();
+	return m_index->Length;
 }
 
 //---------------------------------------------------------------------------
@@ -215,7 +463,9 @@ __int64 Bzip2Reader::Position::get(void)
 	CHECK_DISPOSED(m_disposed);
 
 	msclr::lock lock(m_lock);
-	return static_cast<__int64>(m_bzstream->total_out_hi32) << 32 | m_bzstream->total_out_lo32;
+
+	if(m_index) return m_position;
+	return m_outbase + (static_cast<__int64>(m_bzstream->total_out_hi32) << 32 | m_bzstream->total_out_lo32);
 }
 
 //---------------------------------------------------------------------------
@@ -225,10 +475,52 @@ __int64 Bzip2Reader::Position::get(void)
 
 void Bzip2Reader::Position::set(__int64 value)
 {
-	UNREFERENCED_PARAMETER(value);
-
 	CHECK_DISPOSED(m_disposed);
-	throw gcnew NotSupportedException();
+
+	if(value < 0) throw gcnew ArgumentOutOfRangeException("value");
+	Seek(value, SeekOrigin::Begin);
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Reader::QueueBlocks (private)
+//
+// Scans the read-ahead window and queues candidate blocks for decoding
+//
+// Arguments:
+//
+//	NONE
+
+void Bzip2Reader::QueueBlocks(void)
+{
+	while(!m_pending->IsFull) {
+
+		// Scan the window for the next block or end of stream magic number
+		bool final = false;
+		__int64 bit = Math::Max(m_scanbit, m_next) - (m_windowbase * 8);
+		__int64 marker = FindMarker(m_window, m_windowlen, bit, final);
+
+		if(marker >= 0) {
+
+			marker += m_windowbase * 8;
+
+			// Finding a marker ends the previous candidate; candidates before the next block
+			// to be returned no longer need to be decoded
+			if(m_candidate >= m_next) 
+				m_pending->Enqueue(gcnew Func<Object^, Block^>(&Bzip2Reader::DecodeBlock), gcnew Block(m_window, m_windowbase, m_candidate, marker, final));
+
+			m_candidate = (final) ? -1 : marker;
+			m_scanbit = marker + 1;
+			continue;
+		}
+
+		// Nothing was found in the remainder of the window; only the last 80 bits need to be scanned again
+		m_scanbit = Math::Max(m_scanbit, ((m_windowbase + m_windowlen) * 8) - 79);
+
+		// Read more data into the window, keeping everything from the next block to be returned
+		if((!m_endofstream) && (ReadWindow(m_next >> 3))) continue;
+
+		break;
+	}
 }
 
 //---------------------------------------------------------------------------
@@ -256,6 +548,134 @@ int Bzip2Reader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 	// If there is no buffer to read into or the stream is already done, return zero
 	if((count == 0) || (m_finished)) return 0;
 
+	// With an index, the block that contains the current position is located and decoded by itself
+	if(m_index) {
+
+		int read = 0;						// Total bytes read from the stream
+
+		while(count > 0) {
+
+			if(m_outavail == 0) {
+
+				if(m_position >= m_index->Length) break;
+
+				// Locate the block that contains the current position, the previously decoded block is retained
+				int entry = m_index->Find(m_position);
+				if(entry != m_outentry) { m_out = DecodeEntry(m_index[entry]); m_outentry = entry; }
+
+				m_outpos = static_cast<int>(m_position - m_index[entry]->Position);
+				m_outavail = m_index[entry]->Length - m_outpos;
+			}
+
+			// Copy data from the decoded block into the output buffer
+			int next = Math::Min(m_outavail, count);
+			Array::Copy(m_out, m_outpos, buffer, offset, next);
+
+			m_outpos += next;				// Move offset into the decoded block
+			m_outavail -= next;				// Reduce length of the decoded block
+			m_position += next;				// Move the stream position
+			offset += next;					// Move offset into the output buffer
+			count -= next;					// Decrement the amount of data still to read
+			read += next;					// Increment the amount of data read
+		}
+
+		return read;
+	}
+
+	// Parallel decompression decodes blocks ahead of the reader and returns them in order
+	if(m_pending) {
+
+		int read = 0;						// Total bytes read from the stream
+
+		while(count > 0) {
+
+			// Copy data from the current block into the output buffer
+			if(m_outavail > 0) {
+
+				int next = Math::Min(m_outavail, count);
+				Array::Copy(m_out, m_outpos, buffer, offset, next);
+
+				m_outpos += next;			// Move offset into the block data
+				m_outavail -= next;			// Decrement the amount of block data
+				m_outbase += next;			// Increment the stream position
+				offset += next;				// Move offset into the output buffer
+				count -= next;				// Decrement the amount of data still to read
+				read += next;				// Increment the amount of data read
+				continue;
+			}
+
+			m_out = nullptr;				// Release the current block data
+
+			// Each stream starts with a byte-aligned header ("BZh" and the block size); anything
+			// other than another stream header after the first stream is ignored
+			if(!m_instream) {
+
+				__int64 position = m_next >> 3;
+				bool header = FillWindow(position, 4);
+
+				int pos = static_cast<int>(position - m_windowbase);
+				if((header) && ((m_window[pos] != 'B') || (m_window[pos + 1] != 'Z') || (m_window[pos + 2] != 'h') || 
+					(m_window[pos + 3] < '1') || (m_window[pos + 3] > '9'))) header = false;
+
+				if(!header) {
+
+					// The first stream must be present and valid, an empty base stream is invalid
+					if((m_next == 0) && (m_windowlen < 4)) throw gcnew InvalidDataException();
+					if(m_next == 0) throw gcnew Bzip2Exception(BZ_DATA_ERROR_MAGIC);
+
+					m_finished = true;
+					break;
+				}
+
+				m_next += 32;
+				m_instream = true;
+				m_streamcrc = 0;
+				continue;
+			}
+
+			// Every block and the end of stream marker are followed by a 32-bit CRC
+			if(!FillWindow(m_next >> 3, 11)) throw gcnew InvalidDataException();
+
+			// The end of stream marker is followed by the combined CRC of all the blocks and padding
+			// to the next byte boundary, where another stream may begin
+			__int64 bit = m_next - (m_windowbase * 8);
+			if(ReadBits(m_window, bit, 48) == STREAM_END_MAGIC) {
+
+				if(ReadBits(m_window, bit + 48, 32) != m_streamcrc) throw gcnew Bzip2Exception(BZ_DATA_ERROR);
+
+				m_next = ((m_next + 80 + 7) >> 3) << 3;
+				m_instream = false;
+				continue;
+			}
+
+			// Keep the decoding queue full and get the next decoded candidate
+			QueueBlocks();
+			if((!m_head) && (!m_pending->IsEmpty)) m_head = m_pending->Dequeue();
+
+			// Candidates before the next block were false positives inside a block already returned
+			if((m_head) && (m_head->StartBit < m_next)) { m_head = nullptr; continue; }
+
+			// The next candidate has to start exactly where the previous block ended; running out of
+			// candidates means the stream was truncated
+			if(!m_head) throw gcnew InvalidDataException();
+			if(m_head->StartBit != m_next) throw gcnew Bzip2Exception(BZ_DATA_ERROR);
+
+			// A candidate that failed to decode may have been cut short by a false positive marker
+			Block^ block = (m_head->Complete) ? m_head : ResolveBlock(m_head);
+			m_head = nullptr;
+
+			m_out = block->Output;
+			m_outpos = 0;
+			m_outavail = block->OutputLength;
+
+			// Combine the block CRC into the stream CRC the same way the encoder does
+			m_streamcrc = ((m_streamcrc << 1) | (m_streamcrc >> 31)) ^ block->Checksum;
+			m_next = block->EndBit;
+		}
+
+		return read;
+	}
+
 	// Pin both the input and output byte arrays in memory
 	pin_ptr<unsigned __int8> pinin = &m_in[0];
 	pin_ptr<unsigned __int8> pinout = &buffer[0];
@@ -281,9 +701,39 @@ int Bzip2Reader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 		int result = BZ2_bzDecompress(m_bzstream);
 		m_inpos = (uintptr_t(m_bzstream->next_in) - uintptr_t(pinin));
 
-		// BZ_STREAM_END indicates that there is no more data to decompress, but bzip
-		// will not return it more than once -- set a flag to prevent more attempts
-		if(result == BZ_STREAM_END) { m_finished = true; break; }
+		// BZ_STREAM_END indicates the end of a bzip2 stream, but multiple streams can be concatenated
+		// together; if there is no more data or it's not another stream, set a flag to prevent more attempts
+		if(result == BZ_STREAM_END) {
+
+			// Each stream starts with a byte-aligned header ("BZh" and the block size); move any remaining
+			// input to the start of the buffer so that the entire header can be checked
+			if(m_bzstream->avail_in < 4) {
+
+				Array::Copy(m_in, static_cast<int>(m_inpos), m_in, 0, static_cast<int>(m_bzstream->avail_in));
+				m_inpos = 0;
+
+				while(m_bzstream->avail_in < 4) {
+
+					int read = m_stream->Read(m_in, m_bzstream->avail_in, BUFFER_SIZE - m_bzstream->avail_in);
+					if(read == 0) break;
+
+					m_bzstream->avail_in += read;
+				}
+			}
+
+			// Anything other than another stream header after the end of a stream is ignored
+			int pos = static_cast<int>(m_inpos);
+			if((m_bzstream->avail_in < 4) || (m_in[pos] != 'B') || (m_in[pos + 1] != 'Z') || (m_in[pos + 2] != 'h') || 
+				(m_in[pos + 3] < '1') || (m_in[pos + 3] > '9')) { m_finished = true; break; }
+
+			// libbzip2 cannot reset a decompression stream, it has to be reinitialized for the next one
+			m_outbase += static_cast<__int64>(m_bzstream->total_out_hi32) << 32 | m_bzstream->total_out_lo32;
+
+			result = BZ2_bzDecompressEnd(m_bzstream);
+			if(result == BZ_OK) result = BZ2_bzDecompressInit(m_bzstream, 0, 0);
+			if(result != BZ_OK) throw gcnew Bzip2Exception(result);
+		}
+
 		else if(result != BZ_OK) throw gcnew Bzip2Exception(result);
 
 	} while(m_bzstream->avail_out > 0);
@@ -291,6 +741,92 @@ int Bzip2Reader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 	return (count - m_bzstream->avail_out);
 }
 
+//---------------------------------------------------------------------------
+// Bzip2Reader::ReadBits (internal, static)
+//
+// Reads a big-endian bit field from a window
+//
+// Arguments:
+//
+//	window		- Compressed data window
+//	bit			- Window bit offset of the field
+//	count		- Number of bits to read (up to 64)
+
+unsigned __int64 Bzip2Reader::ReadBits(array<unsigned __int8>^ window, __int64 bit, int count)
+{
+	unsigned __int64 value = 0;
+
+	for(__int64 index = bit; index < bit + count; index++) 
+		value = (value << 1) | ((window[static_cast<int>(index >> 3)] >> (7 - static_cast<int>(index & 7))) & 1);
+
+	return value;
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Reader::ReadWindow (private)
+//
+// Reads more compressed data into the read-ahead window
+//
+// Arguments:
+//
+//	retain		- Stream offset of the first window byte that must be retained
+
+bool Bzip2Reader::ReadWindow(__int64 retain)
+{
+	int keep = m_windowlen - static_cast<int>(retain - m_windowbase);
+	if(keep >= PARALLEL_WINDOW_SIZE) return false;
+
+	// Queued blocks hold a reference to the window they were created from, so rather than shifting
+	// the data in place a new window is created that starts with the retained data
+	array<unsigned __int8>^ window = gcnew array<unsigned __int8>(PARALLEL_WINDOW_SIZE);
+	if(keep > 0) Array::Copy(m_window, static_cast<int>(retain - m_windowbase), window, 0, keep);
+
+	// Fill the remainder of the window from the base stream
+	int read = 0, next = 0;
+	while((keep + read < window->Length) && ((next = m_stream->Read(window, keep + read, window->Length - keep - read)) > 0)) read += next;
+	if(keep + read < window->Length) m_endofstream = true;
+
+	m_window = window;
+	m_windowbase = retain;
+	m_windowlen = keep + read;
+
+	return (read > 0);
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Reader::ResolveBlock (private)
+//
+// Decodes a block whose end marker was a false positive
+//
+// Arguments:
+//
+//	block		- Candidate block that could not be decoded
+
+Bzip2Reader::Block^ Bzip2Reader::ResolveBlock(Block^ block)
+{
+	__int64 end = block->EndBit;
+
+	// A magic number can occur by chance inside the compressed data, which would cut the actual
+	// block short; extend the block to each following marker in turn until it can be decoded
+	while(!block->Complete) {
+
+		bool final = false;
+		__int64 marker = FindMarker(m_window, m_windowlen, end + 1 - (m_windowbase * 8), final);
+
+		if(marker < 0) {
+
+			// Read more data into the window if possible, otherwise the block is corrupt
+			if((!m_endofstream) && (ReadWindow(m_next >> 3))) continue;
+			throw gcnew Bzip2Exception(BZ_DATA_ERROR);
+		}
+
+		end = marker + (m_windowbase * 8);
+		block = DecodeBlock(gcnew Block(m_window, m_windowbase, block->StartBit, end, final));
+	}
+
+	return block;
+}
+
 //---------------------------------------------------------------------------
 // Bzip2Reader::Seek
 //
@@ -303,11 +839,26 @@ int Bzip2Reader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 
 __int64 Bzip2Reader::Seek(__int64 offset, SeekOrigin origin)
 {
-	UNREFERENCED_PARAMETER(offset);
-	UNREFERENCED_PARAMETER(origin);
-
 	CHECK_DISPOSED(m_disposed);
-	throw gcnew NotSupportedException();
+
+	// Seeking is only supported when there is an index
+	if(!m_index) throw gcnew NotSupportedException();
+
+	msclr::lock lock(m_lock);
+
+	// Convert the offset into an absolute position within the decompressed data
+	__int64 position = offset;
+	if(origin == SeekOrigin::Current) position += m_position;
+	else if(origin == SeekOrigin::End) position += m_index->Length;
+	else if(origin != SeekOrigin::Begin) throw gcnew ArgumentOutOfRangeException("origin");
+
+	if(position < 0) throw gcnew IOException("An attempt was made to move the position before the beginning of the stream");
+
+	// The block that contains the new position is located on the next read
+	m_position = position;
+	m_outavail = 0;
+
+	return m_position;
 }
 
 //---------------------------------------------------------------------------
@@ -348,6 +899,22 @@ void Bzip2Reader::Write(array<unsigned __int8>^ buffer, int offset, int count)
 	throw gcnew NotSupportedException();
 }
 
+//---------------------------------------------------------------------------
+// Bzip2Reader::Block Constructor
+//
+// Arguments:
+//
+//	window		- Compressed data window
+//	windowbase	- Stream offset of the compressed data window
+//	startbit	- Stream bit offset of the block magic number
+//	endbit		- Stream bit offset of the following marker
+//	final		- Flag if the following marker ends the stream
+
+Bzip2Reader::Block::Block(array<unsigned __int8>^ window, __int64 windowbase, __int64 startbit, __int64 endbit, bool final) : 
+	Window(window), WindowBase(windowbase), StartBit(startbit), EndBit(endbit), Final(final), Complete(false), Checksum(0), OutputLength(0)
+{
+}
+
 //---------------------------------------------------------------------------
 
 } // zuki::io::compression
@@ -65,6 +65,8 @@
 #pragma once
 
 #include <bzlib.h>
+#include "Bzip2Index.h"
+#include "TaskQueue.h"
 
 #pragma warning(push, 4)				// Enable maximum compiler warnings
 
@@ -87,6 +89,9 @@ public:
 	//
 	Bzip2Reader(Stream^ stream);
 	Bzip2Reader(Stream^ stream, bool leaveopen);
+	Bzip2Reader(Stream^ stream, Bzip2Index^ index, bool leaveopen);
+	Bzip2Reader(Stream^ stream, int threads, bool leaveopen);
+	Bzip2Reader(Stream^ stream, int threads, int maxpending, bool leaveopen);
 
 	//-----------------------------------------------------------------------
 	// Member Functions
@@ -168,6 +173,61 @@ public:
 		void set(__int64 value) override;
 	}
 
+internal:
+
+	// Block
+	//
+	// Compressed block to be decoded independently of the stream
+	ref class Block
+	{
+	public:
+
+		// Instance Constructor
+		//
+		Block(array<unsigned __int8>^ window, __int64 windowbase, __int64 startbit, __int64 endbit, bool final);
+
+		//-------------------------------------------------------------------
+		// Fields
+
+		initonly array<unsigned __int8>^	Window;			// Compressed data window
+		initonly __int64					WindowBase;		// Stream offset of the window
+		initonly __int64					StartBit;		// Stream bit offset of the block
+		initonly __int64					EndBit;			// Stream bit offset of the next marker
+		initonly bool						Final;			// Flag if the next marker ends the stream
+		bool								Complete;		// Flag if block was fully decoded
+		unsigned int						Checksum;		// Block CRC
+		array<unsigned __int8>^				Output;			// Decompressed block data
+		int									OutputLength;	// Length of the decompressed data
+	};
+
+	// BLOCK_MAGIC
+	//
+	// 48-bit magic number (BCD pi) at the start of each compressed block
+	static const unsigned __int64 BLOCK_MAGIC = 0x314159265359;
+
+	// STREAM_END_MAGIC
+	//
+	// 48-bit magic number (BCD sqrt(pi)) at the end of each stream
+	static const unsigned __int64 STREAM_END_MAGIC = 0x177245385090;
+
+	//-----------------------------------------------------------------------
+	// Internal Member Functions
+
+	// DecodeBlock (static)
+	//
+	// Decodes a single compressed block by wrapping it in a synthetic stream
+	static Block^ DecodeBlock(Object^ state);
+
+	// FindMarker (static)
+	//
+	// Locates the next block or end of stream magic number in a window
+	static __int64 FindMarker(array<unsigned __int8>^ window, int length, __int64 bit, bool% final);
+
+	// ReadBits (static)
+	//
+	// Reads a big-endian bit field from a window
+	static unsigned __int64 ReadBits(array<unsigned __int8>^ window, __int64 bit, int count);
+
 private:
 
 	// BUFFER_SIZE
@@ -175,11 +235,49 @@ private:
 	// Size of the local input/output buffer, in bytes
 	static const int BUFFER_SIZE = 65536;
 
+	// PARALLEL_BLOCK_LIMIT
+	//
+	// Maximum decompressed size of a block decoded in parallel, in bytes
+	static const int PARALLEL_BLOCK_LIMIT = (64 << 20);
+
+	// PARALLEL_WINDOW_SIZE
+	//
+	// Size of the compressed data read-ahead window, in bytes
+	static const int PARALLEL_WINDOW_SIZE = (8 << 20);
+
 	// Destructor / Finalizer
 	//
 	~Bzip2Reader();
 	!Bzip2Reader();
 
+	//-----------------------------------------------------------------------
+	// Private Member Functions
+
+	// DecodeEntry
+	//
+	// Decodes a single block located by the index
+	array<unsigned __int8>^ DecodeEntry(Bzip2Index::Entry^ entry);
+
+	// FillWindow
+	//
+	// Ensures that a range of the stream is available in the read-ahead window
+	bool FillWindow(__int64 position, int length);
+
+	// QueueBlocks
+	//
+	// Scans the read-ahead window and queues candidate blocks for decoding
+	void QueueBlocks(void);
+
+	// ReadWindow
+	//
+	// Reads more compressed data into the read-ahead window
+	bool ReadWindow(__int64 retain);
+
+	// ResolveBlock
+	//
+	// Decodes a block whose end marker was a false positive
+	Block^ ResolveBlock(Block^ block);
+
 	//-----------------------------------------------------------------------
 	// Member Variables
 
@@ -189,7 +287,26 @@ private:
 	array<unsigned __int8>^			m_in;			// BZIP2 stream buffer
 	size_t							m_inpos;		// Current position in the buffer
 	bool							m_finished;		// Flag if operation is finished
+	__int64							m_outbase;		// Output from previous streams
 	bz_stream*						m_bzstream;		// BZIP2 stream state information
+	TaskQueue<Block^>^				m_pending;		// Pending block decodes
+	Block^							m_head;			// Next dequeued block
+	array<unsigned __int8>^			m_out;			// Decompressed data being returned
+	int								m_outpos;		// Position within the decompressed data
+	int								m_outavail;		// Available decompressed data
+	array<unsigned __int8>^			m_window;		// Compressed data read-ahead window
+	__int64							m_windowbase;	// Stream offset of the window
+	int								m_windowlen;	// Length of the data in the window
+	bool							m_endofstream;	// Flag if base stream is exhausted
+	__int64							m_scanbit;		// Next bit offset to scan for a marker
+	__int64							m_candidate;	// Block bit offset not yet queued
+	__int64							m_next;			// Bit offset of the next block
+	bool							m_instream;		// Flag if a stream header was read
+	unsigned int					m_streamcrc;	// Combined CRC of the stream blocks
+	Bzip2Index^						m_index;		// Optional random access index
+	__int64							m_basepos;		// Base stream offset of the index
+	__int64							m_position;		// Position within decompressed data
+	int								m_outentry;		// Index entry held in m_out
 
 	Object^	m_lock = gcnew Object();		// Synchronization object
 };
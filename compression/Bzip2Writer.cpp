@@ -77,7 +77,7 @@ namespace zuki::io::compression {
 //	stream		- The stream the compressed data is written to
 
 Bzip2Writer::Bzip2Writer(Stream^ stream) : 
-	Bzip2Writer(stream, Bzip2CompressionLevel::Default, Bzip2WorkFactor::Default, DEFAULT_BUFFER_SIZE, false)
+	Bzip2Writer(stream, Bzip2CompressionLevel::Default, Bzip2WorkFactor::Default, DEFAULT_BUFFER_SIZE, 1, 0, false)
 {
 }
 
@@ -90,7 +90,7 @@ Bzip2Writer::Bzip2Writer(Stream^ stream) :
 //	level		- Indicates whether to emphasize speed or compression efficiency
 
 Bzip2Writer::Bzip2Writer(Stream^ stream, Compression::CompressionLevel level) : 
-	Bzip2Writer(stream, Bzip2CompressionLevel(level), Bzip2WorkFactor::Default, DEFAULT_BUFFER_SIZE, false)
+	Bzip2Writer(stream, Bzip2CompressionLevel(level), Bzip2WorkFactor::Default, DEFAULT_BUFFER_SIZE, 1, 0, false)
 {
 }
 
@@ -103,7 +103,7 @@ Bzip2Writer::Bzip2Writer(Stream^ stream, Compression::CompressionLevel level) :
 //	leaveopen	- Flag to leave the base stream open after disposal
 
 Bzip2Writer::Bzip2Writer(Stream^ stream, bool leaveopen) : 
-	Bzip2Writer(stream, Bzip2CompressionLevel::Default, Bzip2WorkFactor::Default, DEFAULT_BUFFER_SIZE, leaveopen)
+	Bzip2Writer(stream, Bzip2CompressionLevel::Default, Bzip2WorkFactor::Default, DEFAULT_BUFFER_SIZE, 1, 0, leaveopen)
 {
 }
 
@@ -117,7 +117,22 @@ Bzip2Writer::Bzip2Writer(Stream^ stream, bool leaveopen) :
 //	leaveopen	- Flag to leave the base stream open after disposal
 
 Bzip2Writer::Bzip2Writer(Stream^ stream, Compression::CompressionLevel level, bool leaveopen) : 
-	Bzip2Writer(stream, Bzip2CompressionLevel(level), Bzip2WorkFactor::Default, DEFAULT_BUFFER_SIZE, leaveopen)
+	Bzip2Writer(stream, Bzip2CompressionLevel(level), Bzip2WorkFactor::Default, DEFAULT_BUFFER_SIZE, 1, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// Bzip2Writer Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed or decompressed data is written to
+//	level		- Indicates the level of compression to use
+//	threads		- Number of threads to use for compression (zero = processor count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+Bzip2Writer::Bzip2Writer(Stream^ stream, Compression::CompressionLevel level, int threads, bool leaveopen) : 
+	Bzip2Writer(stream, Bzip2CompressionLevel(level), Bzip2WorkFactor::Default, DEFAULT_BUFFER_SIZE, threads, 0, leaveopen)
 {
 }
 
@@ -130,13 +145,30 @@ Bzip2Writer::Bzip2Writer(Stream^ stream, Compression::CompressionLevel level, bo
 //	level			- Indicates the level of compression to use
 //	workfactor		- Indicates the bzip2 work factor to use
 //	buffersize		- Indicates the size of the compression buffer
+//	threads			- Number of threads to use for compression (zero = processor count)
+//	maxpending		- Maximum number of blocks in flight (zero = twice the thread count)
 //	leaveopen		- Flag to leave the base stream open after disposal
 
-Bzip2Writer::Bzip2Writer(Stream^ stream, Bzip2CompressionLevel level, Bzip2WorkFactor workfactor, int buffersize, bool leaveopen) : 
-	m_disposed(false), m_stream(stream), m_leaveopen(leaveopen), m_buffersize(buffersize)
+Bzip2Writer::Bzip2Writer(Stream^ stream, Bzip2CompressionLevel level, Bzip2WorkFactor workfactor, int buffersize, int threads, int maxpending, 
+	bool leaveopen) : m_disposed(false), m_stream(stream), m_leaveopen(leaveopen), m_buffersize(buffersize), m_bzstream(nullptr), 
+	m_level(level), m_workfactor(workfactor), m_inpos(0), m_totalin(0)
 {
 	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
 	if(buffersize <= 0) throw gcnew ArgumentOutOfRangeException("buffersize");
+	if(threads < 0) throw gcnew ArgumentOutOfRangeException("threads");
+	if(maxpending < 0) throw gcnew ArgumentOutOfRangeException("maxpending");
+
+	// Zero threads indicates that the number of processors should be used
+	if(threads == 0) threads = Environment::ProcessorCount;
+
+	// Parallel compression cuts the input at the bzip2 block size for the compression level and
+	// compresses each block as an independent bzip2 stream; concatenated streams are valid bzip2
+	if(threads > 1) {
+
+		m_pending = gcnew TaskQueue<ArraySegment<unsigned __int8>>(threads, (maxpending == 0) ? threads * 2 : maxpending);
+		m_in = gcnew array<unsigned __int8>(m_level * PARALLEL_BLOCK_MULTIPLIER);
+		return;
+	}
 
 	// Allocate and initialize the unmanaged bz_stream structure
 	try { m_bzstream = new bz_stream; memset(m_bzstream, 0, sizeof(bz_stream)); }
@@ -158,27 +190,40 @@ Bzip2Writer::~Bzip2Writer()
 
 	msclr::lock lock(m_lock);
 
-	// Create and pin a local compression buffer
-	array<unsigned __int8>^ out = gcnew array<unsigned __int8>(m_buffersize);
-	pin_ptr<unsigned __int8> pinout = &out[0];
+	// Parallel compression queues the final block and waits for all blocks to be written
+	if(m_pending) {
 
-	// Input is not consumed when finishing the bzip stream
-	m_bzstream->next_in = nullptr;
-	m_bzstream->avail_in = 0;
+		QueueNextBlock(true);
+		WritePendingBlocks(true);
 
-	do {
+		delete m_pending;
+	}
 
-		// Reset the output buffer to point into the managed array
-		m_bzstream->next_out = reinterpret_cast<char*>(pinout);
-		m_bzstream->avail_out = m_buffersize;
+	else {
 
-		// Finish the next block of data in the bzip buffers and write it
-		result = BZ2_bzCompress(m_bzstream, BZ_FINISH);
-		m_stream->Write(out, 0, m_buffersize - m_bzstream->avail_out);
+		// Create and pin a local compression buffer
+		array<unsigned __int8>^ out = gcnew array<unsigned __int8>(m_buffersize);
+		pin_ptr<unsigned __int8> pinout = &out[0];
+
+		// Input is not consumed when finishing the bzip stream
+		m_bzstream->next_in = nullptr;
+		m_bzstream->avail_in = 0;
 
-	} while (result == BZ_FINISH_OK);
+		do {
+
+			// Reset the output buffer to point into the managed array
+			m_bzstream->next_out = reinterpret_cast<char*>(pinout);
+			m_bzstream->avail_out = m_buffersize;
+
+			// Finish the next block of data in the bzip buffers and write it
+			result = BZ2_bzCompress(m_bzstream, BZ_FINISH);
+			m_stream->Write(out, 0, m_buffersize - m_bzstream->avail_out);
+
+		} while (result == BZ_FINISH_OK);
+
+		delete out;							// Dispose of the local buffer
+	}
 
-	delete out;								// Dispose of the local buffer
 	if(!m_leaveopen) delete m_stream;		// Optionally dispose of the base stream
 	
 	this->!Bzip2Writer();
@@ -246,6 +291,39 @@ bool Bzip2Writer::CanWrite::get(void)
 	return m_stream->CanWrite;
 }
 
+//---------------------------------------------------------------------------
+// Bzip2Writer::CompressBlock (private)
+//
+// Compresses a single block of data into an independent bzip2 stream
+//
+// Arguments:
+//
+//	state		- Uncompressed block data as a managed byte array
+
+ArraySegment<unsigned __int8> Bzip2Writer::CompressBlock(Object^ state)
+{
+	char						empty = 0;		// Source for an empty block
+
+	array<unsigned __int8>^ in = safe_cast<array<unsigned __int8>^>(state);
+
+	// The worst case bzip2 expansion is documented as 1% of the input plus 600 bytes
+	array<unsigned __int8>^ out = gcnew array<unsigned __int8>(in->Length + (in->Length / 100) + 600);
+	unsigned int outlen = out->Length;
+
+	// Pin both the input and output buffers in memory
+	pin_ptr<unsigned __int8> pinout = &out[0];
+	pin_ptr<unsigned __int8> pinin = nullptr;
+	if(in->Length > 0) pinin = &in[0];
+
+	// The last block may be empty, libbzip2 still requires a valid source pointer for it
+	char* source = (in->Length > 0) ? reinterpret_cast<char*>(pinin) : &empty;
+
+	int result = BZ2_bzBuffToBuffCompress(reinterpret_cast<char*>(pinout), &outlen, source, in->Length, m_level, 0, m_workfactor);
+	if(result != BZ_OK) throw gcnew Bzip2Exception(result);
+
+	return ArraySegment<unsigned __int8>(out, 0, outlen);
+}
+
 //---------------------------------------------------------------------------
 // Bzip2Writer::Flush
 //
@@ -263,6 +341,15 @@ void Bzip2Writer::Flush(void)
 
 	msclr::lock lock(m_lock);
 
+	// Parallel compression ends the current block early and waits for all blocks to be written
+	if(m_pending) {
+
+		QueueNextBlock(false);
+		WritePendingBlocks(true);
+		m_stream->Flush();
+		return;
+	}
+
 	// Create and pin a local compression buffer
 	array<unsigned __int8>^ out = gcnew array<unsigned __int8>(m_buffersize);
 	pin_ptr<unsigned __int8> pinout = &out[0];
@@ -311,6 +398,8 @@ __int64 Bzip2Writer::Position::get(void)
 	CHECK_DISPOSED(m_disposed);
 
 	msclr::lock lock(m_lock);
+
+	if(m_pending) return m_totalin + m_inpos;
 	return static_cast<__int64>(m_bzstream->total_in_hi32) << 32 | m_bzstream->total_in_lo32;
 }
 
@@ -327,6 +416,37 @@ void Bzip2Writer::Position::set(__int64 value)
 	throw gcnew NotSupportedException();
 }
 
+//---------------------------------------------------------------------------
+// Bzip2Writer::QueueNextBlock (private)
+//
+// Queues the contents of the buffer for compression as a single block
+//
+// Arguments:
+//
+//	last		- Flag if this is the last block of the stream
+
+void Bzip2Writer::QueueNextBlock(bool last)
+{
+	msclr::lock lock(m_lock);
+
+	// If there is nothing in the buffer there is no work to do, unless nothing at all has
+	// been written, in which case an empty bzip2 stream is still generated for the output
+	if((m_inpos == 0) && ((!last) || (m_totalin > 0))) return;
+
+	// A partial block is trimmed to the actual length of the data
+	array<unsigned __int8>^ block = m_in;
+	if(m_inpos < block->Length) Array::Resize<unsigned __int8>(block, m_inpos);
+
+	// Make room in the queue for the block and start compressing it
+	WritePendingBlocks(false);
+	m_pending->Enqueue(gcnew Func<Object^, ArraySegment<unsigned __int8>>(this, &Bzip2Writer::CompressBlock), block);
+	m_totalin += block->Length;
+
+	// The queued buffer now belongs to the worker, a new one is needed for the next block
+	if(Object::ReferenceEquals(block, m_in)) m_in = gcnew array<unsigned __int8>(m_level * PARALLEL_BLOCK_MULTIPLIER);
+	m_inpos = 0;
+}
+
 //---------------------------------------------------------------------------
 // Bzip2Writer::Read
 //
@@ -425,6 +545,24 @@ void Bzip2Writer::Write(array<unsigned __int8>^ buffer, int offset, int count)
 
 	msclr::lock lock(m_lock);
 
+	// Parallel compression buffers the input data and queues it in block-sized chunks
+	if(m_pending) {
+
+		while(count > 0) {
+
+			int next = Math::Min(m_in->Length - m_inpos, count);
+			Array::Copy(buffer, offset, m_in, m_inpos, next);
+
+			m_inpos += next;				// Increment length of buffer
+			offset += next;					// Move offset into the source buffer
+			count -= next;					// Decrement bytes remaining
+
+			if(m_inpos == m_in->Length) QueueNextBlock(false);
+		}
+
+		return;
+	}
+
 	// Create a temporary local buffer to hold the compressed data
 	array<unsigned __int8>^ out = gcnew array<unsigned __int8>(m_buffersize);
 		
@@ -454,6 +592,27 @@ void Bzip2Writer::Write(array<unsigned __int8>^ buffer, int offset, int count)
 	delete out;
 }
 
+//---------------------------------------------------------------------------
+// Bzip2Writer::WritePendingBlocks (private)
+//
+// Writes completed blocks from the compression queue to the base stream
+//
+// Arguments:
+//
+//	all			- Flag to write all pending blocks rather than just make room
+
+void Bzip2Writer::WritePendingBlocks(bool all)
+{
+	msclr::lock lock(m_lock);
+
+	// Wait for the oldest block(s) to finish and write them to the output stream in order
+	while((all) ? !m_pending->IsEmpty : m_pending->IsFull) {
+
+		ArraySegment<unsigned __int8> block = m_pending->Dequeue();
+		m_stream->Write(block.Array, block.Offset, block.Count);
+	}
+}
+
 //---------------------------------------------------------------------------
 
 } // zuki::io::compression
@@ -67,6 +67,7 @@
 #include <bzlib.h>
 #include "Bzip2CompressionLevel.h"
 #include "Bzip2WorkFactor.h"
+#include "TaskQueue.h"
 
 #pragma warning(push, 4)				// Enable maximum compiler warnings
 
@@ -91,6 +92,7 @@ public:
 	Bzip2Writer(Stream^ stream, Compression::CompressionLevel level);
 	Bzip2Writer(Stream^ stream, bool leaveopen);
 	Bzip2Writer(Stream^ stream, Compression::CompressionLevel level, bool leaveopen);
+	Bzip2Writer(Stream^ stream, Compression::CompressionLevel level, int threads, bool leaveopen);
 
 	//-----------------------------------------------------------------------
 	// Member Functions
@@ -186,7 +188,7 @@ internal:
 
 	// Instance Constructor
 	//
-	Bzip2Writer(Stream^ stream, Bzip2CompressionLevel level, Bzip2WorkFactor workfactor, int buffersize, bool leaveopen);
+	Bzip2Writer(Stream^ stream, Bzip2CompressionLevel level, Bzip2WorkFactor workfactor, int buffersize, int threads, int maxpending, bool leaveopen);
 
 private:
 
@@ -195,6 +197,29 @@ private:
 	~Bzip2Writer();
 	!Bzip2Writer();
 
+	// PARALLEL_BLOCK_MULTIPLIER
+	//
+	// Size of each block compressed in parallel per compression level
+	static const int PARALLEL_BLOCK_MULTIPLIER = 100000;
+
+	//-----------------------------------------------------------------------
+	// Private Member Functions
+
+	// CompressBlock
+	//
+	// Compresses a single block of data into an independent bzip2 stream
+	ArraySegment<unsigned __int8> CompressBlock(Object^ state);
+
+	// QueueNextBlock
+	//
+	// Queues the contents of the buffer for compression as a single block
+	void QueueNextBlock(bool last);
+
+	// WritePendingBlocks
+	//
+	// Writes completed blocks from the compression queue to the base stream
+	void WritePendingBlocks(bool all);
+
 	//-----------------------------------------------------------------------
 	// Member Variables
 
@@ -203,6 +228,12 @@ private:
 	bool							m_leaveopen;	// Flag to leave base stream open
 	initonly int					m_buffersize;	// Size of the compression buffer
 	bz_stream*						m_bzstream;		// BZIP2 stream state information
+	initonly int					m_level;		// Compression level
+	initonly int					m_workfactor;	// Compression work factor
+	TaskQueue<ArraySegment<unsigned __int8>>^	m_pending;	// Pending block compressions
+	array<unsigned __int8>^			m_in;			// Parallel input data buffer
+	int								m_inpos;		// Position within the input buffer
+	__int64							m_totalin;		// Total queued input data
 
 	Object^	m_lock = gcnew Object();		// Synchronization object
 };
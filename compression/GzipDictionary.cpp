@@ -0,0 +1,197 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "GzipDictionary.h"
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// GzipDictionary Constructor
+//
+// Arguments:
+//
+//	dictionary	- Preset dictionary data
+
+GzipDictionary::GzipDictionary(array<unsigned __int8>^ dictionary) : m_disposed(false)
+{
+	if(Object::ReferenceEquals(dictionary, nullptr)) throw gcnew ArgumentNullException("dictionary");
+	if(dictionary->Length == 0) throw gcnew ArgumentException("The dictionary must contain at least one byte", "dictionary");
+
+	// Keep a private copy of the data so that the checksum and cached states always match it
+	m_dictionary = safe_cast<array<unsigned __int8>^>(dictionary->Clone());
+
+	pin_ptr<unsigned __int8> pindictionary = &m_dictionary[0];
+	m_id = adler32(adler32(0L, Z_NULL, 0), reinterpret_cast<Bytef const*>(pindictionary), m_dictionary->Length);
+
+	m_deflaters = gcnew Dictionary<int, IntPtr>();
+}
+
+//---------------------------------------------------------------------------
+// GzipDictionary Destructor
+
+GzipDictionary::~GzipDictionary()
+{
+	if(m_disposed) return;
+
+	this->!GzipDictionary();
+	m_disposed = true;
+}
+
+//---------------------------------------------------------------------------
+// GzipDictionary Finalizer
+
+GzipDictionary::!GzipDictionary()
+{
+	if(Object::ReferenceEquals(m_deflaters, nullptr)) return;
+
+	// Release all of the primed deflate stream states
+	for each(IntPtr primed in m_deflaters->Values) {
+
+		z_stream* zstream = reinterpret_cast<z_stream*>(primed.ToPointer());
+		deflateEnd(zstream);
+		delete zstream;
+	}
+
+	m_deflaters->Clear();
+}
+
+//---------------------------------------------------------------------------
+// GzipDictionary::Data::get (internal)
+//
+// Gets a reference to the dictionary data
+
+array<unsigned __int8>^ GzipDictionary::Data::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return m_dictionary;
+}
+
+//---------------------------------------------------------------------------
+// GzipDictionary::DeflateInit (internal)
+//
+// Initializes a deflate stream that has been primed with the dictionary
+//
+// Arguments:
+//
+//	zstream		- Uninitialized deflate stream
+//	level		- Compression level
+//	windowbits	- Window size and container format, as passed to deflateInit2
+//	memlevel	- Memory usage level
+//	strategy	- Compression strategy
+
+int GzipDictionary::DeflateInit(z_stream* zstream, int level, int windowbits, int memlevel, int strategy)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	// Each distinct set of parameters requires a separately primed state
+	int key = ((level + 1) & 0x0F) | (((windowbits + 16) & 0x3F) << 4) | ((memlevel & 0x0F) << 10) | ((strategy & 0x07) << 14);
+
+	msclr::lock lock(m_lock);
+
+	IntPtr cached;
+	if(!m_deflaters->TryGetValue(key, cached)) {
+
+		z_stream* primed = nullptr;
+
+		// Allocate and initialize the unmanaged z_stream structure
+		try { primed = new z_stream; memset(primed, 0, sizeof(z_stream)); }
+		catch(Exception^) { throw gcnew OutOfMemoryException(); }
+
+		int result = deflateInit2(primed, level, Z_DEFLATED, windowbits, memlevel, strategy);
+		if(result != Z_OK) { delete primed; return result; }
+
+		// Hash the dictionary into the new state; this is the work that caching the state avoids
+		pin_ptr<unsigned __int8> pindictionary = &m_dictionary[0];
+		result = deflateSetDictionary(primed, reinterpret_cast<Bytef const*>(pindictionary), m_dictionary->Length);
+		if(result != Z_OK) { deflateEnd(primed); delete primed; return result; }
+
+		cached = IntPtr(primed);
+		m_deflaters->Add(key, cached);
+	}
+
+	// The primed state is never used to compress anything, it is only ever copied
+	return deflateCopy(zstream, reinterpret_cast<z_stream*>(cached.ToPointer()));
+}
+
+//---------------------------------------------------------------------------
+// GzipDictionary::Id::get
+//
+// Gets the Adler-32 checksum of the dictionary, as stored in a zlib header
+
+unsigned int GzipDictionary::Id::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return m_id;
+}
+
+//---------------------------------------------------------------------------
+// GzipDictionary::InflateSetDictionary (internal)
+//
+// Sets the dictionary of an inflate stream
+//
+// Arguments:
+//
+//	zstream		- Initialized inflate stream
+
+int GzipDictionary::InflateSetDictionary(z_stream* zstream)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	// Inflate only copies the dictionary into its window, there is no state worth caching
+	pin_ptr<unsigned __int8> pindictionary = &m_dictionary[0];
+	return inflateSetDictionary(zstream, reinterpret_cast<Bytef const*>(pindictionary), m_dictionary->Length);
+}
+
+//---------------------------------------------------------------------------
+// GzipDictionary::Length::get
+//
+// Gets the length of the dictionary data
+
+int GzipDictionary::Length::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return m_dictionary->Length;
+}
+
+//---------------------------------------------------------------------------
+// GzipDictionary::ToArray
+//
+// Gets a copy of the dictionary data
+//
+// Arguments:
+//
+//	NONE
+
+array<unsigned __int8>^ GzipDictionary::ToArray(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return safe_cast<array<unsigned __int8>^>(m_dictionary->Clone());
+}
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
@@ -0,0 +1,131 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#ifndef __GZIPDICTIONARY_H_
+#define __GZIPDICTIONARY_H_
+#pragma once
+
+#include <zlib.h>
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// Class GzipDictionary
+//
+// Preset deflate dictionary for zlib and raw deflate streams.  The first
+// time the dictionary is used with a given set of compression parameters
+// the deflate state primed with the dictionary is retained, subsequent
+// streams copy that state rather than hashing the dictionary again.  An
+// instance can be shared by any number of streams on any number of threads
+//---------------------------------------------------------------------------
+
+public ref class GzipDictionary
+{
+public:
+
+	// Instance Constructor
+	//
+	GzipDictionary(array<unsigned __int8>^ dictionary);
+
+	//-----------------------------------------------------------------------
+	// Member Functions
+
+	// ToArray
+	//
+	// Gets a copy of the dictionary data
+	array<unsigned __int8>^ ToArray(void);
+
+	//-----------------------------------------------------------------------
+	// Properties
+
+	// Id
+	//
+	// Gets the Adler-32 checksum of the dictionary, as stored in a zlib header
+	property unsigned int Id
+	{
+		unsigned int get(void);
+	}
+
+	// Length
+	//
+	// Gets the length of the dictionary data
+	property int Length
+	{
+		int get(void);
+	}
+
+internal:
+
+	//-----------------------------------------------------------------------
+	// Internal Member Functions
+
+	// DeflateInit
+	//
+	// Initializes a deflate stream that has been primed with the dictionary
+	int DeflateInit(z_stream* zstream, int level, int windowbits, int memlevel, int strategy);
+
+	// InflateSetDictionary
+	//
+	// Sets the dictionary of an inflate stream
+	int InflateSetDictionary(z_stream* zstream);
+
+	//-----------------------------------------------------------------------
+	// Internal Properties
+
+	// Data
+	//
+	// Gets a reference to the dictionary data
+	property array<unsigned __int8>^ Data
+	{
+		array<unsigned __int8>^ get(void);
+	}
+
+private:
+
+	// Destructor / Finalizer
+	//
+	~GzipDictionary();
+	!GzipDictionary();
+
+	//-----------------------------------------------------------------------
+	// Member Variables
+
+	bool								m_disposed;		// Object disposal flag
+	initonly array<unsigned __int8>^	m_dictionary;	// Dictionary data
+	initonly unsigned int				m_id;			// Adler-32 of the dictionary
+	Dictionary<int, IntPtr>^			m_deflaters;	// Primed deflate stream states
+
+	Object^	m_lock = gcnew Object();		// Synchronization object
+};
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
+
+#endif	// __GZIPDICTIONARY_H_
@@ -37,7 +37,8 @@ namespace zuki::io::compression {
 //	NONE
 
 GzipEncoder::GzipEncoder() : m_buffersize(GzipWriter::DEFAULT_BUFFER_SIZE), m_level(GzipCompressionLevel::Default),
-	m_strategy(GzipCompressionStrategy::Default), m_maxmem(GzipMemoryUsageLevel::Default)
+	m_strategy(GzipCompressionStrategy::Default), m_format(GzipContainerFormat::Gzip), m_dictionary(nullptr), 
+	m_maxmem(GzipMemoryUsageLevel::Default), m_maxpending(0), m_threads(1), m_windowsize(GzipWindowSize::Default)
 {
 }
 
@@ -102,6 +103,47 @@ void GzipEncoder::CompressionStrategy::set(GzipCompressionStrategy value)
 	m_strategy = value;
 }
 
+//---------------------------------------------------------------------------
+// GzipEncoder::ContainerFormat::get
+//
+// Gets the container format to wrap the deflate data in
+
+GzipContainerFormat GzipEncoder::ContainerFormat::get(void)
+{
+	return m_format;
+}
+
+//---------------------------------------------------------------------------
+// GzipEncoder::ContainerFormat::set
+//
+// Sets the container format to wrap the deflate data in
+
+void GzipEncoder::ContainerFormat::set(GzipContainerFormat value)
+{
+	if((value < GzipContainerFormat::Gzip) || (value > GzipContainerFormat::Raw)) throw gcnew ArgumentOutOfRangeException("value");
+	m_format = value;
+}
+
+//---------------------------------------------------------------------------
+// GzipEncoder::Dictionary::get
+//
+// Gets the preset dictionary to prime the compressor with
+
+GzipDictionary^ GzipEncoder::Dictionary::get(void)
+{
+	return m_dictionary;
+}
+
+//---------------------------------------------------------------------------
+// GzipEncoder::Dictionary::set
+//
+// Sets the preset dictionary to prime the compressor with
+
+void GzipEncoder::Dictionary::set(GzipDictionary^ value)
+{
+	m_dictionary = value;
+}
+
 //---------------------------------------------------------------------------
 // GzipEncoder::Encode
 //
@@ -175,7 +217,7 @@ void GzipEncoder::Encode(Stream^ instream, Stream^ outstream)
 	if(Object::ReferenceEquals(instream, nullptr)) throw gcnew ArgumentNullException("instream");
 	if(Object::ReferenceEquals(outstream, nullptr)) throw gcnew ArgumentNullException("outstream");
 
-	msclr::auto_handle<GzipWriter> writer(gcnew GzipWriter(outstream, m_level, m_strategy, m_maxmem, m_buffersize, true));
+	msclr::auto_handle<GzipWriter> writer(gcnew GzipWriter(outstream, nullptr, 0, m_format, m_dictionary, m_level, m_strategy, m_maxmem, m_windowsize, m_buffersize, m_threads, m_maxpending, true));
 	instream->CopyTo(writer.get());
 }
 
@@ -194,7 +236,7 @@ void GzipEncoder::Encode(array<unsigned __int8>^ buffer, Stream^ outstream)
 	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
 	if(Object::ReferenceEquals(outstream, nullptr)) throw gcnew ArgumentNullException("outstream");
 
-	msclr::auto_handle<GzipWriter> writer(gcnew GzipWriter(outstream, m_level, m_strategy, m_maxmem, m_buffersize, true));
+	msclr::auto_handle<GzipWriter> writer(gcnew GzipWriter(outstream, nullptr, 0, m_format, m_dictionary, m_level, m_strategy, m_maxmem, m_windowsize, m_buffersize, m_threads, m_maxpending, true));
 	writer->Write(buffer, 0, buffer->Length);
 }
 
@@ -215,10 +257,52 @@ void GzipEncoder::Encode(array<unsigned __int8>^ buffer, int offset, int count,
 	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
 	if(Object::ReferenceEquals(outstream, nullptr)) throw gcnew ArgumentNullException("outstream");
 
-	msclr::auto_handle<GzipWriter> writer(gcnew GzipWriter(outstream, m_level, m_strategy, m_maxmem, m_buffersize, true));
+	msclr::auto_handle<GzipWriter> writer(gcnew GzipWriter(outstream, nullptr, 0, m_format, m_dictionary, m_level, m_strategy, m_maxmem, m_windowsize, m_buffersize, m_threads, m_maxpending, true));
 	writer->Write(buffer, offset, count);
 }
 
+//---------------------------------------------------------------------------
+// GzipEncoder::MaximumPendingBlocks::get
+//
+// Gets the maximum number of blocks in flight during parallel compression
+
+int GzipEncoder::MaximumPendingBlocks::get(void)
+{
+	return m_maxpending;
+}
+
+//---------------------------------------------------------------------------
+// GzipEncoder::MaximumPendingBlocks::set
+//
+// Sets the maximum number of blocks in flight during parallel compression
+
+void GzipEncoder::MaximumPendingBlocks::set(int value)
+{
+	if(value < 0) throw gcnew ArgumentOutOfRangeException("value");
+	m_maxpending = value;
+}
+
+//---------------------------------------------------------------------------
+// GzipEncoder::MaximumThreads::get
+//
+// Gets the number of threads to use for parallel block compression
+
+int GzipEncoder::MaximumThreads::get(void)
+{
+	return m_threads;
+}
+
+//---------------------------------------------------------------------------
+// GzipEncoder::MaximumThreads::set
+//
+// Sets the number of threads to use for parallel block compression
+
+void GzipEncoder::MaximumThreads::set(int value)
+{
+	if(value < 0) throw gcnew ArgumentOutOfRangeException("value");
+	m_threads = value;
+}
+
 //---------------------------------------------------------------------------
 // GzipEncoder::MemoryUsage::get
 //
@@ -239,6 +323,26 @@ void GzipEncoder::MemoryUsage::set(GzipMemoryUsageLevel value)
 	m_maxmem = value;
 }
 
+//---------------------------------------------------------------------------
+// GzipEncoder::WindowSize::get
+//
+// Gets the size of the deflate history window
+
+GzipWindowSize GzipEncoder::WindowSize::get(void)
+{
+	return m_windowsize;
+}
+
+//---------------------------------------------------------------------------
+// GzipEncoder::WindowSize::set
+//
+// Sets the size of the deflate history window
+
+void GzipEncoder::WindowSize::set(GzipWindowSize value)
+{
+	m_windowsize = value;
+}
+
 //---------------------------------------------------------------------------
 
 } // zuki::io::compression
@@ -28,7 +28,10 @@
 #include "Encoder.h"
 #include "GzipCompressionLevel.h"
 #include "GzipCompressionStrategy.h"
+#include "GzipContainerFormat.h"
+#include "GzipDictionary.h"
 #include "GzipMemoryUsageLevel.h"
+#include "GzipWindowSize.h"
 
 #pragma warning(push, 4)				// Enable maximum compiler warnings
 
@@ -114,6 +117,42 @@ public:
 		void set(GzipCompressionStrategy value);
 	}
 
+	// ContainerFormat
+	//
+	// Gets/sets the container format to wrap the deflate data in
+	property GzipContainerFormat ContainerFormat
+	{
+		GzipContainerFormat get(void);
+		void set(GzipContainerFormat value);
+	}
+
+	// Dictionary
+	//
+	// Gets/sets the preset dictionary to prime the compressor with
+	property GzipDictionary^ Dictionary
+	{
+		GzipDictionary^ get(void);
+		void set(GzipDictionary^ value);
+	}
+
+	// MaximumPendingBlocks
+	//
+	// Gets/sets the maximum number of blocks in flight during parallel compression
+	property int MaximumPendingBlocks
+	{
+		int get(void);
+		void set(int value);
+	}
+
+	// MaximumThreads
+	//
+	// Gets/sets the number of threads to use for parallel block compression
+	property int MaximumThreads
+	{
+		int get(void);
+		void set(int value);
+	}
+
 	// MemoryUsage
 	//
 	// Gets/sets the maximum amount of memory to use
@@ -123,6 +162,15 @@ public:
 		void set(GzipMemoryUsageLevel value);
 	}
 
+	// WindowSize
+	//
+	// Gets/sets the size of the deflate history window
+	property GzipWindowSize WindowSize
+	{
+		GzipWindowSize get(void);
+		void set(GzipWindowSize value);
+	}
+
 private:
 
 	//-----------------------------------------------------------------------
@@ -131,7 +179,12 @@ private:
 	int							m_buffersize;		// Size of the compression buffer
 	GzipCompressionLevel		m_level;			// Compression level
 	GzipCompressionStrategy		m_strategy;			// Compression strategy
+	GzipContainerFormat			m_format;			// Container format
+	GzipDictionary^				m_dictionary;		// Preset dictionary
 	GzipMemoryUsageLevel		m_maxmem;			// Memory usage level
+	int							m_maxpending;		// Maximum pending blocks
+	int							m_threads;			// Number of compression threads
+	GzipWindowSize				m_windowsize;		// Deflate window size
 };
 
 //---------------------------------------------------------------------------
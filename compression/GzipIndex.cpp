@@ -0,0 +1,430 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "GzipIndex.h"
+
+#include "GzipException.h"
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+using namespace System::Text;
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// GzipIndex Constructor (internal)
+//
+// Arguments:
+//
+//	spacing				- Minimum distance between checkpoints
+//	length				- Decompressed length of the GZIP stream
+//	compressedlength	- Compressed length of the GZIP stream
+//	checkpoints			- List of index checkpoints
+
+GzipIndex::GzipIndex(__int64 spacing, __int64 length, __int64 compressedlength, List<Checkpoint^>^ checkpoints) : 
+	m_spacing(spacing), m_length(length), m_compressedlength(compressedlength), m_checkpoints(checkpoints)
+{
+}
+
+//---------------------------------------------------------------------------
+// GzipIndex::Build (static)
+//
+// Builds an index by decompressing a GZIP stream
+//
+// Arguments:
+//
+//	stream		- Stream containing the GZIP data to be indexed
+
+GzipIndex^ GzipIndex::Build(Stream^ stream)
+{
+	return Build(stream, DEFAULT_SPACING);
+}
+
+//---------------------------------------------------------------------------
+// GzipIndex::Build (static)
+//
+// Builds an index by decompressing a GZIP stream
+//
+// Arguments:
+//
+//	stream		- Stream containing the GZIP data to be indexed
+//	spacing		- Minimum distance between checkpoints, in decompressed bytes
+
+GzipIndex^ GzipIndex::Build(Stream^ stream, __int64 spacing)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+	if(spacing < WINDOW_SIZE) throw gcnew ArgumentOutOfRangeException("spacing");
+
+	List<Checkpoint^>^ checkpoints = gcnew List<Checkpoint^>();
+	array<unsigned __int8>^ in = gcnew array<unsigned __int8>(BUFFER_SIZE);
+	array<unsigned __int8>^ window = gcnew array<unsigned __int8>(WINDOW_SIZE);
+
+	__int64 totalin = 0;					// Total compressed bytes consumed
+	__int64 totalout = 0;					// Total decompressed bytes generated
+	__int64 last = 0;						// Decompressed offset of last checkpoint
+	bool endofmember = false;				// Flag if a member has just ended
+
+	z_stream zstream;
+	memset(&zstream, 0, sizeof(z_stream));
+
+	// Initialize the z_stream for decompression
+	int result = inflateInit2(&zstream, 16 + MAX_WBITS);
+	if(result != Z_OK) throw gcnew GzipException(result);
+
+	try {
+
+		// Pin both the input buffer and the history window in memory
+		pin_ptr<unsigned __int8> pinin = &in[0];
+		pin_ptr<unsigned __int8> pinwindow = &window[0];
+
+		while(true) {
+
+			// If the input buffer was consumed by a previous iteration, refill it; the stream
+			// may only end after a complete member has been decompressed
+			if(zstream.avail_in == 0) {
+
+				zstream.avail_in = stream->Read(in, 0, BUFFER_SIZE);
+				zstream.next_in = reinterpret_cast<Bytef*>(pinin);
+
+				if(zstream.avail_in == 0) {
+
+					if(endofmember) break;
+					throw gcnew InvalidDataException();
+				}
+			}
+
+			// Multiple members can be concatenated together, anything else after a member is ignored
+			if(endofmember) {
+
+				if(*zstream.next_in != 0x1F) break;
+
+				result = inflateReset(&zstream);
+				if(result != Z_OK) throw gcnew GzipException(result);
+
+				endofmember = false;
+			}
+
+			// The output buffer is a circular window of the most recently decompressed data
+			if(zstream.avail_out == 0) {
+
+				zstream.next_out = reinterpret_cast<Bytef*>(pinwindow);
+				zstream.avail_out = WINDOW_SIZE;
+			}
+
+			// Inflate up to the end of the next deflate block header and track the totals
+			totalin += zstream.avail_in;
+			totalout += zstream.avail_out;
+			result = inflate(&zstream, Z_BLOCK);
+			totalin -= zstream.avail_in;
+			totalout -= zstream.avail_out;
+
+			if(result == Z_STREAM_END) { endofmember = true; continue; }
+			else if(result != Z_OK) throw gcnew GzipException(result);
+
+			// Record a checkpoint when stopped at a block boundary other than after the last block
+			// of a member; the first checkpoint is always at the beginning of the first block
+			if(((zstream.data_type & 128) != 0) && ((zstream.data_type & 64) == 0) && ((checkpoints->Count == 0) || (totalout - last >= spacing))) {
+
+				checkpoints->Add(CreateCheckpoint(totalout, totalin, zstream.data_type & 7, window, WINDOW_SIZE - zstream.avail_out));
+				last = totalout;
+			}
+		}
+	}
+
+	finally { inflateEnd(&zstream); }
+
+	return gcnew GzipIndex(spacing, totalout, totalin, checkpoints);
+}
+
+//---------------------------------------------------------------------------
+// GzipIndex::CompressedLength::get
+//
+// Gets the length of the indexed GZIP stream
+
+__int64 GzipIndex::CompressedLength::get(void)
+{
+	return m_compressedlength;
+}
+
+//---------------------------------------------------------------------------
+// GzipIndex::Count::get
+//
+// Gets the number of checkpoints in the index
+
+int GzipIndex::Count::get(void)
+{
+	return m_checkpoints->Count;
+}
+
+//---------------------------------------------------------------------------
+// GzipIndex::CreateCheckpoint (private, static)
+//
+// Creates a checkpoint from the current state of the circular history window
+//
+// Arguments:
+//
+//	output		- Decompressed data offset of the checkpoint
+//	input		- Compressed data offset of the checkpoint
+//	bits		- Number of unused bits in the byte before input
+//	window		- Circular window of decompressed data
+//	windowpos	- Offset of the next byte to be written into the window
+
+GzipIndex::Checkpoint^ GzipIndex::CreateCheckpoint(__int64 output, __int64 input, int bits, array<unsigned __int8>^ window, int windowpos)
+{
+	// Copy the most recent decompressed data out of the circular window in order
+	int length = static_cast<int>(Math::Min(output, static_cast<__int64>(WINDOW_SIZE)));
+	int start = (windowpos - length + WINDOW_SIZE) % WINDOW_SIZE;
+	int first = Math::Min(length, WINDOW_SIZE - start);
+
+	array<unsigned __int8>^ history = gcnew array<unsigned __int8>(length);
+	Array::Copy(window, start, history, 0, first);
+	Array::Copy(window, 0, history, first, length - first);
+
+	// The first checkpoint of the stream has no history
+	if(length == 0) return gcnew Checkpoint(output, input, bits, history, 0);
+
+	z_stream zstream;
+	memset(&zstream, 0, sizeof(z_stream));
+
+	// The history is deflated to keep the index compact
+	int result = deflateInit(&zstream, Z_BEST_COMPRESSION);
+	if(result != Z_OK) throw gcnew GzipException(result);
+
+	array<unsigned __int8>^ deflated = gcnew array<unsigned __int8>(static_cast<int>(deflateBound(&zstream, length)));
+
+	try {
+
+		pin_ptr<unsigned __int8> pinhistory = &history[0];
+		pin_ptr<unsigned __int8> pindeflated = &deflated[0];
+
+		zstream.next_in = reinterpret_cast<Bytef*>(pinhistory);
+		zstream.avail_in = length;
+		zstream.next_out = reinterpret_cast<Bytef*>(pindeflated);
+		zstream.avail_out = deflated->Length;
+
+		result = deflate(&zstream, Z_FINISH);
+		if(result != Z_STREAM_END) throw gcnew GzipException((result == Z_OK) ? Z_BUF_ERROR : result);
+	}
+
+	finally { deflateEnd(&zstream); }
+
+	Array::Resize<unsigned __int8>(deflated, static_cast<int>(zstream.total_out));
+	return gcnew Checkpoint(output, input, bits, deflated, length);
+}
+
+//---------------------------------------------------------------------------
+// GzipIndex::Find (internal)
+//
+// Locates the last checkpoint at or before a decompressed data offset
+//
+// Arguments:
+//
+//	position	- Decompressed data offset
+
+GzipIndex::Checkpoint^ GzipIndex::Find(__int64 position)
+{
+	int low = 0;
+	int high = m_checkpoints->Count - 1;
+
+	// Binary search for the last checkpoint that doesn't start after the position
+	while(low < high) {
+
+		int middle = low + ((high - low + 1) >> 1);
+		if(m_checkpoints[middle]->Output <= position) low = middle;
+		else high = middle - 1;
+	}
+
+	return m_checkpoints[low];
+}
+
+//---------------------------------------------------------------------------
+// GzipIndex::GetWindow (internal, static)
+//
+// Inflates the history window of a checkpoint
+//
+// Arguments:
+//
+//	checkpoint	- Checkpoint to inflate the history window for
+
+array<unsigned __int8>^ GzipIndex::GetWindow(Checkpoint^ checkpoint)
+{
+	array<unsigned __int8>^ history = gcnew array<unsigned __int8>(checkpoint->WindowLength);
+	if(checkpoint->WindowLength == 0) return history;
+
+	z_stream zstream;
+	memset(&zstream, 0, sizeof(z_stream));
+
+	int result = inflateInit(&zstream);
+	if(result != Z_OK) throw gcnew GzipException(result);
+
+	try {
+
+		pin_ptr<unsigned __int8> pinwindow = &checkpoint->Window[0];
+		pin_ptr<unsigned __int8> pinhistory = &history[0];
+
+		zstream.next_in = reinterpret_cast<Bytef*>(pinwindow);
+		zstream.avail_in = checkpoint->Window->Length;
+		zstream.next_out = reinterpret_cast<Bytef*>(pinhistory);
+		zstream.avail_out = history->Length;
+
+		// The history must inflate to exactly the expected length
+		result = inflate(&zstream, Z_FINISH);
+		if((result != Z_STREAM_END) || (zstream.avail_out != 0)) throw gcnew InvalidDataException();
+	}
+
+	finally { inflateEnd(&zstream); }
+
+	return history;
+}
+
+//---------------------------------------------------------------------------
+// GzipIndex::Length::get
+//
+// Gets the decompressed length of the indexed GZIP stream
+
+__int64 GzipIndex::Length::get(void)
+{
+	return m_length;
+}
+
+//---------------------------------------------------------------------------
+// GzipIndex::Load (static)
+//
+// Loads an index previously written with Save
+//
+// Arguments:
+//
+//	stream		- Stream to read the index from
+
+GzipIndex^ GzipIndex::Load(Stream^ stream)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+
+	msclr::auto_handle<BinaryReader> reader(gcnew BinaryReader(stream, Encoding::UTF8, true));
+
+	try {
+
+		// Check the signature and version of the serialized index
+		if(reader->ReadUInt32() != MAGIC) throw gcnew InvalidDataException();
+		if(reader->ReadInt32() != VERSION) throw gcnew InvalidDataException();
+
+		__int64 spacing = reader->ReadInt64();
+		__int64 length = reader->ReadInt64();
+		__int64 compressedlength = reader->ReadInt64();
+		int count = reader->ReadInt32();
+
+		// There is always at least one checkpoint in a valid index
+		if((spacing < WINDOW_SIZE) || (length < 0) || (compressedlength < 0) || (count < 1)) throw gcnew InvalidDataException();
+
+		List<Checkpoint^>^ checkpoints = gcnew List<Checkpoint^>(count);
+		for(int index = 0; index < count; index++) {
+
+			__int64 output = reader->ReadInt64();
+			__int64 input = reader->ReadInt64();
+			int bits = reader->ReadByte();
+			int windowlength = reader->ReadInt32();
+			int deflatedlength = reader->ReadInt32();
+
+			// Checkpoints must be in order and within the bounds of the indexed stream
+			__int64 previous = (index == 0) ? 0 : checkpoints[index - 1]->Output;
+			if((output < previous) || (output > length) || (input < 0) || (input > compressedlength) || (bits > 7)) throw gcnew InvalidDataException();
+			if((windowlength < 0) || (windowlength > WINDOW_SIZE) || (deflatedlength < 0)) throw gcnew InvalidDataException();
+
+			array<unsigned __int8>^ window = reader->ReadBytes(deflatedlength);
+			if(window->Length != deflatedlength) throw gcnew InvalidDataException();
+
+			checkpoints->Add(gcnew Checkpoint(output, input, bits, window, windowlength));
+		}
+
+		return gcnew GzipIndex(spacing, length, compressedlength, checkpoints);
+	}
+
+	catch(EndOfStreamException^) { throw gcnew InvalidDataException(); }
+}
+
+//---------------------------------------------------------------------------
+// GzipIndex::Save
+//
+// Writes the index to a stream
+//
+// Arguments:
+//
+//	stream		- Stream to write the index into
+
+void GzipIndex::Save(Stream^ stream)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+
+	msclr::auto_handle<BinaryWriter> writer(gcnew BinaryWriter(stream, Encoding::UTF8, true));
+
+	writer->Write(MAGIC);
+	writer->Write(VERSION);
+	writer->Write(m_spacing);
+	writer->Write(m_length);
+	writer->Write(m_compressedlength);
+	writer->Write(m_checkpoints->Count);
+
+	for each(Checkpoint^ checkpoint in m_checkpoints) {
+
+		writer->Write(checkpoint->Output);
+		writer->Write(checkpoint->Input);
+		writer->Write(static_cast<unsigned __int8>(checkpoint->Bits));
+		writer->Write(checkpoint->WindowLength);
+		writer->Write(checkpoint->Window->Length);
+		writer->Write(checkpoint->Window);
+	}
+
+	writer->Flush();
+}
+
+//---------------------------------------------------------------------------
+// GzipIndex::Spacing::get
+//
+// Gets the minimum distance between checkpoints, in decompressed bytes
+
+__int64 GzipIndex::Spacing::get(void)
+{
+	return m_spacing;
+}
+
+//---------------------------------------------------------------------------
+// GzipIndex::Checkpoint Constructor
+//
+// Arguments:
+//
+//	output			- Decompressed data offset of the checkpoint
+//	input			- Compressed data offset of the checkpoint
+//	bits			- Number of unused bits in the byte before input
+//	window			- Deflated history window
+//	windowlength	- Length of the inflated history window
+
+GzipIndex::Checkpoint::Checkpoint(__int64 output, __int64 input, int bits, array<unsigned __int8>^ window, int windowlength) : 
+	Output(output), Input(input), Bits(bits), Window(window), WindowLength(windowlength)
+{
+}
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
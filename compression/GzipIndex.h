@@ -0,0 +1,195 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#ifndef __GZIPINDEX_H_
+#define __GZIPINDEX_H_
+#pragma once
+
+#include <zlib.h>
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::IO;
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// Class GzipIndex
+//
+// Random access index of a GZIP stream.  Each checkpoint records the bit
+// offset of a deflate block boundary along with the preceding 32KiB of
+// decompressed history, which allows GzipReader to resume decompression at
+// the checkpoint without inflating any of the data that comes before it.
+// Checkpoints recorded by GzipWriter at full flush points need no history
+//---------------------------------------------------------------------------
+
+public ref class GzipIndex
+{
+public:
+
+	//-----------------------------------------------------------------------
+	// Member Functions
+
+	// Build (static)
+	//
+	// Builds an index by decompressing a GZIP stream
+	static GzipIndex^ Build(Stream^ stream);
+	static GzipIndex^ Build(Stream^ stream, __int64 spacing);
+
+	// Load (static)
+	//
+	// Loads an index previously written with Save
+	static GzipIndex^ Load(Stream^ stream);
+
+	// Save
+	//
+	// Writes the index to a stream
+	void Save(Stream^ stream);
+
+	//-----------------------------------------------------------------------
+	// Properties
+
+	// CompressedLength
+	//
+	// Gets the length of the indexed GZIP stream
+	property __int64 CompressedLength
+	{
+		__int64 get(void);
+	}
+
+	// Count
+	//
+	// Gets the number of checkpoints in the index
+	property int Count
+	{
+		int get(void);
+	}
+
+	// Length
+	//
+	// Gets the decompressed length of the indexed GZIP stream
+	property __int64 Length
+	{
+		__int64 get(void);
+	}
+
+	// Spacing
+	//
+	// Gets the minimum distance between checkpoints, in decompressed bytes
+	property __int64 Spacing
+	{
+		__int64 get(void);
+	}
+
+internal:
+
+	// Checkpoint
+	//
+	// Position within the GZIP stream where decompression can be resumed
+	ref class Checkpoint
+	{
+	public:
+
+		// Instance Constructor
+		//
+		Checkpoint(__int64 output, __int64 input, int bits, array<unsigned __int8>^ window, int windowlength);
+
+		//-------------------------------------------------------------------
+		// Fields
+
+		initonly __int64					Output;			// Decompressed data offset
+		initonly __int64					Input;			// Compressed data offset
+		initonly int						Bits;			// Unused bits before Input
+		initonly array<unsigned __int8>^	Window;			// Deflated history window
+		initonly int						WindowLength;	// Length of the history window
+	};
+
+	// Instance Constructor
+	//
+	GzipIndex(__int64 spacing, __int64 length, __int64 compressedlength, List<Checkpoint^>^ checkpoints);
+
+	//-----------------------------------------------------------------------
+	// Internal Member Functions
+
+	// Find
+	//
+	// Locates the last checkpoint at or before a decompressed data offset
+	Checkpoint^ Find(__int64 position);
+
+	// GetWindow
+	//
+	// Inflates the history window of a checkpoint
+	static array<unsigned __int8>^ GetWindow(Checkpoint^ checkpoint);
+
+private:
+
+	// BUFFER_SIZE
+	//
+	// Size of the input buffer used to build an index, in bytes
+	static const int BUFFER_SIZE = 65536;
+
+	// DEFAULT_SPACING
+	//
+	// Default minimum distance between checkpoints, in decompressed bytes
+	static const int DEFAULT_SPACING = (1 << 20);
+
+	// MAGIC
+	//
+	// Signature of a serialized index ("GZIX")
+	static const unsigned int MAGIC = 0x58495A47;
+
+	// VERSION
+	//
+	// Version of the serialized index format
+	static const int VERSION = 1;
+
+	// WINDOW_SIZE
+	//
+	// Size of the deflate history window
+	static const int WINDOW_SIZE = (1 << MAX_WBITS);
+
+	//-----------------------------------------------------------------------
+	// Private Member Functions
+
+	// CreateCheckpoint (static)
+	//
+	// Creates a checkpoint from the current state of the circular history window
+	static Checkpoint^ CreateCheckpoint(__int64 output, __int64 input, int bits, array<unsigned __int8>^ window, int windowpos);
+
+	//-----------------------------------------------------------------------
+	// Member Variables
+
+	initonly __int64				m_spacing;			// Distance between checkpoints
+	initonly __int64				m_length;			// Decompressed stream length
+	initonly __int64				m_compressedlength;	// Compressed stream length
+	initonly List<Checkpoint^>^		m_checkpoints;		// Index checkpoints
+};
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
+
+#endif	// __GZIPINDEX_H_
@@ -48,9 +48,127 @@ GzipReader::GzipReader(Stream^ stream) : GzipReader(stream, false)
 //	stream		- The stream the compressed data is read from
 //	leaveopen	- Flag to leave the base stream open after disposal
 
-GzipReader::GzipReader(Stream^ stream, bool leaveopen) : m_disposed(false), m_stream(stream), m_leaveopen(leaveopen), m_inpos(0), m_finished(false)
+GzipReader::GzipReader(Stream^ stream, bool leaveopen) : GzipReader(stream, 1, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// GzipReader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	format		- Container format the deflate data is wrapped in
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+GzipReader::GzipReader(Stream^ stream, GzipContainerFormat format, bool leaveopen) : GzipReader(stream, format, nullptr, 1, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// GzipReader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	format		- Container format the deflate data is wrapped in
+//	dictionary	- Preset dictionary the data was compressed with
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+GzipReader::GzipReader(Stream^ stream, GzipContainerFormat format, GzipDictionary^ dictionary, bool leaveopen) : 
+	GzipReader(stream, format, dictionary, 1, 0, leaveopen)
+{
+	if(Object::ReferenceEquals(dictionary, nullptr)) throw gcnew ArgumentNullException("dictionary");
+}
+
+//---------------------------------------------------------------------------
+// GzipReader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	index		- Random access index of the compressed data
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+GzipReader::GzipReader(Stream^ stream, GzipIndex^ index, bool leaveopen) : GzipReader(stream, 1, 0, leaveopen)
+{
+	if(Object::ReferenceEquals(index, nullptr)) throw gcnew ArgumentNullException("index");
+	if(!stream->CanSeek) throw gcnew ArgumentException("The base stream must support seeking", "stream");
+
+	// The index describes the compressed data starting at the current position of the base stream
+	m_basepos = stream->Position;
+	if((stream->Length - m_basepos) < index->CompressedLength) throw gcnew ArgumentException("The index does not describe the base stream", "index");
+
+	m_index = index;
+}
+
+//---------------------------------------------------------------------------
+// GzipReader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	threads		- Number of threads to use for decompression (zero = processor count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+GzipReader::GzipReader(Stream^ stream, int threads, bool leaveopen) : GzipReader(stream, threads, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// GzipReader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	threads		- Number of threads to use for decompression (zero = processor count)
+//	maxpending	- Maximum number of members decoded ahead (zero = twice the thread count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+GzipReader::GzipReader(Stream^ stream, int threads, int maxpending, bool leaveopen) : 
+	GzipReader(stream, GzipContainerFormat::Gzip, nullptr, threads, maxpending, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// GzipReader Constructor (private)
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	format		- Container format the deflate data is wrapped in
+//	dictionary	- Optional preset dictionary the data was compressed with
+//	threads		- Number of threads to use for decompression (zero = processor count)
+//	maxpending	- Maximum number of members decoded ahead (zero = twice the thread count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+GzipReader::GzipReader(Stream^ stream, GzipContainerFormat format, GzipDictionary^ dictionary, int threads, int maxpending, bool leaveopen) : 
+	m_disposed(false), m_stream(stream), m_leaveopen(leaveopen), m_inpos(0), m_finished(false), m_format(format), m_dictionary(dictionary), 
+	m_outpos(0), m_outavail(0), 
+	m_windowsize(PARALLEL_WINDOW_SIZE), m_windowbase(0), m_windowlen(0), m_endofstream(false), m_scanpos(0), m_candidate(-1), m_next(0), 
+	m_serial(false), m_serialpos(0), m_speculative(false), m_specserial(false), m_specbit(0), m_specqueued(-1), m_speccrc(0), m_specsize(0), m_basepos(0), m_position(0), m_raw(false)
 {
 	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+	if((format < GzipContainerFormat::Gzip) || (format > GzipContainerFormat::AutoDetect)) throw gcnew ArgumentOutOfRangeException("format");
+	if((dictionary) && (format == GzipContainerFormat::Gzip)) throw gcnew ArgumentException("A preset dictionary cannot be used with a GZIP stream", "dictionary");
+	if(threads < 0) throw gcnew ArgumentOutOfRangeException("threads");
+	if(maxpending < 0) throw gcnew ArgumentOutOfRangeException("maxpending");
+
+	// Multiple-member GZIP streams can be decompressed in parallel; zero threads indicates
+	// the processor count and zero pending members indicates twice the thread count
+	if(threads == 0) threads = Environment::ProcessorCount;
+	if((threads > 1) && (format == GzipContainerFormat::Gzip)) {
+
+		int capacity = (maxpending == 0) ? threads * 2 : maxpending;
+		m_pending = gcnew TaskQueue<Member^>(threads, capacity);
+
+		// Members too large to be inflated as a single task are split into speculatively inflated chunks,
+		// the read-ahead window must be large enough to hold all of the queued chunks
+		capacity = Math::Min(capacity, MAXIMUM_PENDING_CHUNKS);
+		m_chunks = gcnew TaskQueue<Chunk^>(threads, capacity);
+		m_windowsize = Math::Max(PARALLEL_WINDOW_SIZE, (capacity + 2) * SPECULATIVE_CHUNK_SIZE);
+		m_history = gcnew array<unsigned __int8>(WINDOW_SIZE);
+	}
 
 	// Allocate and initialize the unmanaged z_stream structure
 	try { m_zstream = new z_stream; memset(m_zstream, 0, sizeof(z_stream)); }
@@ -59,9 +177,21 @@ GzipReader::GzipReader(Stream^ stream, bool leaveopen) : m_disposed(false), m_st
 	// Allocate the managed input buffer for this instance
 	m_in = gcnew array<unsigned __int8>(BUFFER_SIZE);
 
+	// The sign and range of the window bits select the container format zlib expects; the largest
+	// window is always used so that data compressed with any window size can be decompressed
+	int windowbits = (format == GzipContainerFormat::Raw) ? -MAX_WBITS : (format == GzipContainerFormat::Zlib) ? MAX_WBITS : 
+		(format == GzipContainerFormat::AutoDetect) ? 32 + MAX_WBITS : 16 + MAX_WBITS;
+
 	// Initialize the z_stream for decompression
-	int result = inflateInit2(m_zstream, 16 + MAX_WBITS);
+	int result = inflateInit2(m_zstream, windowbits);
 	if(result != Z_OK) throw gcnew GzipException(result);
+
+	// Raw deflate data has no header to request the dictionary, it has to be set up front
+	if((dictionary) && (format == GzipContainerFormat::Raw)) {
+
+		result = dictionary->InflateSetDictionary(m_zstream);
+		if(result != Z_OK) throw gcnew GzipException(result);
+	}
 }
 
 //---------------------------------------------------------------------------
@@ -70,6 +200,10 @@ GzipReader::GzipReader(Stream^ stream, bool leaveopen) : m_disposed(false), m_st
 GzipReader::~GzipReader()
 {
 	if(m_disposed) return;
+
+	// Wait for and discard any members still being decompressed
+	if(m_pending) delete m_pending;
+	if(m_chunks) delete m_chunks;
 	
 	// Optionally dispose of the base stream
 	if(!m_leaveopen) delete m_stream;
@@ -106,6 +240,51 @@ Stream^ GzipReader::BaseStream::get(void)
 	return m_stream;
 }
 
+//---------------------------------------------------------------------------
+// GzipReader::BeginSpeculativeMember (private)
+//
+// Starts inflating a large member as speculatively decoded chunks
+//
+// Arguments:
+//
+//	NONE
+
+void GzipReader::BeginSpeculativeMember(void)
+{
+	unsigned __int8				scratch;		// Output byte for the header inflate
+
+	int result = inflateReset(m_zstream);
+	if(result != Z_OK) throw gcnew GzipException(result);
+
+	// Use zlib to parse the member header; Z_BLOCK stops just before the first deflate block
+	int pos = static_cast<int>(m_next - m_windowbase);
+	pin_ptr<unsigned __int8> pinin = &m_window[0];
+
+	m_zstream->next_in = reinterpret_cast<Bytef*>(&pinin[pos]);
+	m_zstream->avail_in = m_windowlen - pos;
+	m_zstream->next_out = &scratch;
+	m_zstream->avail_out = 1;
+
+	result = inflate(m_zstream, Z_BLOCK);
+	bool header = ((result == Z_OK) && ((m_zstream->data_type & 128) == 128));
+	int headerlength = (m_windowlen - pos) - m_zstream->avail_in;
+
+	result = inflateReset(m_zstream);
+	if(result != Z_OK) throw gcnew GzipException(result);
+
+	// If the header couldn't be parsed from the window, the member is inflated serially
+	if(!header) { m_serialpos = m_next; m_serial = true; return; }
+
+	// The first chunk starts with the first deflate block, which has no history
+	m_specbit = (m_next + headerlength) * 8;
+	m_specqueued = -1;
+	m_speccrc = crc32(0L, Z_NULL, 0);
+	m_specsize = 0;
+	Array::Clear(m_history, 0, m_history->Length);
+
+	m_speculative = true;
+}
+
 //---------------------------------------------------------------------------
 // GzipReader::CanRead::get
 //
@@ -125,7 +304,7 @@ bool GzipReader::CanRead::get(void)
 bool GzipReader::CanSeek::get(void)
 {
 	CHECK_DISPOSED(m_disposed);
-	return false;
+	return (m_index != nullptr);
 }
 
 //---------------------------------------------------------------------------
@@ -154,6 +333,318 @@ void GzipReader::Flush(void)
 	m_stream->Flush();
 }
 
+//---------------------------------------------------------------------------
+// GzipReader::InflateChunk (private)
+//
+// Inflates a single chunk of a large member, speculatively if its history is unknown
+//
+// Arguments:
+//
+//	state		- Chunk instance to be inflated
+
+GzipReader::Chunk^ GzipReader::InflateChunk(Object^ state)
+{
+	z_stream					zstream;		// Local inflate stream state
+	int							result;			// Result from zlib operation
+
+	Chunk^ chunk = safe_cast<Chunk^>(state);
+
+	// Only the first chunk of a member starts at a known block with a known (empty) history
+	bool known = (chunk->StartBit >= 0);
+
+	InitInflate(&zstream, -MAX_WBITS);
+
+	try {
+
+		// The unknown history is replaced with a dictionary of markers holding the low 8 bits of each
+		// history position; any output byte copied from the history will hold one of these markers
+		array<unsigned __int8>^ dictionary = gcnew array<unsigned __int8>(WINDOW_SIZE);
+		for(int index = 0; index < WINDOW_SIZE; index++) dictionary[index] = static_cast<unsigned __int8>(index & 0xFF);
+
+		pin_ptr<unsigned __int8> pindictionary = &dictionary[0];
+
+		// Search the start of the chunk for the first dynamic block header that can be fully inflated
+		if(!known) {
+
+			array<unsigned __int8>^ scratch = gcnew array<unsigned __int8>(WINDOW_SIZE);
+			pin_ptr<unsigned __int8> pinscratch = &scratch[0];
+			pin_ptr<unsigned __int8> pinin = &chunk->Window[chunk->Offset];
+
+			__int64 limit = static_cast<__int64>(Math::Min(chunk->Length, SPECULATIVE_CHUNK_SIZE)) * 8;
+			for(__int64 bit = 0; (chunk->StartBit < 0) && (bit < limit); bit++) {
+
+				if(!IsBlockHeader(pinin, chunk->Length, bit)) continue;
+
+				int byte = static_cast<int>(bit >> 3);
+				int bits = static_cast<int>(bit & 7);
+
+				result = inflateReset(&zstream);
+				if(result == Z_OK) result = inflateSetDictionary(&zstream, pindictionary, WINDOW_SIZE);
+				if((result == Z_OK) && (bits > 0)) result = inflatePrime(&zstream, 8 - bits, pinin[byte++] >> bits);
+				if(result != Z_OK) throw gcnew GzipException(result);
+
+				zstream.next_in = reinterpret_cast<Bytef*>(&pinin[byte]);
+				zstream.avail_in = chunk->Length - byte;
+
+				// Inflate the candidate block, it has to end on another block boundary without error
+				do {
+
+					zstream.next_out = reinterpret_cast<Bytef*>(pinscratch);
+					zstream.avail_out = WINDOW_SIZE;
+					result = inflate(&zstream, Z_BLOCK);
+
+				} while((result == Z_OK) && ((zstream.data_type & 128) == 0));
+
+				if(result == Z_OK) chunk->StartBit = (chunk->Position * 8) + bit;
+			}
+
+			// A chunk without a block boundary in it can't be inflated
+			if(chunk->StartBit < 0) return chunk;
+		}
+
+		// Inflate the chunk with the first marker dictionary, or no dictionary at all if the history is known
+		array<unsigned __int8>^ output = gcnew array<unsigned __int8>(Math::Min(SPECULATIVE_OUTPUT_LIMIT, chunk->Length * 4));
+		int outputlength = 0;
+
+		if(!InflateChunkPass(&zstream, chunk, (known) ? nullptr : pindictionary, output, outputlength)) return chunk;
+
+		chunk->Markers = gcnew List<__int64>();
+
+		if(!known) {
+
+			__int64 endbit = chunk->EndBit;
+			bool final = chunk->Final;
+
+			// Inflate the chunk again with a second marker dictionary that encodes the high bits of each
+			// history position relative to the first; bytes that differ between the passes are references
+			// into the history and bytes that match are literals or references to data within the chunk
+			for(int index = 0; index < WINDOW_SIZE; index++) dictionary[index] = static_cast<unsigned __int8>((index & 0xFF) + (index >> 8) + 1);
+
+			array<unsigned __int8>^ compare = gcnew array<unsigned __int8>(output->Length);
+			int comparelength = 0;
+
+			if(!InflateChunkPass(&zstream, chunk, pindictionary, compare, comparelength)) return chunk;
+			if((comparelength != outputlength) || (chunk->EndBit != endbit) || (chunk->Final != final)) return chunk;
+
+			for(int index = 0; index < outputlength; index++) {
+
+				if(output[index] == compare[index]) continue;
+
+				int high = ((compare[index] - output[index]) & 0xFF) - 1;
+				if(high >= (WINDOW_SIZE >> 8)) return chunk;
+
+				chunk->Markers->Add((static_cast<__int64>(index) << 16) | (high << 8) | output[index]);
+			}
+		}
+
+		// The 8-byte member trailer follows the final block on the next byte boundary
+		if(chunk->Final) {
+
+			int trailer = static_cast<int>(((chunk->EndBit + 7) >> 3) - chunk->Position);
+			if(trailer + 8 > chunk->Length) return chunk;
+
+			chunk->Trailer = gcnew array<unsigned __int8>(8);
+			Array::Copy(chunk->Window, chunk->Offset + trailer, chunk->Trailer, 0, 8);
+		}
+
+		chunk->Complete = true;
+		chunk->Output = output;
+		chunk->OutputLength = outputlength;
+	}
+
+	finally { inflateEnd(&zstream); }
+
+	return chunk;
+}
+
+//---------------------------------------------------------------------------
+// GzipReader::InflateChunkPass (private)
+//
+// Inflates a chunk once using the specified history dictionary
+//
+// Arguments:
+//
+//	zstream			- Raw deflate stream state to use
+//	chunk			- Chunk to be inflated; the start bit must be known
+//	dictionary		- Optional WINDOW_SIZE history dictionary
+//	output			- Output buffer, grown as necessary
+//	outputlength	- On success set to the length of the output
+
+bool GzipReader::InflateChunkPass(z_stream* zstream, Chunk^ chunk, Bytef const* dictionary, array<unsigned __int8>^% output, int% outputlength)
+{
+	pin_ptr<unsigned __int8> pinin = &chunk->Window[chunk->Offset];
+
+	// The first block of the chunk is not necessarily on a byte boundary
+	__int64 start = chunk->StartBit - (chunk->Position * 8);
+	int byte = static_cast<int>(start >> 3);
+	int bits = static_cast<int>(start & 7);
+
+	int result = inflateReset(zstream);
+	if((result == Z_OK) && (dictionary != nullptr)) result = inflateSetDictionary(zstream, dictionary, WINDOW_SIZE);
+	if((result == Z_OK) && (bits > 0)) result = inflatePrime(zstream, 8 - bits, pinin[byte++] >> bits);
+	if(result != Z_OK) throw gcnew GzipException(result);
+
+	zstream->next_in = reinterpret_cast<Bytef*>(&pinin[byte]);
+	zstream->avail_in = chunk->Length - byte;
+	outputlength = 0;
+
+	// The chunk ends at the first dynamic block boundary at or after the start of the next chunk
+	__int64 endbit = static_cast<__int64>(SPECULATIVE_CHUNK_SIZE) * 8;
+
+	while(true) {
+
+		// Grow the output buffer if it has been filled, unless it's already at the limit
+		if(outputlength == output->Length) {
+
+			if(output->Length == SPECULATIVE_OUTPUT_LIMIT) return false;
+			Array::Resize<unsigned __int8>(output, Math::Min(SPECULATIVE_OUTPUT_LIMIT, output->Length * 2));
+		}
+
+		pin_ptr<unsigned __int8> pinout = &output[0];
+		zstream->next_out = reinterpret_cast<Bytef*>(&pinout[outputlength]);
+		zstream->avail_out = output->Length - outputlength;
+
+		result = inflate(zstream, Z_BLOCK);
+		outputlength = output->Length - zstream->avail_out;
+
+		// Running out of input or invalid data means the chunk can't be inflated
+		if((result != Z_OK) && (result != Z_STREAM_END)) return false;
+
+		// Determine the current bit offset from the consumed input and the unused bits
+		__int64 bit = (static_cast<__int64>(chunk->Length - zstream->avail_in) * 8) - (zstream->data_type & 7);
+
+		if(result == Z_STREAM_END) { chunk->EndBit = (chunk->Position * 8) + bit; chunk->Final = true; return true; }
+
+		if(((zstream->data_type & 128) == 128) && (bit >= endbit) && (IsBlockHeader(pinin, chunk->Length, bit))) {
+
+			chunk->EndBit = (chunk->Position * 8) + bit;
+			chunk->Final = false;
+			return true;
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+// GzipReader::InflateMember (private)
+//
+// Inflates a single candidate GZIP member from the read-ahead window
+//
+// Arguments:
+//
+//	state		- Member instance to be inflated
+
+GzipReader::Member^ GzipReader::InflateMember(Object^ state)
+{
+	z_stream					zstream;		// Local inflate stream state
+	int							result;			// Result from zlib operation
+
+	Member^ member = safe_cast<Member^>(state);
+
+	InitInflate(&zstream, 16 + MAX_WBITS);
+
+	try {
+
+		pin_ptr<unsigned __int8> pinin = &member->Window[0];
+		zstream.next_in = reinterpret_cast<Bytef*>(&pinin[member->Offset]);
+		zstream.avail_in = member->Length;
+
+		// Start with an output buffer proportional to the input, it's grown as needed up to the limit
+		array<unsigned __int8>^ out = gcnew array<unsigned __int8>(Math::Min(PARALLEL_MEMBER_LIMIT, Math::Max(BUFFER_SIZE, member->Length * 4)));
+
+		do {
+
+			// Grow the output buffer if it has been filled, unless it's already at the limit
+			if(static_cast<int>(zstream.total_out) == out->Length) {
+
+				if(out->Length == PARALLEL_MEMBER_LIMIT) break;
+				Array::Resize<unsigned __int8>(out, Math::Min(PARALLEL_MEMBER_LIMIT, out->Length * 2));
+			}
+
+			// The output buffer may have moved, reset the pointer based on the total output
+			pin_ptr<unsigned __int8> pinout = &out[0];
+			zstream.next_out = reinterpret_cast<Bytef*>(&pinout[zstream.total_out]);
+			zstream.avail_out = out->Length - static_cast<int>(zstream.total_out);
+
+			result = inflate(&zstream, Z_NO_FLUSH);
+
+		} while(result == Z_OK);
+
+		// Only a member that was inflated up to and including its trailer is complete; running out of
+		// input, exceeding the output limit or not actually being a GZIP member leaves it incomplete
+		if(result == Z_STREAM_END) {
+
+			member->Complete = true;
+			member->Consumed = static_cast<int>(zstream.total_in);
+			member->Output = out;
+			member->OutputLength = static_cast<int>(zstream.total_out);
+		}
+	}
+
+	finally { inflateEnd(&zstream); }
+
+	return member;
+}
+
+//---------------------------------------------------------------------------
+// GzipReader::InitInflate (internal, static)
+//
+// Initializes an inflate stream state
+//
+// Arguments:
+//
+//	zstream		- Inflate stream state to be initialized
+//	windowbits	- Window size bits; negative for raw deflate data
+
+void GzipReader::InitInflate(z_stream* zstream, int windowbits)
+{
+	memset(zstream, 0, sizeof(z_stream));
+
+	int result = inflateInit2(zstream, windowbits);
+	if(result != Z_OK) throw gcnew GzipException(result);
+}
+
+//---------------------------------------------------------------------------
+// GzipReader::IsBlockHeader (private, static)
+//
+// Determines if a bit offset appears to be the start of a dynamic deflate block
+//
+// Arguments:
+//
+//	data		- Compressed data
+//	length		- Length of the compressed data
+//	bit			- Bit offset into the compressed data to check
+
+bool GzipReader::IsBlockHeader(unsigned __int8 const* data, int length, __int64 bit)
+{
+	// The header and code length code lengths of a dynamic block are up to 74 bits long
+	if(bit + 74 > static_cast<__int64>(length) * 8) return false;
+
+	// BFINAL (1), BTYPE (2), HLIT (5), HDIST (5) and HCLEN (4), least significant bit first
+	unsigned int header = 0;
+	for(int index = 0; index < 17; index++) header |= ((data[(bit + index) >> 3] >> ((bit + index) & 7)) & 1) << index;
+
+	// BFINAL must be clear and BTYPE must be 2 (dynamic Huffman codes)
+	if((header & 0x07) != 0x04) return false;
+
+	// There can be at most 286 literal/length codes and 30 distance codes
+	if((((header >> 3) & 0x1F) > 29) || (((header >> 8) & 0x1F) > 29)) return false;
+
+	// The code length code lengths must describe a complete prefix code
+	int count = ((header >> 13) & 0x0F) + 4;
+	int kraft = 0;
+
+	for(int index = 0; index < count; index++) {
+
+		int codelength = 0;
+		__int64 offset = bit + 17 + (index * 3);
+		for(int shift = 0; shift < 3; shift++) codelength |= ((data[(offset + shift) >> 3] >> ((offset + shift) & 7)) & 1) << shift;
+
+		if(codelength > 0) kraft += (128 >> codelength);
+	}
+
+	return (kraft == 128);
+}
+
 //--------------------------------------------------------------------------
 // GzipReader::Length::get
 //
@@ -162,7 +653,10 @@ void GzipReader::Flush(void)
 __int64 GzipReader::Length::get(void)
 {
 	CHECK_DISPOSED(m_disposed);
-	throw gcnew NotSupportedException();
+
+	// The length of the stream is only known when there is an index
+	if(!m_index) throw gcnew NotSupportedException();
+	return m_index->Length;
 }
 
 //---------------------------------------------------------------------------
@@ -175,7 +669,7 @@ __int64 GzipReader::Position::get(void)
 	CHECK_DISPOSED(m_disposed);
 
 	msclr::lock lock(m_lock);
-	return static_cast<__int64>(m_zstream->total_out);
+	return m_position;
 }
 
 //---------------------------------------------------------------------------
@@ -185,10 +679,102 @@ __int64 GzipReader::Position::get(void)
 
 void GzipReader::Position::set(__int64 value)
 {
-	UNREFERENCED_PARAMETER(value);
-
 	CHECK_DISPOSED(m_disposed);
-	throw gcnew NotSupportedException();
+
+	if(!m_index) throw gcnew NotSupportedException();
+	if(value < 0) throw gcnew ArgumentOutOfRangeException("value");
+
+	msclr::lock lock(m_lock);
+	SeekToPosition(value);
+}
+
+//---------------------------------------------------------------------------
+// GzipReader::QueueChunks (private)
+//
+// Queues chunks of a large member for speculative decompression
+//
+// Arguments:
+//
+//	NONE
+
+void GzipReader::QueueChunks(void)
+{
+	while(!m_chunks->IsFull) {
+
+		// The first chunk starts at the first block of the member, the rest start at fixed intervals
+		bool first = (m_specqueued < 0);
+		__int64 position = (first) ? (m_specbit >> 3) : m_specqueued;
+
+		// Each chunk needs enough data to inflate past its nominal end to the next block boundary; keep
+		// everything from the chunk currently being returned when reading more into the window
+		if((!m_endofstream) && (m_windowbase + m_windowlen < position + (SPECULATIVE_CHUNK_SIZE * 2))) {
+
+			if(ReadWindow(m_specbit >> 3)) continue;
+			if(!m_endofstream) break;
+		}
+
+		int offset = static_cast<int>(position - m_windowbase);
+		if(offset >= m_windowlen) break;
+
+		m_chunks->Enqueue(gcnew Func<Object^, Chunk^>(this, &GzipReader::InflateChunk), gcnew Chunk(m_window, m_windowbase, 
+			offset, Math::Min(m_windowlen - offset, SPECULATIVE_CHUNK_SIZE * 2), (first) ? m_specbit : -1));
+
+		m_specqueued = position + SPECULATIVE_CHUNK_SIZE;
+	}
+}
+
+//---------------------------------------------------------------------------
+// GzipReader::QueueMembers (private)
+//
+// Scans the read-ahead window and queues candidate members for decompression
+//
+// Arguments:
+//
+//	NONE
+
+void GzipReader::QueueMembers(void)
+{
+	while(!m_pending->IsFull) {
+
+		// Scan the window for the next possible GZIP member header (ID1, ID2, CM and FLG)
+		int pos = static_cast<int>(Math::Max(m_scanpos, m_next) - m_windowbase);
+		while((pos + 4 <= m_windowlen) && ((m_window[pos] != 0x1F) || (m_window[pos + 1] != 0x8B) || 
+			(m_window[pos + 2] != Z_DEFLATED) || ((m_window[pos + 3] & 0xE0) != 0))) pos++;
+
+		m_scanpos = m_windowbase + pos;
+
+		if(pos + 4 <= m_windowlen) {
+
+			// Finding a header ends the previous candidate, queue it now that its data is most likely all
+			// in the window; candidates at or before the last member returned no longer need to be decoded
+			if(m_candidate >= m_next) {
+
+				int offset = static_cast<int>(m_candidate - m_windowbase);
+				m_pending->Enqueue(gcnew Func<Object^, Member^>(this, &GzipReader::InflateMember), 
+					gcnew Member(m_window, m_windowbase, offset, m_windowlen - offset));
+			}
+
+			m_candidate = m_scanpos++;
+			continue;
+		}
+
+		// Read more data into the window, keeping everything from the next member to be returned
+		if((!m_endofstream) && (ReadWindow(m_next))) continue;
+
+		// At the end of the stream the last candidate can be queued, otherwise the window is full
+		// and the next member will have to be inflated serially
+		if((m_endofstream) && (m_candidate >= m_next)) {
+
+			int offset = static_cast<int>(m_candidate - m_windowbase);
+			m_pending->Enqueue(gcnew Func<Object^, Member^>(this, &GzipReader::InflateMember), 
+				gcnew Member(m_window, m_windowbase, offset, m_windowlen - offset));
+
+			m_candidate = -1;
+			continue;
+		}
+
+		break;
+	}
 }
 
 //---------------------------------------------------------------------------
@@ -216,6 +802,82 @@ int GzipReader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 	// If there is no buffer to read into or the stream is already done, return zero
 	if((count == 0) || (m_finished)) return 0;
 
+	// Parallel decompression inflates members ahead of the reader and returns them in order
+	if(m_pending) {
+
+		int read = 0;						// Total bytes read from the stream
+
+		while(count > 0) {
+
+			// Copy data from the current member or chunk into the output buffer
+			if(m_outavail > 0) {
+
+				int next = Math::Min(m_outavail, count);
+				Array::Copy(m_out, m_outpos, buffer, offset, next);
+
+				m_outpos += next;			// Move offset into the decompressed data
+				m_outavail -= next;			// Decrement the amount of decompressed data
+				offset += next;				// Move offset into the output buffer
+				count -= next;				// Decrement the amount of data still to read
+				read += next;				// Increment the amount of data read
+				continue;
+			}
+
+			m_out = nullptr;				// Release the decompressed data
+
+			// A member that couldn't be inflated in parallel or speculatively is inflated serially
+			if((m_serial) || (m_specserial)) {
+
+				int next = (m_serial) ? ReadSerialMember(buffer, offset, count) : ReadSpeculativeSerial(buffer, offset, count);
+
+				offset += next;				// Move offset into the output buffer
+				count -= next;				// Decrement the amount of data still to read
+				read += next;				// Increment the amount of data read
+				continue;
+			}
+
+			// A large member is returned one speculatively inflated chunk at a time
+			if(m_speculative) { ReadNextChunk(); continue; }
+
+			// Keep the decompression queue full and get the next decoded candidate
+			QueueMembers();
+			if((!m_head) && (!m_pending->IsEmpty)) m_head = m_pending->Dequeue();
+
+			// Candidates before the next member were false positives inside a member already returned
+			if((m_head) && (m_head->Position < m_next)) { m_head = nullptr; continue; }
+
+			// A complete candidate that begins where the previous member ended is the next member
+			if((m_head) && (m_head->Position == m_next) && (m_head->Complete)) {
+
+				m_out = m_head->Output;
+				m_outpos = 0;
+				m_outavail = m_head->OutputLength;
+
+				m_next += m_head->Consumed;
+				m_head = nullptr;
+				continue;
+			}
+
+			// Otherwise if there is another member header at this position, the member was too large to
+			// be inflated as a single task and is split into chunks that are inflated speculatively
+			int pos = static_cast<int>(m_next - m_windowbase);
+			if((pos + 2 <= m_windowlen) && (m_window[pos] == 0x1F) && (m_window[pos + 1] == 0x8B)) {
+
+				BeginSpeculativeMember();
+				continue;
+			}
+
+			// There are no more members; an empty stream is not valid and anything else is ignored
+			if(m_next == 0) throw gcnew InvalidDataException();
+
+			m_finished = true;
+			break;
+		}
+
+		m_position += read;
+		return read;
+	}
+
 	// Pin both the input and output byte arrays in memory
 	pin_ptr<unsigned __int8> pinin = &m_in[0];
 	pin_ptr<unsigned __int8> pinout = &buffer[0];
@@ -241,9 +903,168 @@ int GzipReader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 		int result = inflate(m_zstream, Z_NO_FLUSH);
 		m_inpos = (uintptr_t(m_zstream->next_in) - uintptr_t(pinin));
 
-		// Z_STREAM_END indicates that there is no more data to decompress, but zlib
-		// will not return it more than once -- set a flag to prevent more attempts
-		if(result == Z_STREAM_END) { m_finished = true; break; }
+		// A zlib header with FDICT set stops for the dictionary; zlib verifies that its Adler-32 matches
+		if((result == Z_NEED_DICT) && (m_dictionary)) {
+
+			result = m_dictionary->InflateSetDictionary(m_zstream);
+			if(result != Z_OK) throw gcnew GzipException(result);
+			continue;
+		}
+
+		// Z_STREAM_END indicates the end of a GZIP member, but multiple members can be concatenated
+		// together; if there is no more data or it's not another member, set a flag to prevent more attempts
+		if(result == Z_STREAM_END) {
+
+			// zlib and raw deflate streams cannot be concatenated, anything after the end is ignored
+			if((m_format == GzipContainerFormat::Zlib) || (m_format == GzipContainerFormat::Raw)) { m_finished = true; break; }
+
+			// A member resumed from an index checkpoint was inflated as raw deflate data, skip the trailer
+			for(int skip = (m_raw) ? TRAILER_SIZE : 0; skip > 0;) {
+
+				if(m_zstream->avail_in == 0) m_inpos = (m_zstream->avail_in = m_stream->Read(m_in, 0, BUFFER_SIZE)) - m_zstream->avail_in;
+				if(m_zstream->avail_in == 0) throw gcnew InvalidDataException();
+
+				int next = Math::Min(skip, static_cast<int>(m_zstream->avail_in));
+				m_inpos += next;
+				m_zstream->avail_in -= next;
+				skip -= next;
+			}
+
+			if(m_zstream->avail_in == 0) m_inpos = (m_zstream->avail_in = m_stream->Read(m_in, 0, BUFFER_SIZE)) - m_zstream->avail_in;
+			if((m_zstream->avail_in == 0) || (m_in[static_cast<int>(m_inpos)] != 0x1F)) { m_finished = true; break; }
+
+			result = (m_raw) ? inflateReset2(m_zstream, 16 + MAX_WBITS) : inflateReset(m_zstream);
+			if(result != Z_OK) throw gcnew GzipException(result);
+
+			m_raw = false;
+		}
+
+		else if(result != Z_OK) throw gcnew GzipException(result);
+
+	} while(m_zstream->avail_out > 0);
+
+	m_position += (count - m_zstream->avail_out);
+	return (count - m_zstream->avail_out);
+}
+
+//---------------------------------------------------------------------------
+// GzipReader::ReadLE32 (internal, static)
+//
+// Reads an unsigned 32 bit value from a buffer
+//
+// Arguments:
+//
+//	buffer		- Buffer from which to read the value
+//	offset		- Offset of the value within the buffer
+
+unsigned int GzipReader::ReadLE32(array<unsigned __int8>^ buffer, int offset)
+{
+	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException();
+
+	// Convert the 4 individual bytes into a single unsigned 32-bit value
+	return (buffer[offset] << 0) | (buffer[offset + 1] << 8) | (buffer[offset + 2] << 16) | (buffer[offset + 3] << 24);
+}
+
+//---------------------------------------------------------------------------
+// GzipReader::ReadNextChunk (private)
+//
+// Resolves the next speculatively inflated chunk of a large member
+//
+// Arguments:
+//
+//	NONE
+
+void GzipReader::ReadNextChunk(void)
+{
+	// Keep the decompression queue full and get the next chunk
+	QueueChunks();
+	Chunk^ chunk = (m_chunks->IsEmpty) ? nullptr : m_chunks->Dequeue();
+
+	// If the chunk couldn't be inflated or doesn't start where the previous chunk ended, speculation
+	// has failed and the remainder of the member has to be inflated serially
+	if((!chunk) || (!chunk->Complete) || (chunk->StartBit != m_specbit)) { StartSpeculativeSerial(); return; }
+
+	// Now that the history is known, replace the markers with the data they refer to
+	for each(__int64 marker in chunk->Markers) chunk->Output[static_cast<int>(marker >> 16)] = m_history[static_cast<int>(marker & 0xFFFF)];
+
+	int length = chunk->OutputLength;
+	if(length > 0) {
+
+		pin_ptr<unsigned __int8> pinout = &chunk->Output[0];
+		m_speccrc = crc32(m_speccrc, pinout, length);
+		m_specsize += length;
+
+		// Slide the history window to end with the data from this chunk
+		if(length >= WINDOW_SIZE) Array::Copy(chunk->Output, length - WINDOW_SIZE, m_history, 0, WINDOW_SIZE);
+		else {
+
+			Array::Copy(m_history, length, m_history, 0, WINDOW_SIZE - length);
+			Array::Copy(chunk->Output, 0, m_history, WINDOW_SIZE - length, length);
+		}
+	}
+
+	m_out = chunk->Output;
+	m_outpos = 0;
+	m_outavail = length;
+
+	m_specbit = chunk->EndBit;
+	if(!chunk->Final) return;
+
+	// The final chunk includes the member trailer, which must match the data that was returned
+	array<unsigned __int8>^ trailer = chunk->Trailer;
+	unsigned int crc = ReadLE32(trailer, 0);
+	unsigned int size = ReadLE32(trailer, 4);
+
+	if((crc != m_speccrc) || (size != static_cast<unsigned int>(m_specsize))) throw gcnew InvalidDataException();
+
+	// Discard any chunks queued past the end of the member and continue with the next member
+	m_chunks->Clear();
+	m_next = ((m_specbit + 7) >> 3) + 8;
+	m_speculative = false;
+}
+
+//---------------------------------------------------------------------------
+// GzipReader::ReadSerialMember (private)
+//
+// Inflates a member that could not be decompressed in parallel
+//
+// Arguments:
+//
+//	buffer		- Destination data buffer
+//	offset		- Offset within buffer to begin copying data
+//	count		- Maximum number of bytes to write into the destination buffer
+
+int GzipReader::ReadSerialMember(array<unsigned __int8>^ buffer, int offset, int count)
+{
+	pin_ptr<unsigned __int8> pinout = &buffer[0];
+
+	// Set up the output buffer pointer and available length
+	m_zstream->next_out = reinterpret_cast<Bytef*>(&pinout[offset]);
+	m_zstream->avail_out = count;
+
+	do {
+
+		// If the window has been exhausted read more data into it; none of the existing data needs
+		// to be kept and running out of data before the end of the member is an error
+		if(m_serialpos == m_windowbase + m_windowlen) {
+
+			if(!ReadWindow(m_serialpos)) throw gcnew InvalidDataException();
+		}
+
+		// Reset the input pointer based on the current position in the window, the address
+		// of the window itself may have changed between calls due to pinning
+		int pos = static_cast<int>(m_serialpos - m_windowbase);
+		pin_ptr<unsigned __int8> pinin = &m_window[0];
+
+		m_zstream->next_in = reinterpret_cast<Bytef*>(&pinin[pos]);
+		m_zstream->avail_in = m_windowlen - pos;
+
+		// Attempt to decompress the next block of data and adjust the stream position
+		int result = inflate(m_zstream, Z_NO_FLUSH);
+		m_serialpos += (m_windowlen - pos) - m_zstream->avail_in;
+
+		// At the end of the member go back to parallel decompression for the next one
+		if(result == Z_STREAM_END) { m_next = m_serialpos; m_serial = false; break; }
 		else if(result != Z_OK) throw gcnew GzipException(result);
 
 	} while(m_zstream->avail_out > 0);
@@ -251,6 +1072,107 @@ int GzipReader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 	return (count - m_zstream->avail_out);
 }
 
+//---------------------------------------------------------------------------
+// GzipReader::ReadSpeculativeSerial (private)
+//
+// Inflates the remainder of a large member after speculation has failed
+//
+// Arguments:
+//
+//	buffer		- Destination data buffer
+//	offset		- Offset within buffer to begin copying data
+//	count		- Maximum number of bytes to write into buffer
+
+int GzipReader::ReadSpeculativeSerial(array<unsigned __int8>^ buffer, int offset, int count)
+{
+	pin_ptr<unsigned __int8> pinout = &buffer[0];
+
+	// Set up the output buffer pointer and available length
+	m_zstream->next_out = reinterpret_cast<Bytef*>(&pinout[offset]);
+	m_zstream->avail_out = count;
+
+	do {
+
+		// If the window has been exhausted read more data into it; running out of data
+		// before the end of the member is an error
+		if(m_serialpos == m_windowbase + m_windowlen) {
+
+			if(!ReadWindow(m_serialpos)) throw gcnew InvalidDataException();
+		}
+
+		int pos = static_cast<int>(m_serialpos - m_windowbase);
+		pin_ptr<unsigned __int8> pinin = &m_window[0];
+
+		m_zstream->next_in = reinterpret_cast<Bytef*>(&pinin[pos]);
+		m_zstream->avail_in = m_windowlen - pos;
+
+		// Raw deflate data doesn't include the trailer, the CRC and length are tracked here
+		Bytef* out = m_zstream->next_out;
+		int result = inflate(m_zstream, Z_NO_FLUSH);
+		m_serialpos += (m_windowlen - pos) - m_zstream->avail_in;
+
+		uInt produced = static_cast<uInt>(m_zstream->next_out - out);
+		m_speccrc = crc32(m_speccrc, out, produced);
+		m_specsize += produced;
+
+		if(result == Z_STREAM_END) {
+
+			// The member trailer follows the deflate data and must match the data that was returned
+			while(m_windowbase + m_windowlen < m_serialpos + 8) if(!ReadWindow(m_serialpos)) throw gcnew InvalidDataException();
+
+			pos = static_cast<int>(m_serialpos - m_windowbase);
+			unsigned int crc = ReadLE32(m_window, pos);
+			unsigned int size = ReadLE32(m_window, pos + 4);
+
+			if((crc != m_speccrc) || (size != static_cast<unsigned int>(m_specsize))) throw gcnew InvalidDataException();
+
+			// Switch back to GZIP decoding and go back to parallel decompression for the next member
+			result = inflateReset2(m_zstream, 16 + MAX_WBITS);
+			if(result != Z_OK) throw gcnew GzipException(result);
+
+			m_next = m_serialpos + 8;
+			m_specserial = m_speculative = false;
+			break;
+		}
+		
+		else if(result != Z_OK) throw gcnew GzipException(result);
+
+	} while(m_zstream->avail_out > 0);
+
+	return (count - m_zstream->avail_out);
+}
+
+//---------------------------------------------------------------------------
+// GzipReader::ReadWindow (private)
+//
+// Reads more compressed data into the read-ahead window
+//
+// Arguments:
+//
+//	retain		- Stream offset of the first window byte that must be retained
+
+bool GzipReader::ReadWindow(__int64 retain)
+{
+	int keep = m_windowlen - static_cast<int>(retain - m_windowbase);
+	if(keep >= m_windowsize) return false;
+
+	// Queued members hold a reference to the window they were created from, so rather than shifting
+	// the data in place a new window is created that starts with the retained data
+	array<unsigned __int8>^ window = gcnew array<unsigned __int8>(m_windowsize);
+	if(keep > 0) Array::Copy(m_window, static_cast<int>(retain - m_windowbase), window, 0, keep);
+
+	// Fill the remainder of the window from the base stream
+	int read = 0, next = 0;
+	while((keep + read < window->Length) && ((next = m_stream->Read(window, keep + read, window->Length - keep - read)) > 0)) read += next;
+	if(keep + read < window->Length) m_endofstream = true;
+
+	m_window = window;
+	m_windowbase = retain;
+	m_windowlen = keep + read;
+
+	return (read > 0);
+}
+
 //---------------------------------------------------------------------------
 // GzipReader::Seek
 //
@@ -263,11 +1185,83 @@ int GzipReader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 
 __int64 GzipReader::Seek(__int64 offset, SeekOrigin origin)
 {
-	UNREFERENCED_PARAMETER(offset);
-	UNREFERENCED_PARAMETER(origin);
-
 	CHECK_DISPOSED(m_disposed);
-	throw gcnew NotSupportedException();
+
+	// Seeking is only supported when there is an index
+	if(!m_index) throw gcnew NotSupportedException();
+
+	msclr::lock lock(m_lock);
+
+	// Convert the offset into an absolute position within the decompressed data
+	__int64 position = offset;
+	if(origin == SeekOrigin::Current) position += m_position;
+	else if(origin == SeekOrigin::End) position += m_index->Length;
+	else if(origin != SeekOrigin::Begin) throw gcnew ArgumentOutOfRangeException("origin");
+
+	if(position < 0) throw gcnew IOException("An attempt was made to move the position before the beginning of the stream");
+
+	SeekToPosition(position);
+	return m_position;
+}
+
+//---------------------------------------------------------------------------
+// GzipReader::SeekToPosition (private)
+//
+// Repositions the stream using the nearest checkpoint of the index
+//
+// Arguments:
+//
+//	position	- Decompressed data offset to seek to
+
+void GzipReader::SeekToPosition(__int64 position)
+{
+	// A position at or beyond the end of the stream leaves nothing more to be read
+	if(position >= m_index->Length) { m_finished = true; m_position = position; return; }
+
+	// Seeking forward without passing another checkpoint continues from the current position,
+	// otherwise decompression is restarted from the last checkpoint before the target position
+	GzipIndex::Checkpoint^ checkpoint = m_index->Find(position);
+	if((m_finished) || (position < m_position) || (checkpoint->Output > m_position)) {
+
+		// Checkpoints are at deflate block boundaries, inflate from there as raw deflate data
+		int result = inflateReset2(m_zstream, -MAX_WBITS);
+		if(result != Z_OK) throw gcnew GzipException(result);
+
+		// Restart reading at the byte that contains the first bit of the checkpoint
+		m_stream->Position = m_basepos + checkpoint->Input - ((checkpoint->Bits > 0) ? 1 : 0);
+		m_zstream->avail_in = 0;
+		m_inpos = 0;
+
+		if(checkpoint->Bits > 0) {
+
+			int value = m_stream->ReadByte();
+			if(value < 0) throw gcnew InvalidDataException();
+
+			result = inflatePrime(m_zstream, checkpoint->Bits, value >> (8 - checkpoint->Bits));
+			if(result != Z_OK) throw gcnew GzipException(result);
+		}
+
+		// Prime the decompressor with the history that precedes the checkpoint
+		array<unsigned __int8>^ history = GzipIndex::GetWindow(checkpoint);
+		if(history->Length > 0) {
+
+			pin_ptr<unsigned __int8> pinhistory = &history[0];
+			result = inflateSetDictionary(m_zstream, reinterpret_cast<Bytef*>(pinhistory), history->Length);
+			if(result != Z_OK) throw gcnew GzipException(result);
+		}
+
+		m_raw = true;
+		m_finished = false;
+		m_position = checkpoint->Output;
+	}
+
+	// Inflate and discard the data between the checkpoint and the target position
+	array<unsigned __int8>^ discard = gcnew array<unsigned __int8>(BUFFER_SIZE);
+	while(m_position < position) {
+
+		if(Read(discard, 0, static_cast<int>(Math::Min(position - m_position, static_cast<__int64>(BUFFER_SIZE)))) == 0) 
+			throw gcnew InvalidDataException();
+	}
 }
 
 //---------------------------------------------------------------------------
@@ -287,6 +1281,47 @@ void GzipReader::SetLength(__int64 value)
 	throw gcnew NotSupportedException();
 }
 
+//---------------------------------------------------------------------------
+// GzipReader::StartSpeculativeSerial (private)
+//
+// Switches from speculative to serial inflation of a large member
+//
+// Arguments:
+//
+//	NONE
+
+void GzipReader::StartSpeculativeSerial(void)
+{
+	// Wait for and discard any chunks still being inflated
+	m_chunks->Clear();
+
+	// Inflate the remainder of the member as raw deflate data starting with the known history
+	int result = inflateReset2(m_zstream, -MAX_WBITS);
+	if(result != Z_OK) throw gcnew GzipException(result);
+
+	int historylength = static_cast<int>(Math::Min(m_specsize, static_cast<__int64>(WINDOW_SIZE)));
+	if(historylength > 0) {
+
+		pin_ptr<unsigned __int8> pinhistory = &m_history[WINDOW_SIZE - historylength];
+		result = inflateSetDictionary(m_zstream, pinhistory, historylength);
+		if(result != Z_OK) throw gcnew GzipException(result);
+	}
+
+	// The next block is not necessarily on a byte boundary
+	m_serialpos = m_specbit >> 3;
+
+	int bits = static_cast<int>(m_specbit & 7);
+	if(bits > 0) {
+
+		result = inflatePrime(m_zstream, 8 - bits, m_window[static_cast<int>(m_serialpos - m_windowbase)] >> bits);
+		if(result != Z_OK) throw gcnew GzipException(result);
+
+		m_serialpos++;
+	}
+
+	m_specserial = true;
+}
+
 //---------------------------------------------------------------------------
 // GzipReader::Write
 //
@@ -308,6 +1343,38 @@ void GzipReader::Write(array<unsigned __int8>^ buffer, int offset, int count)
 	throw gcnew NotSupportedException();
 }
 
+//---------------------------------------------------------------------------
+// GzipReader::Chunk Constructor
+//
+// Arguments:
+//
+//	window		- Compressed data window
+//	windowbase	- Stream offset of the compressed data window
+//	offset		- Offset of the chunk within the window
+//	length		- Length of the data available from offset
+//	startbit	- Stream bit offset of the first block, or -1 if unknown
+
+GzipReader::Chunk::Chunk(array<unsigned __int8>^ window, __int64 windowbase, int offset, int length, __int64 startbit) : 
+	Window(window), Position(windowbase + offset), Offset(offset), Length(length), StartBit(startbit), EndBit(-1), Complete(false), 
+	Final(false), OutputLength(0)
+{
+}
+
+//---------------------------------------------------------------------------
+// GzipReader::Member Constructor
+//
+// Arguments:
+//
+//	window		- Compressed data window
+//	windowbase	- Stream offset of the compressed data window
+//	offset		- Offset of the member within the window
+//	length		- Length of the data available from offset
+
+GzipReader::Member::Member(array<unsigned __int8>^ window, __int64 windowbase, int offset, int length) : 
+	Window(window), Position(windowbase + offset), Offset(offset), Length(length), Complete(false), Consumed(0), OutputLength(0)
+{
+}
+
 //---------------------------------------------------------------------------
 
 } // zuki::io::compression
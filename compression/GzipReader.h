@@ -25,10 +25,15 @@
 #pragma once
 
 #include <zlib.h>
+#include "GzipContainerFormat.h"
+#include "GzipDictionary.h"
+#include "GzipIndex.h"
+#include "TaskQueue.h"
 
 #pragma warning(push, 4)				// Enable maximum compiler warnings
 
 using namespace System;
+using namespace System::Collections::Generic;
 using namespace System::IO;
 
 namespace zuki::io::compression {
@@ -47,6 +52,11 @@ public:
 	//
 	GzipReader(Stream^ stream);
 	GzipReader(Stream^ stream, bool leaveopen);
+	GzipReader(Stream^ stream, GzipContainerFormat format, bool leaveopen);
+	GzipReader(Stream^ stream, GzipContainerFormat format, GzipDictionary^ dictionary, bool leaveopen);
+	GzipReader(Stream^ stream, GzipIndex^ index, bool leaveopen);
+	GzipReader(Stream^ stream, int threads, bool leaveopen);
+	GzipReader(Stream^ stream, int threads, int maxpending, bool leaveopen);
 
 	//-----------------------------------------------------------------------
 	// Member Functions
@@ -128,6 +138,21 @@ public:
 		void set(__int64 value) override;
 	}
 
+internal:
+
+	//-----------------------------------------------------------------------
+	// Internal Member Functions
+
+	// InitInflate (static)
+	//
+	// Initializes an inflate stream state
+	static void InitInflate(z_stream* zstream, int windowbits);
+
+	// ReadLE32 (static)
+	//
+	// Reads a little endian 32-bit number from a buffer
+	static unsigned int ReadLE32(array<unsigned __int8>^ buffer, int offset);
+
 private:
 
 	// BUFFER_SIZE
@@ -135,11 +160,170 @@ private:
 	// Size of the local input/output buffer, in bytes
 	static const int BUFFER_SIZE = 65536;
 
+	// MAXIMUM_PENDING_CHUNKS
+	//
+	// Maximum number of large member chunks inflated ahead of the reader
+	static const int MAXIMUM_PENDING_CHUNKS = 16;
+
+	// PARALLEL_MEMBER_LIMIT
+	//
+	// Maximum decompressed size of a member inflated in parallel, in bytes
+	static const int PARALLEL_MEMBER_LIMIT = (16 << 20);
+
+	// PARALLEL_WINDOW_SIZE
+	//
+	// Size of the compressed data read-ahead window, in bytes
+	static const int PARALLEL_WINDOW_SIZE = (8 << 20);
+
+	// SPECULATIVE_CHUNK_SIZE
+	//
+	// Size of each chunk of a large member that is inflated speculatively, in bytes
+	static const int SPECULATIVE_CHUNK_SIZE = (1 << 20);
+
+	// SPECULATIVE_OUTPUT_LIMIT
+	//
+	// Maximum decompressed size of a speculatively inflated chunk, in bytes
+	static const int SPECULATIVE_OUTPUT_LIMIT = (64 << 20);
+
+	// TRAILER_SIZE
+	//
+	// Size of the GZIP member trailer, in bytes
+	static const int TRAILER_SIZE = 8;
+
+	// WINDOW_SIZE
+	//
+	// Size of the deflate history window
+	static const int WINDOW_SIZE = (1 << MAX_WBITS);
+
 	// Destructor / Finalzier
 	//
 	~GzipReader();
 	!GzipReader();
 
+	// Instance Constructor
+	//
+	GzipReader(Stream^ stream, GzipContainerFormat format, GzipDictionary^ dictionary, int threads, int maxpending, bool leaveopen);
+
+	// Chunk
+	//
+	// Chunk of a large GZIP member to be inflated speculatively
+	ref class Chunk
+	{
+	public:
+
+		// Instance Constructor
+		//
+		Chunk(array<unsigned __int8>^ window, __int64 windowbase, int offset, int length, __int64 startbit);
+
+		//-------------------------------------------------------------------
+		// Fields
+
+		initonly array<unsigned __int8>^	Window;			// Compressed data window
+		initonly __int64					Position;		// Stream offset of the chunk
+		initonly int						Offset;			// Offset of the chunk in the window
+		initonly int						Length;			// Length of the available data
+		__int64								StartBit;		// Stream bit offset of first block
+		__int64								EndBit;			// Stream bit offset after last block
+		bool								Complete;		// Flag if chunk was fully inflated
+		bool								Final;			// Flag if chunk ends the member
+		array<unsigned __int8>^				Output;			// Decompressed chunk data
+		int									OutputLength;	// Length of the decompressed data
+		List<__int64>^						Markers;		// Unresolved history references
+		array<unsigned __int8>^				Trailer;		// GZIP member trailer
+	};
+
+	// Member
+	//
+	// Candidate GZIP member to be inflated in parallel
+	ref class Member
+	{
+	public:
+
+		// Instance Constructor
+		//
+		Member(array<unsigned __int8>^ window, __int64 windowbase, int offset, int length);
+
+		//-------------------------------------------------------------------
+		// Fields
+
+		initonly array<unsigned __int8>^	Window;			// Compressed data window
+		initonly __int64					Position;		// Stream offset of the member
+		initonly int						Offset;			// Offset of the member in the window
+		initonly int						Length;			// Length of the available data
+		bool								Complete;		// Flag if member was fully inflated
+		int									Consumed;		// Compressed length of the member
+		array<unsigned __int8>^				Output;			// Decompressed member data
+		int									OutputLength;	// Length of the decompressed data
+	};
+
+	//-----------------------------------------------------------------------
+	// Private Member Functions
+
+	// BeginSpeculativeMember
+	//
+	// Starts inflating a large member as speculatively decoded chunks
+	void BeginSpeculativeMember(void);
+
+	// InflateChunk
+	//
+	// Inflates a single chunk of a large member, speculatively if its history is unknown
+	Chunk^ InflateChunk(Object^ state);
+
+	// InflateChunkPass
+	//
+	// Inflates a chunk once using the specified history dictionary
+	bool InflateChunkPass(z_stream* zstream, Chunk^ chunk, Bytef const* dictionary, array<unsigned __int8>^% output, int% outputlength);
+
+	// InflateMember
+	//
+	// Inflates a single candidate GZIP member from the read-ahead window
+	Member^ InflateMember(Object^ state);
+
+	// IsBlockHeader (static)
+	//
+	// Determines if a bit offset appears to be the start of a dynamic deflate block
+	static bool IsBlockHeader(unsigned __int8 const* data, int length, __int64 bit);
+
+	// QueueChunks
+	//
+	// Queues chunks of a large member for speculative decompression
+	void QueueChunks(void);
+
+	// QueueMembers
+	//
+	// Scans the read-ahead window and queues candidate members for decompression
+	void QueueMembers(void);
+
+	// ReadNextChunk
+	//
+	// Resolves the next speculatively inflated chunk of a large member
+	void ReadNextChunk(void);
+
+	// ReadSerialMember
+	//
+	// Inflates a member that could not be decompressed in parallel
+	int ReadSerialMember(array<unsigned __int8>^ buffer, int offset, int count);
+
+	// ReadSpeculativeSerial
+	//
+	// Inflates the remainder of a large member after speculation has failed
+	int ReadSpeculativeSerial(array<unsigned __int8>^ buffer, int offset, int count);
+
+	// ReadWindow
+	//
+	// Reads more compressed data into the read-ahead window
+	bool ReadWindow(__int64 retain);
+
+	// SeekToPosition
+	//
+	// Repositions the stream using the nearest checkpoint of the index
+	void SeekToPosition(__int64 position);
+
+	// StartSpeculativeSerial
+	//
+	// Switches from speculative to serial inflation of a large member
+	void StartSpeculativeSerial(void);
+
 	//-----------------------------------------------------------------------
 	// Member Variables
 
@@ -150,6 +334,35 @@ private:
 	size_t							m_inpos;		// Current position in the buffer
 	bool							m_finished;		// Flag if operation is finished
 	z_stream*						m_zstream;		// GZIP stream state information
+	initonly GzipContainerFormat	m_format;		// Container format
+	GzipDictionary^					m_dictionary;	// Optional preset dictionary
+	TaskQueue<Member^>^				m_pending;		// Pending member decompressions
+	Member^							m_head;			// Next dequeued member
+	array<unsigned __int8>^			m_out;			// Decompressed data being returned
+	int								m_outpos;		// Position within the decompressed data
+	int								m_outavail;		// Available decompressed data
+	initonly int					m_windowsize;	// Size of the read-ahead window
+	array<unsigned __int8>^			m_window;		// Compressed data read-ahead window
+	__int64							m_windowbase;	// Stream offset of the window
+	int								m_windowlen;	// Length of the data in the window
+	bool							m_endofstream;	// Flag if base stream is exhausted
+	__int64							m_scanpos;		// Next offset to scan for a header
+	__int64							m_candidate;	// Header offset not yet queued
+	__int64							m_next;			// Offset of the next member
+	bool							m_serial;		// Flag if inflating serially
+	__int64							m_serialpos;	// Serial inflate stream offset
+	TaskQueue<Chunk^>^				m_chunks;		// Pending chunk decompressions
+	bool							m_speculative;	// Flag if inflating speculatively
+	bool							m_specserial;	// Flag if speculation has failed
+	__int64							m_specbit;		// Stream bit offset of next chunk
+	__int64							m_specqueued;	// Stream offset of next queued chunk
+	unsigned long					m_speccrc;		// CRC-32 of the member data
+	__int64							m_specsize;		// Length of the member data
+	array<unsigned __int8>^			m_history;		// Deflate history window
+	GzipIndex^						m_index;		// Random access index
+	__int64							m_basepos;		// Base stream offset of the index
+	__int64							m_position;		// Decompressed stream position
+	bool							m_raw;			// Flag if inflating raw deflate data
 
 	Object^	m_lock = gcnew Object();		// Synchronization object
 };
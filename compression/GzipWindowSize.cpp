@@ -0,0 +1,141 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "GzipWindowSize.h"
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// GzipWindowSize Constructor
+//
+// Arguments:
+//
+//	windowlog	- Base two logarithm of the window size
+
+GzipWindowSize::GzipWindowSize(int windowlog) : m_windowlog(windowlog)
+{
+	// zlib will not create a raw deflate stream with a 256 byte window, so 9 is the minimum
+	if((windowlog < 9) || (windowlog > MAX_WBITS)) throw gcnew ArgumentOutOfRangeException("windowlog");
+}
+
+//---------------------------------------------------------------------------
+// GzipWindowSize::operator == (static)
+
+bool GzipWindowSize::operator==(GzipWindowSize lhs, GzipWindowSize rhs)
+{
+	return lhs.m_windowlog == rhs.m_windowlog;
+}
+
+//---------------------------------------------------------------------------
+// GzipWindowSize::operator != (static)
+
+bool GzipWindowSize::operator!=(GzipWindowSize lhs, GzipWindowSize rhs)
+{
+	return lhs.m_windowlog != rhs.m_windowlog;
+}
+
+//---------------------------------------------------------------------------
+// GzipWindowSize::operator GzipWindowSize (static)
+
+GzipWindowSize::operator GzipWindowSize(int windowlog)
+{
+	return GzipWindowSize(windowlog);
+}
+
+//---------------------------------------------------------------------------
+// GzipWindowSize::operator int (static)
+
+GzipWindowSize::operator int(GzipWindowSize rhs)
+{
+	return rhs.m_windowlog;
+}
+
+//---------------------------------------------------------------------------
+// GzipWindowSize::Equals
+//
+// Compares this GzipWindowSize to another GzipWindowSize
+//
+// Arguments:
+//
+//	rhs		- Right-hand GzipWindowSize to compare against
+
+bool GzipWindowSize::Equals(GzipWindowSize rhs)
+{
+	return (*this == rhs);
+}
+
+//---------------------------------------------------------------------------
+// GzipWindowSize::Equals
+//
+// Overrides Object::Equals()
+//
+// Arguments:
+//
+//	rhs		- Right-hand object instance to compare against
+
+bool GzipWindowSize::Equals(Object^ rhs)
+{
+	if(Object::ReferenceEquals(rhs, nullptr)) return false;
+
+	// Convert the provided object into a GzipWindowSize instance
+	GzipWindowSize^ rhsref = dynamic_cast<GzipWindowSize^>(rhs);
+	if(rhsref == nullptr) return false;
+
+	return (*this == *rhsref);
+}
+
+//---------------------------------------------------------------------------
+// GzipWindowSize::GetHashCode
+//
+// Overrides Object::GetHashCode()
+//
+// Arguments:
+//
+//	NONE
+
+int GzipWindowSize::GetHashCode(void)
+{
+	return m_windowlog.GetHashCode();
+}
+
+//---------------------------------------------------------------------------
+// GzipWindowSize::ToString
+//
+// Overrides Object::ToString()
+//
+// Arguments:
+//
+//	NONE
+
+String^ GzipWindowSize::ToString(void)
+{
+	return m_windowlog.ToString();
+}
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
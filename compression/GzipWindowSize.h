@@ -0,0 +1,120 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#ifndef __GZIPWINDOWSIZE_H_
+#define __GZIPWINDOWSIZE_H_
+#pragma once
+
+#include <zlib.h>
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+using namespace System;
+using namespace System::IO;
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// Class GzipWindowSize
+//
+// Indicates the deflate history window size to use with the GZIP encoder,
+// expressed as a power of two
+//---------------------------------------------------------------------------
+
+public value class GzipWindowSize
+{
+public:
+
+	// Instance Constructors
+	//
+	GzipWindowSize(int windowlog);
+
+	//-----------------------------------------------------------------------
+	// Overloaded Operators
+
+	// operator== (static)
+	//
+	static bool operator==(GzipWindowSize lhs, GzipWindowSize rhs);
+
+	// operator!= (static)
+	//
+	static bool operator!=(GzipWindowSize lhs, GzipWindowSize rhs);
+
+	// operator GzipWindowSize (static)
+	//
+	static operator GzipWindowSize(int windowlog);
+
+	//-----------------------------------------------------------------------
+	// Member Functions
+
+	// Equals
+	//
+	// Overrides Object::Equals()
+	virtual bool Equals(Object^ rhs) override;
+
+	// Equals
+	//
+	// Compares this GzipWindowSize to another GzipWindowSize
+	bool Equals(GzipWindowSize rhs);
+
+	// GetHashCode
+	//
+	// Overrides Object::GetHashCode()
+	virtual int GetHashCode(void) override;
+
+	// ToString
+	//
+	// Overrides Object::ToString()
+	virtual String^ ToString(void) override;
+
+	//-----------------------------------------------------------------------
+	// Fields
+
+	static initonly GzipWindowSize Default		= GzipWindowSize(MAX_WBITS);
+	static initonly GzipWindowSize Minimum		= GzipWindowSize(9);
+	static initonly GzipWindowSize Maximum		= GzipWindowSize(MAX_WBITS);
+
+internal:
+
+	//-----------------------------------------------------------------------
+	// Internal Operators
+
+	// operator int
+	//
+	// Exposes the value as an integer
+	static operator int(GzipWindowSize rhs);
+
+private:
+
+	//-----------------------------------------------------------------------
+	// Member Variables
+
+	int							m_windowlog;	// Underlying window size (log2)
+};
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
+
+#endif	// __GZIPWINDOWSIZE_H_
@@ -37,7 +37,7 @@ namespace zuki::io::compression {
 //	stream		- The stream the compressed data is written to
 
 GzipWriter::GzipWriter(Stream^ stream) : 
-	GzipWriter(stream, GzipCompressionLevel::Default, GzipCompressionStrategy::Default, GzipMemoryUsageLevel::Default, DEFAULT_BUFFER_SIZE, false)
+	GzipWriter(stream, nullptr, 0, GzipContainerFormat::Gzip, nullptr, GzipCompressionLevel::Default, GzipCompressionStrategy::Default, GzipMemoryUsageLevel::Default, GzipWindowSize::Default, DEFAULT_BUFFER_SIZE, 1, 0, false)
 {
 }
 
@@ -50,7 +50,7 @@ GzipWriter::GzipWriter(Stream^ stream) :
 //	level		- Indicates whether to emphasize speed or compression efficiency
 
 GzipWriter::GzipWriter(Stream^ stream, Compression::CompressionLevel level) : 
-	GzipWriter(stream, GzipCompressionLevel(level), GzipCompressionStrategy::Default, GzipMemoryUsageLevel::Default, DEFAULT_BUFFER_SIZE, false)
+	GzipWriter(stream, nullptr, 0, GzipContainerFormat::Gzip, nullptr, GzipCompressionLevel(level), GzipCompressionStrategy::Default, GzipMemoryUsageLevel::Default, GzipWindowSize::Default, DEFAULT_BUFFER_SIZE, 1, 0, false)
 {
 }
 
@@ -63,7 +63,7 @@ GzipWriter::GzipWriter(Stream^ stream, Compression::CompressionLevel level) :
 //	leaveopen	- Flag to leave the base stream open after disposal
 
 GzipWriter::GzipWriter(Stream^ stream, bool leaveopen) : 
-	GzipWriter(stream, GzipCompressionLevel::Default, GzipCompressionStrategy::Default, GzipMemoryUsageLevel::Default, DEFAULT_BUFFER_SIZE, leaveopen)
+	GzipWriter(stream, nullptr, 0, GzipContainerFormat::Gzip, nullptr, GzipCompressionLevel::Default, GzipCompressionStrategy::Default, GzipMemoryUsageLevel::Default, GzipWindowSize::Default, DEFAULT_BUFFER_SIZE, 1, 0, leaveopen)
 {
 }
 
@@ -77,34 +77,146 @@ GzipWriter::GzipWriter(Stream^ stream, bool leaveopen) :
 //	leaveopen	- Flag to leave the base stream open after disposal
 
 GzipWriter::GzipWriter(Stream^ stream, Compression::CompressionLevel level, bool leaveopen) : 
-	GzipWriter(stream, GzipCompressionLevel(level), GzipCompressionStrategy::Default, GzipMemoryUsageLevel::Default, DEFAULT_BUFFER_SIZE, leaveopen)
+	GzipWriter(stream, nullptr, 0, GzipContainerFormat::Gzip, nullptr, GzipCompressionLevel(level), GzipCompressionStrategy::Default, GzipMemoryUsageLevel::Default, GzipWindowSize::Default, DEFAULT_BUFFER_SIZE, 1, 0, leaveopen)
 {
 }
 
+//---------------------------------------------------------------------------
+// GzipWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed or decompressed data is written to
+//	level		- Indicates the level of compression to use
+//	threads		- Number of threads to use for compression (zero = processor count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+GzipWriter::GzipWriter(Stream^ stream, Compression::CompressionLevel level, int threads, bool leaveopen) : 
+	GzipWriter(stream, nullptr, 0, GzipContainerFormat::Gzip, nullptr, GzipCompressionLevel(level), GzipCompressionStrategy::Default, GzipMemoryUsageLevel::Default, GzipWindowSize::Default, DEFAULT_BUFFER_SIZE, threads, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// GzipWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	format		- Container format to wrap the deflate data in
+//	level		- Indicates the level of compression to use
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+GzipWriter::GzipWriter(Stream^ stream, GzipContainerFormat format, Compression::CompressionLevel level, bool leaveopen) : 
+	GzipWriter(stream, nullptr, 0, format, nullptr, GzipCompressionLevel(level), GzipCompressionStrategy::Default, GzipMemoryUsageLevel::Default, GzipWindowSize::Default, DEFAULT_BUFFER_SIZE, 1, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// GzipWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	format		- Container format to wrap the deflate data in
+//	dictionary	- Preset dictionary to prime the compressor with
+//	level		- Indicates the level of compression to use
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+GzipWriter::GzipWriter(Stream^ stream, GzipContainerFormat format, GzipDictionary^ dictionary, Compression::CompressionLevel level, bool leaveopen) : 
+	GzipWriter(stream, nullptr, 0, format, dictionary, GzipCompressionLevel(level), GzipCompressionStrategy::Default, GzipMemoryUsageLevel::Default, GzipWindowSize::Default, DEFAULT_BUFFER_SIZE, 1, 0, leaveopen)
+{
+	if(Object::ReferenceEquals(dictionary, nullptr)) throw gcnew ArgumentNullException("dictionary");
+}
+
+//---------------------------------------------------------------------------
+// GzipWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	index		- The stream the GzipIndex is written to when disposed
+//	spacing		- Minimum distance between access points, in uncompressed bytes
+//	level		- Indicates the level of compression to use
+//	threads		- Number of threads to use for compression (zero = processor count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+GzipWriter::GzipWriter(Stream^ stream, Stream^ index, __int64 spacing, Compression::CompressionLevel level, int threads, bool leaveopen) : 
+	GzipWriter(stream, index, spacing, GzipContainerFormat::Gzip, nullptr, GzipCompressionLevel(level), GzipCompressionStrategy::Default, GzipMemoryUsageLevel::Default, GzipWindowSize::Default, DEFAULT_BUFFER_SIZE, threads, 0, leaveopen)
+{
+	if(Object::ReferenceEquals(index, nullptr)) throw gcnew ArgumentNullException("index");
+}
+
 //---------------------------------------------------------------------------
 // GzipWriter Constructor (internal)
 //
 // Arguments:
 //
 //	stream			- The stream the compressed or decompressed data is written to
+//	index			- Optional stream the GzipIndex is written to when disposed
+//	spacing			- Minimum distance between access points, in uncompressed bytes
+//	format			- Container format to wrap the deflate data in
+//	dictionary		- Optional preset dictionary to prime the compressor with
 //	level			- Indicates the level of compression to use
 //	strategy		- Indicates the compression strategy to use
 //	maxmem			- Indicates the maximum memory to use during encoding
+//	windowsize		- Indicates the size of the deflate history window
 //	buffersize		- Indicates the size of the compression buffer
+//	threads			- Number of threads to use for compression (zero = processor count)
+//	maxpending		- Maximum number of blocks in flight (zero = twice the thread count)
 //	leaveopen		- Flag to leave the base stream open after disposal
 
-GzipWriter::GzipWriter(Stream^ stream, GzipCompressionLevel level, GzipCompressionStrategy strategy, GzipMemoryUsageLevel maxmem, int buffersize, bool leaveopen) : 
-	m_disposed(false), m_stream(stream), m_leaveopen(leaveopen), m_buffersize(buffersize)
+GzipWriter::GzipWriter(Stream^ stream, Stream^ index, __int64 spacing, GzipContainerFormat format, GzipDictionary^ dictionary, 
+	GzipCompressionLevel level, GzipCompressionStrategy strategy, GzipMemoryUsageLevel maxmem, GzipWindowSize windowsize, int buffersize, 
+	int threads, int maxpending, bool leaveopen) : m_disposed(false), m_stream(stream), m_leaveopen(leaveopen), m_buffersize(buffersize), 
+	m_zstream(nullptr), m_format(format), m_windowbits(windowsize), m_dictionary(dictionary), m_level(level), m_strategy(static_cast<int>(strategy)), 
+	m_maxmem(maxmem), m_hasheader(false), m_inpos(0), m_totalin(0), m_totalout(0), m_indexstream(index), m_spacing(spacing), 
+	m_nextaccess(spacing), m_blockin(0)
 {
 	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+	if((format < GzipContainerFormat::Gzip) || (format > GzipContainerFormat::Raw)) throw gcnew ArgumentOutOfRangeException("format");
+	if((dictionary) && (format == GzipContainerFormat::Gzip)) throw gcnew ArgumentException("A preset dictionary cannot be used with a GZIP stream", "dictionary");
 	if(buffersize <= 0) throw gcnew ArgumentOutOfRangeException("buffersize");
+	if(threads < 0) throw gcnew ArgumentOutOfRangeException("threads");
+	if(maxpending < 0) throw gcnew ArgumentOutOfRangeException("maxpending");
+
+	// Access points are only recorded when there is somewhere to write the index; they are
+	// never closer together than the history window, as with an index built from the stream
+	if(!Object::ReferenceEquals(index, nullptr)) {
+
+		if(format != GzipContainerFormat::Gzip) throw gcnew ArgumentException("An index can only be generated for a GZIP stream", "format");
+		if(spacing < WINDOW_SIZE) throw gcnew ArgumentOutOfRangeException("spacing");
+		m_checkpoints = gcnew List<GzipIndex::Checkpoint^>();
+
+		// The first access point is at the start of the deflate data, after the 10 byte GZIP header
+		m_checkpoints->Add(gcnew GzipIndex::Checkpoint(0, 10, 0, gcnew array<unsigned __int8>(0), 0));
+	}
+
+	// Zero threads indicates that the number of processors should be used
+	if(threads == 0) threads = Environment::ProcessorCount;
+
+	// Parallel compression deflates fixed-size blocks independently and stitches them together
+	// into a single deflate stream; the container header and trailer are generated here rather than by zlib
+	if(threads > 1) {
+
+		m_pending = gcnew TaskQueue<Block^>(threads, (maxpending == 0) ? threads * 2 : maxpending);
+		m_in = gcnew array<unsigned __int8>(PARALLEL_BLOCK_SIZE);
+		m_checksum = (format == GzipContainerFormat::Zlib) ? adler32(0L, Z_NULL, 0) : crc32(0L, Z_NULL, 0);
+
+		// A preset dictionary primes the first block the same way previous input primes the others
+		if(dictionary) m_previous = dictionary->Data;
+		return;
+	}
 
 	// Allocate and initialize the unmanaged z_stream structure
 	try { m_zstream = new z_stream; memset(m_zstream, 0, sizeof(z_stream)); }
 	catch(Exception^) { throw gcnew OutOfMemoryException(); }
 
-	// Initialize the z_stream for compression (window size is fixed for GZIP compatibility)
-	int result = deflateInit2(m_zstream, level, Z_DEFLATED, 16 + MAX_WBITS, maxmem, static_cast<int>(strategy));
+	// The sign and range of the window bits select the container format zlib wraps the deflate data in
+	int windowbits = (format == GzipContainerFormat::Raw) ? -m_windowbits : (format == GzipContainerFormat::Zlib) ? m_windowbits : 16 + m_windowbits;
+
+	// Initialize the z_stream for compression; a preset dictionary provides a stream that is already primed
+	int result = (dictionary) ? dictionary->DeflateInit(m_zstream, level, windowbits, maxmem, static_cast<int>(strategy)) :
+		deflateInit2(m_zstream, level, Z_DEFLATED, windowbits, maxmem, static_cast<int>(strategy));
 	if(result != Z_OK) throw gcnew GzipException(result);
 }
 
@@ -119,30 +231,61 @@ GzipWriter::~GzipWriter()
 
 	msclr::lock lock(m_lock);
 
-	// Create and pin a local compression buffer
-	array<unsigned __int8>^ out = gcnew array<unsigned __int8>(m_buffersize);
-	pin_ptr<unsigned __int8> pinout = &out[0];
+	// Parallel compression finishes the deflate stream with the last block and writes the
+	// GZIP (CRC-32 and ISIZE) or zlib (Adler-32) trailer directly into the output stream
+	if(m_pending) {
 
-	// Input is not consumed when finishing the zlib stream
-	m_zstream->next_in = nullptr;
-	m_zstream->avail_in = 0;
+		QueueBlock(true);
+		WritePendingBlocks(true);
 
-	do {
+		if(m_format == GzipContainerFormat::Gzip) {
 
-		// Reset the output buffer to point into the managed array
-		m_zstream->next_out = reinterpret_cast<Bytef*>(pinout);
-		m_zstream->avail_out = m_buffersize;
+			WriteLE32(m_stream, static_cast<unsigned int>(m_checksum));
+			WriteLE32(m_stream, static_cast<unsigned int>(m_totalin & 0xFFFFFFFF));
+			m_totalout += 8;
+		}
 
-		// Finish the next block of data in the zlib buffers and write it
-		result = deflate(m_zstream, Z_FINISH);
-		m_stream->Write(out, 0, m_buffersize - m_zstream->avail_out);
+		else if(m_format == GzipContainerFormat::Zlib) {
+
+			WriteBE32(m_stream, static_cast<unsigned int>(m_checksum));
+			m_totalout += 4;
+		}
+
+		delete m_pending;
+	}
+
+	else {
+
+		// Create and pin a local compression buffer
+		array<unsigned __int8>^ out = gcnew array<unsigned __int8>(m_buffersize);
+		pin_ptr<unsigned __int8> pinout = &out[0];
+
+		// Input is not consumed when finishing the zlib stream
+		m_zstream->next_in = nullptr;
+		m_zstream->avail_in = 0;
 
-	} while (result == Z_OK);
+		do {
 
-	// The end result of FINISH should be Z_STREAM_END
-	if(result != Z_STREAM_END) throw gcnew GzipException(result);
+			// Reset the output buffer to point into the managed array
+			m_zstream->next_out = reinterpret_cast<Bytef*>(pinout);
+			m_zstream->avail_out = m_buffersize;
+
+			// Finish the next block of data in the zlib buffers and write it
+			result = deflate(m_zstream, Z_FINISH);
+			m_stream->Write(out, 0, m_buffersize - m_zstream->avail_out);
+			m_totalout += m_buffersize - m_zstream->avail_out;
+
+		} while (result == Z_OK);
+
+		// The end result of FINISH should be Z_STREAM_END
+		if(result != Z_STREAM_END) throw gcnew GzipException(result);
+
+		delete out;							// Dispose of the compression buffer
+	}
+
+	// The index is written after the GZIP trailer; the index stream is always left open
+	if(m_checkpoints) (gcnew GzipIndex(m_spacing, m_totalin, m_totalout, m_checkpoints))->Save(m_indexstream);
 	
-	delete out;								// Dispose of the compression buffer
 	if(!m_leaveopen) delete m_stream;		// Optionally dispose of the base stream
 	
 	this->!GzipWriter();
@@ -166,6 +309,48 @@ GzipWriter::!GzipWriter()
 	m_zstream = nullptr;
 }
 
+//---------------------------------------------------------------------------
+// GzipWriter::AddAccessPoint (private)
+//
+// Ends the deflate data with a full flush and records an index checkpoint
+//
+// Arguments:
+//
+//	NONE
+
+void GzipWriter::AddAccessPoint(void)
+{
+	int result = Z_OK;			// Result from zlib operation
+
+	// Create and pin a local compression buffer
+	array<unsigned __int8>^ out = gcnew array<unsigned __int8>(m_buffersize);
+	pin_ptr<unsigned __int8> pinout = &out[0];
+
+	// Input is not consumed when flushing the zlib stream
+	m_zstream->next_in = nullptr;
+	m_zstream->avail_in = 0;
+
+	do {
+
+		// Reset the output buffer to point into the managed array
+		m_zstream->next_out = reinterpret_cast<Bytef*>(pinout);
+		m_zstream->avail_out = m_buffersize;
+
+		// A full flush byte-aligns the output and discards the history window
+		result = deflate(m_zstream, Z_FULL_FLUSH);
+		m_stream->Write(out, 0, m_buffersize - m_zstream->avail_out);
+		m_totalout += m_buffersize - m_zstream->avail_out;
+
+	} while(result == Z_OK);
+
+	// The end state of a zlib flush operation will be Z_BUF_ERROR
+	if(result != Z_BUF_ERROR) throw gcnew GzipException(result);
+
+	// Nothing after this point refers to earlier data, so the checkpoint needs no history
+	m_checkpoints->Add(gcnew GzipIndex::Checkpoint(m_totalin, m_totalout, 0, gcnew array<unsigned __int8>(0), 0));
+	m_nextaccess += m_spacing;
+}
+
 //---------------------------------------------------------------------------
 // GzipWriter::BaseStream::get
 //
@@ -210,6 +395,102 @@ bool GzipWriter::CanWrite::get(void)
 	return m_stream->CanWrite;
 }
 
+//---------------------------------------------------------------------------
+// GzipWriter::CompressBlock (private)
+//
+// Compresses a single block of input data into raw deflate data
+//
+// Arguments:
+//
+//	state		- Block instance to be compressed
+
+GzipWriter::Block^ GzipWriter::CompressBlock(Object^ state)
+{
+	z_stream					zstream;		// Local deflate stream state
+
+	Block^ block = safe_cast<Block^>(state);
+
+	// Each block is compressed as raw deflate data, the container header and trailer are generated separately
+	InitDeflate(&zstream, m_level, -m_windowbits, m_maxmem, m_strategy);
+	int result = Z_OK;
+
+	try {
+
+		// Prime the stream with the end of the previous block's input so that matches can span blocks
+		if((block->Dictionary) && (block->Dictionary->Length > 0)) {
+
+			int length = Math::Min(block->Dictionary->Length, 1 << m_windowbits);
+			pin_ptr<unsigned __int8> pindictionary = &block->Dictionary[block->Dictionary->Length - length];
+
+			result = deflateSetDictionary(&zstream, reinterpret_cast<Bytef const*>(pindictionary), length);
+			if(result != Z_OK) throw gcnew GzipException(result);
+		}
+
+		// The output buffer must be able to hold the entire block, including the flush marker
+		block->Output = gcnew array<unsigned __int8>(deflateBound(&zstream, block->Input->Length) + 16);
+		pin_ptr<unsigned __int8> pinout = &block->Output[0];
+
+		// The last block may be empty, it still needs to be compressed to end the deflate stream
+		pin_ptr<unsigned __int8> pinin = nullptr;
+		if(block->Input->Length > 0) pinin = &block->Input[0];
+
+		zstream.next_in = reinterpret_cast<Bytef*>(pinin);
+		zstream.avail_in = block->Input->Length;
+		zstream.next_out = reinterpret_cast<Bytef*>(pinout);
+		zstream.avail_out = block->Output->Length;
+
+		// The last block finishes the deflate stream; every other block is ended with a sync
+		// flush so that it ends on a byte boundary and can be concatenated with the next one
+		result = deflate(&zstream, (block->Last) ? Z_FINISH : Z_SYNC_FLUSH);
+		if(result != ((block->Last) ? Z_STREAM_END : Z_OK)) throw gcnew GzipException(result);
+		if((zstream.avail_in != 0) || (zstream.avail_out == 0)) throw gcnew GzipException(Z_BUF_ERROR);
+
+		block->OutputLength = block->Output->Length - zstream.avail_out;
+		block->Checksum = (m_format == GzipContainerFormat::Zlib) ? adler32(adler32(0L, Z_NULL, 0), reinterpret_cast<Bytef*>(pinin), block->Input->Length) :
+			crc32(0L, reinterpret_cast<Bytef*>(pinin), block->Input->Length);
+	}
+
+	finally { deflateEnd(&zstream); }
+
+	return block;
+}
+
+//---------------------------------------------------------------------------
+// GzipWriter::CreateHeader (internal, static)
+//
+// Creates a GZIP member header with an optional extra field
+//
+// Arguments:
+//
+//	xfl			- Extra flags (XFL) field value
+//	os			- Operating system (OS) field value
+//	extra		- Optional extra field data; sets the FEXTRA flag
+
+array<unsigned __int8>^ GzipWriter::CreateHeader(int xfl, int os, array<unsigned __int8>^ extra)
+{
+	int xlen = (extra) ? extra->Length : 0;
+	if(xlen > 0xFFFF) throw gcnew ArgumentOutOfRangeException("extra");
+
+	// ID1, ID2, CM, FLG, MTIME, XFL and OS; MTIME is always zero
+	array<unsigned __int8>^ header = gcnew array<unsigned __int8>((extra) ? 12 + xlen : 10);
+	header[0] = 0x1F;
+	header[1] = 0x8B;
+	header[2] = Z_DEFLATED;
+	header[3] = (extra) ? 0x04 : 0;
+	header[8] = static_cast<unsigned __int8>(xfl);
+	header[9] = static_cast<unsigned __int8>(os);
+
+	// The extra field is preceded by its length (XLEN)
+	if(extra) {
+
+		header[10] = static_cast<unsigned __int8>(xlen & 0xFF);
+		header[11] = static_cast<unsigned __int8>((xlen >> 8) & 0xFF);
+		Array::Copy(extra, 0, header, 12, xlen);
+	}
+
+	return header;
+}
+
 //---------------------------------------------------------------------------
 // GzipWriter::Flush
 //
@@ -227,6 +508,15 @@ void GzipWriter::Flush(void)
 
 	msclr::lock lock(m_lock);
 
+	// Parallel compression ends the current block with a sync flush and waits for all blocks
+	if(m_pending) {
+
+		QueueBlock(false);
+		WritePendingBlocks(true);
+		m_stream->Flush();
+		return;
+	}
+
 	// Create and pin a local compression buffer
 	array<unsigned __int8>^ out = gcnew array<unsigned __int8>(m_buffersize);
 	pin_ptr<unsigned __int8> pinout = &out[0];
@@ -244,6 +534,7 @@ void GzipWriter::Flush(void)
 		// Flush the next block of data in the zlib buffers and write it
 		result = deflate(m_zstream, Z_SYNC_FLUSH);
 		m_stream->Write(out, 0, m_buffersize - m_zstream->avail_out);
+		m_totalout += m_buffersize - m_zstream->avail_out;
 	
 	} while(result == Z_OK);
 
@@ -254,6 +545,27 @@ void GzipWriter::Flush(void)
 	m_stream->Flush();				// Flush the underlying base stream
 }
 
+//---------------------------------------------------------------------------
+// GzipWriter::InitDeflate (internal, static)
+//
+// Initializes a deflate stream state
+//
+// Arguments:
+//
+//	zstream		- Deflate stream state to be initialized
+//	level		- Compression level
+//	windowbits	- Window size bits; negative for raw deflate data
+//	maxmem		- Memory usage level
+//	strategy	- Compression strategy
+
+void GzipWriter::InitDeflate(z_stream* zstream, int level, int windowbits, int maxmem, int strategy)
+{
+	memset(zstream, 0, sizeof(z_stream));
+
+	int result = deflateInit2(zstream, level, Z_DEFLATED, windowbits, maxmem, strategy);
+	if(result != Z_OK) throw gcnew GzipException(result);
+}
+
 //--------------------------------------------------------------------------
 // GzipWriter::Length::get
 //
@@ -275,7 +587,7 @@ __int64 GzipWriter::Position::get(void)
 	CHECK_DISPOSED(m_disposed);
 
 	msclr::lock lock(m_lock);
-	return static_cast<__int64>(m_zstream->total_in);
+	return m_totalin + m_inpos;
 }
 
 //---------------------------------------------------------------------------
@@ -291,6 +603,58 @@ void GzipWriter::Position::set(__int64 value)
 	throw gcnew NotSupportedException();
 }
 
+//---------------------------------------------------------------------------
+// GzipWriter::QueueBlock (private)
+//
+// Queues the contents of the input buffer for parallel compression
+//
+// Arguments:
+//
+//	last		- Flag if this is the last block of the stream
+
+void GzipWriter::QueueBlock(bool last)
+{
+	msclr::lock lock(m_lock);
+
+	// Only the last block is queued when the input buffer is empty
+	if((m_inpos == 0) && (!last)) return;
+
+	// A partial block is trimmed to the actual length of the data
+	array<unsigned __int8>^ input = m_in;
+	if(m_inpos < input->Length) Array::Resize<unsigned __int8>(input, m_inpos);
+
+	// A block that starts at an access point is compressed without the previous input, which
+	// has the same effect as a full flush once the blocks are concatenated together
+	array<unsigned __int8>^ dictionary = m_previous;
+	if((m_checkpoints) && (input->Length > 0) && (m_totalin >= m_nextaccess)) {
+
+		dictionary = nullptr;
+		m_nextaccess = m_totalin + m_spacing;
+	}
+
+	// Make room in the queue for the block and start compressing it
+	WritePendingBlocks(false);
+	m_pending->Enqueue(gcnew Func<Object^, Block^>(this, &GzipWriter::CompressBlock), gcnew Block(dictionary, input, last));
+	m_totalin += input->Length;
+
+	// The next block is primed with the most recent WINDOW_SIZE bytes of input; if this block
+	// was short (after a Flush), carry the tail of the previous history forward with it
+	if((input->Length >= WINDOW_SIZE) || (Object::ReferenceEquals(m_previous, nullptr))) m_previous = input;
+	else {
+
+		int keep = Math::Min(m_previous->Length, WINDOW_SIZE - input->Length);
+		array<unsigned __int8>^ history = gcnew array<unsigned __int8>(keep + input->Length);
+
+		Array::Copy(m_previous, m_previous->Length - keep, history, 0, keep);
+		Array::Copy(input, 0, history, keep, input->Length);
+		m_previous = history;
+	}
+
+	// The queued buffer now belongs to the worker, a new one is needed for the next block
+	if(Object::ReferenceEquals(input, m_in)) m_in = gcnew array<unsigned __int8>(PARALLEL_BLOCK_SIZE);
+	m_inpos = 0;
+}
+
 //---------------------------------------------------------------------------
 // GzipWriter::Read
 //
@@ -388,6 +752,24 @@ void GzipWriter::Write(array<unsigned __int8>^ buffer, int offset, int count)
 
 	msclr::lock lock(m_lock);
 
+	// Parallel compression buffers the input data and queues it in fixed-size blocks
+	if(m_pending) {
+
+		while(count > 0) {
+
+			int next = Math::Min(m_in->Length - m_inpos, count);
+			Array::Copy(buffer, offset, m_in, m_inpos, next);
+
+			m_inpos += next;				// Increment length of buffer
+			offset += next;					// Move offset into the source buffer
+			count -= next;					// Decrement bytes remaining
+
+			if(m_inpos == m_in->Length) QueueBlock(false);
+		}
+
+		return;
+	}
+
 	// Create a temporary local buffer to hold the compressed data
 	array<unsigned __int8>^ out = gcnew array<unsigned __int8>(m_buffersize);
 		
@@ -395,24 +777,181 @@ void GzipWriter::Write(array<unsigned __int8>^ buffer, int offset, int count)
 	pin_ptr<unsigned __int8> pinin = &buffer[0];
 	pin_ptr<unsigned __int8> pinout = &out[0];
 
-	// Set up the input buffer pointer and available length
-	m_zstream->next_in = reinterpret_cast<Bytef*>(&pinin[offset]);
-	m_zstream->avail_in = count;
+	while(count > 0) {
 
-	// Repeatedly compress blocks of data until all input has been consumed
-	while(m_zstream->avail_in > 0) {
+		// When recording access points, a full flush is issued before any input beyond one
+		if((m_checkpoints) && (m_totalin == m_nextaccess)) AddAccessPoint();
 
-		// Reset the output buffer pointer and length
-		m_zstream->next_out = reinterpret_cast<Bytef*>(pinout);
-		m_zstream->avail_out = m_buffersize;
+		// Only the input up to the next access point is compressed in this pass
+		int next = (m_checkpoints) ? static_cast<int>(Math::Min(static_cast<__int64>(count), m_nextaccess - m_totalin)) : count;
 
-		// Compress the next block of input data into the output buffer
-		int result = deflate(m_zstream, Z_NO_FLUSH);
-		if(result != Z_OK) throw gcnew GzipException(result);
+		// Set up the input buffer pointer and available length
+		m_zstream->next_in = reinterpret_cast<Bytef*>(&pinin[offset]);
+		m_zstream->avail_in = next;
 
-		// Write the compressed data into the underlying base stream
-		m_stream->Write(out, 0, m_buffersize - m_zstream->avail_out);
-	};
+		// Repeatedly compress blocks of data until all input has been consumed
+		while(m_zstream->avail_in > 0) {
+
+			// Reset the output buffer pointer and length
+			m_zstream->next_out = reinterpret_cast<Bytef*>(pinout);
+			m_zstream->avail_out = m_buffersize;
+
+			// Compress the next block of input data into the output buffer
+			int result = deflate(m_zstream, Z_NO_FLUSH);
+			if(result != Z_OK) throw gcnew GzipException(result);
+
+			// Write the compressed data into the underlying base stream
+			m_stream->Write(out, 0, m_buffersize - m_zstream->avail_out);
+			m_totalout += m_buffersize - m_zstream->avail_out;
+		};
+
+		m_totalin += next;				// Increment total input data
+		offset += next;					// Move offset into the source buffer
+		count -= next;					// Decrement bytes remaining
+	}
+}
+
+//---------------------------------------------------------------------------
+// GzipWriter::WriteBE32 (static, private)
+//
+// Writes an unsigned 32 bit value into an output stream in big endian order
+//
+// Arguments:
+//
+//	stream		- Stream instance to write the value into
+//	value		- Value to be written into the stream
+
+void GzipWriter::WriteBE32(Stream^ stream, unsigned int value)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException();
+
+	// Convert the 32 bit unsigned value into an array of 4 big endian bytes
+	array<unsigned __int8>^ buffer = gcnew array<unsigned __int8>{(unsigned __int8)((value & 0xFF000000) >> 24), 
+		(unsigned __int8)((value & 0xFF0000) >> 16), (unsigned __int8)((value & 0xFF00) >> 8), (unsigned __int8)((value & 0xFF) >> 0)};
+
+	stream->Write(buffer, 0, 4);
+}
+
+//---------------------------------------------------------------------------
+// GzipWriter::WriteLE32 (static, private)
+//
+// Writes an unsigned 32 bit value into an output stream
+//
+// Arguments:
+//
+//	stream		- Stream instance to write the value into
+//	value		- Value to be written into the stream
+
+void GzipWriter::WriteLE32(Stream^ stream, unsigned int value)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException();
+
+	array<unsigned __int8>^ buffer = gcnew array<unsigned __int8>(4);
+	WriteLE32(buffer, 0, value);
+
+	stream->Write(buffer, 0, 4);
+}
+
+//---------------------------------------------------------------------------
+// GzipWriter::WriteLE32 (internal, static)
+//
+// Writes an unsigned 32 bit value into a buffer
+//
+// Arguments:
+//
+//	buffer		- Buffer to write the value into
+//	offset		- Offset within the buffer to write the value
+//	value		- Value to be written into the buffer
+
+void GzipWriter::WriteLE32(array<unsigned __int8>^ buffer, int offset, unsigned int value)
+{
+	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException();
+
+	// Convert the 32 bit unsigned value into 4 little endian bytes
+	buffer[offset + 0] = static_cast<unsigned __int8>((value & 0xFF) >> 0);
+	buffer[offset + 1] = static_cast<unsigned __int8>((value & 0xFF00) >> 8);
+	buffer[offset + 2] = static_cast<unsigned __int8>((value & 0xFF0000) >> 16);
+	buffer[offset + 3] = static_cast<unsigned __int8>((value & 0xFF000000) >> 24);
+}
+
+//---------------------------------------------------------------------------
+// GzipWriter::WritePendingBlocks (private)
+//
+// Writes completed blocks from the compression queue to the base stream
+//
+// Arguments:
+//
+//	all			- Flag to write all pending blocks rather than just make room
+
+void GzipWriter::WritePendingBlocks(bool all)
+{
+	msclr::lock lock(m_lock);
+
+	while((all) ? !m_pending->IsEmpty : m_pending->IsFull) {
+
+		// Wait for the oldest block to finish compressing
+		Block^ block = m_pending->Dequeue();
+
+		// Write the container header before the first block; the GZIP XFL and OS fields and the
+		// zlib FLEVEL field are set the same as zlib would set them, raw deflate has no header
+		if(!m_hasheader) {
+
+			int level = (m_level == Z_DEFAULT_COMPRESSION) ? 6 : m_level;
+
+			if(m_format == GzipContainerFormat::Gzip) {
+
+				int xfl = (level == Z_BEST_COMPRESSION) ? 2 : ((m_strategy >= Z_HUFFMAN_ONLY) || (level < 2)) ? 4 : 0;
+
+				array<unsigned __int8>^ header = CreateHeader(xfl, 0x0B, nullptr);
+				m_stream->Write(header, 0, header->Length);
+				m_totalout += header->Length;
+			}
+
+			else if(m_format == GzipContainerFormat::Zlib) {
+
+				int flevel = ((m_strategy >= Z_HUFFMAN_ONLY) || (level < 2)) ? 0 : (level < 6) ? 1 : (level == 6) ? 2 : 3;
+
+				// CMF holds the method and window size, FLG the level, FDICT and a check value that makes the pair a multiple of 31
+				int header = ((Z_DEFLATED + ((m_windowbits - 8) << 4)) << 8) | (flevel << 6) | ((m_dictionary) ? 0x20 : 0);
+				header += 31 - (header % 31);
+
+				m_stream->Write(gcnew array<unsigned __int8>{ static_cast<unsigned __int8>(header >> 8), static_cast<unsigned __int8>(header & 0xFF) }, 0, 2);
+				m_totalout += 2;
+
+				// FDICT is followed by the Adler-32 of the dictionary so the decompressor can identify it
+				if(m_dictionary) { WriteBE32(m_stream, m_dictionary->Id); m_totalout += 4; }
+			}
+
+			m_hasheader = true;
+		}
+
+		// A block compressed without a dictionary after the first one is an access point; the
+		// previous block ended with a sync flush so it starts on a byte boundary
+		if((m_checkpoints) && (Object::ReferenceEquals(block->Dictionary, nullptr)) && (m_blockin > 0))
+			m_checkpoints->Add(gcnew GzipIndex::Checkpoint(m_blockin, m_totalout, 0, gcnew array<unsigned __int8>(0), 0));
+
+		// Write the raw deflate data and combine the block's checksum into the overall checksum
+		m_stream->Write(block->Output, 0, block->OutputLength);
+		m_checksum = (m_format == GzipContainerFormat::Zlib) ? adler32_combine(m_checksum, block->Checksum, block->Input->Length) :
+			crc32_combine(m_checksum, block->Checksum, block->Input->Length);
+
+		m_totalout += block->OutputLength;
+		m_blockin += block->Input->Length;
+	}
+}
+
+//---------------------------------------------------------------------------
+// GzipWriter::Block Constructor
+//
+// Arguments:
+//
+//	dictionary	- Previous input data used to prime the compressor
+//	input		- Uncompressed input data
+//	last		- Flag if this is the last block of the stream
+
+GzipWriter::Block::Block(array<unsigned __int8>^ dictionary, array<unsigned __int8>^ input, bool last) : 
+	Dictionary(dictionary), Input(input), Last(last), OutputLength(0), Checksum(0)
+{
 }
 
 //---------------------------------------------------------------------------
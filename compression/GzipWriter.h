@@ -27,11 +27,17 @@
 #include <zlib.h>
 #include "GzipCompressionLevel.h"
 #include "GzipCompressionStrategy.h"
+#include "GzipContainerFormat.h"
+#include "GzipDictionary.h"
+#include "GzipIndex.h"
 #include "GzipMemoryUsageLevel.h"
+#include "GzipWindowSize.h"
+#include "TaskQueue.h"
 
 #pragma warning(push, 4)				// Enable maximum compiler warnings
 
 using namespace System;
+using namespace System::Collections::Generic;
 using namespace System::IO;
 
 namespace zuki::io::compression {
@@ -52,6 +58,10 @@ public:
 	GzipWriter(Stream^ stream, Compression::CompressionLevel level);
 	GzipWriter(Stream^ stream, bool leaveopen);
 	GzipWriter(Stream^ stream, Compression::CompressionLevel level, bool leaveopen);
+	GzipWriter(Stream^ stream, Compression::CompressionLevel level, int threads, bool leaveopen);
+	GzipWriter(Stream^ stream, GzipContainerFormat format, Compression::CompressionLevel level, bool leaveopen);
+	GzipWriter(Stream^ stream, GzipContainerFormat format, GzipDictionary^ dictionary, Compression::CompressionLevel level, bool leaveopen);
+	GzipWriter(Stream^ stream, Stream^ index, __int64 spacing, Compression::CompressionLevel level, int threads, bool leaveopen);
 
 	//-----------------------------------------------------------------------
 	// Member Functions
@@ -147,7 +157,27 @@ internal:
 
 	// Instance Constructor
 	//
-	GzipWriter(Stream^ stream, GzipCompressionLevel level, GzipCompressionStrategy strategy, GzipMemoryUsageLevel maxmem, int buffersize, bool leaveopen);
+	GzipWriter(Stream^ stream, Stream^ index, __int64 spacing, GzipContainerFormat format, GzipDictionary^ dictionary, 
+		GzipCompressionLevel level, GzipCompressionStrategy strategy, GzipMemoryUsageLevel maxmem, GzipWindowSize windowsize, 
+		int buffersize, int threads, int maxpending, bool leaveopen);
+
+	//-----------------------------------------------------------------------
+	// Internal Member Functions
+
+	// CreateHeader (static)
+	//
+	// Creates a GZIP member header with an optional extra field
+	static array<unsigned __int8>^ CreateHeader(int xfl, int os, array<unsigned __int8>^ extra);
+
+	// InitDeflate (static)
+	//
+	// Initializes a deflate stream state
+	static void InitDeflate(z_stream* zstream, int level, int windowbits, int maxmem, int strategy);
+
+	// WriteLE32 (static)
+	//
+	// Writes a little endian 32-bit number into a buffer
+	static void WriteLE32(array<unsigned __int8>^ buffer, int offset, unsigned int value);
 
 private:
 
@@ -156,6 +186,71 @@ private:
 	~GzipWriter();
 	!GzipWriter();
 
+	// PARALLEL_BLOCK_SIZE
+	//
+	// Size of each block of input data compressed in parallel
+	static const int PARALLEL_BLOCK_SIZE = (128 << 10);
+
+	// WINDOW_SIZE
+	//
+	// Size of the deflate history window used to prime parallel blocks
+	static const int WINDOW_SIZE = (1 << MAX_WBITS);
+
+	// Block
+	//
+	// Input and output data for a single block compressed in parallel
+	ref class Block
+	{
+	public:
+
+		// Instance Constructor
+		//
+		Block(array<unsigned __int8>^ dictionary, array<unsigned __int8>^ input, bool last);
+
+		//-------------------------------------------------------------------
+		// Fields
+
+		initonly array<unsigned __int8>^	Dictionary;		// Previous block's input data
+		initonly array<unsigned __int8>^	Input;			// Uncompressed input data
+		initonly bool						Last;			// Flag if this is the last block
+		array<unsigned __int8>^				Output;			// Compressed output data
+		int									OutputLength;	// Length of the output data
+		unsigned long						Checksum;		// Checksum of the input data
+	};
+
+	//-----------------------------------------------------------------------
+	// Private Member Functions
+
+	// AddAccessPoint
+	//
+	// Ends the deflate data with a full flush and records an index checkpoint
+	void AddAccessPoint(void);
+
+	// CompressBlock
+	//
+	// Compresses a single block of input data into raw deflate data
+	Block^ CompressBlock(Object^ state);
+
+	// QueueBlock
+	//
+	// Queues the contents of the input buffer for parallel compression
+	void QueueBlock(bool last);
+
+	// WriteBE32 (static)
+	//
+	// Writes a big endian 32-bit number into a stream
+	static void WriteBE32(Stream^ stream, unsigned int value);
+
+	// WriteLE32 (static)
+	//
+	// Writes a little endian 32-bit number into a stream
+	static void WriteLE32(Stream^ stream, unsigned int value);
+
+	// WritePendingBlocks
+	//
+	// Writes completed blocks from the compression queue to the base stream
+	void WritePendingBlocks(bool all);
+
 	//-----------------------------------------------------------------------
 	// Member Variables
 
@@ -164,6 +259,25 @@ private:
 	bool							m_leaveopen;	// Flag to leave base stream open
 	initonly int					m_buffersize;	// Size of the compression buffer
 	z_stream*						m_zstream;		// GZIP stream state information
+	initonly GzipContainerFormat	m_format;		// Container format
+	initonly int					m_windowbits;	// Deflate window size (log2)
+	GzipDictionary^					m_dictionary;	// Optional preset dictionary
+	initonly int					m_level;		// Compression level
+	initonly int					m_strategy;		// Compression strategy
+	initonly int					m_maxmem;		// Memory usage level
+	TaskQueue<Block^>^				m_pending;		// Pending block compressions
+	bool							m_hasheader;	// Flag if container header was written
+	array<unsigned __int8>^			m_in;			// Parallel input data buffer
+	int								m_inpos;		// Position within the input buffer
+	array<unsigned __int8>^			m_previous;		// Previously queued input data
+	__int64							m_totalin;		// Total queued input data
+	unsigned long					m_checksum;		// Combined checksum of the input
+	__int64							m_totalout;		// Total output data written
+	Stream^							m_indexstream;	// Optional index stream
+	initonly __int64				m_spacing;		// Distance between access points
+	__int64							m_nextaccess;	// Input offset of next access point
+	__int64							m_blockin;		// Input offset of next written block
+	List<GzipIndex::Checkpoint^>^	m_checkpoints;	// Access point index checkpoints
 
 	Object^	m_lock = gcnew Object();		// Synchronization object
 };
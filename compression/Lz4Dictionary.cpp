@@ -0,0 +1,275 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// LZ4 Library
+// Copyright (c) 2011-2016, Yann Collet
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice, this
+//   list of conditions and the following disclaimer in the documentation and/or
+//   other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//---------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "Lz4Dictionary.h"
+
+#include <xxhash.h>
+
+// LZ4F_CDict_s is an incomplete type; causes LNK4248
+//
+struct LZ4F_CDict_s {};
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// Lz4Dictionary Constructor
+//
+// Arguments:
+//
+//	dictionary	- Dictionary data, only the last 64KiB is used
+
+Lz4Dictionary::Lz4Dictionary(array<unsigned __int8>^ dictionary) : m_disposed(false), m_data(nullptr), m_length(0), m_cdict(nullptr), m_stream(nullptr)
+{
+	if(Object::ReferenceEquals(dictionary, nullptr)) throw gcnew ArgumentNullException("dictionary");
+	if(dictionary->Length == 0) throw gcnew ArgumentException("The dictionary must contain at least one byte", "dictionary");
+
+	// The digested states refer to the dictionary data, which has to stay put in unmanaged memory
+	m_length = Math::Min(dictionary->Length, MAXIMUM_LENGTH);
+	try { m_data = new unsigned __int8[m_length]; }
+	catch(Exception^) { throw gcnew OutOfMemoryException(); }
+
+	pin_ptr<unsigned __int8> pindictionary = &dictionary[dictionary->Length - m_length];
+	memcpy(m_data, pindictionary, m_length);
+
+	// The identifier written into the frame header is the XXH32 of the data that is actually used
+	m_id = XXH32(m_data, m_length, 0);
+
+	// Digest the dictionary for the frame compressor, which handles both fast and high compression
+	m_cdict = LZ4F_createCDict(m_data, m_length);
+	if(m_cdict == nullptr) throw gcnew OutOfMemoryException();
+
+	// Digest the dictionary for the fast block compressor; high compression states depend on
+	// the compression level and are digested the first time each level is requested
+	m_stream = LZ4_createStream();
+	if(m_stream == nullptr) throw gcnew OutOfMemoryException();
+	LZ4_loadDict(m_stream, reinterpret_cast<char const*>(m_data), m_length);
+
+	m_hcstreams = gcnew Dictionary<int, IntPtr>();
+}
+
+//---------------------------------------------------------------------------
+// Lz4Dictionary Destructor
+
+Lz4Dictionary::~Lz4Dictionary()
+{
+	if(m_disposed) return;
+
+	this->!Lz4Dictionary();
+	m_disposed = true;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Dictionary Finalizer
+
+Lz4Dictionary::!Lz4Dictionary()
+{
+	// Release all of the digested high compression block states
+	if(m_hcstreams) {
+
+		for each(IntPtr stream in m_hcstreams->Values) LZ4_freeStreamHC(reinterpret_cast<LZ4_streamHC_t*>(stream.ToPointer()));
+		m_hcstreams->Clear();
+	}
+
+	if(m_stream) { LZ4_freeStream(m_stream); m_stream = nullptr; }
+	if(m_cdict) { LZ4F_freeCDict(m_cdict); m_cdict = nullptr; }
+	if(m_data) { delete[] m_data; m_data = nullptr; }
+}
+
+//---------------------------------------------------------------------------
+// Lz4Dictionary::CDict::get (internal)
+//
+// Gets the digested dictionary for the LZ4 frame compressor
+
+LZ4F_CDict* Lz4Dictionary::CDict::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return m_cdict;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Dictionary::Compress (internal)
+//
+// Compresses an independent block of data using the dictionary
+//
+// Arguments:
+//
+//	source		- Uncompressed block data
+//	destination	- Buffer to receive the compressed data
+//	sourcelen	- Length of the uncompressed block data
+//	destlen		- Length of the destination buffer
+//	level		- Compression level
+
+int Lz4Dictionary::Compress(char const* source, char* destination, int sourcelen, int destlen, int level)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	// Fast compression starts from a copy of the state that was digested by the constructor,
+	// which is the same thing the LZ4 frame compressor does with a digested dictionary
+	if(level < LZ4HC_CLEVEL_MIN) {
+
+		LZ4_stream_t* stream = LZ4_createStream();
+		if(stream == nullptr) throw gcnew OutOfMemoryException();
+
+		try {
+
+			memcpy(stream, m_stream, sizeof(LZ4_stream_t));
+			return LZ4_compress_fast_continue(stream, source, destination, sourcelen, destlen, 1);
+		}
+
+		finally { LZ4_freeStream(stream); }
+	}
+
+	LZ4_streamHC_t* stream = LZ4_createStreamHC();
+	if(stream == nullptr) throw gcnew OutOfMemoryException();
+
+	try {
+
+		msclr::lock lock(m_lock);
+
+		// Digest the dictionary for this compression level if it hasn't been requested before
+		IntPtr digested;
+		if(!m_hcstreams->TryGetValue(level, digested)) {
+
+			LZ4_streamHC_t* hcstream = LZ4_createStreamHC();
+			if(hcstream == nullptr) throw gcnew OutOfMemoryException();
+
+			LZ4_resetStreamHC(hcstream, level);
+			LZ4_loadDictHC(hcstream, reinterpret_cast<char const*>(m_data), m_length);
+
+			digested = IntPtr(hcstream);
+			m_hcstreams->Add(level, digested);
+		}
+
+		memcpy(stream, digested.ToPointer(), sizeof(LZ4_streamHC_t));
+		lock.release();
+
+		return LZ4_compress_HC_continue(stream, source, destination, sourcelen, destlen);
+	}
+
+	finally { LZ4_freeStreamHC(stream); }
+}
+
+//---------------------------------------------------------------------------
+// Lz4Dictionary::Data::get (internal)
+//
+// Gets a pointer to the unmanaged dictionary data
+
+void const* Lz4Dictionary::Data::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return m_data;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Dictionary::Decompress (internal)
+//
+// Decompresses an independent block of data using the dictionary
+//
+// Arguments:
+//
+//	source		- Compressed block data
+//	destination	- Buffer to receive the decompressed data
+//	sourcelen	- Length of the compressed block data
+//	destlen		- Length of the destination buffer
+
+int Lz4Dictionary::Decompress(char const* source, char* destination, int sourcelen, int destlen)
+{
+	CHECK_DISPOSED(m_disposed);
+	return LZ4_decompress_safe_usingDict(source, destination, sourcelen, destlen, reinterpret_cast<char const*>(m_data), m_length);
+}
+
+//---------------------------------------------------------------------------
+// Lz4Dictionary::Id::get
+//
+// Gets the dictionary identifier stored in the LZ4 frame header
+
+unsigned int Lz4Dictionary::Id::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return m_id;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Dictionary::Length::get
+//
+// Gets the length of the dictionary data
+
+int Lz4Dictionary::Length::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return m_length;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Dictionary::ToArray
+//
+// Gets a copy of the dictionary data
+//
+// Arguments:
+//
+//	NONE
+
+array<unsigned __int8>^ Lz4Dictionary::ToArray(void)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	array<unsigned __int8>^ dictionary = gcnew array<unsigned __int8>(m_length);
+	Marshal::Copy(IntPtr(m_data), dictionary, 0, m_length);
+
+	return dictionary;
+}
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
@@ -0,0 +1,176 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// LZ4 Library
+// Copyright (c) 2011-2016, Yann Collet
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice, this
+//   list of conditions and the following disclaimer in the documentation and/or
+//   other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//---------------------------------------------------------------------------
+
+#ifndef __LZ4DICTIONARY_H_
+#define __LZ4DICTIONARY_H_
+#pragma once
+
+#include <lz4.h>
+#include <lz4hc.h>
+#include <lz4frame_static.h>
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Runtime::InteropServices;
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// Class Lz4Dictionary
+//
+// Pre-digested LZ4 dictionary.  The dictionary is loaded into the LZ4 frame
+// and block compressors once, when the instance is created, and each stream
+// or block that uses it starts from a copy of that state.  An instance can
+// be shared by any number of streams on any number of threads
+//---------------------------------------------------------------------------
+
+public ref class Lz4Dictionary
+{
+public:
+
+	// Instance Constructor
+	//
+	Lz4Dictionary(array<unsigned __int8>^ dictionary);
+
+	//-----------------------------------------------------------------------
+	// Member Functions
+
+	// ToArray
+	//
+	// Gets a copy of the dictionary data
+	array<unsigned __int8>^ ToArray(void);
+
+	//-----------------------------------------------------------------------
+	// Properties
+
+	// Id
+	//
+	// Gets the dictionary identifier stored in the LZ4 frame header
+	property unsigned int Id
+	{
+		unsigned int get(void);
+	}
+
+	// Length
+	//
+	// Gets the length of the dictionary data
+	property int Length
+	{
+		int get(void);
+	}
+
+internal:
+
+	//-----------------------------------------------------------------------
+	// Internal Member Functions
+
+	// Compress
+	//
+	// Compresses an independent block of data using the dictionary
+	int Compress(char const* source, char* destination, int sourcelen, int destlen, int level);
+
+	// Decompress
+	//
+	// Decompresses an independent block of data using the dictionary
+	int Decompress(char const* source, char* destination, int sourcelen, int destlen);
+
+	//-----------------------------------------------------------------------
+	// Internal Properties
+
+	// CDict
+	//
+	// Gets the digested dictionary for the LZ4 frame compressor
+	property LZ4F_CDict* CDict
+	{
+		LZ4F_CDict* get(void);
+	}
+
+	// Data
+	//
+	// Gets a pointer to the unmanaged dictionary data
+	property void const* Data
+	{
+		void const* get(void);
+	}
+
+private:
+
+	// Destructor / Finalizer
+	//
+	~Lz4Dictionary();
+	!Lz4Dictionary();
+
+	// MAXIMUM_LENGTH
+	//
+	// Maximum dictionary length; LZ4 only refers back 64KiB
+	static const int MAXIMUM_LENGTH = (64 << 10);
+
+	//-----------------------------------------------------------------------
+	// Member Variables
+
+	bool							m_disposed;			// Object disposal flag
+	unsigned __int8*				m_data;				// Dictionary data
+	int								m_length;			// Length of the dictionary data
+	initonly unsigned int			m_id;				// Dictionary identifier
+	LZ4F_CDict*						m_cdict;			// Digested frame dictionary
+	LZ4_stream_t*					m_stream;			// Digested block dictionary
+	Dictionary<int, IntPtr>^		m_hcstreams;		// Digested HC block dictionaries
+
+	Object^	m_lock = gcnew Object();		// Synchronization object
+};
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
+
+#endif	// __LZ4DICTIONARY_H_
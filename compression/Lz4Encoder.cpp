@@ -64,7 +64,7 @@ namespace zuki::io::compression {
 //	NONE
 
 Lz4Encoder::Lz4Encoder() : m_autoflush(false), m_blockmode(Lz4BlockMode::Default), m_blocksize(Lz4BlockSize::Default), 
-	m_level(Lz4CompressionLevel::Default), m_checksum(Lz4ContentChecksum::Default)
+	m_level(Lz4CompressionLevel::Default), m_checksum(Lz4ContentChecksum::Default), m_framesize(0), m_maxpending(0), m_threads(1)
 {
 }
 
@@ -168,6 +168,89 @@ void Lz4Encoder::ContentChecksum::set(Lz4ContentChecksum value)
 	m_checksum = value;
 }
 
+//---------------------------------------------------------------------------
+// Lz4Encoder::Dictionary::get
+//
+// Gets the dictionary to compress the data with
+
+Lz4Dictionary^ Lz4Encoder::Dictionary::get(void)
+{
+	return m_dictionary;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Encoder::Dictionary::set
+//
+// Sets the dictionary to compress the data with
+
+void Lz4Encoder::Dictionary::set(Lz4Dictionary^ value)
+{
+	m_dictionary = value;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Encoder::FrameSize::get
+//
+// Gets the size of independent frames for seekable output
+
+int Lz4Encoder::FrameSize::get(void)
+{
+	return m_framesize;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Encoder::FrameSize::set
+//
+// Sets the size of independent frames for seekable output
+
+void Lz4Encoder::FrameSize::set(int value)
+{
+	if(value < 0) throw gcnew ArgumentOutOfRangeException("value");
+	m_framesize = value;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Encoder::MaximumPendingBlocks::get
+//
+// Gets the maximum number of blocks in flight during parallel compression
+
+int Lz4Encoder::MaximumPendingBlocks::get(void)
+{
+	return m_maxpending;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Encoder::MaximumPendingBlocks::set
+//
+// Sets the maximum number of blocks in flight during parallel compression
+
+void Lz4Encoder::MaximumPendingBlocks::set(int value)
+{
+	if(value < 0) throw gcnew ArgumentOutOfRangeException("value");
+	m_maxpending = value;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Encoder::MaximumThreads::get
+//
+// Gets the number of threads to use for independent block compression
+
+int Lz4Encoder::MaximumThreads::get(void)
+{
+	return m_threads;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Encoder::MaximumThreads::set
+//
+// Sets the number of threads to use for independent block compression
+
+void Lz4Encoder::MaximumThreads::set(int value)
+{
+	if(value < 0) throw gcnew ArgumentOutOfRangeException("value");
+	m_threads = value;
+}
+
 //---------------------------------------------------------------------------
 // Lz4Encoder::Encode
 //
@@ -241,7 +324,7 @@ void Lz4Encoder::Encode(Stream^ instream, Stream^ outstream)
 	if(Object::ReferenceEquals(instream, nullptr)) throw gcnew ArgumentNullException("instream");
 	if(Object::ReferenceEquals(outstream, nullptr)) throw gcnew ArgumentNullException("outstream");
 
-	msclr::auto_handle<Lz4Writer> writer(gcnew Lz4Writer(outstream, m_level, m_autoflush, m_blocksize, m_blockmode, m_checksum, true));
+	msclr::auto_handle<Lz4Writer> writer(gcnew Lz4Writer(outstream, m_level, m_autoflush, m_blocksize, m_blockmode, m_checksum, m_dictionary, m_framesize, m_threads, m_maxpending, true));
 	instream->CopyTo(writer.get());
 }
 
@@ -260,7 +343,7 @@ void Lz4Encoder::Encode(array<unsigned __int8>^ buffer, Stream^ outstream)
 	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
 	if(Object::ReferenceEquals(outstream, nullptr)) throw gcnew ArgumentNullException("outstream");
 
-	msclr::auto_handle<Lz4Writer> writer(gcnew Lz4Writer(outstream, m_level, m_autoflush, m_blocksize, m_blockmode, m_checksum, true));
+	msclr::auto_handle<Lz4Writer> writer(gcnew Lz4Writer(outstream, m_level, m_autoflush, m_blocksize, m_blockmode, m_checksum, m_dictionary, m_framesize, m_threads, m_maxpending, true));
 	writer->Write(buffer, 0, buffer->Length);
 }
 
@@ -281,7 +364,7 @@ void Lz4Encoder::Encode(array<unsigned __int8>^ buffer, int offset, int count, S
 	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
 	if(Object::ReferenceEquals(outstream, nullptr)) throw gcnew ArgumentNullException("outstream");
 
-	msclr::auto_handle<Lz4Writer> writer(gcnew Lz4Writer(outstream, m_level, m_autoflush, m_blocksize, m_blockmode, m_checksum, true));
+	msclr::auto_handle<Lz4Writer> writer(gcnew Lz4Writer(outstream, m_level, m_autoflush, m_blocksize, m_blockmode, m_checksum, m_dictionary, m_framesize, m_threads, m_maxpending, true));
 	writer->Write(buffer, offset, count);
 }
 
@@ -56,6 +56,7 @@
 #include "Lz4BlockSize.h"
 #include "Lz4CompressionLevel.h"
 #include "Lz4ContentChecksum.h"
+#include "Lz4Dictionary.h"
 
 #pragma warning(push, 4)				// Enable maximum compiler warnings
 
@@ -159,6 +160,42 @@ public:
 		void set(Lz4ContentChecksum value);
 	}
 
+	// Dictionary
+	//
+	// Gets/sets the dictionary to compress the data with
+	property Lz4Dictionary^ Dictionary
+	{
+		Lz4Dictionary^ get(void);
+		void set(Lz4Dictionary^ value);
+	}
+
+	// FrameSize
+	//
+	// Gets/sets the size of independent frames for seekable output (zero = single frame)
+	property int FrameSize
+	{
+		int get(void);
+		void set(int value);
+	}
+
+	// MaximumPendingBlocks
+	//
+	// Gets/sets the maximum number of blocks in flight during parallel compression
+	property int MaximumPendingBlocks
+	{
+		int get(void);
+		void set(int value);
+	}
+
+	// MaximumThreads
+	//
+	// Gets/sets the number of threads to use for independent block compression
+	property int MaximumThreads
+	{
+		int get(void);
+		void set(int value);
+	}
+
 private:
 
 	//-----------------------------------------------------------------------
@@ -169,6 +206,10 @@ private:
 	Lz4BlockSize				m_blocksize;		// Encoder block size
 	Lz4CompressionLevel			m_level;			// Compression level
 	Lz4ContentChecksum			m_checksum;			// Content checksum mode
+	Lz4Dictionary^				m_dictionary;		// Compression dictionary
+	int							m_framesize;		// Seekable frame size
+	int							m_maxpending;		// Maximum blocks in flight
+	int							m_threads;			// Number of worker threads
 };
 
 //---------------------------------------------------------------------------
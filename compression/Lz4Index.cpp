@@ -0,0 +1,467 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "Lz4Index.h"
+
+#include <xxhash.h>
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// Lz4Index Constructor (internal)
+//
+// Arguments:
+//
+//	entries		- List of index entries, in stream order
+
+Lz4Index::Lz4Index(List<Entry^>^ entries) : m_entries(entries), 
+	m_length((entries->Count == 0) ? 0 : entries[entries->Count - 1]->Position + entries[entries->Count - 1]->Length)
+{
+}
+
+//---------------------------------------------------------------------------
+// Lz4Index::Build (static)
+//
+// Builds an index by scanning the frames and block headers of an LZ4 stream
+//
+// Arguments:
+//
+//	stream		- Stream containing the LZ4 data to be indexed
+
+Lz4Index^ Lz4Index::Build(Stream^ stream)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+
+	List<Entry^>^ entries = gcnew List<Entry^>();
+	array<unsigned __int8>^ header = gcnew array<unsigned __int8>(FRAME_HEADER_MAX);
+	array<unsigned __int8>^ block = gcnew array<unsigned __int8>(0);
+
+	__int64 offset = 0;						// Offset into the compressed data
+	__int64 position = 0;					// Offset into the decompressed data
+
+	while(true) {
+
+		// The base stream may only end between frames, and must contain at least one frame
+		int next = stream->ReadByte();
+		if(next < 0) { if(offset == 0) throw gcnew InvalidDataException(); break; }
+
+		header[0] = static_cast<unsigned __int8>(next);
+		ReadBuffer(stream, header, 1, 3);
+		unsigned int magic = BitConverter::ToUInt32(header, 0);
+
+		// Skippable frames, including any previously appended index, are passed over
+		if((magic & 0xFFFFFFF0) == LZ4F_MAGIC_SKIPPABLE_START) {
+
+			ReadBuffer(stream, header, 0, 4);
+			unsigned int size = BitConverter::ToUInt32(header, 0);
+			offset += 8 + static_cast<__int64>(size);
+
+			if(block->Length < 65536) block = gcnew array<unsigned __int8>(65536);
+			while(size > 0) {
+
+				int skip = static_cast<int>(Math::Min(size, static_cast<unsigned int>(block->Length)));
+				ReadBuffer(stream, block, 0, skip);
+				size -= skip;
+			}
+
+			continue;
+		}
+
+		if(magic != LZ4F_MAGICNUMBER) throw gcnew InvalidDataException();
+
+		// Read the FLG and BD bytes from the frame header
+		ReadBuffer(stream, header, 4, 2);
+		unsigned __int8 flags = header[4];
+		if((flags >> 6) != 0x01) throw gcnew InvalidDataException();
+
+		// Linked blocks depend on the blocks that precede them, there is no point within such a frame other
+		// than the beginning where decoding can start.  Independent blocks compressed with a dictionary only
+		// refer back to the dictionary, which the reader has to be provided with to decode them
+		if((flags & 0x20) == 0) throw gcnew NotSupportedException("LZ4 frames with linked blocks cannot be entered mid-stream and cannot be indexed");
+
+		// The header may include an 8 byte content size and a 4 byte dictionary identifier, and always ends with the header checksum
+		int length = 6 + ((flags & 0x08) ? 8 : 0) + ((flags & 0x01) ? 4 : 0) + 1;
+		ReadBuffer(stream, header, 6, length - 6);
+
+		{
+			// Verify the header checksum, which is the second byte of the XXH32 of the descriptor
+			pin_ptr<unsigned __int8> pinheader = &header[0];
+			if(((XXH32(&pinheader[4], length - 5, 0) >> 8) & 0xFF) != header[length - 1]) throw gcnew InvalidDataException();
+		}
+
+		// Block maximum size identifiers 4 through 7 indicate 64KiB, 256KiB, 1MiB and 4MiB
+		int blocksizeid = (header[5] >> 4) & 0x07;
+		if(blocksizeid < 4) throw gcnew InvalidDataException();
+
+		int blocksize = 1 << (8 + (blocksizeid * 2));
+		bool blockchecksum = ((flags & 0x10) != 0);
+		offset += length;
+
+		if(block->Length < (blocksize + 4)) block = gcnew array<unsigned __int8>(blocksize + 4);
+
+		while(true) {
+
+			ReadBuffer(stream, header, 0, 4);
+			unsigned int blockheader = BitConverter::ToUInt32(header, 0);
+
+			// A zero length block is the end mark, it may be followed by the content checksum which
+			// cannot be verified when decoding starts in the middle of the frame
+			if(blockheader == 0) {
+
+				offset += 4;
+				if((flags & 0x04) != 0) { ReadBuffer(stream, header, 0, 4); offset += 4; }
+				break;
+			}
+
+			int blocklength = static_cast<int>(blockheader & 0x7FFFFFFF);
+			if(blocklength > blocksize) throw gcnew InvalidDataException();
+
+			int compressedlength = 4 + blocklength + ((blockchecksum) ? 4 : 0);
+			ReadBuffer(stream, block, 0, compressedlength - 4);
+
+			// Uncompressed blocks are stored as-is, the length of a compressed block is determined from
+			// the literal and match lengths of its sequences without generating the decompressed data
+			int decompressed = (blockheader & 0x80000000) ? blocklength : GetBlockLength(block, 0, blocklength, blocksize);
+			if(decompressed < 0) throw gcnew InvalidDataException();
+
+			if(decompressed > 0) entries->Add(gcnew Entry(offset, compressedlength, position, decompressed, static_cast<unsigned __int8>((blockchecksum) ? ENTRY_BLOCKCHECKSUM : 0)));
+
+			offset += compressedlength;
+			position += decompressed;
+		}
+	}
+
+	return gcnew Lz4Index(entries);
+}
+
+//---------------------------------------------------------------------------
+// Lz4Index::Count::get
+//
+// Gets the number of entries in the index
+
+int Lz4Index::Count::get(void)
+{
+	return m_entries->Count;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Index::default[int]::get (internal)
+//
+// Gets the entry at the specified index
+
+Lz4Index::Entry^ Lz4Index::default::get(int index)
+{
+	return m_entries[index];
+}
+
+//---------------------------------------------------------------------------
+// Lz4Index::Find (internal)
+//
+// Locates the index of the entry that contains a decompressed data offset
+//
+// Arguments:
+//
+//	position	- Decompressed data offset
+
+int Lz4Index::Find(__int64 position)
+{
+	int low = 0;
+	int high = m_entries->Count - 1;
+
+	// Binary search for the last entry that doesn't start after the position
+	while(low < high) {
+
+		int middle = low + ((high - low + 1) >> 1);
+		if(m_entries[middle]->Position <= position) low = middle;
+		else high = middle - 1;
+	}
+
+	return low;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Index::GetBlockLength (private, static)
+//
+// Determines the decompressed length of an LZ4 block from its sequence headers
+//
+// Arguments:
+//
+//	block		- Buffer containing the compressed block data
+//	offset		- Offset of the compressed block data within the buffer
+//	length		- Length of the compressed block data
+//	limit		- Maximum allowable decompressed length
+
+int Lz4Index::GetBlockLength(array<unsigned __int8>^ block, int offset, int length, int limit)
+{
+	__int64 total = 0;						// Decompressed length of the block
+	int end = offset + length;				// End of the compressed block data
+
+	while(offset < end) {
+
+		// Each sequence starts with a token of the literal and match lengths, either of which
+		// can be extended with additional bytes when the 4-bit value in the token is 15
+		int token = block[offset++];
+
+		__int64 literals = token >> 4;
+		if(literals == 15) {
+
+			int next = 255;
+			while(next == 255) {
+
+				if(offset >= end) return -1;
+				literals += (next = block[offset++]);
+			}
+		}
+
+		// The final sequence of a block consists of only literals
+		if(literals > (end - offset)) return -1;
+		offset += static_cast<int>(literals);
+		total += literals;
+		if(offset == end) break;
+
+		// Skip over the match offset and determine the match length, the minimum match is 4 bytes
+		if((offset + 2) > end) return -1;
+		offset += 2;
+
+		__int64 match = (token & 0x0F) + 4;
+		if((token & 0x0F) == 15) {
+
+			int next = 255;
+			while(next == 255) {
+
+				if(offset >= end) return -1;
+				match += (next = block[offset++]);
+			}
+		}
+
+		total += match;
+		if(total > limit) return -1;
+	}
+
+	return (total > limit) ? -1 : static_cast<int>(total);
+}
+
+//---------------------------------------------------------------------------
+// Lz4Index::Length::get
+//
+// Gets the decompressed length of the indexed LZ4 stream
+
+__int64 Lz4Index::Length::get(void)
+{
+	return m_length;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Index::Load (static)
+//
+// Loads an index previously written with Save
+//
+// Arguments:
+//
+//	stream		- Stream to read the index from
+
+Lz4Index^ Lz4Index::Load(Stream^ stream)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+
+	// The index is contained in a skippable frame
+	array<unsigned __int8>^ header = gcnew array<unsigned __int8>(8);
+	ReadBuffer(stream, header, 0, 8);
+
+	if(BitConverter::ToUInt32(header, 0) != SKIPPABLE_MAGIC) throw gcnew InvalidDataException();
+	unsigned int size = BitConverter::ToUInt32(header, 4);
+	if((size < FOOTER_SIZE) || (size > static_cast<unsigned int>(Int32::MaxValue)) || (((size - FOOTER_SIZE) % ENTRY_SIZE) != 0)) throw gcnew InvalidDataException();
+
+	array<unsigned __int8>^ table = gcnew array<unsigned __int8>(static_cast<int>(size));
+	ReadBuffer(stream, table, 0, table->Length);
+
+	// The footer at the end of the frame identifies the seek table and the number of entries
+	int count = (table->Length - FOOTER_SIZE) / ENTRY_SIZE;
+	if(BitConverter::ToUInt32(table, table->Length - 4) != SEEKTABLE_MAGIC) throw gcnew InvalidDataException();
+	if(table[table->Length - 5] != VERSION) throw gcnew InvalidDataException();
+	if(BitConverter::ToUInt32(table, table->Length - FOOTER_SIZE) != static_cast<unsigned int>(count)) throw gcnew InvalidDataException();
+
+	List<Entry^>^ entries = gcnew List<Entry^>(count);
+	__int64 offset = 0;						// Offset into the compressed data
+	__int64 position = 0;					// Offset into the decompressed data
+
+	for(int index = 0; index < count; index++) {
+
+		int pos = index * ENTRY_SIZE;
+
+		__int64 entryoffset = BitConverter::ToInt64(table, pos);
+		int compressedlength = BitConverter::ToInt32(table, pos + 8);
+		int length = BitConverter::ToInt32(table, pos + 12);
+		unsigned __int8 flags = table[pos + 16];
+
+		// Entries must be in stream order and cannot overlap
+		if((entryoffset < offset) || (compressedlength <= 0) || (length <= 0)) throw gcnew InvalidDataException();
+		if((flags & ~(ENTRY_BLOCKCHECKSUM | ENTRY_FRAME)) != 0) throw gcnew InvalidDataException();
+
+		entries->Add(gcnew Entry(entryoffset, compressedlength, position, length, flags));
+
+		offset = entryoffset + compressedlength;
+		position += length;
+	}
+
+	return gcnew Lz4Index(entries);
+}
+
+//---------------------------------------------------------------------------
+// Lz4Index::ReadBuffer (private, static)
+//
+// Reads an exact number of bytes from a stream
+//
+// Arguments:
+//
+//	stream		- Stream instance from which to read the data
+//	buffer		- Destination data buffer
+//	offset		- Offset within buffer to begin copying data
+//	count		- Number of bytes to read from the stream
+
+void Lz4Index::ReadBuffer(Stream^ stream, array<unsigned __int8>^ buffer, int offset, int count)
+{
+	// Stream::Read() can return less data than requested, keep reading until done
+	while(count > 0) {
+
+		int next = stream->Read(buffer, offset, count);
+		if(next == 0) throw gcnew InvalidDataException();
+
+		offset += next;
+		count -= next;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Lz4Index::ReadTrailer (internal, static)
+//
+// Loads an index appended to the end of a seekable stream, if present
+//
+// Arguments:
+//
+//	stream		- Seekable stream containing the LZ4 data
+//	start		- Offset of the LZ4 data within the stream
+
+Lz4Index^ Lz4Index::ReadTrailer(Stream^ stream, __int64 start)
+{
+	if(!stream->CanSeek) return nullptr;
+
+	__int64 position = stream->Position;
+	__int64 end = stream->Length;
+
+	if((end - start) < (8 + FOOTER_SIZE)) return nullptr;
+
+	try {
+
+		// Check the footer of the index at the very end of the stream
+		array<unsigned __int8>^ footer = gcnew array<unsigned __int8>(FOOTER_SIZE);
+		stream->Position = end - FOOTER_SIZE;
+		ReadBuffer(stream, footer, 0, FOOTER_SIZE);
+
+		if((BitConverter::ToUInt32(footer, 5) != SEEKTABLE_MAGIC) || (footer[4] != VERSION)) return nullptr;
+
+		// The footer provides the number of entries, which leads back to the skippable frame header
+		__int64 tablestart = end - 8 - ((static_cast<__int64>(BitConverter::ToUInt32(footer, 0)) * ENTRY_SIZE) + FOOTER_SIZE);
+		if(tablestart < start) return nullptr;
+
+		stream->Position = tablestart;
+		Lz4Index^ index = Load(stream);
+
+		// All of the indexed data has to precede the index itself
+		if(index->Count > 0) {
+
+			Entry^ last = index->m_entries[index->Count - 1];
+			if((start + last->Offset + last->CompressedLength) > tablestart) return nullptr;
+		}
+
+		return index;
+	}
+
+	// A trailer that cannot be parsed is not an index, the stream is just not seekable
+	catch(InvalidDataException^) { return nullptr; }
+
+	finally { stream->Position = position; }
+}
+
+//---------------------------------------------------------------------------
+// Lz4Index::Save
+//
+// Writes the index to a stream as an LZ4 skippable frame
+//
+// Arguments:
+//
+//	stream		- Stream to write the index into
+
+void Lz4Index::Save(Stream^ stream)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+
+	int size = (m_entries->Count * ENTRY_SIZE) + FOOTER_SIZE;
+	array<unsigned __int8>^ frame = gcnew array<unsigned __int8>(8 + size);
+
+	// Skippable frame header
+	Array::Copy(BitConverter::GetBytes(SKIPPABLE_MAGIC), 0, frame, 0, 4);
+	Array::Copy(BitConverter::GetBytes(size), 0, frame, 4, 4);
+
+	// Entries; the decompressed offsets are implied by the decompressed lengths
+	int pos = 8;
+	for each(Entry^ entry in m_entries) {
+
+		Array::Copy(BitConverter::GetBytes(entry->Offset), 0, frame, pos, 8);
+		Array::Copy(BitConverter::GetBytes(entry->CompressedLength), 0, frame, pos + 8, 4);
+		Array::Copy(BitConverter::GetBytes(entry->Length), 0, frame, pos + 12, 4);
+		frame[pos + 16] = entry->Flags;
+		pos += ENTRY_SIZE;
+	}
+
+	// Footer
+	Array::Copy(BitConverter::GetBytes(m_entries->Count), 0, frame, pos, 4);
+	frame[pos + 4] = VERSION;
+	Array::Copy(BitConverter::GetBytes(SEEKTABLE_MAGIC), 0, frame, pos + 5, 4);
+
+	stream->Write(frame, 0, frame->Length);
+}
+
+//---------------------------------------------------------------------------
+// Lz4Index::Entry Constructor
+//
+// Arguments:
+//
+//	offset				- Offset of the block or frame in the compressed data
+//	compressedlength	- Length of the block or frame in the compressed data
+//	position			- Offset of the block or frame in the decompressed data
+//	length				- Length of the decompressed block or frame data
+//	flags				- Entry flags
+
+Lz4Index::Entry::Entry(__int64 offset, int compressedlength, __int64 position, int length, unsigned __int8 flags) : 
+	Offset(offset), CompressedLength(compressedlength), Position(position), Length(length), Flags(flags)
+{
+}
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
@@ -0,0 +1,215 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#ifndef __LZ4INDEX_H_
+#define __LZ4INDEX_H_
+#pragma once
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::IO;
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// Class Lz4Index
+//
+// Random access index of an LZ4 stream.  Each entry locates an independently
+// decodable block or frame and its offset within the decompressed data.  The
+// index is serialized as an LZ4 skippable frame, which can either be kept in
+// a sidecar file or appended to the indexed stream, where it is ignored by
+// other LZ4 decoders and located automatically by Lz4Reader
+//---------------------------------------------------------------------------
+
+public ref class Lz4Index
+{
+public:
+
+	//-----------------------------------------------------------------------
+	// Member Functions
+
+	// Build (static)
+	//
+	// Builds an index by scanning the frames and block headers of an LZ4 stream
+	static Lz4Index^ Build(Stream^ stream);
+
+	// Load (static)
+	//
+	// Loads an index previously written with Save
+	static Lz4Index^ Load(Stream^ stream);
+
+	// Save
+	//
+	// Writes the index to a stream as an LZ4 skippable frame
+	void Save(Stream^ stream);
+
+	//-----------------------------------------------------------------------
+	// Properties
+
+	// Count
+	//
+	// Gets the number of entries in the index
+	property int Count
+	{
+		int get(void);
+	}
+
+	// Length
+	//
+	// Gets the decompressed length of the indexed LZ4 stream
+	property __int64 Length
+	{
+		__int64 get(void);
+	}
+
+internal:
+
+	// Entry
+	//
+	// Independently decodable block or frame within the LZ4 stream
+	ref class Entry
+	{
+	public:
+
+		// Instance Constructor
+		//
+		Entry(__int64 offset, int compressedlength, __int64 position, int length, unsigned __int8 flags);
+
+		//-------------------------------------------------------------------
+		// Fields
+
+		initonly __int64			Offset;				// Compressed data offset
+		initonly int				CompressedLength;	// Compressed data length
+		initonly __int64			Position;			// Decompressed data offset
+		initonly int				Length;				// Decompressed data length
+		initonly unsigned __int8	Flags;				// Entry flags
+	};
+
+	// ENTRY_BLOCKCHECKSUM
+	//
+	// Entry flag indicating that a block is followed by a block checksum
+	static const unsigned __int8 ENTRY_BLOCKCHECKSUM = 0x01;
+
+	// ENTRY_FRAME
+	//
+	// Entry flag indicating that the entry is a complete frame rather than a block
+	static const unsigned __int8 ENTRY_FRAME = 0x02;
+
+	// Instance Constructor
+	//
+	Lz4Index(List<Entry^>^ entries);
+
+	//-----------------------------------------------------------------------
+	// Internal Member Functions
+
+	// Find
+	//
+	// Locates the index of the entry that contains a decompressed data offset
+	int Find(__int64 position);
+
+	// ReadTrailer (static)
+	//
+	// Loads an index appended to the end of a seekable stream, if present
+	static Lz4Index^ ReadTrailer(Stream^ stream, __int64 start);
+
+	//-----------------------------------------------------------------------
+	// Internal Properties
+
+	// default[int]
+	//
+	// Gets the entry at the specified index
+	property Entry^ default[int]
+	{
+		Entry^ get(int index);
+	}
+
+private:
+
+	// ENTRY_SIZE
+	//
+	// Size of a serialized index entry
+	static const int ENTRY_SIZE = 17;
+
+	// FOOTER_SIZE
+	//
+	// Size of the serialized index footer
+	static const int FOOTER_SIZE = 9;
+
+	// FRAME_HEADER_MAX
+	//
+	// Maximum size of an LZ4 frame header
+	static const int FRAME_HEADER_MAX = 19;
+
+	// LZ4F_MAGICNUMBER
+	//
+	// LZ4 frame format magic number
+	static const unsigned int LZ4F_MAGICNUMBER = 0x184D2204;
+
+	// LZ4F_MAGIC_SKIPPABLE_START
+	//
+	// First of the sixteen LZ4 skippable frame magic numbers
+	static const unsigned int LZ4F_MAGIC_SKIPPABLE_START = 0x184D2A50;
+
+	// SEEKTABLE_MAGIC
+	//
+	// Signature at the end of a serialized index ("L4ST")
+	static const unsigned int SEEKTABLE_MAGIC = 0x5453344C;
+
+	// SKIPPABLE_MAGIC
+	//
+	// Skippable frame magic number used for a serialized index
+	static const unsigned int SKIPPABLE_MAGIC = 0x184D2A5E;
+
+	// VERSION
+	//
+	// Version of the serialized index format
+	static const unsigned __int8 VERSION = 1;
+
+	//-----------------------------------------------------------------------
+	// Private Member Functions
+
+	// GetBlockLength (static)
+	//
+	// Determines the decompressed length of an LZ4 block from its sequence headers
+	static int GetBlockLength(array<unsigned __int8>^ block, int offset, int length, int limit);
+
+	// ReadBuffer (static)
+	//
+	// Reads an exact number of bytes from a stream
+	static void ReadBuffer(Stream^ stream, array<unsigned __int8>^ buffer, int offset, int count);
+
+	//-----------------------------------------------------------------------
+	// Member Variables
+
+	initonly List<Entry^>^		m_entries;			// Index entries
+	initonly __int64			m_length;			// Decompressed stream length
+};
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
+
+#endif	// __LZ4INDEX_H_
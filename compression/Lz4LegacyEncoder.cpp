@@ -63,7 +63,7 @@ namespace zuki::io::compression {
 //
 //	NONE
 
-Lz4LegacyEncoder::Lz4LegacyEncoder() : m_level(Lz4CompressionLevel::Default)
+Lz4LegacyEncoder::Lz4LegacyEncoder() : m_level(Lz4CompressionLevel::Default), m_maxpending(0), m_threads(1)
 {
 }
 
@@ -87,6 +87,68 @@ void Lz4LegacyEncoder::CompressionLevel::set(Lz4CompressionLevel value)
 	m_level = value;
 }
 
+//---------------------------------------------------------------------------
+// Lz4LegacyEncoder::Dictionary::get
+//
+// Gets the dictionary to compress the data with
+
+Lz4Dictionary^ Lz4LegacyEncoder::Dictionary::get(void)
+{
+	return m_dictionary;
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyEncoder::Dictionary::set
+//
+// Sets the dictionary to compress the data with
+
+void Lz4LegacyEncoder::Dictionary::set(Lz4Dictionary^ value)
+{
+	m_dictionary = value;
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyEncoder::MaximumPendingBlocks::get
+//
+// Gets the maximum number of blocks in flight during parallel compression
+
+int Lz4LegacyEncoder::MaximumPendingBlocks::get(void)
+{
+	return m_maxpending;
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyEncoder::MaximumPendingBlocks::set
+//
+// Sets the maximum number of blocks in flight during parallel compression
+
+void Lz4LegacyEncoder::MaximumPendingBlocks::set(int value)
+{
+	if(value < 0) throw gcnew ArgumentOutOfRangeException("value");
+	m_maxpending = value;
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyEncoder::MaximumThreads::get
+//
+// Gets the number of threads to use for block compression
+
+int Lz4LegacyEncoder::MaximumThreads::get(void)
+{
+	return m_threads;
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyEncoder::MaximumThreads::set
+//
+// Sets the number of threads to use for block compression
+
+void Lz4LegacyEncoder::MaximumThreads::set(int value)
+{
+	if(value < 0) throw gcnew ArgumentOutOfRangeException("value");
+	m_threads = value;
+}
+
 //---------------------------------------------------------------------------
 // Lz4LegacyEncoder::Encode
 //
@@ -160,7 +222,7 @@ void Lz4LegacyEncoder::Encode(Stream^ instream, Stream^ outstream)
 	if(Object::ReferenceEquals(instream, nullptr)) throw gcnew ArgumentNullException("instream");
 	if(Object::ReferenceEquals(outstream, nullptr)) throw gcnew ArgumentNullException("outstream");
 
-	msclr::auto_handle<Lz4LegacyWriter> writer(gcnew Lz4LegacyWriter(outstream, m_level, true));
+	msclr::auto_handle<Lz4LegacyWriter> writer(gcnew Lz4LegacyWriter(outstream, m_level, m_dictionary, m_threads, m_maxpending, true));
 	instream->CopyTo(writer.get());
 }
 
@@ -179,7 +241,7 @@ void Lz4LegacyEncoder::Encode(array<unsigned __int8>^ buffer, Stream^ outstream)
 	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
 	if(Object::ReferenceEquals(outstream, nullptr)) throw gcnew ArgumentNullException("outstream");
 
-	msclr::auto_handle<Lz4LegacyWriter> writer(gcnew Lz4LegacyWriter(outstream, m_level, true));
+	msclr::auto_handle<Lz4LegacyWriter> writer(gcnew Lz4LegacyWriter(outstream, m_level, m_dictionary, m_threads, m_maxpending, true));
 	writer->Write(buffer, 0, buffer->Length);
 }
 
@@ -200,7 +262,7 @@ void Lz4LegacyEncoder::Encode(array<unsigned __int8>^ buffer, int offset, int co
 	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
 	if(Object::ReferenceEquals(outstream, nullptr)) throw gcnew ArgumentNullException("outstream");
 
-	msclr::auto_handle<Lz4LegacyWriter> writer(gcnew Lz4LegacyWriter(outstream, m_level, true));
+	msclr::auto_handle<Lz4LegacyWriter> writer(gcnew Lz4LegacyWriter(outstream, m_level, m_dictionary, m_threads, m_maxpending, true));
 	writer->Write(buffer, offset, count);
 }
 
@@ -53,6 +53,7 @@
 
 #include "Encoder.h"
 #include "Lz4CompressionLevel.h"
+#include "Lz4Dictionary.h"
 
 #pragma warning(push, 4)				// Enable maximum compiler warnings
 
@@ -120,12 +121,42 @@ public:
 		void set(Lz4CompressionLevel value);
 	}
 
+	// Dictionary
+	//
+	// Gets/sets the dictionary to compress the data with
+	property Lz4Dictionary^ Dictionary
+	{
+		Lz4Dictionary^ get(void);
+		void set(Lz4Dictionary^ value);
+	}
+
+	// MaximumPendingBlocks
+	//
+	// Gets/sets the maximum number of blocks in flight during parallel compression
+	property int MaximumPendingBlocks
+	{
+		int get(void);
+		void set(int value);
+	}
+
+	// MaximumThreads
+	//
+	// Gets/sets the number of threads to use for block compression
+	property int MaximumThreads
+	{
+		int get(void);
+		void set(int value);
+	}
+
 private:
 
 	//-----------------------------------------------------------------------
 	// Member Variables
 
 	Lz4CompressionLevel			m_level;			// Compression level
+	Lz4Dictionary^				m_dictionary;		// Compression dictionary
+	int							m_maxpending;		// Maximum blocks in flight
+	int							m_threads;			// Number of worker threads
 };
 
 //---------------------------------------------------------------------------
@@ -0,0 +1,327 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// LZ4 Library
+// Copyright (c) 2011-2016, Yann Collet
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice, this
+//   list of conditions and the following disclaimer in the documentation and/or
+//   other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//---------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "Lz4LegacyIndex.h"
+
+#include <lz4.h>
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// Lz4LegacyIndex Constructor
+//
+// Arguments:
+//
+//	NONE
+
+Lz4LegacyIndex::Lz4LegacyIndex() : m_offsets(gcnew List<__int64>()), m_ends(gcnew List<__int64>()), m_complete(false)
+{
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyIndex::BlockLength (static, private)
+//
+// Counts the decompressed length of an LZ4 block from its sequences
+//
+// Arguments:
+//
+//	block		- Compressed LZ4 block data
+
+int Lz4LegacyIndex::BlockLength(array<unsigned __int8>^ block)
+{
+	__int64						length = 0;			// Decompressed length
+	int							pos = 0;			// Position within the block
+	unsigned __int8				next;				// Next length byte
+
+	while(pos < block->Length) {
+
+		// Each sequence starts with a token that holds the literal and match lengths
+		unsigned __int8 token = block[pos++];
+
+		__int64 literals = token >> 4;
+		if(literals == 15) do {
+
+			if(pos >= block->Length) throw gcnew InvalidDataException();
+			next = block[pos++];
+			literals += next;
+
+		} while(next == 255);
+
+		length += literals;
+		if((pos + literals > block->Length) || (length > LEGACY_BLOCKSIZE)) throw gcnew InvalidDataException();
+		pos += static_cast<int>(literals);
+
+		// The last sequence in the block consists of literals only
+		if(pos == block->Length) return static_cast<int>(length);
+
+		// Skip over the match offset, the match length is offset by the minimum match of 4
+		pos += 2;
+		if(pos > block->Length) throw gcnew InvalidDataException();
+
+		__int64 match = token & 0x0F;
+		if(match == 15) do {
+
+			if(pos >= block->Length) throw gcnew InvalidDataException();
+			next = block[pos++];
+			match += next;
+
+		} while(next == 255);
+
+		length += match + 4;
+		if(length > LEGACY_BLOCKSIZE) throw gcnew InvalidDataException();
+	}
+
+	// A block that ends with a match instead of literals is not valid
+	throw gcnew InvalidDataException();
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyIndex::Build (static)
+//
+// Builds an index by scanning the block headers of a legacy LZ4 stream
+//
+// Arguments:
+//
+//	stream		- Stream containing the legacy LZ4 data to be indexed
+
+Lz4LegacyIndex^ Lz4LegacyIndex::Build(Stream^ stream)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+	if(!stream->CanSeek) throw gcnew ArgumentException("The base stream must support seeking", "stream");
+
+	// Block offsets are relative to the current position of the stream
+	Lz4LegacyIndex^ index = gcnew Lz4LegacyIndex();
+	index->Locate(stream, stream->Position, Int32::MaxValue);
+
+	return index;
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyIndex::Count::get
+//
+// Gets the number of blocks that have been located
+
+int Lz4LegacyIndex::Count::get(void)
+{
+	msclr::lock lock(m_lock);
+	return m_offsets->Count;
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyIndex::default[int]::get (internal)
+//
+// Gets the offset of the length prefix of the specified block
+
+__int64 Lz4LegacyIndex::default::get(int index)
+{
+	msclr::lock lock(m_lock);
+	return m_offsets[index];
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyIndex::Find (internal)
+//
+// Locates the block that contains a decompressed position
+//
+// Arguments:
+//
+//	stream		- Stream containing the legacy LZ4 data
+//	basepos		- Stream offset of the legacy magic number
+//	position	- Decompressed position to be located
+
+int Lz4LegacyIndex::Find(Stream^ stream, __int64 basepos, __int64 position)
+{
+	msclr::lock lock(m_lock);
+
+	// The decompressed length of a block is known once the block after it has been located
+	while((!m_complete) && ((m_ends->Count == 0) || (m_ends[m_ends->Count - 1] <= position))) LocateNext(stream, basepos);
+
+	// Blocks are in order, the block that contains the position is the first one that ends after it
+	int block = m_ends->BinarySearch(position);
+	if(block < 0) block = ~block;
+	while((block < m_ends->Count) && (m_ends[block] <= position)) block++;
+
+	return (block < m_ends->Count) ? block : -1;
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyIndex::IsComplete::get
+//
+// Gets a flag indicating if every block in the stream has been located
+
+bool Lz4LegacyIndex::IsComplete::get(void)
+{
+	msclr::lock lock(m_lock);
+	return m_complete;
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyIndex::Locate (internal)
+//
+// Locates blocks by scanning the block headers until a number of blocks are known
+//
+// Arguments:
+//
+//	stream		- Stream containing the legacy LZ4 data
+//	basepos		- Stream offset of the legacy magic number
+//	count		- Number of blocks that need to be located
+
+bool Lz4LegacyIndex::Locate(Stream^ stream, __int64 basepos, int count)
+{
+	msclr::lock lock(m_lock);
+
+	while((m_offsets->Count < count) && (!m_complete)) LocateNext(stream, basepos);
+	return (m_offsets->Count >= count);
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyIndex::LocateNext (private)
+//
+// Locates the next block by hopping over the previous block
+//
+// Arguments:
+//
+//	stream		- Stream containing the legacy LZ4 data
+//	basepos		- Stream offset of the legacy magic number
+
+void Lz4LegacyIndex::LocateNext(Stream^ stream, __int64 basepos)
+{
+	unsigned int				value;				// Value read from the stream
+
+	msclr::lock lock(m_lock);
+
+	__int64 length = stream->Length;
+
+	// The first block immediately follows the magic number
+	__int64 next = 4;
+
+	if(m_offsets->Count == 0) {
+
+		stream->Position = basepos;
+		if(!ReadLE32(stream, value) || (value != LEGACY_MAGICNUMBER)) throw gcnew InvalidDataException();
+	}
+
+	// Every other block follows the previous block's length prefix and compressed data
+	else {
+
+		__int64 previous = m_offsets[m_offsets->Count - 1];
+
+		stream->Position = basepos + previous;
+		if(!ReadLE32(stream, value)) throw gcnew InvalidDataException();
+		if((value == 0) || (value > static_cast<unsigned int>(LZ4_compressBound(LEGACY_BLOCKSIZE)))) throw gcnew InvalidDataException();
+
+		next = previous + 4 + value;
+		if(basepos + next > length) throw gcnew InvalidDataException();
+
+		// Every block except the last one holds a full block of data, the compressed data only needs
+		// to be read when this is the last block; its length is counted from the LZ4 sequences
+		__int64 blocklength = LEGACY_BLOCKSIZE;
+		if(basepos + next + 4 > length) {
+
+			array<unsigned __int8>^ block = gcnew array<unsigned __int8>(value);
+			for(int read = 0; read < block->Length;) {
+
+				int count = stream->Read(block, read, block->Length - read);
+				if(count == 0) throw gcnew InvalidDataException();
+				read += count;
+			}
+
+			blocklength = BlockLength(block);
+		}
+
+		m_ends->Add(((m_ends->Count == 0) ? 0 : m_ends[m_ends->Count - 1]) + blocklength);
+	}
+
+	// The stream ends when there isn't enough data left for another length prefix
+	if(basepos + next + 4 > length) m_complete = true;
+	else m_offsets->Add(next);
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyIndex::Position[int]::get (internal)
+//
+// Gets the decompressed position of the specified block
+
+__int64 Lz4LegacyIndex::Position::get(int index)
+{
+	msclr::lock lock(m_lock);
+	return (index == 0) ? 0 : m_ends[index - 1];
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyIndex::ReadLE32 (static, private)
+//
+// Reads an unsigned 32 bit value from an input stream
+//
+// Arguments:
+//
+//	stream		- Stream instance from which to read the value
+//	value		- Value read from the stream
+
+bool Lz4LegacyIndex::ReadLE32(Stream^ stream, unsigned int% value)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException();
+
+	array<unsigned __int8>^ buffer = gcnew array<unsigned __int8>(4);
+	if(stream->Read(buffer, 0, 4) != 4) return false;
+
+	// Convert the 4 individual bytes into a single unsigned 32-bit value
+	value = (buffer[0] << 0) | (buffer[1] << 8) | (buffer[2] << 16) | (buffer[3] << 24);
+
+	return true;
+}
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
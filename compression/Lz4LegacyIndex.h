@@ -0,0 +1,188 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// LZ4 Library
+// Copyright (c) 2011-2016, Yann Collet
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice, this
+//   list of conditions and the following disclaimer in the documentation and/or
+//   other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//---------------------------------------------------------------------------
+
+#ifndef __LZ4LEGACYINDEX_H_
+#define __LZ4LEGACYINDEX_H_
+#pragma once
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::IO;
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// Class Lz4LegacyIndex
+//
+// Random access index of a legacy LZ4 stream.  Every block is prefixed with
+// its compressed length, so blocks are located by hopping over the length
+// prefixes.  Every block except the last one holds 8MiB of data; the length
+// of the last block is counted from its LZ4 sequences without decompressing
+// any data.  An index can be built up front or left empty and filled in by
+// Lz4LegacyReader as blocks are located
+//---------------------------------------------------------------------------
+
+public ref class Lz4LegacyIndex
+{
+public:
+
+	// Instance Constructor
+	//
+	Lz4LegacyIndex();
+
+	//-----------------------------------------------------------------------
+	// Member Functions
+
+	// Build (static)
+	//
+	// Builds an index by scanning the block headers of a legacy LZ4 stream
+	static Lz4LegacyIndex^ Build(Stream^ stream);
+
+	//-----------------------------------------------------------------------
+	// Properties
+
+	// Count
+	//
+	// Gets the number of blocks that have been located
+	property int Count
+	{
+		int get(void);
+	}
+
+	// IsComplete
+	//
+	// Gets a flag indicating if every block in the stream has been located
+	property bool IsComplete
+	{
+		bool get(void);
+	}
+
+internal:
+
+	//-----------------------------------------------------------------------
+	// Internal Member Functions
+
+	// Find
+	//
+	// Locates the block that contains a decompressed position
+	int Find(Stream^ stream, __int64 basepos, __int64 position);
+
+	// Locate
+	//
+	// Locates blocks by scanning the block headers until a number of blocks are known
+	bool Locate(Stream^ stream, __int64 basepos, int count);
+
+	//-----------------------------------------------------------------------
+	// Internal Properties
+
+	// default[int]
+	//
+	// Gets the offset of the length prefix of the specified block
+	property __int64 default[int]
+	{
+		__int64 get(int index);
+	}
+
+	// Position[int]
+	//
+	// Gets the decompressed position of the specified block
+	property __int64 Position[int]
+	{
+		__int64 get(int index);
+	}
+
+private:
+
+	// LEGACY_BLOCKSIZE
+	//
+	// Legacy lz4 block size
+	static const int LEGACY_BLOCKSIZE = (8 << 20);
+
+	// LEGACY_MAGICNUMBER
+	//
+	// Legacy lz4 magic number
+	static const unsigned int LEGACY_MAGICNUMBER = 0x184C2102;
+
+	//-----------------------------------------------------------------------
+	// Private Member Functions
+
+	// BlockLength (static)
+	//
+	// Counts the decompressed length of an LZ4 block from its sequences
+	static int BlockLength(array<unsigned __int8>^ block);
+
+	// LocateNext
+	//
+	// Locates the next block by hopping over the previous block
+	void LocateNext(Stream^ stream, __int64 basepos);
+
+	// ReadLE32 (static)
+	//
+	// Reads a little endian 32-bit number from a stream
+	static bool ReadLE32(Stream^ stream, unsigned int% value);
+
+	//-----------------------------------------------------------------------
+	// Member Variables
+
+	initonly List<__int64>^		m_offsets;			// Block length prefix offsets
+	initonly List<__int64>^		m_ends;				// Block decompressed end positions
+	bool						m_complete;			// Flag if all blocks are located
+
+	Object^	m_lock = gcnew Object();		// Synchronization object
+};
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
+
+#endif	// __LZ4LEGACYINDEX_H_
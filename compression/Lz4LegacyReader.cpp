@@ -73,13 +73,123 @@ Lz4LegacyReader::Lz4LegacyReader(Stream^ stream) : Lz4LegacyReader(stream, false
 //	stream		- The stream the compressed data is read from
 //	leaveopen	- Flag to leave the base stream open after disposal
 
-Lz4LegacyReader::Lz4LegacyReader(Stream^ stream, bool leaveopen) : m_disposed(false), m_stream(stream), m_leaveopen(leaveopen), 
-	m_hasmagic(false), m_outavail(0), m_outpos(0)
+Lz4LegacyReader::Lz4LegacyReader(Stream^ stream, bool leaveopen) : Lz4LegacyReader(stream, nullptr, 1, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyReader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	dictionary	- Dictionary the data was compressed with
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+Lz4LegacyReader::Lz4LegacyReader(Stream^ stream, Lz4Dictionary^ dictionary, bool leaveopen) : Lz4LegacyReader(stream, dictionary, 1, 0, leaveopen)
+{
+	if(Object::ReferenceEquals(dictionary, nullptr)) throw gcnew ArgumentNullException("dictionary");
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyReader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	index		- Random access index of the compressed data, may be empty
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+Lz4LegacyReader::Lz4LegacyReader(Stream^ stream, Lz4LegacyIndex^ index, bool leaveopen) : Lz4LegacyReader(stream, nullptr, 1, 0, leaveopen)
+{
+	if(Object::ReferenceEquals(index, nullptr)) throw gcnew ArgumentNullException("index");
+	if(!stream->CanSeek) throw gcnew ArgumentException("The base stream must support seeking", "stream");
+
+	// Block offsets in the index are relative to the current position of the base stream; blocks
+	// that have not been located yet are added to the index as they are needed
+	m_index = index;
+	m_basepos = stream->Position;
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyReader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	index		- Random access index of the compressed data, may be empty
+//	dictionary	- Dictionary the data was compressed with
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+Lz4LegacyReader::Lz4LegacyReader(Stream^ stream, Lz4LegacyIndex^ index, Lz4Dictionary^ dictionary, bool leaveopen) : Lz4LegacyReader(stream, dictionary, 1, 0, leaveopen)
+{
+	if(Object::ReferenceEquals(index, nullptr)) throw gcnew ArgumentNullException("index");
+	if(Object::ReferenceEquals(dictionary, nullptr)) throw gcnew ArgumentNullException("dictionary");
+	if(!stream->CanSeek) throw gcnew ArgumentException("The base stream must support seeking", "stream");
+
+	// Block offsets in the index are relative to the current position of the base stream; blocks
+	// that have not been located yet are added to the index as they are needed
+	m_index = index;
+	m_basepos = stream->Position;
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyReader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	threads		- Number of threads to use for decompression (zero = processor count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+Lz4LegacyReader::Lz4LegacyReader(Stream^ stream, int threads, bool leaveopen) : Lz4LegacyReader(stream, threads, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyReader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	threads		- Number of threads to use for decompression (zero = processor count)
+//	maxpending	- Maximum number of blocks read ahead (zero = twice the thread count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+Lz4LegacyReader::Lz4LegacyReader(Stream^ stream, int threads, int maxpending, bool leaveopen) : Lz4LegacyReader(stream, nullptr, threads, maxpending, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyReader Constructor (private)
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	dictionary	- Optional dictionary the data was compressed with
+//	threads		- Number of threads to use for decompression (zero = processor count)
+//	maxpending	- Maximum number of blocks read ahead (zero = twice the thread count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+Lz4LegacyReader::Lz4LegacyReader(Stream^ stream, Lz4Dictionary^ dictionary, int threads, int maxpending, bool leaveopen) : m_disposed(false), 
+	m_stream(stream), m_leaveopen(leaveopen), m_hasmagic(false), m_outavail(0), m_outpos(0), m_endofstream(false), 
+	m_basepos(0), m_position(0), m_length(-1), m_outblock(-1), m_outlength(0), m_dictionary(dictionary)
 {
 	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+	if(threads < 0) throw gcnew ArgumentOutOfRangeException("threads");
+	if(maxpending < 0) throw gcnew ArgumentOutOfRangeException("maxpending");
 
 	// Allocate the managed output buffer for this instance
 	m_out = gcnew array<unsigned __int8>(LEGACY_BLOCKSIZE);
+
+	// Legacy blocks are always independent and can be decompressed in parallel; zero threads
+	// indicates the processor count and zero pending blocks indicates twice the thread count
+	if(threads == 0) threads = Environment::ProcessorCount;
+	if(threads > 1) {
+
+		m_pending = gcnew TaskQueue<ArraySegment<unsigned __int8>>(threads, (maxpending == 0) ? threads * 2 : maxpending);
+		m_buffers = gcnew ConcurrentBag<array<unsigned __int8>^>();
+	}
 }
 
 //---------------------------------------------------------------------------
@@ -89,6 +199,9 @@ Lz4LegacyReader::~Lz4LegacyReader()
 {
 	if(m_disposed) return;
 
+	// Wait for and discard any blocks still being decompressed
+	if(m_pending) delete m_pending;
+
 	// Destroy the managed output data buffer
 	delete m_out;
 
@@ -128,7 +241,7 @@ bool Lz4LegacyReader::CanRead::get(void)
 bool Lz4LegacyReader::CanSeek::get(void)
 {
 	CHECK_DISPOSED(m_disposed);
-	return false;
+	return (m_index != nullptr);
 }
 
 //---------------------------------------------------------------------------
@@ -142,6 +255,74 @@ bool Lz4LegacyReader::CanWrite::get(void)
 	return false;
 }
 
+//---------------------------------------------------------------------------
+// Lz4LegacyReader::DecodeEntry (private)
+//
+// Decodes a single block located by the index into the output buffer
+//
+// Arguments:
+//
+//	block		- Index of the block to be decoded
+
+int Lz4LegacyReader::DecodeEntry(int block)
+{
+	unsigned int				blocksize;			// Compressed block size
+
+	// Read the length prefix and the entire block of compressed data from the input stream
+	m_stream->Position = m_basepos + m_index[block];
+	if(!ReadLE32(m_stream, blocksize)) throw gcnew InvalidDataException();
+	if((blocksize == 0) || (blocksize > static_cast<unsigned int>(LZ4_compressBound(LEGACY_BLOCKSIZE)))) throw gcnew InvalidDataException();
+
+	array<unsigned __int8>^ in = gcnew array<unsigned __int8>(blocksize);
+	if(m_stream->Read(in, 0, blocksize) != (int)blocksize) throw gcnew InvalidDataException();
+
+	// Pin both the input and output buffers so the LZ4 API can access them
+	pin_ptr<unsigned __int8> pinin = &in[0];
+	pin_ptr<unsigned __int8> pinout = &m_out[0];
+
+	int outlen = (m_dictionary) ? m_dictionary->Decompress(reinterpret_cast<char const*>(pinin), reinterpret_cast<char*>(pinout), blocksize, m_out->Length) :
+		LZ4_decompress_safe(reinterpret_cast<char const*>(pinin), reinterpret_cast<char*>(pinout), blocksize, m_out->Length);
+	if(outlen <= 0) throw gcnew InvalidDataException();
+
+	// Every block except the last one must be a full block, the length of the last block was counted
+	// from its sequences when it was located
+	if(outlen != (m_index->Position[block + 1] - m_index->Position[block])) throw gcnew InvalidDataException();
+
+	return outlen;
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyReader::DecompressBlock (private)
+//
+// Decompresses a single legacy block into a pooled output buffer
+//
+// Arguments:
+//
+//	state		- Compressed block data as a managed byte array
+
+ArraySegment<unsigned __int8> Lz4LegacyReader::DecompressBlock(Object^ state)
+{
+	array<unsigned __int8>^		out;			// Output data buffer
+
+	array<unsigned __int8>^ in = safe_cast<array<unsigned __int8>^>(state);
+
+	// Output buffers are recycled once the reader has consumed them, only allocate
+	// a new one when every buffer in the ring is still in use
+	if(!m_buffers->TryTake(out)) out = gcnew array<unsigned __int8>(LEGACY_BLOCKSIZE);
+
+	// Pin both the input and output buffers so the LZ4 API can access them
+	pin_ptr<unsigned __int8> pinin = &in[0];
+	pin_ptr<unsigned __int8> pinout = &out[0];
+
+	// Decompress the block of data into the output buffer; the legacy format has no means to identify
+	// the dictionary that was used, a mismatched dictionary will normally fail as corrupt block data
+	int outlen = (m_dictionary) ? m_dictionary->Decompress(reinterpret_cast<char const*>(pinin), reinterpret_cast<char*>(pinout), in->Length, out->Length) :
+		LZ4_decompress_safe(reinterpret_cast<char const*>(pinin), reinterpret_cast<char*>(pinout), in->Length, out->Length);
+	if(outlen <= 0) throw gcnew InvalidDataException();
+
+	return ArraySegment<unsigned __int8>(out, 0, outlen);
+}
+
 //---------------------------------------------------------------------------
 // Lz4LegacyReader::Flush
 //
@@ -165,7 +346,20 @@ void Lz4LegacyReader::Flush(void)
 __int64 Lz4LegacyReader::Length::get(void)
 {
 	CHECK_DISPOSED(m_disposed);
-	throw gcnew NotSupportedException();
+
+	// The length of the stream is only known when there is an index
+	if(!m_index) throw gcnew NotSupportedException();
+
+	msclr::lock lock(m_lock);
+
+	// The decompressed length of every block is counted as it is located, nothing needs to be decoded
+	if(m_length < 0) {
+
+		m_index->Locate(m_stream, m_basepos, Int32::MaxValue);
+		m_length = m_index->Position[m_index->Count];
+	}
+
+	return m_length;
 }
 
 //---------------------------------------------------------------------------
@@ -176,7 +370,11 @@ __int64 Lz4LegacyReader::Length::get(void)
 __int64 Lz4LegacyReader::Position::get(void)
 {
 	CHECK_DISPOSED(m_disposed);
-	throw gcnew NotSupportedException();
+
+	if(!m_index) throw gcnew NotSupportedException();
+
+	msclr::lock lock(m_lock);
+	return m_position;
 }
 
 //---------------------------------------------------------------------------
@@ -186,10 +384,38 @@ __int64 Lz4LegacyReader::Position::get(void)
 
 void Lz4LegacyReader::Position::set(__int64 value)
 {
-	UNREFERENCED_PARAMETER(value);
-
 	CHECK_DISPOSED(m_disposed);
-	throw gcnew NotSupportedException();
+
+	if(value < 0) throw gcnew ArgumentOutOfRangeException("value");
+	Seek(value, SeekOrigin::Begin);
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyReader::QueueBlocks (private)
+//
+// Reads ahead and queues length-prefixed blocks for decompression
+//
+// Arguments:
+//
+//	NONE
+
+void Lz4LegacyReader::QueueBlocks(void)
+{
+	unsigned int				nextblock;			// Next compressed block size
+
+	while((!m_endofstream) && (!m_pending->IsFull)) {
+
+		// Get the length of the next block of data to be decompressed; if there
+		// is insufficient data left in the stream, decompression is finished
+		if(!ReadLE32(m_stream, nextblock)) { m_endofstream = true; break; }
+		if((nextblock == 0) || (nextblock > static_cast<unsigned int>(LZ4_compressBound(LEGACY_BLOCKSIZE)))) throw gcnew InvalidDataException();
+
+		// Read the next entire block of compressed data from the input stream
+		array<unsigned __int8>^ in = gcnew array<unsigned __int8>(nextblock);
+		if(m_stream->Read(in, 0, nextblock) != (int)nextblock) throw gcnew InvalidDataException();
+
+		m_pending->Enqueue(gcnew Func<Object^, ArraySegment<unsigned __int8>>(this, &Lz4LegacyReader::DecompressBlock), in);
+	}
 }
 
 //---------------------------------------------------------------------------
@@ -219,6 +445,38 @@ int Lz4LegacyReader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 
 	msclr::lock lock(m_lock);				// Serialize access to the buffer
 
+	// With an index, the block that contains the current position is located and decoded by itself
+	if(m_index) {
+
+		while(count > 0) {
+
+			if(m_outavail == 0) {
+
+				// Locate the block that contains the current position, the previously decoded block is retained
+				int block = m_index->Find(m_stream, m_basepos, m_position);
+				if(block < 0) break;
+				if(block != m_outblock) { m_outlength = DecodeEntry(block); m_outblock = block; }
+
+				m_outpos = static_cast<int>(m_position - m_index->Position[block]);
+				if(m_outpos >= m_outlength) break;
+				m_outavail = m_outlength - m_outpos;
+			}
+
+			// Copy data from the decoded block into the output buffer
+			int next = Math::Min(m_outavail, count);
+			Array::Copy(m_out, m_outpos, buffer, offset, next);
+
+			m_outpos += next;				// Move offset into the decoded block
+			m_outavail -= next;				// Reduce length of the decoded block
+			m_position += next;				// Move the stream position
+			offset += next;					// Move offset into the caller's buffer
+			out += next;					// Increment the amount of data written to the caller
+			count -= next;					// Decrement the amount of data still to read
+		}
+
+		return out;
+	}
+
 	// Wait to check the magic number of the input stream until the first Read() attempt
 	if(!m_hasmagic) {
 
@@ -229,8 +487,25 @@ int Lz4LegacyReader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 
 	do {
 
+		// Parallel decompression reads ahead from the base stream and returns the blocks in order
+		if((m_pending) && (m_outavail == 0)) {
+
+			// Return the consumed output buffer to the ring before starting more blocks
+			if(!Object::ReferenceEquals(m_out, nullptr)) m_buffers->Add(m_out);
+			m_out = nullptr;
+
+			// Keep the decompression queue full, if it's empty all blocks have been returned
+			QueueBlocks();
+			if(m_pending->IsEmpty) break;
+
+			ArraySegment<unsigned __int8> block = m_pending->Dequeue();
+			m_out = block.Array;
+			m_outpos = 0;
+			m_outavail = block.Count;
+		}
+
 		// If there is no more output data available, decompress some more
-		if(m_outavail == 0) {
+		else if(m_outavail == 0) {
 
 			// Get the length of the next block of data to be decompressed; if there
 			// is insufficient data left in the stream, decompression is finished
@@ -246,7 +521,8 @@ int Lz4LegacyReader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 			pin_ptr<unsigned __int8> pinout = &m_out[0];
 
 			// Decompress the next block of data into the output buffer
-			m_outavail = LZ4_decompress_safe(reinterpret_cast<char const*>(pinin), reinterpret_cast<char*>(pinout), nextblock, m_out->Length);
+			m_outavail = (m_dictionary) ? m_dictionary->Decompress(reinterpret_cast<char const*>(pinin), reinterpret_cast<char*>(pinout), nextblock, m_out->Length) :
+				LZ4_decompress_safe(reinterpret_cast<char const*>(pinin), reinterpret_cast<char*>(pinout), nextblock, m_out->Length);
 			if(m_outavail <= 0) throw gcnew InvalidDataException();
 
 			m_outpos = 0;					// Reset the stored buffer offset
@@ -259,6 +535,7 @@ int Lz4LegacyReader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 
 		m_outpos += next;					// Move offset into the decompression buffer
 		m_outavail -= next;					// Reduce length of the decompression buffer
+		offset += next;						// Move offset into the caller's buffer
 		out += next;						// Increment the amount of data written to the caller
 		count -= next;						// Decrement the amount of data still to read
 	
@@ -302,11 +579,27 @@ bool Lz4LegacyReader::ReadLE32(Stream^ stream, unsigned int% value)
 
 __int64 Lz4LegacyReader::Seek(__int64 offset, SeekOrigin origin)
 {
-	UNREFERENCED_PARAMETER(offset);
-	UNREFERENCED_PARAMETER(origin);
-
 	CHECK_DISPOSED(m_disposed);
-	throw gcnew NotSupportedException();
+
+	// Seeking is only supported when there is an index
+	if(!m_index) throw gcnew NotSupportedException();
+
+	msclr::lock lock(m_lock);
+
+	// Convert the offset into an absolute position within the decompressed data; seeking
+	// relative to the end locates every remaining block to determine the length
+	__int64 position = offset;
+	if(origin == SeekOrigin::Current) position += m_position;
+	else if(origin == SeekOrigin::End) position += Length;
+	else if(origin != SeekOrigin::Begin) throw gcnew ArgumentOutOfRangeException("origin");
+
+	if(position < 0) throw gcnew IOException("An attempt was made to move the position before the beginning of the stream");
+
+	// The block that contains the new position is located on the next read
+	m_position = position;
+	m_outavail = 0;
+
+	return m_position;
 }
 
 //---------------------------------------------------------------------------
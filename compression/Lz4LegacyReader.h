@@ -52,10 +52,14 @@
 #pragma once
 
 #include <lz4.h>
+#include "Lz4Dictionary.h"
+#include "Lz4LegacyIndex.h"
+#include "TaskQueue.h"
 
 #pragma warning(push, 4)				// Enable maximum compiler warnings
 
 using namespace System;
+using namespace System::Collections::Concurrent;
 using namespace System::IO;
 
 namespace zuki::io::compression {
@@ -74,6 +78,11 @@ public:
 	//
 	Lz4LegacyReader(Stream^ stream);
 	Lz4LegacyReader(Stream^ stream, bool leaveopen);
+	Lz4LegacyReader(Stream^ stream, Lz4Dictionary^ dictionary, bool leaveopen);
+	Lz4LegacyReader(Stream^ stream, Lz4LegacyIndex^ index, bool leaveopen);
+	Lz4LegacyReader(Stream^ stream, Lz4LegacyIndex^ index, Lz4Dictionary^ dictionary, bool leaveopen);
+	Lz4LegacyReader(Stream^ stream, int threads, bool leaveopen);
+	Lz4LegacyReader(Stream^ stream, int threads, int maxpending, bool leaveopen);
 
 	//-----------------------------------------------------------------------
 	// Member Functions
@@ -167,6 +176,10 @@ private:
 	// Legacy lz4 block size
 	static const int LEGACY_BLOCKSIZE = (8 << 20);
 
+	// Instance Constructor
+	//
+	Lz4LegacyReader(Stream^ stream, Lz4Dictionary^ dictionary, int threads, int maxpending, bool leaveopen);
+
 	// Destructor
 	//
 	~Lz4LegacyReader();
@@ -174,6 +187,21 @@ private:
 	//-----------------------------------------------------------------------
 	// Private Member Functions
 
+	// DecodeEntry
+	//
+	// Decodes a single block located by the index into the output buffer
+	int DecodeEntry(int block);
+
+	// DecompressBlock
+	//
+	// Decompresses a single legacy block into a pooled output buffer
+	ArraySegment<unsigned __int8> DecompressBlock(Object^ state);
+
+	// QueueBlocks
+	//
+	// Reads ahead and queues length-prefixed blocks for decompression
+	void QueueBlocks(void);
+
 	// ReadLE32 (static)
 	//
 	// Reads a little endian 32-bit number from a stream
@@ -189,6 +217,16 @@ private:
 	array<unsigned __int8>^			m_out;				// Output data buffer
 	int								m_outpos;			// Position within the buffer
 	int								m_outavail;			// Available data in the buffer
+	bool							m_endofstream;		// Flag if all blocks have been read
+	TaskQueue<ArraySegment<unsigned __int8>>^	m_pending;	// Pending block decompressions
+	ConcurrentBag<array<unsigned __int8>^>^		m_buffers;	// Recycled output data buffers
+	Lz4LegacyIndex^					m_index;			// Optional random access index
+	__int64							m_basepos;			// Base stream offset of the index
+	__int64							m_position;			// Position within decompressed data
+	__int64							m_length;			// Decompressed length, if known
+	int								m_outblock;			// Index block held in m_out
+	int								m_outlength;		// Length of the index block in m_out
+	Lz4Dictionary^					m_dictionary;		// Optional decompression dictionary
 
 	Object^	m_lock = gcnew Object();		// Synchronization object
 };
@@ -74,7 +74,7 @@ static int LZ4IO_LZ4_compress(char const* source, char* destination, int sourcel
 //	stream		- The stream the compressed data is written to
 
 Lz4LegacyWriter::Lz4LegacyWriter(Stream^ stream) : 
-	Lz4LegacyWriter(stream, Lz4CompressionLevel::Default, false)
+	Lz4LegacyWriter(stream, Lz4CompressionLevel::Default, nullptr, 1, 0, false)
 {
 }
 
@@ -87,7 +87,7 @@ Lz4LegacyWriter::Lz4LegacyWriter(Stream^ stream) :
 //	level		- Indicates whether to emphasize speed or compression efficiency
 
 Lz4LegacyWriter::Lz4LegacyWriter(Stream^ stream, Compression::CompressionLevel level) : 
-	Lz4LegacyWriter(stream, Lz4CompressionLevel(level), false)
+	Lz4LegacyWriter(stream, Lz4CompressionLevel(level), nullptr, 1, 0, false)
 {
 }
 
@@ -100,7 +100,7 @@ Lz4LegacyWriter::Lz4LegacyWriter(Stream^ stream, Compression::CompressionLevel l
 //	leaveopen	- Flag to leave the base stream open after disposal
 
 Lz4LegacyWriter::Lz4LegacyWriter(Stream^ stream, bool leaveopen) : 
-	Lz4LegacyWriter(stream, Lz4CompressionLevel::Default, leaveopen)
+	Lz4LegacyWriter(stream, Lz4CompressionLevel::Default, nullptr, 1, 0, leaveopen)
 {
 }
 
@@ -114,7 +114,7 @@ Lz4LegacyWriter::Lz4LegacyWriter(Stream^ stream, bool leaveopen) :
 //	leaveopen	- Flag to leave the base stream open after disposal
 
 Lz4LegacyWriter::Lz4LegacyWriter(Stream^ stream, Compression::CompressionLevel level, bool leaveopen) :
-	Lz4LegacyWriter(stream, Lz4CompressionLevel(level), leaveopen)
+	Lz4LegacyWriter(stream, Lz4CompressionLevel(level), nullptr, 1, 0, leaveopen)
 {
 }
 
@@ -125,18 +125,59 @@ Lz4LegacyWriter::Lz4LegacyWriter(Stream^ stream, Compression::CompressionLevel l
 //
 //	stream		- The stream the compressed data is read from
 //	level		- Indicates the level of compression to use
+//	threads		- Number of threads to use for compression (zero = processor count)
 //	leaveopen	- Flag to leave the base stream open after disposal
 
-Lz4LegacyWriter::Lz4LegacyWriter(Stream^ stream, Lz4CompressionLevel level, bool leaveopen) : m_disposed(false), 
-	m_stream(stream), m_level(level), m_leaveopen(leaveopen), m_hasmagic(false), m_inpos(0)
+Lz4LegacyWriter::Lz4LegacyWriter(Stream^ stream, Compression::CompressionLevel level, int threads, bool leaveopen) :
+	Lz4LegacyWriter(stream, Lz4CompressionLevel(level), nullptr, threads, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	dictionary	- Dictionary to compress the data with
+//	level		- Indicates the level of compression to use
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+Lz4LegacyWriter::Lz4LegacyWriter(Stream^ stream, Lz4Dictionary^ dictionary, Compression::CompressionLevel level, bool leaveopen) :
+	Lz4LegacyWriter(stream, Lz4CompressionLevel(level), dictionary, 1, 0, leaveopen)
+{
+	if(Object::ReferenceEquals(dictionary, nullptr)) throw gcnew ArgumentNullException("dictionary");
+}
+
+//---------------------------------------------------------------------------
+// Lz4LegacyWriter Constructor (internal)
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	level		- Indicates the level of compression to use
+//	dictionary	- Optional dictionary to compress the data with
+//	threads		- Number of threads to use for compression (zero = processor count)
+//	maxpending	- Maximum number of blocks in flight (zero = twice the thread count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+Lz4LegacyWriter::Lz4LegacyWriter(Stream^ stream, Lz4CompressionLevel level, Lz4Dictionary^ dictionary, int threads, int maxpending, bool leaveopen) : 
+	m_disposed(false), m_stream(stream), m_level(level), m_dictionary(dictionary), m_leaveopen(leaveopen), m_hasmagic(false), m_inpos(0)
 {
 	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+	if(threads < 0) throw gcnew ArgumentOutOfRangeException("threads");
+	if(maxpending < 0) throw gcnew ArgumentOutOfRangeException("maxpending");
 
 	// Select a compression function based on the requested compression level
 	m_compressor = (m_level < 3) ? LZ4IO_LZ4_compress : LZ4_compress_HC;
 
 	// Create the managed input data buffer
 	m_in = gcnew array<unsigned __int8>(LEGACY_BLOCKSIZE);
+
+	// Legacy blocks are always independent and can be compressed in parallel; zero threads
+	// indicates the processor count and zero pending blocks indicates twice the thread count
+	if(threads == 0) threads = Environment::ProcessorCount;
+	if(threads > 1) m_pending = gcnew TaskQueue<array<unsigned __int8>^>(threads, (maxpending == 0) ? threads * 2 : maxpending);
 }
 
 //---------------------------------------------------------------------------
@@ -146,8 +187,11 @@ Lz4LegacyWriter::~Lz4LegacyWriter()
 {
 	if(m_disposed) return;
 
+	msclr::lock lock(m_lock);
+
 	// On disposal, finish compressing any partial block still in the buffer
-	if(m_inpos > 0) WriteNextBlock();
+	if(m_pending) { QueueNextBlock(); WritePendingBlocks(true); delete m_pending; }
+	else if(m_inpos > 0) WriteNextBlock();
 
 	// Destroy the managed input data buffer
 	delete m_in;
@@ -202,6 +246,40 @@ bool Lz4LegacyWriter::CanWrite::get(void)
 	return m_stream->CanWrite;
 }
 
+//---------------------------------------------------------------------------
+// Lz4LegacyWriter::CompressBlock (private)
+//
+// Compresses a single block of data into a length-prefixed legacy block
+//
+// Arguments:
+//
+//	state		- Uncompressed block data as a managed byte array
+
+array<unsigned __int8>^ Lz4LegacyWriter::CompressBlock(Object^ state)
+{
+	array<unsigned __int8>^ in = safe_cast<array<unsigned __int8>^>(state);
+
+	// Generate a buffer large enough for LZ4 to compress into, plus the length prefix
+	array<unsigned __int8>^ out = gcnew array<unsigned __int8>(LZ4_compressBound(in->Length) + 4);
+
+	// Pin both the input and output buffers in memory
+	pin_ptr<unsigned __int8> pinin = &in[0];
+	pin_ptr<unsigned __int8> pinout = &out[0];
+
+	// Compress the data using the specified compressor and level, or the dictionary if one was provided
+	int outlen = (m_dictionary) ? m_dictionary->Compress(reinterpret_cast<char const*>(pinin), reinterpret_cast<char*>(&pinout[4]), in->Length, out->Length - 4, m_level) :
+		m_compressor(reinterpret_cast<char const*>(pinin), reinterpret_cast<char*>(&pinout[4]), in->Length, out->Length - 4, m_level);
+	if(outlen <= 0) throw gcnew InvalidOperationException();
+
+	// Write the length prefix into the first 4 bytes of the output buffer
+	out[0] = static_cast<unsigned __int8>(outlen & 0xFF);
+	out[1] = static_cast<unsigned __int8>((outlen >> 8) & 0xFF);
+	out[2] = static_cast<unsigned __int8>((outlen >> 16) & 0xFF);
+	out[3] = static_cast<unsigned __int8>((outlen >> 24) & 0xFF);
+
+	return out;
+}
+
 //---------------------------------------------------------------------------
 // Lz4LegacyWriter::Flush
 //
@@ -217,7 +295,10 @@ void Lz4LegacyWriter::Flush(void)
 
 	msclr::lock lock(m_lock);
 
-	if(m_inpos > 0) WriteNextBlock();		// Flush buffered data
+	// Flush buffered data, waiting for any blocks being compressed in parallel
+	if(m_pending) { QueueNextBlock(); WritePendingBlocks(true); }
+	else if(m_inpos > 0) WriteNextBlock();
+
 	m_stream->Flush();						// Flush underlying stream
 }
 
@@ -256,6 +337,33 @@ void Lz4LegacyWriter::Position::set(__int64 value)
 	throw gcnew NotSupportedException();
 }
 
+//---------------------------------------------------------------------------
+// Lz4LegacyWriter::QueueNextBlock (private)
+//
+// Queues the contents of the buffer for compression as a single block
+//
+// Arguments:
+//
+//	NONE
+
+void Lz4LegacyWriter::QueueNextBlock(void)
+{
+	// If there is nothing in the buffer, there is no work to do
+	if(m_inpos == 0) return;
+
+	// A partial block is trimmed to the actual length of the data
+	array<unsigned __int8>^ block = m_in;
+	if(m_inpos < block->Length) Array::Resize<unsigned __int8>(block, m_inpos);
+
+	// Make room in the queue for the block and start compressing it
+	WritePendingBlocks(false);
+	m_pending->Enqueue(gcnew Func<Object^, array<unsigned __int8>^>(this, &Lz4LegacyWriter::CompressBlock), block);
+
+	// The queued buffer now belongs to the worker, a new one is needed for the next block
+	if(Object::ReferenceEquals(block, m_in)) m_in = gcnew array<unsigned __int8>(LEGACY_BLOCKSIZE);
+	m_inpos = 0;
+}
+
 //---------------------------------------------------------------------------
 // Lz4LegacyWriter::Read
 //
@@ -364,10 +472,15 @@ void Lz4LegacyWriter::Write(array<unsigned __int8>^ buffer, int offset, int coun
 		Array::Copy(buffer, offset, m_in, m_inpos, next);
 
 		m_inpos += next;				// Increment length of buffer
+		offset += next;					// Move offset into the source buffer
 		count -= next;					// Decrement bytes remaining
 
-		// If the input buffer has been filled, write the next block to output
-		if(m_inpos == m_in->Length) WriteNextBlock();
+		// If the input buffer has been filled, write or queue the next block
+		if(m_inpos == m_in->Length) {
+
+			if(m_pending) QueueNextBlock();
+			else WriteNextBlock();
+		}
 	}
 }
 
@@ -415,8 +528,9 @@ int Lz4LegacyWriter::WriteNextBlock(void)
 	pin_ptr<unsigned __int8> pinin = &m_in[0];
 	pin_ptr<unsigned __int8> pinout = &out[0];
 
-	// Compress the data using the specified compressor and level
-	int outlen = m_compressor(reinterpret_cast<char const*>(pinin), reinterpret_cast<char*>(pinout), m_inpos, out->Length, m_level);
+	// Compress the data using the specified compressor and level, or the dictionary if one was provided
+	int outlen = (m_dictionary) ? m_dictionary->Compress(reinterpret_cast<char const*>(pinin), reinterpret_cast<char*>(pinout), m_inpos, out->Length, m_level) :
+		m_compressor(reinterpret_cast<char const*>(pinin), reinterpret_cast<char*>(pinout), m_inpos, out->Length, m_level);
 
 	WriteLE32(m_stream, outlen);			// Write the length prefix
 	m_stream->Write(out, 0, outlen);		// Write the compressed data
@@ -427,6 +541,28 @@ int Lz4LegacyWriter::WriteNextBlock(void)
 	return outlen + 4;						// Include the LE32 length prefix
 }
 
+//---------------------------------------------------------------------------
+// Lz4LegacyWriter::WritePendingBlocks (private)
+//
+// Writes completed blocks from the compression queue to the base stream
+//
+// Arguments:
+//
+//	all			- Flag to write all pending blocks rather than just make room
+
+void Lz4LegacyWriter::WritePendingBlocks(bool all)
+{
+	while((all) ? !m_pending->IsEmpty : m_pending->IsFull) {
+
+		// Wait for the oldest block to finish and write it to the output stream; the
+		// length of the compressed data is stored in the block's length prefix
+		array<unsigned __int8>^ block = m_pending->Dequeue();
+		int length = (block[0] << 0) | (block[1] << 8) | (block[2] << 16) | (block[3] << 24);
+
+		m_stream->Write(block, 0, length + 4);
+	}
+}
+
 //---------------------------------------------------------------------------
 
 } // zuki::io::compression
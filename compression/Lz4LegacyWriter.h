@@ -54,6 +54,8 @@
 #include <lz4.h>
 #include <lz4hc.h>
 #include "Lz4CompressionLevel.h"
+#include "Lz4Dictionary.h"
+#include "TaskQueue.h"
 
 #pragma warning(push, 4)				// Enable maximum compiler warnings
 
@@ -78,6 +80,8 @@ public:
 	Lz4LegacyWriter(Stream^ stream, Compression::CompressionLevel level);
 	Lz4LegacyWriter(Stream^ stream, bool leaveopen);
 	Lz4LegacyWriter(Stream^ stream, Compression::CompressionLevel level, bool leaveopen);
+	Lz4LegacyWriter(Stream^ stream, Compression::CompressionLevel level, int threads, bool leaveopen);
+	Lz4LegacyWriter(Stream^ stream, Lz4Dictionary^ dictionary, Compression::CompressionLevel level, bool leaveopen);
 
 	//-----------------------------------------------------------------------
 	// Member Functions
@@ -168,7 +172,7 @@ internal:
 
 	// Instance Constructor
 	//
-	Lz4LegacyWriter(Stream^ stream, Lz4CompressionLevel level, bool leaveopen);
+	Lz4LegacyWriter(Stream^ stream, Lz4CompressionLevel level, Lz4Dictionary^ dictionary, int threads, int maxpending, bool leaveopen);
 
 private:
 
@@ -194,6 +198,16 @@ private:
 	//-----------------------------------------------------------------------
 	// Private Member Functions
 
+	// CompressBlock
+	//
+	// Compresses a single block of data into a length-prefixed legacy block
+	array<unsigned __int8>^ CompressBlock(Object^ state);
+
+	// QueueNextBlock
+	//
+	// Queues the contents of the buffer for compression as a single block
+	void QueueNextBlock(void);
+
 	// WriteLE32 (static)
 	//
 	// Reads a little endian 32-bit number into a stream
@@ -204,6 +218,11 @@ private:
 	// Writes the next block of data into the output stream
 	int WriteNextBlock(void);
 
+	// WritePendingBlocks
+	//
+	// Writes completed blocks from the compression queue to the base stream
+	void WritePendingBlocks(bool all);
+
 	//-----------------------------------------------------------------------
 	// Member Variables
 
@@ -212,9 +231,11 @@ private:
 	bool							m_leaveopen;		// Flag to leave base stream open
 	CompressFunc					m_compressor;		// Pointer to the compression func
 	int								m_level;			// Compression level
+	Lz4Dictionary^					m_dictionary;		// Optional compression dictionary
 	bool							m_hasmagic;			// Flag if magic number was written
 	array<unsigned __int8>^			m_in;				// Input data buffer
 	int								m_inpos;			// Position within the buffer
+	TaskQueue<array<unsigned __int8>^>^	m_pending;		// Pending block compressions
 
 	Object^	m_lock = gcnew Object();		// Synchronization object
 };
@@ -50,6 +50,8 @@
 #include "stdafx.h"
 #include "Lz4Reader.h"
 
+#include <lz4.h>
+#include <lz4frame_static.h>
 #include "Lz4Exception.h"
 
 // LZ4F_dctx_s is an incomplete type; causes LNK4248
@@ -79,10 +81,109 @@ Lz4Reader::Lz4Reader(Stream^ stream) : Lz4Reader(stream, false)
 //	stream		- The stream the compressed data is read from
 //	leaveopen	- Flag to leave the base stream open after disposal
 
-Lz4Reader::Lz4Reader(Stream^ stream, bool leaveopen) : m_disposed(false), m_stream(stream), m_leaveopen(leaveopen), m_inpos(0), 
-	m_finished(false), m_inavail(0)
+Lz4Reader::Lz4Reader(Stream^ stream, bool leaveopen) : Lz4Reader(stream, nullptr, 1, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// Lz4Reader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	dictionary	- Dictionary the data was compressed with
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+Lz4Reader::Lz4Reader(Stream^ stream, Lz4Dictionary^ dictionary, bool leaveopen) : Lz4Reader(stream, dictionary, 1, 0, leaveopen)
+{
+	if(Object::ReferenceEquals(dictionary, nullptr)) throw gcnew ArgumentNullException("dictionary");
+}
+
+//---------------------------------------------------------------------------
+// Lz4Reader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	index		- Random access index of the compressed data
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+Lz4Reader::Lz4Reader(Stream^ stream, Lz4Index^ index, bool leaveopen) : Lz4Reader(stream, nullptr, 1, 0, leaveopen)
+{
+	if(Object::ReferenceEquals(index, nullptr)) throw gcnew ArgumentNullException("index");
+	if(!stream->CanSeek) throw gcnew ArgumentException("The base stream must support seeking", "stream");
+
+	m_index = index;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Reader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	index		- Random access index of the compressed data
+//	dictionary	- Dictionary the data was compressed with
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+Lz4Reader::Lz4Reader(Stream^ stream, Lz4Index^ index, Lz4Dictionary^ dictionary, bool leaveopen) : Lz4Reader(stream, dictionary, 1, 0, leaveopen)
+{
+	if(Object::ReferenceEquals(index, nullptr)) throw gcnew ArgumentNullException("index");
+	if(Object::ReferenceEquals(dictionary, nullptr)) throw gcnew ArgumentNullException("dictionary");
+	if(!stream->CanSeek) throw gcnew ArgumentException("The base stream must support seeking", "stream");
+
+	m_index = index;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Reader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	threads		- Number of threads to use for decompression (zero = processor count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+Lz4Reader::Lz4Reader(Stream^ stream, int threads, bool leaveopen) : Lz4Reader(stream, threads, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// Lz4Reader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	threads		- Number of threads to use for decompression (zero = processor count)
+//	maxpending	- Maximum number of blocks in flight (zero = twice the thread count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+Lz4Reader::Lz4Reader(Stream^ stream, int threads, int maxpending, bool leaveopen) : Lz4Reader(stream, nullptr, threads, maxpending, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// Lz4Reader Constructor (private)
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	dictionary	- Optional dictionary the data was compressed with
+//	threads		- Number of threads to use for decompression (zero = processor count)
+//	maxpending	- Maximum number of blocks in flight (zero = twice the thread count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+Lz4Reader::Lz4Reader(Stream^ stream, Lz4Dictionary^ dictionary, int threads, int maxpending, bool leaveopen) : m_disposed(false), m_stream(stream), 
+	m_leaveopen(leaveopen), m_inpos(0), m_finished(false), m_inavail(0), m_threads(threads), m_maxpending(maxpending), m_hasheader(false), 
+	m_endmark(false), m_outpos(0), m_outavail(0), m_basepos(0), m_position(0), m_outentry(-1), m_random(false), m_dictionary(dictionary), 
+	m_framestart(true)
 {
 	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+	if(threads < 0) throw gcnew ArgumentOutOfRangeException("threads");
+	if(maxpending < 0) throw gcnew ArgumentOutOfRangeException("maxpending");
+
+	// Zero threads indicates that the number of processors should be used
+	if(m_threads == 0) m_threads = Environment::ProcessorCount;
 
 	// Allocate and initialize the decompression context structure
 	try { m_context = new LZ4F_decompressionContext_t; memset(m_context, 0, sizeof(LZ4F_decompressionContext_t)); }
@@ -94,6 +195,13 @@ Lz4Reader::Lz4Reader(Stream^ stream, bool leaveopen) : m_disposed(false), m_stre
 	// Create the LZ4 decompression context structure for this instance
 	LZ4F_errorCode_t result = LZ4F_createDecompressionContext(m_context, LZ4F_VERSION);
 	if(LZ4F_isError(result)) throw gcnew Lz4Exception(result);
+
+	// A seekable base stream may have an index appended to it in a trailing skippable frame
+	if(stream->CanSeek) {
+
+		m_basepos = stream->Position;
+		m_index = Lz4Index::ReadTrailer(stream, m_basepos);
+	}
 }
 
 //---------------------------------------------------------------------------
@@ -103,8 +211,12 @@ Lz4Reader::~Lz4Reader()
 {
 	if(m_disposed) return;
 
-	// Destroy the managed input buffer
+	// Wait for any outstanding decompression operations
+	if(m_pending) delete m_pending;
+
+	// Destroy the managed input and output buffers
 	delete m_in;
+	if(m_out) delete m_out;
 
 	// Optionally dispose of the input stream instance
 	if(!m_leaveopen) delete m_stream;
@@ -118,6 +230,9 @@ Lz4Reader::~Lz4Reader()
 
 Lz4Reader::!Lz4Reader()
 {
+	// Release the content checksum state used for parallel decompression
+	if(m_xxhash) { XXH32_freeState(m_xxhash); m_xxhash = nullptr; }
+
 	if(m_context == nullptr) return;
 
 	// Release the LZ4 compression context structure
@@ -157,7 +272,7 @@ bool Lz4Reader::CanRead::get(void)
 bool Lz4Reader::CanSeek::get(void)
 {
 	CHECK_DISPOSED(m_disposed);
-	return false;
+	return (m_index != nullptr);
 }
 
 //---------------------------------------------------------------------------
@@ -171,6 +286,172 @@ bool Lz4Reader::CanWrite::get(void)
 	return false;
 }
 
+//---------------------------------------------------------------------------
+// Lz4Reader::DecodeEntry (private)
+//
+// Decodes a single block or frame located by the index
+//
+// Arguments:
+//
+//	entry		- Index entry to be decoded
+
+array<unsigned __int8>^ Lz4Reader::DecodeEntry(Lz4Index::Entry^ entry)
+{
+	array<unsigned __int8>^ in = gcnew array<unsigned __int8>(entry->CompressedLength);
+	array<unsigned __int8>^ out = gcnew array<unsigned __int8>(entry->Length);
+
+	m_stream->Position = m_basepos + entry->Offset;
+	if(ReadBuffer(m_stream, in, 0, in->Length) != in->Length) throw gcnew InvalidDataException();
+
+	pin_ptr<unsigned __int8> pinin = &in[0];
+	pin_ptr<unsigned __int8> pinout = &out[0];
+
+	// A complete frame is decoded from the beginning with a context of its own
+	if(entry->Flags & Lz4Index::ENTRY_FRAME) {
+
+		VerifyFrameHeader(pinin, in->Length);
+
+		LZ4F_decompressionContext_t context;
+		LZ4F_errorCode_t result = LZ4F_createDecompressionContext(&context, LZ4F_VERSION);
+		if(LZ4F_isError(result)) throw gcnew Lz4Exception(result);
+
+		try {
+
+			size_t inpos = 0;
+			size_t outpos = 0;
+
+			do {
+
+				// Use local input/output size values, they are modified by LZ4F_decompress
+				size_t insize = in->Length - inpos;
+				size_t outsize = out->Length - outpos;
+
+				LZ4F_decompressOptions_t options ={ 0 /* stableSrc */, {0, 0, 0} /* reserved */};
+				result = (m_dictionary) ? LZ4F_decompress_usingDict(context, &pinout[outpos], &outsize, &pinin[inpos], &insize, m_dictionary->Data, m_dictionary->Length, &options) :
+					LZ4F_decompress(context, &pinout[outpos], &outsize, &pinin[inpos], &insize, &options);
+				if(LZ4F_isError(result)) throw gcnew Lz4Exception(result);
+
+				inpos += insize;
+				outpos += outsize;
+
+				if((result != 0) && (insize == 0) && (outsize == 0)) throw gcnew InvalidDataException();
+
+			} while(result != 0);
+
+			// The frame must produce exactly the length recorded in the index
+			if(outpos != static_cast<size_t>(out->Length)) throw gcnew InvalidDataException();
+		}
+
+		finally { LZ4F_freeDecompressionContext(context); }
+
+		return out;
+	}
+
+	// Otherwise the entry is an independent block, verify the optional block checksum
+	unsigned int header = (in[0] << 0) | (in[1] << 8) | (in[2] << 16) | (in[3] << 24);
+	int length = static_cast<int>(header & 0x7FFFFFFF);
+	if((length + ((entry->Flags & Lz4Index::ENTRY_BLOCKCHECKSUM) ? 8 : 4)) != in->Length) throw gcnew InvalidDataException();
+
+	if(entry->Flags & Lz4Index::ENTRY_BLOCKCHECKSUM) {
+
+		unsigned int checksum = (in[length + 4] << 0) | (in[length + 5] << 8) | (in[length + 6] << 16) | (in[length + 7] << 24);
+		if(XXH32(&pinin[4], length, 0) != checksum) throw gcnew InvalidDataException();
+	}
+
+	// Uncompressed blocks are simply copied into the output buffer
+	if(header & 0x80000000) {
+
+		if(length != out->Length) throw gcnew InvalidDataException();
+		Array::Copy(in, 4, out, 0, length);
+	}
+
+	else {
+
+		// Independent blocks of a frame compressed with a dictionary each refer back to the dictionary
+		int outlen = (m_dictionary) ? m_dictionary->Decompress(reinterpret_cast<char const*>(&pinin[4]), reinterpret_cast<char*>(pinout), length, out->Length) :
+			LZ4_decompress_safe(reinterpret_cast<char const*>(&pinin[4]), reinterpret_cast<char*>(pinout), length, out->Length);
+		if(outlen != out->Length) throw gcnew InvalidDataException();
+	}
+
+	return out;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Reader::DecompressBlock (private)
+//
+// Decompresses a single independent LZ4 frame block
+//
+// Arguments:
+//
+//	state		- Compressed block data, including the block header, as a managed byte array
+
+array<unsigned __int8>^ Lz4Reader::DecompressBlock(Object^ state)
+{
+	array<unsigned __int8>^ in = safe_cast<array<unsigned __int8>^>(state);
+	pin_ptr<unsigned __int8> pinin = &in[0];
+
+	// The block header indicates the length of the data and if it was stored uncompressed
+	unsigned int header = (in[0] << 0) | (in[1] << 8) | (in[2] << 16) | (in[3] << 24);
+	int length = static_cast<int>(header & 0x7FFFFFFF);
+
+	// Verify the optional block checksum, which immediately follows the block data
+	if(m_blockchecksum) {
+
+		unsigned int checksum = (in[length + 4] << 0) | (in[length + 5] << 8) | (in[length + 6] << 16) | (in[length + 7] << 24);
+		if(XXH32(&pinin[4], length, 0) != checksum) throw gcnew InvalidDataException();
+	}
+
+	// Uncompressed blocks are simply copied into the output buffer
+	if(header & 0x80000000) {
+
+		array<unsigned __int8>^ out = gcnew array<unsigned __int8>(length);
+		Array::Copy(in, 4, out, 0, length);
+		return out;
+	}
+
+	// Compressed blocks are decompressed into a buffer large enough to hold the largest block
+	array<unsigned __int8>^ out = gcnew array<unsigned __int8>(m_blocksize);
+	pin_ptr<unsigned __int8> pinout = &out[0];
+
+	int outlen = (m_dictionary) ? m_dictionary->Decompress(reinterpret_cast<char const*>(&pinin[4]), reinterpret_cast<char*>(pinout), length, out->Length) :
+		LZ4_decompress_safe(reinterpret_cast<char const*>(&pinin[4]), reinterpret_cast<char*>(pinout), length, out->Length);
+	if(outlen < 0) throw gcnew InvalidDataException();
+
+	// Only the final block of the frame is normally shorter than the maximum block size
+	if(outlen < out->Length) Array::Resize<unsigned __int8>(out, outlen);
+	return out;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Reader::FillInput (private)
+//
+// Ensures that the input buffer holds at least the requested amount of data
+//
+// Arguments:
+//
+//	required	- Number of bytes required in the input buffer
+
+void Lz4Reader::FillInput(size_t required)
+{
+	if(m_inavail >= required) return;
+
+	// Move any remaining input data to the start of the buffer
+	if(m_inpos > 0) {
+
+		Array::Copy(m_in, static_cast<int>(m_inpos), m_in, 0, static_cast<int>(m_inavail));
+		m_inpos = 0;
+	}
+
+	// The base stream may have less data available than requested, which is not an error here
+	while(m_inavail < required) {
+
+		int next = m_stream->Read(m_in, static_cast<int>(m_inavail), BUFFER_SIZE - static_cast<int>(m_inavail));
+		if(next == 0) break;
+
+		m_inavail += next;
+	}
+}
+
 //---------------------------------------------------------------------------
 // Lz4Reader::Flush
 //
@@ -194,7 +475,10 @@ void Lz4Reader::Flush(void)
 __int64 Lz4Reader::Length::get(void)
 {
 	CHECK_DISPOSED(m_disposed);
-	throw gcnew NotSupportedException();
+
+	// The length of the stream is only known when there is an index
+	if(!m_index) throw gcnew NotSupportedException();
+	return m_index->Length;
 }
 
 //---------------------------------------------------------------------------
@@ -205,7 +489,11 @@ __int64 Lz4Reader::Length::get(void)
 __int64 Lz4Reader::Position::get(void)
 {
 	CHECK_DISPOSED(m_disposed);
-	throw gcnew NotSupportedException();
+
+	if(!m_index) throw gcnew NotSupportedException();
+
+	msclr::lock lock(m_lock);
+	return m_position;
 }
 
 //---------------------------------------------------------------------------
@@ -215,10 +503,51 @@ __int64 Lz4Reader::Position::get(void)
 
 void Lz4Reader::Position::set(__int64 value)
 {
-	UNREFERENCED_PARAMETER(value);
-
 	CHECK_DISPOSED(m_disposed);
-	throw gcnew NotSupportedException();
+
+	if(value < 0) throw gcnew ArgumentOutOfRangeException("value");
+	Seek(value, SeekOrigin::Begin);
+}
+
+//---------------------------------------------------------------------------
+// Lz4Reader::QueueBlocks (private)
+//
+// Reads ahead and queues independent blocks for decompression
+//
+// Arguments:
+//
+//	NONE
+
+void Lz4Reader::QueueBlocks(void)
+{
+	unsigned int				header;				// Block header value
+
+	while((!m_endmark) && (!m_pending->IsFull)) {
+
+		if(!ReadLE32(m_stream, header)) throw gcnew InvalidDataException();
+
+		// A zero length block is the end mark, it may be followed by the content checksum
+		if(header == 0) {
+
+			if((m_xxhash) && (!ReadLE32(m_stream, m_checksum))) throw gcnew InvalidDataException();
+			m_endmark = true;
+			break;
+		}
+
+		// Sanity check the block length against the maximum block size from the frame header
+		int length = static_cast<int>(header & 0x7FFFFFFF);
+		if(length > m_blocksize) throw gcnew InvalidDataException();
+
+		// Read the entire block, including the header and optional checksum, into a buffer
+		array<unsigned __int8>^ block = gcnew array<unsigned __int8>(length + ((m_blockchecksum) ? 8 : 4));
+		block[0] = static_cast<unsigned __int8>(header & 0xFF);
+		block[1] = static_cast<unsigned __int8>((header >> 8) & 0xFF);
+		block[2] = static_cast<unsigned __int8>((header >> 16) & 0xFF);
+		block[3] = static_cast<unsigned __int8>((header >> 24) & 0xFF);
+		if(ReadBuffer(m_stream, block, 4, block->Length - 4) != (block->Length - 4)) throw gcnew InvalidDataException();
+
+		m_pending->Enqueue(gcnew Func<Object^, array<unsigned __int8>^>(this, &Lz4Reader::DecompressBlock), block);
+	}
 }
 
 //---------------------------------------------------------------------------
@@ -246,6 +575,106 @@ int Lz4Reader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 	// If there is no buffer to read into or the stream is already done, return zero
 	if((count == 0) || (m_finished)) return 0;
 
+	// With an index, the block or frame that contains the current position is located and decoded by itself;
+	// parallel decompression is still used to read from the start of the stream until it is repositioned
+	if((m_index) && ((m_threads == 1) || (m_random))) {
+
+		int read = 0;						// Total bytes read from the stream
+
+		// Independent blocks rely on the header of the frame they belong to for the dictionary identifier
+		if(m_framestart) {
+
+			array<unsigned __int8>^ header = gcnew array<unsigned __int8>(LZ4F_HEADER_SIZE_MAX);
+			pin_ptr<unsigned __int8> pinheader = &header[0];
+
+			m_stream->Position = m_basepos;
+			VerifyFrameHeader(pinheader, ReadBuffer(m_stream, header, 0, header->Length));
+			m_framestart = false;
+		}
+
+		while(count > 0) {
+
+			if(m_outavail == 0) {
+
+				if(m_position >= m_index->Length) break;
+
+				// Locate the entry that contains the current position, the previously decoded entry is retained
+				int entry = m_index->Find(m_position);
+				if(entry != m_outentry) { m_out = DecodeEntry(m_index[entry]); m_outentry = entry; }
+
+				m_outpos = static_cast<int>(m_position - m_index[entry]->Position);
+				m_outavail = m_out->Length - m_outpos;
+			}
+
+			// Copy data from the decoded entry into the output buffer
+			int next = Math::Min(m_outavail, count);
+			Array::Copy(m_out, m_outpos, buffer, offset, next);
+
+			m_outpos += next;				// Move offset into the decoded entry
+			m_outavail -= next;				// Reduce length of the decoded entry
+			m_position += next;				// Move the stream position
+			offset += next;					// Move offset into the output buffer
+			count -= next;					// Decrement the amount of data still to read
+			read += next;					// Increment the amount of data read
+		}
+
+		return read;
+	}
+
+	// Wait to check the frame header for parallel decompression until the first Read() attempt
+	if((m_threads > 1) && (!m_hasheader)) ReadFrameHeader();
+
+	// Parallel decompression reads ahead from the base stream and returns the blocks in order
+	if(m_pending) {
+
+		int read = 0;						// Total bytes read from the stream
+
+		while(count > 0) {
+
+			if(m_outavail == 0) {
+
+				// Keep the decompression queue full, if it's empty all blocks in the frame have been returned
+				QueueBlocks();
+				if(m_pending->IsEmpty) {
+
+					// Verify the optional content checksum now that all data in the frame has been returned
+					if((m_xxhash) && (XXH32_digest(m_xxhash) != m_checksum)) throw gcnew InvalidDataException();
+
+					// Frames can be concatenated together, decompression continues with the next frame
+					// header; a frame that can't be decompressed in parallel continues serially
+					if(!ReadFrameHeader()) { m_finished = true; break; }
+					if(!m_pending) break;
+					continue;
+				}
+
+				m_out = m_pending->Dequeue();
+				m_outpos = 0;
+				m_outavail = m_out->Length;
+
+				// The content checksum has to be calculated serially against the decompressed data
+				if((m_xxhash) && (m_outavail > 0)) {
+
+					pin_ptr<unsigned __int8> pinout = &m_out[0];
+					XXH32_update(m_xxhash, pinout, m_outavail);
+				}
+			}
+
+			// Copy data from the decompressed block into the output buffer
+			int next = Math::Min(m_outavail, count);
+			Array::Copy(m_out, m_outpos, buffer, offset, next);
+
+			m_outpos += next;				// Move offset into the decompressed block
+			m_outavail -= next;				// Reduce length of the decompressed block
+			offset += next;					// Move offset into the output buffer
+			count -= next;					// Decrement the amount of data still to read
+			read += next;					// Increment the amount of data read
+		}
+
+		// If the next frame can't be decompressed in parallel and no data has been read yet,
+		// fall through and start the serial decompression of that frame
+		if((read > 0) || (m_pending) || (m_finished)) { m_position += read; return read; }
+	}
+
 	// Pin the input and output buffers in memory
 	pin_ptr<unsigned __int8> pinin = &m_in[0];
 	pin_ptr<unsigned __int8> pinout = &buffer[0];
@@ -255,6 +684,14 @@ int Lz4Reader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 
 	do {
 
+		// The dictionary identifier is checked before LZ4F_decompress sees the frame header
+		if(m_framestart) {
+
+			FillInput(LZ4F_HEADER_SIZE_MAX);
+			VerifyFrameHeader(&pinin[m_inpos], m_inavail);
+			m_framestart = false;
+		}
+
 		// If the input buffer was flushed from a previous iteration, refill it
 		if(m_inavail == 0) {
 
@@ -268,7 +705,9 @@ int Lz4Reader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 
 		// Decompress the next chunk of input data
 		LZ4F_decompressOptions_t options ={ 0 /* stableSrc */, {0, 0, 0} /* reserved */};
-		LZ4F_errorCode_t result = LZ4F_decompress(*m_context, &pinout[offset], &outsize, &pinin[m_inpos], &insize, &options);
+		LZ4F_errorCode_t result = (m_dictionary) ? 
+			LZ4F_decompress_usingDict(*m_context, &pinout[offset], &outsize, &pinin[m_inpos], &insize, m_dictionary->Data, m_dictionary->Length, &options) :
+			LZ4F_decompress(*m_context, &pinout[offset], &outsize, &pinin[m_inpos], &insize, &options);
 		if(LZ4F_isError(result)) throw gcnew Lz4Exception(result);
 
 		// Adjust the input buffer parameters
@@ -279,14 +718,180 @@ int Lz4Reader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 		availout -= static_cast<int>(outsize);
 		offset += static_cast<int>(outsize);
 
-		// Zero indicates that the end of the input stream has been reached
-		if(result == 0) { m_finished = true; break; }
+		// Zero indicates the end of a frame; frames can be concatenated together, so decompression only
+		// continues if the next input is another frame or a skippable frame (such as a seek table)
+		if(result == 0) {
+
+			m_framestart = true;
+
+			// Only the complete magic number identifies another frame, anything else ends the stream
+			FillInput(4);
+			if(m_inavail < 4) { m_finished = true; break; }
+
+			int inpos = static_cast<int>(m_inpos);
+			unsigned int magic = (m_in[inpos] << 0) | (m_in[inpos + 1] << 8) | (m_in[inpos + 2] << 16) | (m_in[inpos + 3] << 24);
+			if((magic != LZ4F_MAGICNUMBER) && ((magic & 0xFFFFFFF0) != LZ4F_MAGIC_SKIPPABLE_START)) { m_finished = true; break; }
+		}
 
 	} while(availout > 0);
 
+	m_position += (count - availout);
 	return (count - availout);
 }
 
+//---------------------------------------------------------------------------
+// Lz4Reader::ReadBuffer (static, private)
+//
+// Reads an exact number of bytes from a stream
+//
+// Arguments:
+//
+//	stream		- Stream instance from which to read the data
+//	buffer		- Destination data buffer
+//	offset		- Offset within buffer to begin copying data
+//	count		- Number of bytes to read from the stream
+
+int Lz4Reader::ReadBuffer(Stream^ stream, array<unsigned __int8>^ buffer, int offset, int count)
+{
+	int read = 0;					// Total bytes read from the stream
+
+	// Stream::Read() can return less data than requested, keep reading until done
+	while(read < count) {
+
+		int next = stream->Read(buffer, offset + read, count - read);
+		if(next == 0) break;
+
+		read += next;
+	}
+
+	return read;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Reader::ReadFrameHeader (private)
+//
+// Reads the next frame header to determine if parallel decompression is possible
+//
+// Arguments:
+//
+//	NONE
+
+bool Lz4Reader::ReadFrameHeader(void)
+{
+	m_hasheader = true;
+
+	// Create a temporary buffer to hold the frame header information
+	array<unsigned __int8>^ header = gcnew array<unsigned __int8>(LZ4F_HEADER_SIZE_MAX);
+
+	// Read the magic number, FLG and BD bytes from the frame header
+	int length = ReadBuffer(m_stream, header, 0, 7);
+	unsigned int magic = (header[0] << 0) | (header[1] << 8) | (header[2] << 16) | (header[3] << 24);
+
+	// Skippable frames (such as a seek table) are passed over; the length follows the magic number
+	while((length == 7) && ((magic & 0xFFFFFFF0) == LZ4F_MAGIC_SKIPPABLE_START)) {
+
+		if(ReadBuffer(m_stream, header, length, 1) != 1) throw gcnew InvalidDataException();
+		unsigned int skip = (header[4] << 0) | (header[5] << 8) | (header[6] << 16) | (header[7] << 24);
+
+		if(m_stream->CanSeek) m_stream->Seek(skip, SeekOrigin::Current);
+		else {
+
+			array<unsigned __int8>^ discard = gcnew array<unsigned __int8>(static_cast<int>(Math::Min(skip, static_cast<unsigned int>(BUFFER_SIZE))));
+			while(skip > 0) {
+
+				int read = m_stream->Read(discard, 0, static_cast<int>(Math::Min(skip, static_cast<unsigned int>(discard->Length))));
+				if(read == 0) throw gcnew InvalidDataException();
+				skip -= read;
+			}
+		}
+
+		length = ReadBuffer(m_stream, header, 0, 7);
+		magic = (header[0] << 0) | (header[1] << 8) | (header[2] << 16) | (header[3] << 24);
+	}
+
+	// When a frame follows another frame that was decompressed in parallel, anything other than
+	// another frame ends the stream the same way it does for serial decompression
+	if((m_pending) && ((length < 5) || (magic != LZ4F_MAGICNUMBER))) return false;
+
+	unsigned __int8 flags = header[4];
+
+	// Only version 01 frames with independent blocks can be decompressed in parallel
+	if((length == 7) && (magic == LZ4F_MAGICNUMBER) && ((flags >> 6) == 0x01) && ((flags & 0x20) != 0)) {
+
+		// The header may include an 8 byte content size and a 4 byte dictionary identifier, and always ends with the header checksum
+		int remaining = ((flags & 0x08) ? 8 : 0) + ((flags & 0x01) ? 4 : 0) + 1;
+		if(ReadBuffer(m_stream, header, length, remaining) != remaining) throw gcnew InvalidDataException();
+		length += remaining;
+
+		// Verify the header checksum, which is the second byte of the XXH32 of the descriptor
+		pin_ptr<unsigned __int8> pinheader = &header[0];
+		if(((XXH32(&pinheader[4], length - 5, 0) >> 8) & 0xFF) != header[length - 1]) throw gcnew InvalidDataException();
+
+		VerifyFrameHeader(pinheader, length);
+		m_framestart = false;
+
+		// Block maximum size identifiers 4 through 7 indicate 64KiB, 256KiB, 1MiB and 4MiB
+		int blocksizeid = (header[5] >> 4) & 0x07;
+		if(blocksizeid < 4) throw gcnew InvalidDataException();
+
+		m_blocksize = 1 << (8 + (blocksizeid * 2));
+		m_blockchecksum = ((flags & 0x10) != 0);
+		m_endmark = false;
+
+		// The content checksum has to be calculated serially against the decompressed data
+		if((flags & 0x04) != 0) {
+
+			if(m_xxhash == nullptr) m_xxhash = XXH32_createState();
+			if(m_xxhash == nullptr) throw gcnew OutOfMemoryException();
+			XXH32_reset(m_xxhash, 0);
+		}
+
+		else if(m_xxhash) { XXH32_freeState(m_xxhash); m_xxhash = nullptr; }
+
+		// The decompression queue is reused for each frame that follows the first one
+		if(!m_pending) m_pending = gcnew TaskQueue<array<unsigned __int8>^>(m_threads, (m_maxpending == 0) ? m_threads * 2 : m_maxpending);
+	}
+
+	// Linked block frames fall back to serial decompression, including when they follow a frame that
+	// was decompressed in parallel; the header data that was already read from the base stream is
+	// handed off to LZ4F_decompress via the input buffer
+	else {
+
+		if(m_pending) { delete m_pending; m_pending = nullptr; }
+		if(m_xxhash) { XXH32_freeState(m_xxhash); m_xxhash = nullptr; }
+
+		Array::Copy(header, m_in, length);
+		m_inpos = 0;
+		m_inavail = length;
+		m_framestart = true;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Reader::ReadLE32 (static, private)
+//
+// Reads an unsigned 32 bit value from an input stream
+//
+// Arguments:
+//
+//	stream		- Stream instance from which to read the value
+//	value		- Value read from the stream
+
+bool Lz4Reader::ReadLE32(Stream^ stream, unsigned int% value)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException();
+
+	array<unsigned __int8>^ buffer = gcnew array<unsigned __int8>(4);
+	if(ReadBuffer(stream, buffer, 0, 4) != 4) return false;
+
+	// Convert the 4 individual bytes into a single unsigned 32-bit value
+	value = (buffer[0] << 0) | (buffer[1] << 8) | (buffer[2] << 16) | (buffer[3] << 24);
+
+	return true;
+}
+
 //---------------------------------------------------------------------------
 // Lz4Reader::Seek
 //
@@ -299,11 +904,28 @@ int Lz4Reader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 
 __int64 Lz4Reader::Seek(__int64 offset, SeekOrigin origin)
 {
-	UNREFERENCED_PARAMETER(offset);
-	UNREFERENCED_PARAMETER(origin);
-
 	CHECK_DISPOSED(m_disposed);
-	throw gcnew NotSupportedException();
+
+	// Seeking is only supported when there is an index
+	if(!m_index) throw gcnew NotSupportedException();
+
+	msclr::lock lock(m_lock);
+
+	// Convert the offset into an absolute position within the decompressed data
+	__int64 position = offset;
+	if(origin == SeekOrigin::Current) position += m_position;
+	else if(origin == SeekOrigin::End) position += m_index->Length;
+	else if(origin != SeekOrigin::Begin) throw gcnew ArgumentOutOfRangeException("origin");
+
+	if(position < 0) throw gcnew IOException("An attempt was made to move the position before the beginning of the stream");
+
+	// The entry that contains the new position is located on the next read
+	m_position = position;
+	m_outavail = 0;
+	m_random = true;
+	m_finished = false;
+
+	return m_position;
 }
 
 //---------------------------------------------------------------------------
@@ -323,6 +945,33 @@ void Lz4Reader::SetLength(__int64 value)
 	throw gcnew NotSupportedException();
 }
 
+//---------------------------------------------------------------------------
+// Lz4Reader::VerifyFrameHeader (private)
+//
+// Verifies the dictionary identifier in an LZ4 frame header
+//
+// Arguments:
+//
+//	header		- Pointer to the start of the frame header
+//	length		- Length of the available header data
+
+void Lz4Reader::VerifyFrameHeader(unsigned __int8 const* header, size_t length)
+{
+	// Skippable frames and anything that isn't a frame header are left for LZ4F_decompress to deal with
+	if(length < 5) return;
+	unsigned int magic = (header[0] << 0) | (header[1] << 8) | (header[2] << 16) | (header[3] << 24);
+	if((magic != LZ4F_MAGICNUMBER) || ((header[4] & 0x01) == 0)) return;
+
+	// The dictionary identifier follows the FLG and BD bytes and the optional 8 byte content size
+	size_t offset = 6 + ((header[4] & 0x08) ? 8 : 0);
+	if(length < offset + 4) throw gcnew InvalidDataException();
+
+	unsigned int id = (header[offset] << 0) | (header[offset + 1] << 8) | (header[offset + 2] << 16) | (header[offset + 3] << 24);
+
+	if(!m_dictionary) throw gcnew InvalidDataException("The LZ4 frame was compressed with a dictionary");
+	if(id != m_dictionary->Id) throw gcnew InvalidDataException("The LZ4 frame was compressed with a different dictionary");
+}
+
 //---------------------------------------------------------------------------
 // Lz4Reader::Write
 //
@@ -52,6 +52,10 @@
 #pragma once
 
 #include <lz4frame.h>
+#include <xxhash.h>
+#include "Lz4Dictionary.h"
+#include "Lz4Index.h"
+#include "TaskQueue.h"
 
 #pragma warning(push, 4)				// Enable maximum compiler warnings
 
@@ -74,6 +78,11 @@ public:
 	//
 	Lz4Reader(Stream^ stream);
 	Lz4Reader(Stream^ stream, bool leaveopen);
+	Lz4Reader(Stream^ stream, Lz4Dictionary^ dictionary, bool leaveopen);
+	Lz4Reader(Stream^ stream, Lz4Index^ index, bool leaveopen);
+	Lz4Reader(Stream^ stream, Lz4Index^ index, Lz4Dictionary^ dictionary, bool leaveopen);
+	Lz4Reader(Stream^ stream, int threads, bool leaveopen);
+	Lz4Reader(Stream^ stream, int threads, int maxpending, bool leaveopen);
 
 	//-----------------------------------------------------------------------
 	// Member Functions
@@ -162,11 +171,68 @@ private:
 	// Size of the local input buffer, in bytes
 	static const int BUFFER_SIZE = 65536;
 
+	// LZ4F_MAGICNUMBER
+	//
+	// LZ4 frame format magic number
+	static const unsigned int LZ4F_MAGICNUMBER = 0x184D2204;
+
+	// LZ4F_MAGIC_SKIPPABLE_START
+	//
+	// LZ4 skippable frame magic number (low 4 bits are user defined)
+	static const unsigned int LZ4F_MAGIC_SKIPPABLE_START = 0x184D2A50;
+
+	// Instance Constructor
+	//
+	Lz4Reader(Stream^ stream, Lz4Dictionary^ dictionary, int threads, int maxpending, bool leaveopen);
+
 	// Destructor / Finalizer
 	//
 	~Lz4Reader();
 	!Lz4Reader();
 
+	//-----------------------------------------------------------------------
+	// Private Member Functions
+
+	// DecodeEntry
+	//
+	// Decodes a single block or frame located by the index
+	array<unsigned __int8>^ DecodeEntry(Lz4Index::Entry^ entry);
+
+	// DecompressBlock
+	//
+	// Decompresses a single independent LZ4 frame block
+	array<unsigned __int8>^ DecompressBlock(Object^ state);
+
+	// FillInput
+	//
+	// Ensures that the input buffer holds at least the requested amount of data
+	void FillInput(size_t required);
+
+	// QueueBlocks
+	//
+	// Reads ahead and queues independent blocks for decompression
+	void QueueBlocks(void);
+
+	// ReadBuffer (static)
+	//
+	// Reads an exact number of bytes from a stream
+	static int ReadBuffer(Stream^ stream, array<unsigned __int8>^ buffer, int offset, int count);
+
+	// ReadFrameHeader
+	//
+	// Reads the next frame header to determine if parallel decompression is possible
+	bool ReadFrameHeader(void);
+
+	// ReadLE32 (static)
+	//
+	// Reads a little endian 32-bit number from a stream
+	static bool ReadLE32(Stream^ stream, unsigned int% value);
+
+	// VerifyFrameHeader
+	//
+	// Verifies the dictionary identifier in an LZ4 frame header
+	void VerifyFrameHeader(unsigned __int8 const* header, size_t length);
+
 	//-----------------------------------------------------------------------
 	// Member Variables
 
@@ -178,6 +244,25 @@ private:
 	array<unsigned __int8>^			m_in;				// LZ4 input stream buffer
 	size_t							m_inpos;			// Current position in the buffer
 	size_t							m_inavail;			// Available data in the buffer
+	int								m_threads;			// Number of worker threads
+	int								m_maxpending;		// Maximum blocks in flight
+	bool							m_hasheader;		// Flag if frame header was read
+	TaskQueue<array<unsigned __int8>^>^	m_pending;		// Pending block decompressions
+	int								m_blocksize;		// Maximum frame block size
+	bool							m_blockchecksum;	// Flag if blocks have checksums
+	bool							m_endmark;			// Flag if end mark was read
+	XXH32_state_t*					m_xxhash;			// Content checksum state
+	unsigned int					m_checksum;			// Expected content checksum
+	array<unsigned __int8>^			m_out;				// Decompressed block buffer
+	int								m_outpos;			// Position within the buffer
+	int								m_outavail;			// Available data in the buffer
+	Lz4Index^						m_index;			// Random access index
+	__int64							m_basepos;			// Base stream offset of the index
+	__int64							m_position;			// Decompressed stream position
+	int								m_outentry;			// Index entry in the output buffer
+	bool							m_random;			// Flag if reading entries by position
+	Lz4Dictionary^					m_dictionary;		// Optional decompression dictionary
+	bool							m_framestart;		// Flag if input is at a frame header
 
 	Object^	m_lock = gcnew Object();		// Synchronization object
 };
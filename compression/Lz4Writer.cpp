@@ -50,6 +50,8 @@
 #include "stdafx.h"
 #include "Lz4Writer.h"
 
+#include <lz4.h>
+#include <lz4hc.h>
 #include <lz4frame_static.h>
 #include "Lz4Exception.h"
 
@@ -81,6 +83,18 @@ static size_t LZ4F_getBlockSize(unsigned blockSizeID)
     return blockSizes[blockSizeID];
 }
 
+//---------------------------------------------------------------------------
+// LZ4F_localLZ4_compress (local)
+//
+// Adaptation of lz4frame::LZ4F_localLZ4_compress_limitedOutput; accepts an unused
+// compression level argument to allow for pointer compatibility with LZ4_compress_HC
+
+static int LZ4F_localLZ4_compress(char const* source, char* destination, int sourcelen, int destlen, int level)
+{
+	UNREFERENCED_PARAMETER(level);
+	return LZ4_compress_fast(source, destination, sourcelen, destlen, 1);
+}
+
 //---------------------------------------------------------------------------
 // Lz4Writer Constructor
 //
@@ -89,7 +103,7 @@ static size_t LZ4F_getBlockSize(unsigned blockSizeID)
 //	stream		- The stream the compressed data is written to
 
 Lz4Writer::Lz4Writer(Stream^ stream) : 
-	Lz4Writer(stream, Lz4CompressionLevel::Default, false, Lz4BlockSize::Default, Lz4BlockMode::Default, Lz4ContentChecksum::Default, false)
+	Lz4Writer(stream, Lz4CompressionLevel::Default, false, Lz4BlockSize::Default, Lz4BlockMode::Default, Lz4ContentChecksum::Default, nullptr, 0, 1, 0, false)
 {
 }
 
@@ -102,7 +116,7 @@ Lz4Writer::Lz4Writer(Stream^ stream) :
 //	level		- Indicates whether to emphasize speed or compression efficiency
 
 Lz4Writer::Lz4Writer(Stream^ stream, Compression::CompressionLevel level) : 
-	Lz4Writer(stream, Lz4CompressionLevel(level), false, Lz4BlockSize::Default, Lz4BlockMode::Default, Lz4ContentChecksum::Default, false)
+	Lz4Writer(stream, Lz4CompressionLevel(level), false, Lz4BlockSize::Default, Lz4BlockMode::Default, Lz4ContentChecksum::Default, nullptr, 0, 1, 0, false)
 {
 }
 
@@ -115,7 +129,7 @@ Lz4Writer::Lz4Writer(Stream^ stream, Compression::CompressionLevel level) :
 //	leaveopen	- Flag to leave the base stream open after disposal
 
 Lz4Writer::Lz4Writer(Stream^ stream, bool leaveopen) : 
-	Lz4Writer(stream, Lz4CompressionLevel::Default, false, Lz4BlockSize::Default, Lz4BlockMode::Default, Lz4ContentChecksum::Default, leaveopen)
+	Lz4Writer(stream, Lz4CompressionLevel::Default, false, Lz4BlockSize::Default, Lz4BlockMode::Default, Lz4ContentChecksum::Default, nullptr, 0, 1, 0, leaveopen)
 {
 }
 
@@ -129,10 +143,57 @@ Lz4Writer::Lz4Writer(Stream^ stream, bool leaveopen) :
 //	leaveopen	- Flag to leave the base stream open after disposal
 
 Lz4Writer::Lz4Writer(Stream^ stream, Compression::CompressionLevel level, bool leaveopen) :
-	Lz4Writer(stream, Lz4CompressionLevel(level), false, Lz4BlockSize::Default, Lz4BlockMode::Default, Lz4ContentChecksum::Default, leaveopen)
+	Lz4Writer(stream, Lz4CompressionLevel(level), false, Lz4BlockSize::Default, Lz4BlockMode::Default, Lz4ContentChecksum::Default, nullptr, 0, 1, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// Lz4Writer Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	level		- Indicates the level of compression to use
+//	threads		- Number of threads to use for compression (zero = processor count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+Lz4Writer::Lz4Writer(Stream^ stream, Compression::CompressionLevel level, int threads, bool leaveopen) :
+	Lz4Writer(stream, Lz4CompressionLevel(level), false, Lz4BlockSize::Default, Lz4BlockMode::Independent, Lz4ContentChecksum::Default, nullptr, 0, threads, 0, leaveopen)
 {
 }
 
+//---------------------------------------------------------------------------
+// Lz4Writer Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	level		- Indicates the level of compression to use
+//	framesize	- Size of independent frames for seekable output (zero = single frame)
+//	threads		- Number of threads to use for compression (zero = processor count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+Lz4Writer::Lz4Writer(Stream^ stream, Compression::CompressionLevel level, int framesize, int threads, bool leaveopen) :
+	Lz4Writer(stream, Lz4CompressionLevel(level), false, Lz4BlockSize::Default, Lz4BlockMode::Independent, Lz4ContentChecksum::Default, nullptr, framesize, threads, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// Lz4Writer Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	dictionary	- Dictionary to compress the data with
+//	level		- Indicates the level of compression to use
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+Lz4Writer::Lz4Writer(Stream^ stream, Lz4Dictionary^ dictionary, Compression::CompressionLevel level, bool leaveopen) :
+	Lz4Writer(stream, Lz4CompressionLevel(level), false, Lz4BlockSize::Default, Lz4BlockMode::Default, Lz4ContentChecksum::Default, dictionary, 0, 1, 0, leaveopen)
+{
+	if(Object::ReferenceEquals(dictionary, nullptr)) throw gcnew ArgumentNullException("dictionary");
+}
+
 //---------------------------------------------------------------------------
 // Lz4Writer Constructor (internal)
 //
@@ -144,14 +205,22 @@ Lz4Writer::Lz4Writer(Stream^ stream, Compression::CompressionLevel level, bool l
 //	blocksize		- Maximum block size to use during encoding
 //	blockmode		- Block mode (linked/unlinked) to use during encoding
 //	checksum		- Content checksum flag to use during encoding
+//	dictionary		- Optional dictionary to compress the data with
+//	framesize		- Size of independent frames for seekable output (zero = single frame)
+//	threads			- Number of threads to use for compression (zero = processor count)
+//	maxpending		- Maximum number of blocks in flight (zero = twice the thread count)
 //	leaveopen		- Flag to leave the base stream open after disposal
 
-Lz4Writer::Lz4Writer(Stream^ stream, Lz4CompressionLevel level, bool autoflush, Lz4BlockSize blocksize, Lz4BlockMode blockmode, Lz4ContentChecksum checksum, bool leaveopen) : 
-	m_disposed(false), m_stream(stream), m_leaveopen(leaveopen)
+Lz4Writer::Lz4Writer(Stream^ stream, Lz4CompressionLevel level, bool autoflush, Lz4BlockSize blocksize, Lz4BlockMode blockmode, Lz4ContentChecksum checksum, 
+	Lz4Dictionary^ dictionary, int framesize, int threads, int maxpending, bool leaveopen) : m_disposed(false), m_stream(stream), m_leaveopen(leaveopen), 
+	m_level(level), m_dictionary(dictionary), m_blockpos(0), m_framesize(framesize), m_frameoffset(0), m_frameposition(0)
 {
 	LZ4F_errorCode_t				result;				// Result from LZ4 function call
 
 	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+	if(framesize < 0) throw gcnew ArgumentOutOfRangeException("framesize");
+	if(threads < 0) throw gcnew ArgumentOutOfRangeException("threads");
+	if(maxpending < 0) throw gcnew ArgumentOutOfRangeException("maxpending");
 
 	// Allocate and initialize the compression context structure
 	try { m_context = new LZ4F_compressionContext_t; memset(m_context, 0, sizeof(LZ4F_compressionContext_t)); }
@@ -173,17 +242,51 @@ Lz4Writer::Lz4Writer(Stream^ stream, Lz4CompressionLevel level, bool autoflush,
 	m_prefs->frameInfo.contentChecksumFlag = static_cast<LZ4F_contentChecksum_t>(checksum);
 	m_prefs->frameInfo.frameType = LZ4F_frameType_t::LZ4F_frame;
 
-	// Create a temporary buffer to hold the stream header information (max 15 bytes)
-	array<unsigned __int8>^ header = gcnew array<unsigned __int8>(15);
+	// The dictionary identifier in the frame header lets the decompressor verify it has the right dictionary
+	if(dictionary) m_prefs->frameInfo.dictID = dictionary->Id;
+
+	if(threads == 0) threads = Environment::ProcessorCount;
+
+	// Seekable output is a series of complete frames that are each compressed on their own; the
+	// frames can be compressed in parallel regardless of the block mode since they are independent
+	if(framesize > 0) {
+
+		m_block = gcnew array<unsigned __int8>(framesize);
+		m_frames = gcnew List<Lz4Index::Entry^>();
+
+		if(threads > 1) m_pending = gcnew TaskQueue<array<unsigned __int8>^>(threads, (maxpending == 0) ? threads * 2 : maxpending);
+		return;
+	}
+
+	// Create a temporary buffer to hold the stream header information
+	array<unsigned __int8>^ header = gcnew array<unsigned __int8>(LZ4F_HEADER_SIZE_MAX);
 	pin_ptr<unsigned __int8> pinheader = &header[0];
 
-	// Initialize the compressed stream
-	result = LZ4F_compressBegin(*m_context, pinheader, header->Length, m_prefs);
+	// Initialize the compressed stream, a dictionary is applied to the context from its digested state
+	result = (dictionary) ? LZ4F_compressBegin_usingCDict(*m_context, pinheader, header->Length, dictionary->CDict, m_prefs) :
+		LZ4F_compressBegin(*m_context, pinheader, header->Length, m_prefs);
 	if(LZ4F_isError(result)) throw gcnew Lz4Exception(result);
 
 	// Result cannot be larger than Int32::MaxValue
 	if(result > Int32::MaxValue) throw gcnew OverflowException();
 	m_stream->Write(header, 0, static_cast<int>(result));
+
+	// Independent blocks can be compressed in parallel; each block is compressed directly with the
+	// LZ4 block API by a worker thread and the frame is assembled here in the original block order
+	if((threads > 1) && (blockmode == Lz4BlockMode::Independent)) {
+
+		m_pending = gcnew TaskQueue<array<unsigned __int8>^>(threads, (maxpending == 0) ? threads * 2 : maxpending);
+		m_compressor = (m_level < 3) ? LZ4F_localLZ4_compress : LZ4_compress_HC;
+		m_block = gcnew array<unsigned __int8>(static_cast<int>(LZ4F_getBlockSize(m_prefs->frameInfo.blockSizeID)));
+
+		// The content checksum has to be calculated serially against the uncompressed data
+		if(checksum == Lz4ContentChecksum::Enabled) {
+
+			m_xxhash = XXH32_createState();
+			if(m_xxhash == nullptr) throw gcnew OutOfMemoryException();
+			XXH32_reset(m_xxhash, 0);
+		}
+	}
 }
 
 //---------------------------------------------------------------------------
@@ -193,6 +296,50 @@ Lz4Writer::~Lz4Writer()
 {
 	if(m_disposed) return;
 
+	if(m_framesize > 0) {
+
+		// Compress any partial frame and write all outstanding frames to the output stream
+		QueueFrame();
+		if(m_pending) WritePendingFrames(true);
+
+		// An empty stream still consists of a single (empty) frame
+		if(m_frameoffset == 0) WriteFrame(CompressFrame(gcnew array<unsigned __int8>(0)));
+
+		// Append the seek table in a skippable frame, which is ignored by LZ4 decoders
+		(gcnew Lz4Index(m_frames))->Save(m_stream);
+
+		if(m_pending) delete m_pending;
+		delete m_block;
+
+		// Optionally dispose of the input stream instance
+		if(!m_leaveopen) delete m_stream;
+
+		this->!Lz4Writer();
+		m_disposed = true;
+		return;
+	}
+
+	if(m_pending) {
+
+		// Compress any partial block and write all outstanding blocks to the output stream
+		QueueBlock();
+		WritePendingBlocks(true);
+
+		// Complete the frame with the end mark and the optional content checksum
+		WriteLE32(m_stream, 0);
+		if(m_xxhash) WriteLE32(m_stream, XXH32_digest(m_xxhash));
+
+		delete m_pending;
+		delete m_block;
+
+		// Optionally dispose of the input stream instance
+		if(!m_leaveopen) delete m_stream;
+
+		this->!Lz4Writer();
+		m_disposed = true;
+		return;
+	}
+
 	// There is no way to know how much data there is in the lz4 buffers, use a full block
 	size_t bound = LZ4F_compressBound(LZ4F_getBlockSize(m_prefs->frameInfo.blockSizeID), m_prefs);
 	if(bound > Int32::MaxValue) throw gcnew OverflowException();
@@ -225,6 +372,9 @@ Lz4Writer::!Lz4Writer()
 
 	if(m_prefs) { delete m_prefs; m_prefs = nullptr; }
 	if(m_context) { delete m_context; m_context = nullptr; }
+
+	// Release the content checksum state used for parallel compression
+	if(m_xxhash) { XXH32_freeState(m_xxhash); m_xxhash = nullptr; }
 }
 
 //---------------------------------------------------------------------------
@@ -271,6 +421,134 @@ bool Lz4Writer::CanWrite::get(void)
 	return m_stream->CanWrite;
 }
 
+//---------------------------------------------------------------------------
+// Lz4Writer::CompressBlock (private)
+//
+// Compresses a single independent block of data into an LZ4 frame block
+//
+// Arguments:
+//
+//	state		- Uncompressed block data as a managed byte array
+
+array<unsigned __int8>^ Lz4Writer::CompressBlock(Object^ state)
+{
+	array<unsigned __int8>^ in = safe_cast<array<unsigned __int8>^>(state);
+
+	// The output block has a 4 byte length prefix and will never be larger than the input block
+	array<unsigned __int8>^ out = gcnew array<unsigned __int8>(in->Length + 4);
+
+	// Pin both the input and output buffers in memory
+	pin_ptr<unsigned __int8> pinin = &in[0];
+	pin_ptr<unsigned __int8> pinout = &out[0];
+
+	// Limit the output to one byte less than the input, if the data is incompressible it will fail; every
+	// independent block in a frame with a dictionary refers back to the dictionary rather than the previous block
+	unsigned int length = (m_dictionary) ? 
+		m_dictionary->Compress(reinterpret_cast<char const*>(pinin), reinterpret_cast<char*>(&pinout[4]), in->Length, in->Length - 1, m_level) :
+		m_compressor(reinterpret_cast<char const*>(pinin), reinterpret_cast<char*>(&pinout[4]), in->Length, in->Length - 1, m_level);
+	unsigned int header = length;
+
+	// Incompressible blocks are stored as-is with the high bit set in the length prefix
+	if(length == 0) {
+
+		memcpy(&pinout[4], pinin, in->Length);
+		header = (length = in->Length) | 0x80000000;
+	}
+
+	// Write the length prefix into the first 4 bytes of the output buffer
+	out[0] = static_cast<unsigned __int8>(header & 0xFF);
+	out[1] = static_cast<unsigned __int8>((header >> 8) & 0xFF);
+	out[2] = static_cast<unsigned __int8>((header >> 16) & 0xFF);
+	out[3] = static_cast<unsigned __int8>((header >> 24) & 0xFF);
+
+	return out;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Writer::CompressFrame (private)
+//
+// Compresses a single independent frame of data
+//
+// Arguments:
+//
+//	state		- Uncompressed frame data as a managed byte array
+
+array<unsigned __int8>^ Lz4Writer::CompressFrame(Object^ state)
+{
+	array<unsigned __int8>^ in = safe_cast<array<unsigned __int8>^>(state);
+	int length = in->Length;
+
+	// An empty frame has no source data, but the buffer still needs to be pinned
+	if(length == 0) in = gcnew array<unsigned __int8>(1);
+
+	// A frame compressed with a dictionary is built incrementally, which needs room for the header and end mark
+	size_t bound = (m_dictionary) ? LZ4F_HEADER_SIZE_MAX + LZ4F_compressBound(length, m_prefs) + LZ4F_compressBound(0, m_prefs) :
+		LZ4F_compressFrameBound(length, m_prefs);
+	if(bound > static_cast<size_t>(Int32::MaxValue - 4)) throw gcnew OverflowException();
+
+	// The output frame has a 4 byte prefix that holds the length of the uncompressed data
+	array<unsigned __int8>^ out = gcnew array<unsigned __int8>(static_cast<int>(bound) + 4);
+
+	// Pin both the input and output buffers in memory
+	pin_ptr<unsigned __int8> pinin = &in[0];
+	pin_ptr<unsigned __int8> pinout = &out[0];
+
+	// Compress the data into a complete frame using the preferences of this instance
+	size_t result = (m_dictionary) ? CompressFrameUsingDictionary(&pinout[4], bound, pinin, length) : LZ4F_compressFrame(&pinout[4], bound, pinin, length, m_prefs);
+	if(LZ4F_isError(result)) throw gcnew Lz4Exception(result);
+
+	out[0] = static_cast<unsigned __int8>(length & 0xFF);
+	out[1] = static_cast<unsigned __int8>((length >> 8) & 0xFF);
+	out[2] = static_cast<unsigned __int8>((length >> 16) & 0xFF);
+	out[3] = static_cast<unsigned __int8>((length >> 24) & 0xFF);
+
+	Array::Resize<unsigned __int8>(out, static_cast<int>(result) + 4);
+	return out;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Writer::CompressFrameUsingDictionary (private)
+//
+// Compresses a single independent frame of data using the dictionary
+//
+// Arguments:
+//
+//	destination	- Buffer to receive the compressed frame
+//	destlen		- Length of the destination buffer
+//	source		- Uncompressed frame data
+//	sourcelen	- Length of the uncompressed frame data
+
+size_t Lz4Writer::CompressFrameUsingDictionary(void* destination, size_t destlen, void const* source, size_t sourcelen)
+{
+	LZ4F_compressionContext_t	context;			// Frame compression context
+	size_t						length = 0;			// Length of the compressed frame
+
+	// Frames may be compressed in parallel, so each one needs a context of its own
+	size_t result = LZ4F_createCompressionContext(&context, LZ4F_VERSION);
+	if(LZ4F_isError(result)) return result;
+
+	try {
+
+		unsigned __int8* out = reinterpret_cast<unsigned __int8*>(destination);
+
+		result = LZ4F_compressBegin_usingCDict(context, out, destlen, m_dictionary->CDict, m_prefs);
+		if(LZ4F_isError(result)) return result;
+		length += result;
+
+		result = LZ4F_compressUpdate(context, &out[length], destlen - length, source, sourcelen, nullptr);
+		if(LZ4F_isError(result)) return result;
+		length += result;
+
+		result = LZ4F_compressEnd(context, &out[length], destlen - length, nullptr);
+		if(LZ4F_isError(result)) return result;
+		length += result;
+	}
+
+	finally { LZ4F_freeCompressionContext(context); }
+
+	return length;
+}
+
 //---------------------------------------------------------------------------
 // Lz4Writer::Flush
 //
@@ -286,6 +564,24 @@ void Lz4Writer::Flush(void)
 
 	msclr::lock lock(m_lock);
 
+	// Seekable output ends the current frame early and waits for all outstanding frames to be written
+	if(m_framesize > 0) {
+
+		QueueFrame();
+		if(m_pending) WritePendingFrames(true);
+		m_stream->Flush();
+		return;
+	}
+
+	// Compress any partial block and wait for all outstanding blocks to be written
+	if(m_pending) {
+
+		QueueBlock();
+		WritePendingBlocks(true);
+		m_stream->Flush();
+		return;
+	}
+
 	// There is no way to know how much data there is in the lz4 buffers, use a full block
 	size_t bound = LZ4F_compressBound(LZ4F_getBlockSize(m_prefs->frameInfo.blockSizeID), m_prefs);
 	if(bound > Int32::MaxValue) throw gcnew OverflowException();
@@ -340,6 +636,73 @@ void Lz4Writer::Position::set(__int64 value)
 	throw gcnew NotSupportedException();
 }
 
+//---------------------------------------------------------------------------
+// Lz4Writer::QueueBlock (private)
+//
+// Queues the current input block for compression
+//
+// Arguments:
+//
+//	NONE
+
+void Lz4Writer::QueueBlock(void)
+{
+	// If there is nothing in the block buffer, there is no work to do
+	if(m_blockpos == 0) return;
+
+	// A partial block is trimmed to the actual length of the data
+	array<unsigned __int8>^ block = m_block;
+	if(m_blockpos < block->Length) Array::Resize<unsigned __int8>(block, m_blockpos);
+
+	// Update the content checksum, this must be done in order as the blocks are queued
+	if(m_xxhash) {
+
+		pin_ptr<unsigned __int8> pinblock = &block[0];
+		XXH32_update(m_xxhash, pinblock, block->Length);
+	}
+
+	// Make room in the queue for the block and start compressing it
+	WritePendingBlocks(false);
+	m_pending->Enqueue(gcnew Func<Object^, array<unsigned __int8>^>(this, &Lz4Writer::CompressBlock), block);
+
+	// The queued buffer now belongs to the worker, a new one is needed for the next block
+	if(Object::ReferenceEquals(block, m_block)) m_block = gcnew array<unsigned __int8>(m_block->Length);
+	m_blockpos = 0;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Writer::QueueFrame (private)
+//
+// Queues or compresses the current input frame
+//
+// Arguments:
+//
+//	NONE
+
+void Lz4Writer::QueueFrame(void)
+{
+	// If there is nothing in the frame buffer, there is no work to do
+	if(m_blockpos == 0) return;
+
+	// A partial frame is trimmed to the actual length of the data
+	array<unsigned __int8>^ frame = m_block;
+	if(m_blockpos < frame->Length) Array::Resize<unsigned __int8>(frame, m_blockpos);
+
+	if(m_pending) {
+
+		// Make room in the queue for the frame and start compressing it
+		WritePendingFrames(false);
+		m_pending->Enqueue(gcnew Func<Object^, array<unsigned __int8>^>(this, &Lz4Writer::CompressFrame), frame);
+
+		// The queued buffer now belongs to the worker, a new one is needed for the next frame
+		if(Object::ReferenceEquals(frame, m_block)) m_block = gcnew array<unsigned __int8>(m_block->Length);
+	}
+
+	else WriteFrame(CompressFrame(frame));
+
+	m_blockpos = 0;
+}
+
 //---------------------------------------------------------------------------
 // Lz4Writer::Read
 //
@@ -438,6 +801,30 @@ void Lz4Writer::Write(array<unsigned __int8>^ buffer, int offset, int count)
 
 	msclr::lock lock(m_lock);
 
+	// Parallel compression and seekable output accumulate the input into blocks or frames
+	if((m_pending) || (m_framesize > 0)) {
+
+		while(count > 0) {
+
+			// Copy the next chunk of input data into the block buffer
+			int next = Math::Min(m_block->Length - m_blockpos, count);
+			Array::Copy(buffer, offset, m_block, m_blockpos, next);
+
+			m_blockpos += next;				// Increment length of block
+			offset += next;					// Increment offset into input
+			count -= next;					// Decrement bytes remaining
+
+			// If the block buffer has been filled, queue it for compression
+			if(m_blockpos == m_block->Length) {
+
+				if(m_framesize > 0) QueueFrame();
+				else QueueBlock();
+			}
+		}
+
+		return;
+	}
+
 	// Create a temporary local buffer to hold the compressed data
 	size_t bound = LZ4F_compressBound(count, m_prefs);
 	if(bound > Int32::MaxValue) throw gcnew OverflowException();
@@ -461,6 +848,87 @@ void Lz4Writer::Write(array<unsigned __int8>^ buffer, int offset, int count)
 	delete out;						// Destroy the local buffer
 }
 
+//---------------------------------------------------------------------------
+// Lz4Writer::WriteFrame (private)
+//
+// Writes a compressed frame to the base stream and records it in the seek table
+//
+// Arguments:
+//
+//	frame		- Compressed frame with the uncompressed length prefix
+
+void Lz4Writer::WriteFrame(array<unsigned __int8>^ frame)
+{
+	int length = (frame[0] << 0) | (frame[1] << 8) | (frame[2] << 16) | (frame[3] << 24);
+	int compressedlength = frame->Length - 4;
+
+	m_stream->Write(frame, 4, compressedlength);
+
+	// Empty frames contain no data to be located and are not recorded in the seek table
+	if(length > 0) m_frames->Add(gcnew Lz4Index::Entry(m_frameoffset, compressedlength, m_frameposition, length, Lz4Index::ENTRY_FRAME));
+
+	m_frameoffset += compressedlength;
+	m_frameposition += length;
+}
+
+//---------------------------------------------------------------------------
+// Lz4Writer::WriteLE32 (static, private)
+//
+// Writes an unsigned 32 bit value into an output stream
+//
+// Arguments:
+//
+//	stream		- Stream instance to write the value into
+//	value		- Value to be written into the stream
+
+void Lz4Writer::WriteLE32(Stream^ stream, unsigned int value)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException();
+
+	// Convert the 32 bit unsigned value into an array of 4 little endian bytes
+	array<unsigned __int8>^ buffer = gcnew array<unsigned __int8>{(unsigned __int8)((value & 0xFF) >> 0), 
+		(unsigned __int8)((value & 0xFF00) >> 8), (unsigned __int8)((value & 0xFF0000) >> 16), (unsigned __int8)((value & 0xFF000000) >> 24)};
+
+	stream->Write(buffer, 0, 4);
+}
+
+//---------------------------------------------------------------------------
+// Lz4Writer::WritePendingBlocks (private)
+//
+// Writes completed blocks from the compression queue to the base stream
+//
+// Arguments:
+//
+//	all			- Flag to write all pending blocks rather than just make room
+
+void Lz4Writer::WritePendingBlocks(bool all)
+{
+	while((all) ? !m_pending->IsEmpty : m_pending->IsFull) {
+
+		// Wait for the oldest block to finish and write it to the output stream; the
+		// length of the compressed data is stored in the block's length prefix
+		array<unsigned __int8>^ block = m_pending->Dequeue();
+		int length = (block[0] << 0) | (block[1] << 8) | (block[2] << 16) | ((block[3] & 0x7F) << 24);
+
+		m_stream->Write(block, 0, length + 4);
+	}
+}
+
+//---------------------------------------------------------------------------
+// Lz4Writer::WritePendingFrames (private)
+//
+// Writes completed frames from the compression queue to the base stream
+//
+// Arguments:
+//
+//	all			- Flag to write all pending frames rather than just make room
+
+void Lz4Writer::WritePendingFrames(bool all)
+{
+	// Wait for the oldest frame to finish and write it to the output stream
+	while((all) ? !m_pending->IsEmpty : m_pending->IsFull) WriteFrame(m_pending->Dequeue());
+}
+
 //---------------------------------------------------------------------------
 
 } // zuki::io::compression
@@ -52,14 +52,19 @@
 #pragma once
 
 #include <lz4frame.h>
+#include <xxhash.h>
 #include "Lz4BlockMode.h"
 #include "Lz4BlockSize.h"
 #include "Lz4CompressionLevel.h"
 #include "Lz4ContentChecksum.h"
+#include "Lz4Dictionary.h"
+#include "Lz4Index.h"
+#include "TaskQueue.h"
 
 #pragma warning(push, 4)				// Enable maximum compiler warnings
 
 using namespace System;
+using namespace System::Collections::Generic;
 using namespace System::IO;
 
 namespace zuki::io::compression {
@@ -80,6 +85,9 @@ public:
 	Lz4Writer(Stream^ stream, Compression::CompressionLevel level);
 	Lz4Writer(Stream^ stream, bool leaveopen);
 	Lz4Writer(Stream^ stream, Compression::CompressionLevel level, bool leaveopen);
+	Lz4Writer(Stream^ stream, Compression::CompressionLevel level, int threads, bool leaveopen);
+	Lz4Writer(Stream^ stream, Compression::CompressionLevel level, int framesize, int threads, bool leaveopen);
+	Lz4Writer(Stream^ stream, Lz4Dictionary^ dictionary, Compression::CompressionLevel level, bool leaveopen);
 
 	//-----------------------------------------------------------------------
 	// Member Functions
@@ -171,15 +179,68 @@ internal:
 	// Instance Constructor
 	//
 	Lz4Writer(Stream^ stream, Lz4CompressionLevel level, bool autoflush, Lz4BlockSize blocksize, Lz4BlockMode blockmode, 
-		Lz4ContentChecksum checksum, bool leaveopen);
+		Lz4ContentChecksum checksum, Lz4Dictionary^ dictionary, int framesize, int threads, int maxpending, bool leaveopen);
 
 private:
 
+	// CompressFunc
+	//
+	// Function pointer to an LZ4 block compressor implementation
+	using CompressFunc = int (*)(char const* src, char* dst, int srcSize, int dstSize, int cLevel);
+
 	// Destructor / Finalizer
 	//
 	~Lz4Writer();
 	!Lz4Writer();
 
+	//-----------------------------------------------------------------------
+	// Private Member Functions
+
+	// CompressBlock
+	//
+	// Compresses a single independent block of data into an LZ4 frame block
+	array<unsigned __int8>^ CompressBlock(Object^ state);
+
+	// CompressFrame
+	//
+	// Compresses a single independent frame of data
+	array<unsigned __int8>^ CompressFrame(Object^ state);
+
+	// CompressFrameUsingDictionary
+	//
+	// Compresses a single independent frame of data using the dictionary
+	size_t CompressFrameUsingDictionary(void* destination, size_t destlen, void const* source, size_t sourcelen);
+
+	// QueueBlock
+	//
+	// Queues the current input block for compression
+	void QueueBlock(void);
+
+	// QueueFrame
+	//
+	// Queues or compresses the current input frame
+	void QueueFrame(void);
+
+	// WriteLE32 (static)
+	//
+	// Writes a little endian 32-bit number into a stream
+	static void WriteLE32(Stream^ stream, unsigned int value);
+
+	// WritePendingBlocks
+	//
+	// Writes completed blocks from the compression queue to the base stream
+	void WritePendingBlocks(bool all);
+
+	// WriteFrame
+	//
+	// Writes a compressed frame to the base stream and records it in the seek table
+	void WriteFrame(array<unsigned __int8>^ frame);
+
+	// WritePendingFrames
+	//
+	// Writes completed frames from the compression queue to the base stream
+	void WritePendingFrames(bool all);
+
 	//-----------------------------------------------------------------------
 	// Member Variables
 
@@ -188,6 +249,17 @@ private:
 	bool							m_leaveopen;		// Flag to leave base stream open
 	LZ4F_compressionContext_t*		m_context;			// LZ4 compression context
 	LZ4F_preferences_t*				m_prefs;			// LZ4 compression preferences
+	TaskQueue<array<unsigned __int8>^>^	m_pending;		// Pending block compressions
+	CompressFunc					m_compressor;		// Pointer to the compression func
+	int								m_level;			// Compression level
+	Lz4Dictionary^					m_dictionary;		// Optional compression dictionary
+	XXH32_state_t*					m_xxhash;			// Content checksum state
+	array<unsigned __int8>^			m_block;			// Current input block
+	int								m_blockpos;			// Position within the block
+	int								m_framesize;		// Seekable frame size
+	List<Lz4Index::Entry^>^			m_frames;			// Seek table entries
+	__int64							m_frameoffset;		// Compressed offset of next frame
+	__int64							m_frameposition;	// Decompressed offset of next frame
 
 	Object^	m_lock = gcnew Object();		// Synchronization object
 };
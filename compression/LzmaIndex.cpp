@@ -0,0 +1,460 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "LzmaIndex.h"
+
+#include <Alloc.h>
+#include <lz4.h>
+#include "LzmaException.h"
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+using namespace System::Text;
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// LzmaIndex Constructor (private)
+//
+// Arguments:
+//
+//	spacing				- Minimum distance between checkpoints
+//	length				- Decompressed length of the LZMA stream
+//	checkpoints			- List of index checkpoints
+
+LzmaIndex::LzmaIndex(__int64 spacing, __int64 length, List<Checkpoint^>^ checkpoints) : 
+	m_spacing(spacing), m_length(length), m_checkpoints(checkpoints)
+{
+}
+
+//---------------------------------------------------------------------------
+// LzmaIndex::Build (static)
+//
+// Builds an index by decompressing an LZMA stream
+//
+// Arguments:
+//
+//	stream		- Stream containing the LZMA data to be indexed
+
+LzmaIndex^ LzmaIndex::Build(Stream^ stream)
+{
+	return Build(stream, DEFAULT_SPACING);
+}
+
+//---------------------------------------------------------------------------
+// LzmaIndex::Build (static)
+//
+// Builds an index by decompressing an LZMA stream
+//
+// Arguments:
+//
+//	stream		- Stream containing the LZMA data to be indexed
+//	spacing		- Minimum distance between checkpoints, in decompressed bytes
+
+LzmaIndex^ LzmaIndex::Build(Stream^ stream, __int64 spacing)
+{
+	CLzmaDec					state;				// LZMA decoder state
+	ELzmaStatus					status;				// Status from LZMA decode operation
+
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+	if(spacing < BUFFER_SIZE) throw gcnew ArgumentOutOfRangeException("spacing");
+
+	List<Checkpoint^>^ checkpoints = gcnew List<Checkpoint^>();
+	array<unsigned __int8>^ in = gcnew array<unsigned __int8>(BUFFER_SIZE);
+	array<unsigned __int8>^ out = gcnew array<unsigned __int8>(BUFFER_SIZE);
+
+	// Read the properties and expected stream length from the input stream
+	array<unsigned __int8>^ props = gcnew array<unsigned __int8>(LZMA_PROPS_SIZE + sizeof(uint64_t));
+	if(stream->Read(props, 0, props->Length) != props->Length) throw gcnew InvalidDataException();
+	unsigned __int64 expected = BitConverter::ToUInt64(props, LZMA_PROPS_SIZE);
+
+	__int64 totalin = props->Length;		// Total compressed bytes consumed
+	__int64 totalout = 0;					// Total decompressed bytes generated
+	__int64 last = 0;						// Decompressed offset of last checkpoint
+	size_t inpos = 0;						// Position within the input buffer
+	size_t insize = 0;						// Length of the input buffer data
+
+	LzmaDec_Construct(&state);
+
+	pin_ptr<unsigned __int8> pinprops = &props[0];
+	SRes result = LzmaDec_Allocate(&state, pinprops, LZMA_PROPS_SIZE, &g_Alloc);
+	if(result == SZ_ERROR_MEM) throw gcnew OutOfMemoryException();
+	else if(result == SZ_ERROR_UNSUPPORTED) throw gcnew InvalidDataException();
+
+	try {
+
+		LzmaDec_Init(&state);
+
+		pin_ptr<unsigned __int8> pinin = &in[0];
+		pin_ptr<unsigned __int8> pinout = &out[0];
+
+		while(true) {
+
+			// If the input buffer was consumed by a previous iteration, refill it
+			if(inpos == insize) { insize = stream->Read(in, 0, BUFFER_SIZE); inpos = 0; }
+
+			size_t inlength = insize - inpos;
+			size_t outlength = BUFFER_SIZE;
+
+			// If this will definitively be the final decode operation set LZMA_FINISH_END
+			ELzmaFinishMode finishmode = ((static_cast<unsigned __int64>(totalout) + outlength) >= expected) ? LZMA_FINISH_END : LZMA_FINISH_ANY;
+
+			result = LzmaDec_DecodeToBuf(&state, pinout, &outlength, &pinin[inpos], &inlength, finishmode, &status);
+			if(result != SZ_OK) throw gcnew LzmaException(SZ_ERROR_DATA);
+
+			inpos += inlength;
+			totalin += inlength;
+			totalout += outlength;
+
+			// The stream is finished at an end mark, or when nothing more can be decoded
+			if(status == LZMA_STATUS_FINISHED_WITH_MARK) break;
+			if((inlength == 0) && (outlength == 0)) {
+
+				if(expected > static_cast<unsigned __int64>(totalout)) throw gcnew LzmaException(SZ_ERROR_DATA);
+				break;
+			}
+
+			// Snapshot the decoder between decode operations, when all of its output has been copied out
+			if(totalout - last >= spacing) {
+
+				checkpoints->Add(Capture(&state, totalout, totalin));
+				last = totalout;
+			}
+		}
+	}
+
+	finally { LzmaDec_Free(&state, &g_Alloc); }
+
+	return gcnew LzmaIndex(spacing, totalout, checkpoints);
+}
+
+//---------------------------------------------------------------------------
+// LzmaIndex::Capture (internal, static)
+//
+// Creates a checkpoint from the current state of an LZMA decoder
+//
+// Arguments:
+//
+//	state		- LZMA decoder state to be captured
+//	output		- Decompressed data offset of the decoder
+//	input		- Compressed data offset of the decoder
+
+LzmaIndex::Checkpoint^ LzmaIndex::Capture(CLzmaDec* state, __int64 output, __int64 input)
+{
+	if(state == nullptr) throw gcnew ArgumentNullException("state");
+
+	// The scalar decoder variables are serialized individually so that the format doesn't
+	// depend on the layout of the CLzmaDec structure; partially consumed input is included
+	MemoryStream^ variables = gcnew MemoryStream();
+	msclr::auto_handle<BinaryWriter> writer(gcnew BinaryWriter(variables));
+
+	writer->Write(static_cast<unsigned __int64>(state->dicBufSize));
+	writer->Write(static_cast<unsigned int>(state->numProbs));
+	writer->Write(static_cast<unsigned int>(state->range));
+	writer->Write(static_cast<unsigned int>(state->code));
+	writer->Write(static_cast<unsigned __int64>(state->dicPos));
+	writer->Write(static_cast<unsigned int>(state->processedPos));
+	writer->Write(static_cast<unsigned int>(state->checkDicSize));
+	writer->Write(static_cast<unsigned int>(state->state));
+	for(int index = 0; index < 4; index++) writer->Write(static_cast<unsigned int>(state->reps[index]));
+	writer->Write(static_cast<unsigned int>(state->remainLen));
+	writer->Write(static_cast<int>(state->needFlush));
+	writer->Write(static_cast<int>(state->needInitState));
+	writer->Write(static_cast<unsigned int>(state->tempBufSize));
+	for(int index = 0; index < LZMA_REQUIRED_INPUT_MAX; index++) writer->Write(static_cast<unsigned __int8>(state->tempBuf[index]));
+	writer->Flush();
+
+	// The dictionary is only partially filled until the decoder has wrapped around it once
+	int probslength = static_cast<int>(state->numProbs * sizeof(CLzmaProb));
+	int diclength = static_cast<int>((static_cast<unsigned __int64>(output) >= state->dicBufSize) ? state->dicBufSize : state->dicPos);
+
+	array<unsigned __int8>^ raw = gcnew array<unsigned __int8>(probslength + diclength);
+	pin_ptr<unsigned __int8> pinraw = &raw[0];
+	memcpy(pinraw, state->probs, probslength);
+	if(diclength > 0) memcpy(&pinraw[probslength], state->dic, diclength);
+
+	// The probabilities and dictionary are compressed with LZ4, which is fast enough to
+	// make restoring a checkpoint much cheaper than decoding up to the same position
+	array<unsigned __int8>^ snapshot = gcnew array<unsigned __int8>(LZ4_compressBound(raw->Length));
+	pin_ptr<unsigned __int8> pinsnapshot = &snapshot[0];
+
+	int length = LZ4_compress_fast(reinterpret_cast<char const*>(pinraw), reinterpret_cast<char*>(pinsnapshot), raw->Length, snapshot->Length, 1);
+	if(length <= 0) throw gcnew InvalidOperationException();
+
+	pinsnapshot = nullptr;
+	Array::Resize<unsigned __int8>(snapshot, length);
+
+	return gcnew Checkpoint(output, input, variables->ToArray(), snapshot, raw->Length);
+}
+
+//---------------------------------------------------------------------------
+// LzmaIndex::Count::get
+//
+// Gets the number of checkpoints in the index
+
+int LzmaIndex::Count::get(void)
+{
+	return m_checkpoints->Count;
+}
+
+//---------------------------------------------------------------------------
+// LzmaIndex::Find (internal)
+//
+// Locates the last checkpoint at or before a decompressed data offset
+//
+// Arguments:
+//
+//	position	- Decompressed data offset
+
+LzmaIndex::Checkpoint^ LzmaIndex::Find(__int64 position)
+{
+	int low = 0;
+	int high = m_checkpoints->Count - 1;
+
+	// There is no checkpoint at the start of the stream, the decoder is simply initialized
+	if((high < 0) || (m_checkpoints[0]->Output > position)) return nullptr;
+
+	// Binary search for the last checkpoint that doesn't start after the position
+	while(low < high) {
+
+		int middle = low + ((high - low + 1) >> 1);
+		if(m_checkpoints[middle]->Output <= position) low = middle;
+		else high = middle - 1;
+	}
+
+	return m_checkpoints[low];
+}
+
+//---------------------------------------------------------------------------
+// LzmaIndex::Length::get
+//
+// Gets the decompressed length of the indexed LZMA stream
+
+__int64 LzmaIndex::Length::get(void)
+{
+	return m_length;
+}
+
+//---------------------------------------------------------------------------
+// LzmaIndex::Load (static)
+//
+// Loads an index previously written with Save
+//
+// Arguments:
+//
+//	stream		- Stream to read the index from
+
+LzmaIndex^ LzmaIndex::Load(Stream^ stream)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+
+	msclr::auto_handle<BinaryReader> reader(gcnew BinaryReader(stream, Encoding::UTF8, true));
+
+	try {
+
+		// Check the signature and version of the serialized index
+		if(reader->ReadUInt32() != MAGIC) throw gcnew InvalidDataException();
+		if(reader->ReadInt32() != VERSION) throw gcnew InvalidDataException();
+
+		__int64 spacing = reader->ReadInt64();
+		__int64 length = reader->ReadInt64();
+		int count = reader->ReadInt32();
+
+		if((spacing < BUFFER_SIZE) || (length < 0) || (count < 0)) throw gcnew InvalidDataException();
+
+		List<Checkpoint^>^ checkpoints = gcnew List<Checkpoint^>(count);
+		for(int index = 0; index < count; index++) {
+
+			__int64 output = reader->ReadInt64();
+			__int64 input = reader->ReadInt64();
+			int statelength = reader->ReadInt32();
+			int snapshotlength = reader->ReadInt32();
+			int compressedlength = reader->ReadInt32();
+
+			// Checkpoints must be in order and within the bounds of the indexed stream
+			__int64 previous = (index == 0) ? 0 : checkpoints[index - 1]->Output;
+			if((output < previous) || (output > length) || (input < 0)) throw gcnew InvalidDataException();
+			if((statelength < 0) || (snapshotlength < 0) || (compressedlength < 0)) throw gcnew InvalidDataException();
+
+			array<unsigned __int8>^ state = reader->ReadBytes(statelength);
+			array<unsigned __int8>^ snapshot = reader->ReadBytes(compressedlength);
+			if((state->Length != statelength) || (snapshot->Length != compressedlength)) throw gcnew InvalidDataException();
+
+			checkpoints->Add(gcnew Checkpoint(output, input, state, snapshot, snapshotlength));
+		}
+
+		return gcnew LzmaIndex(spacing, length, checkpoints);
+	}
+
+	catch(EndOfStreamException^) { throw gcnew InvalidDataException(); }
+}
+
+//---------------------------------------------------------------------------
+// LzmaIndex::Restore (internal, static)
+//
+// Restores the state of an LZMA decoder from a checkpoint
+//
+// Arguments:
+//
+//	checkpoint	- Checkpoint to be restored
+//	state		- Allocated LZMA decoder state to restore into
+
+void LzmaIndex::Restore(Checkpoint^ checkpoint, CLzmaDec* state)
+{
+	if(Object::ReferenceEquals(checkpoint, nullptr)) throw gcnew ArgumentNullException("checkpoint");
+	if(state == nullptr) throw gcnew ArgumentNullException("state");
+
+	msclr::auto_handle<BinaryReader> reader(gcnew BinaryReader(gcnew MemoryStream(checkpoint->State)));
+
+	try {
+
+		// The decoder must have been allocated with the same properties as the indexed stream
+		if(reader->ReadUInt64() != state->dicBufSize) throw gcnew InvalidDataException();
+		if(reader->ReadUInt32() != state->numProbs) throw gcnew InvalidDataException();
+
+		unsigned int range = reader->ReadUInt32();
+		unsigned int code = reader->ReadUInt32();
+		unsigned __int64 dicpos = reader->ReadUInt64();
+		unsigned int processedpos = reader->ReadUInt32();
+		unsigned int checkdicsize = reader->ReadUInt32();
+		unsigned int decoderstate = reader->ReadUInt32();
+
+		UInt32 reps[4];
+		for(int index = 0; index < 4; index++) reps[index] = reader->ReadUInt32();
+
+		unsigned int remainlen = reader->ReadUInt32();
+		int needflush = reader->ReadInt32();
+		int needinitstate = reader->ReadInt32();
+		unsigned int tempbufsize = reader->ReadUInt32();
+		array<unsigned __int8>^ tempbuf = reader->ReadBytes(LZMA_REQUIRED_INPUT_MAX);
+
+		// Anything the decoder uses to address its buffers has to be checked before it's restored;
+		// match distances can never be larger than the dictionary buffer
+		if((dicpos > state->dicBufSize) || (checkdicsize > state->dicBufSize) || (tempbufsize > LZMA_REQUIRED_INPUT_MAX)) throw gcnew InvalidDataException();
+		for(int index = 0; index < 4; index++) if(reps[index] > state->dicBufSize) throw gcnew InvalidDataException();
+
+		// The decoder state indexes the probabilities and the remaining length is at most one past the
+		// end marker, which flags a pending state initialization; the remaining flags are booleans
+		if((decoderstate >= NUM_STATES) || (remainlen > MATCH_SPEC_LEN_START + 1)) throw gcnew InvalidDataException();
+		if((needflush != 0) && (needflush != 1)) throw gcnew InvalidDataException();
+		if((needinitstate != 0) && (needinitstate != 1)) throw gcnew InvalidDataException();
+		if(tempbuf->Length != LZMA_REQUIRED_INPUT_MAX) throw gcnew InvalidDataException();
+
+		// Decompress the probabilities and dictionary contents
+		int probslength = static_cast<int>(state->numProbs * sizeof(CLzmaProb));
+		int diclength = checkpoint->SnapshotLength - probslength;
+		if((diclength < 0) || (static_cast<unsigned __int64>(diclength) > state->dicBufSize)) throw gcnew InvalidDataException();
+
+		array<unsigned __int8>^ raw = gcnew array<unsigned __int8>(checkpoint->SnapshotLength);
+		pin_ptr<unsigned __int8> pinraw = &raw[0];
+		pin_ptr<unsigned __int8> pinsnapshot = &checkpoint->Snapshot[0];
+
+		int length = LZ4_decompress_safe(reinterpret_cast<char const*>(pinsnapshot), reinterpret_cast<char*>(pinraw), checkpoint->Snapshot->Length, raw->Length);
+		if(length != raw->Length) throw gcnew InvalidDataException();
+
+		memcpy(state->probs, pinraw, probslength);
+		if(diclength > 0) memcpy(state->dic, &pinraw[probslength], diclength);
+
+		state->range = range;
+		state->code = code;
+		state->dicPos = static_cast<SizeT>(dicpos);
+		state->processedPos = processedpos;
+		state->checkDicSize = checkdicsize;
+		state->state = decoderstate;
+		for(int index = 0; index < 4; index++) state->reps[index] = reps[index];
+		state->remainLen = remainlen;
+		state->needFlush = needflush;
+		state->needInitState = needinitstate;
+		state->tempBufSize = tempbufsize;
+		for(int index = 0; index < LZMA_REQUIRED_INPUT_MAX; index++) state->tempBuf[index] = tempbuf[index];
+	}
+
+	catch(EndOfStreamException^) { throw gcnew InvalidDataException(); }
+}
+
+//---------------------------------------------------------------------------
+// LzmaIndex::Save
+//
+// Writes the index to a stream
+//
+// Arguments:
+//
+//	stream		- Stream to write the index into
+
+void LzmaIndex::Save(Stream^ stream)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+
+	msclr::auto_handle<BinaryWriter> writer(gcnew BinaryWriter(stream, Encoding::UTF8, true));
+
+	writer->Write(MAGIC);
+	writer->Write(VERSION);
+	writer->Write(m_spacing);
+	writer->Write(m_length);
+	writer->Write(m_checkpoints->Count);
+
+	for each(Checkpoint^ checkpoint in m_checkpoints) {
+
+		writer->Write(checkpoint->Output);
+		writer->Write(checkpoint->Input);
+		writer->Write(checkpoint->State->Length);
+		writer->Write(checkpoint->SnapshotLength);
+		writer->Write(checkpoint->Snapshot->Length);
+		writer->Write(checkpoint->State);
+		writer->Write(checkpoint->Snapshot);
+	}
+
+	writer->Flush();
+}
+
+//---------------------------------------------------------------------------
+// LzmaIndex::Spacing::get
+//
+// Gets the minimum distance between checkpoints, in decompressed bytes
+
+__int64 LzmaIndex::Spacing::get(void)
+{
+	return m_spacing;
+}
+
+//---------------------------------------------------------------------------
+// LzmaIndex::Checkpoint Constructor
+//
+// Arguments:
+//
+//	output			- Decompressed data offset of the checkpoint
+//	input			- Compressed data offset of the checkpoint
+//	state			- Serialized decoder variables
+//	snapshot		- LZ4 compressed probabilities and dictionary
+//	snapshotlength	- Length of the decompressed snapshot
+
+LzmaIndex::Checkpoint::Checkpoint(__int64 output, __int64 input, array<unsigned __int8>^ state, array<unsigned __int8>^ snapshot, int snapshotlength) : 
+	Output(output), Input(input), State(state), Snapshot(snapshot), SnapshotLength(snapshotlength)
+{
+}
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
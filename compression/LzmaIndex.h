@@ -0,0 +1,188 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#ifndef __LZMAINDEX_H_
+#define __LZMAINDEX_H_
+#pragma once
+
+#include <LzmaDec.h>
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::IO;
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// Class LzmaIndex
+//
+// Random access index of a single-stream LZMA file.  The format has no block
+// structure, so each checkpoint is a snapshot of the entire decoder: the
+// range decoder and probability state along with the dictionary contents,
+// compressed with LZ4.  LzmaReader restores the nearest checkpoint and
+// decodes forward from there rather than from the start of the stream
+//---------------------------------------------------------------------------
+
+public ref class LzmaIndex
+{
+public:
+
+	//-----------------------------------------------------------------------
+	// Member Functions
+
+	// Build (static)
+	//
+	// Builds an index by decompressing an LZMA stream
+	static LzmaIndex^ Build(Stream^ stream);
+	static LzmaIndex^ Build(Stream^ stream, __int64 spacing);
+
+	// Load (static)
+	//
+	// Loads an index previously written with Save
+	static LzmaIndex^ Load(Stream^ stream);
+
+	// Save
+	//
+	// Writes the index to a stream
+	void Save(Stream^ stream);
+
+	//-----------------------------------------------------------------------
+	// Properties
+
+	// Count
+	//
+	// Gets the number of checkpoints in the index
+	property int Count
+	{
+		int get(void);
+	}
+
+	// Length
+	//
+	// Gets the decompressed length of the indexed LZMA stream
+	property __int64 Length
+	{
+		__int64 get(void);
+	}
+
+	// Spacing
+	//
+	// Gets the minimum distance between checkpoints, in decompressed bytes
+	property __int64 Spacing
+	{
+		__int64 get(void);
+	}
+
+internal:
+
+	// Checkpoint
+	//
+	// Snapshot of the decoder state where decompression can be resumed
+	ref class Checkpoint
+	{
+	public:
+
+		// Instance Constructor
+		//
+		Checkpoint(__int64 output, __int64 input, array<unsigned __int8>^ state, array<unsigned __int8>^ snapshot, int snapshotlength);
+
+		//-------------------------------------------------------------------
+		// Fields
+
+		initonly __int64					Output;			// Decompressed data offset
+		initonly __int64					Input;			// Compressed data offset
+		initonly array<unsigned __int8>^	State;			// Serialized decoder variables
+		initonly array<unsigned __int8>^	Snapshot;		// LZ4 probabilities and dictionary
+		initonly int						SnapshotLength;	// Length of the decompressed snapshot
+	};
+
+	//-----------------------------------------------------------------------
+	// Internal Member Functions
+
+	// Capture (static)
+	//
+	// Creates a checkpoint from the current state of an LZMA decoder
+	static Checkpoint^ Capture(CLzmaDec* state, __int64 output, __int64 input);
+
+	// Find
+	//
+	// Locates the last checkpoint at or before a decompressed data offset
+	Checkpoint^ Find(__int64 position);
+
+	// Restore (static)
+	//
+	// Restores the state of an LZMA decoder from a checkpoint
+	static void Restore(Checkpoint^ checkpoint, CLzmaDec* state);
+
+private:
+
+	// Instance Constructor
+	//
+	LzmaIndex(__int64 spacing, __int64 length, List<Checkpoint^>^ checkpoints);
+
+	// BUFFER_SIZE
+	//
+	// Size of the input and output buffers used to build an index, in bytes
+	static const int BUFFER_SIZE = 65536;
+
+	// DEFAULT_SPACING
+	//
+	// Default minimum distance between checkpoints, in decompressed bytes
+	static const int DEFAULT_SPACING = (16 << 20);
+
+	// MAGIC
+	//
+	// Signature of a serialized index ("LZIX")
+	static const unsigned int MAGIC = 0x58495A4C;
+
+	// MATCH_SPEC_LEN_START
+	//
+	// LZMA decoder remaining length that indicates the end marker (kMatchSpecLenStart)
+	static const unsigned int MATCH_SPEC_LEN_START = 274;
+
+	// NUM_STATES
+	//
+	// Number of LZMA decoder states (kNumStates)
+	static const unsigned int NUM_STATES = 12;
+
+	// VERSION
+	//
+	// Version of the serialized index format
+	static const int VERSION = 1;
+
+	//-----------------------------------------------------------------------
+	// Member Variables
+
+	initonly __int64				m_spacing;			// Distance between checkpoints
+	initonly __int64				m_length;			// Decompressed stream length
+	initonly List<Checkpoint^>^		m_checkpoints;		// Index checkpoints
+};
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
+
+#endif	// __LZMAINDEX_H_
@@ -50,7 +50,7 @@ LzmaReader::LzmaReader(Stream^ stream) : LzmaReader(stream, false)
 //	leaveopen	- Flag to leave the base stream open after disposal
 
 LzmaReader::LzmaReader(Stream^ stream, bool leaveopen) : m_disposed(false), m_stream(stream), m_leaveopen(leaveopen), m_init(false), 
-	m_finished(false), m_inpos(0), m_insize(0), m_expected(System::UInt64::MaxValue), m_processed(0)
+	m_finished(false), m_inpos(0), m_insize(0), m_expected(System::UInt64::MaxValue), m_processed(0), m_basepos(0)
 {
 	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
 
@@ -64,6 +64,25 @@ LzmaReader::LzmaReader(Stream^ stream, bool leaveopen) : m_disposed(false), m_st
 	LzmaDec_Construct(m_state);			// Construct the LZMA state
 }
 
+//---------------------------------------------------------------------------
+// LzmaReader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	index		- Random access index of the compressed data
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+LzmaReader::LzmaReader(Stream^ stream, LzmaIndex^ index, bool leaveopen) : LzmaReader(stream, leaveopen)
+{
+	if(Object::ReferenceEquals(index, nullptr)) throw gcnew ArgumentNullException("index");
+	if(!stream->CanSeek) throw gcnew ArgumentException("The base stream must support seeking", "stream");
+
+	// The index describes the compressed data starting at the current position of the base stream
+	m_basepos = stream->Position;
+	m_index = index;
+}
+
 //---------------------------------------------------------------------------
 // LzmaReader Destructor
 
@@ -122,7 +141,7 @@ bool LzmaReader::CanRead::get(void)
 bool LzmaReader::CanSeek::get(void)
 {
 	CHECK_DISPOSED(m_disposed);
-	return false;
+	return (m_index != nullptr);
 }
 
 //---------------------------------------------------------------------------
@@ -151,6 +170,34 @@ void LzmaReader::Flush(void)
 	m_stream->Flush();
 }
 
+//---------------------------------------------------------------------------
+// LzmaReader::Initialize (private)
+//
+// Reads the stream header and initializes the LZMA decoder
+//
+// Arguments:
+//
+//	NONE
+
+void LzmaReader::Initialize(void)
+{
+	// Create a local temporary buffer to hold the header information
+	array<unsigned __int8>^ props = gcnew array<unsigned __int8>(LZMA_PROPS_SIZE + sizeof(uint64_t));
+	pin_ptr<unsigned __int8> pinprops = &props[0];
+
+	// Read the properties and expected stream length from the input stream
+	if(m_stream->Read(props, 0, LZMA_PROPS_SIZE + sizeof(uint64_t)) != LZMA_PROPS_SIZE + sizeof(uint64_t)) throw gcnew InvalidDataException();
+	m_expected = *reinterpret_cast<unsigned __int64*>(&pinprops[LZMA_PROPS_SIZE]);
+
+	// Allocate the LZMA decoder state
+	SRes result = LzmaDec_Allocate(m_state, pinprops, LZMA_PROPS_SIZE, &g_Alloc);
+	if(result == SZ_ERROR_MEM) throw gcnew OutOfMemoryException();
+	else if(result == SZ_ERROR_UNSUPPORTED) throw gcnew InvalidDataException();
+
+	LzmaDec_Init(m_state);				// Initialize the LZMA decoder
+	m_init = true;						// Ready to decompress the stream
+}
+
 //--------------------------------------------------------------------------
 // LzmaReader::Length::get
 //
@@ -159,7 +206,10 @@ void LzmaReader::Flush(void)
 __int64 LzmaReader::Length::get(void)
 {
 	CHECK_DISPOSED(m_disposed);
-	throw gcnew NotSupportedException();
+
+	// The length is only known when there is an index
+	if(!m_index) throw gcnew NotSupportedException();
+	return m_index->Length;
 }
 
 //---------------------------------------------------------------------------
@@ -182,10 +232,10 @@ __int64 LzmaReader::Position::get(void)
 
 void LzmaReader::Position::set(__int64 value)
 {
-	UNREFERENCED_PARAMETER(value);
-
 	CHECK_DISPOSED(m_disposed);
-	throw gcnew NotSupportedException();
+
+	if(value < 0) throw gcnew ArgumentOutOfRangeException("value");
+	Seek(value, SeekOrigin::Begin);
 }
 
 //---------------------------------------------------------------------------
@@ -216,24 +266,7 @@ int LzmaReader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 	if((count == 0) || (m_finished)) return 0;
 
 	// Wait to initialize the LZMA decoder until the first call to Read()
-	if(!m_init) {
-
-		// Create a local temporary buffer to hold the header information
-		array<unsigned __int8>^ props = gcnew array<unsigned __int8>(LZMA_PROPS_SIZE + sizeof(uint64_t));
-		pin_ptr<unsigned __int8> pinprops = &props[0];
-
-		// Read the properties and expected stream length from the input stream
-		if(m_stream->Read(props, 0, LZMA_PROPS_SIZE + sizeof(uint64_t)) != LZMA_PROPS_SIZE + sizeof(uint64_t)) throw gcnew InvalidDataException();
-		m_expected = *reinterpret_cast<unsigned __int64*>(&pinprops[LZMA_PROPS_SIZE]);
-
-		// Allocate the LZMA decoder state
-		SRes result = LzmaDec_Allocate(m_state, pinprops, LZMA_PROPS_SIZE, &g_Alloc);
-		if(result == SZ_ERROR_MEM) throw gcnew OutOfMemoryException();
-		else if(result == SZ_ERROR_UNSUPPORTED) throw gcnew InvalidDataException();
-
-		LzmaDec_Init(m_state);				// Initialize the LZMA decoder
-		m_init = true;						// Ready to decompress the stream
-	}
+	if(!m_init) Initialize();
 
 	// Pin the input/output buffers and the available input length
 	pin_ptr<unsigned __int8> pinin = &m_in[0];
@@ -296,11 +329,74 @@ int LzmaReader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 
 __int64 LzmaReader::Seek(__int64 offset, SeekOrigin origin)
 {
-	UNREFERENCED_PARAMETER(offset);
-	UNREFERENCED_PARAMETER(origin);
-
 	CHECK_DISPOSED(m_disposed);
-	throw gcnew NotSupportedException();
+
+	// Seeking is only supported when there is an index
+	if(!m_index) throw gcnew NotSupportedException();
+
+	msclr::lock lock(m_lock);
+
+	// Convert the offset into an absolute position within the decompressed data
+	__int64 position = offset;
+	if(origin == SeekOrigin::Current) position += static_cast<__int64>(m_processed);
+	else if(origin == SeekOrigin::End) position += m_index->Length;
+	else if(origin != SeekOrigin::Begin) throw gcnew ArgumentOutOfRangeException("origin");
+
+	if(position < 0) throw gcnew IOException("An attempt was made to move the position before the beginning of the stream");
+
+	SeekToPosition(position);
+	return static_cast<__int64>(m_processed);
+}
+
+//---------------------------------------------------------------------------
+// LzmaReader::SeekToPosition (private)
+//
+// Repositions the stream using the nearest checkpoint of the index
+//
+// Arguments:
+//
+//	position	- Decompressed data offset to seek to
+
+void LzmaReader::SeekToPosition(__int64 position)
+{
+	// A position at or beyond the end of the stream leaves nothing more to be read
+	if(position >= m_index->Length) { m_finished = true; m_processed = position; return; }
+
+	// Seeking forward without passing another checkpoint continues from the current position,
+	// otherwise the decoder is restored from the last checkpoint before the target position
+	LzmaIndex::Checkpoint^ checkpoint = m_index->Find(position);
+	__int64 processed = static_cast<__int64>(m_processed);
+	if((!m_init) || (m_finished) || (position < processed) || ((checkpoint) && (checkpoint->Output > processed))) {
+
+		// The decoder is allocated from the stream header the first time it's needed
+		if(!m_init) { m_stream->Position = m_basepos; Initialize(); }
+
+		if(checkpoint) {
+
+			LzmaIndex::Restore(checkpoint, m_state);
+			m_stream->Position = m_basepos + checkpoint->Input;
+			m_processed = checkpoint->Output;
+		}
+
+		else {
+
+			// There is no checkpoint before the position, start over after the stream header
+			LzmaDec_Init(m_state);
+			m_stream->Position = m_basepos + LZMA_PROPS_SIZE + sizeof(uint64_t);
+			m_processed = 0;
+		}
+
+		m_inpos = m_insize = 0;
+		m_finished = false;
+	}
+
+	// Decode and discard the data between the checkpoint and the target position
+	array<unsigned __int8>^ discard = gcnew array<unsigned __int8>(BUFFER_SIZE);
+	while(static_cast<__int64>(m_processed) < position) {
+
+		if(Read(discard, 0, static_cast<int>(Math::Min(position - static_cast<__int64>(m_processed), static_cast<__int64>(BUFFER_SIZE)))) == 0) 
+			throw gcnew InvalidDataException();
+	}
 }
 
 //---------------------------------------------------------------------------
@@ -25,6 +25,7 @@
 #pragma once
 
 #include <LzmaDec.h>
+#include "LzmaIndex.h"
 
 #pragma warning(push, 4)				// Enable maximum compiler warnings
 
@@ -47,6 +48,7 @@ public:
 	//
 	LzmaReader(Stream^ stream);
 	LzmaReader(Stream^ stream, bool leaveopen);
+	LzmaReader(Stream^ stream, LzmaIndex^ index, bool leaveopen);
 
 	//-----------------------------------------------------------------------
 	// Member Functions
@@ -140,6 +142,19 @@ private:
 	~LzmaReader();
 	!LzmaReader();
 
+	//-----------------------------------------------------------------------
+	// Private Member Functions
+
+	// Initialize
+	//
+	// Reads the stream header and initializes the LZMA decoder
+	void Initialize(void);
+
+	// SeekToPosition
+	//
+	// Repositions the stream using the nearest checkpoint of the index
+	void SeekToPosition(__int64 position);
+
 	//-----------------------------------------------------------------------
 	// Member Variables
 
@@ -154,6 +169,8 @@ private:
 	size_t							m_insize;			// Size of the input buffer data
 	unsigned __int64				m_expected;			// Expected output length
 	unsigned __int64				m_processed;		// Output bytes processed
+	LzmaIndex^						m_index;			// Random access index
+	__int64							m_basepos;			// Base stream offset of the index
 
 	Object^	m_lock = gcnew Object();		// Synchronization object
 };
@@ -0,0 +1,577 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "LzmaWriter.h"
+
+#include <Alloc.h>
+#include "LzmaException.h"
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// LzmaWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+
+LzmaWriter::LzmaWriter(Stream^ stream) : LzmaWriter(stream, DefaultProperties(LzmaCompressionLevel::Default), System::UInt64::MaxValue, false)
+{
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	level		- Indicates whether to emphasize speed or compression efficiency
+
+LzmaWriter::LzmaWriter(Stream^ stream, Compression::CompressionLevel level) : 
+	LzmaWriter(stream, DefaultProperties(LzmaCompressionLevel(level)), System::UInt64::MaxValue, false)
+{
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+LzmaWriter::LzmaWriter(Stream^ stream, bool leaveopen) : 
+	LzmaWriter(stream, DefaultProperties(LzmaCompressionLevel::Default), System::UInt64::MaxValue, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	level		- Indicates the level of compression to use
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+LzmaWriter::LzmaWriter(Stream^ stream, Compression::CompressionLevel level, bool leaveopen) : 
+	LzmaWriter(stream, DefaultProperties(LzmaCompressionLevel(level)), System::UInt64::MaxValue, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	level		- Indicates the level of compression to use
+//	length		- Exact length of the data that will be written
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+LzmaWriter::LzmaWriter(Stream^ stream, Compression::CompressionLevel level, __int64 length, bool leaveopen) : 
+	LzmaWriter(stream, DefaultProperties(LzmaCompressionLevel(level)), (length < 0) ? 
+	throw gcnew ArgumentOutOfRangeException("length") : static_cast<unsigned __int64>(length), leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter Constructor (internal)
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	props		- LZMA encoder properties
+//	length		- Exact length of the data that will be written, or UInt64::MaxValue
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+LzmaWriter::LzmaWriter(Stream^ stream, CLzmaEncProps const& props, unsigned __int64 length, bool leaveopen) : m_disposed(false), 
+	m_stream(stream), m_leaveopen(leaveopen), m_handle(nullptr), m_length(length), m_totalin(0), m_overflow(false), m_stagingpos(0), m_encodingpos(0), 
+	m_onread(gcnew OnReadDelegate(this, &LzmaWriter::OnRead)), m_onwrite(gcnew OnWriteDelegate(this, &LzmaWriter::OnWrite))
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+
+	CLzmaEncProps encprops = props;
+
+	// If the length of the input is not known, an end mark must be used otherwise there
+	// will be no way to properly decode the compressed stream
+	encprops.reduceSize = length;
+	if(length == System::UInt64::MaxValue) encprops.writeEndMark = 1;
+
+	// Normalize the properties to ensure nothing is out of range
+	LzmaEncProps_Normalize(&encprops);
+
+	// Create the LZMA encoder instance
+	m_handle = LzmaEnc_Create(&g_Alloc);
+	if(m_handle == nullptr) throw gcnew OutOfMemoryException();
+
+	// Apply the encoder properties to the encoder
+	SRes result = LzmaEnc_SetProps(m_handle, &encprops);
+	if(result != SZ_OK) throw gcnew LzmaException(result);
+
+	// Allocate and initialize the ISeqInStream and ISeqOutStream interfaces
+	try { 
+		
+		m_seqin = new ISeqInStream{ static_cast<OnReadPointer>(Marshal::GetFunctionPointerForDelegate(m_onread).ToPointer()) }; 
+		m_seqout = new ISeqOutStream{ static_cast<OnWritePointer>(Marshal::GetFunctionPointerForDelegate(m_onwrite).ToPointer()) };
+	}
+
+	catch(Exception^) { throw gcnew OutOfMemoryException(); }
+
+	// Construct a managed byte array to hold the stream properties
+	array<unsigned __int8>^ propbits = gcnew array<unsigned __int8>(LZMA_PROPS_SIZE);
+	pin_ptr<unsigned __int8> pinpropbits = &propbits[0];
+
+	// Convert the properties into a byte array for the output stream
+	size_t outsize = propbits->Length;
+	result = LzmaEnc_WriteProperties(m_handle, pinpropbits, &outsize);
+	if(result != SZ_OK) throw gcnew LzmaException(result);
+
+	// Write the properties and the length of the input data into the output stream
+	m_stream->Write(propbits, 0, propbits->Length);
+	array<unsigned __int8>^ sizebits = BitConverter::GetBytes(length);
+	m_stream->Write(sizebits, 0, sizebits->Length);
+
+	// LzmaEnc_Encode pulls its input, so it runs on a dedicated worker that is fed a bounded
+	// number of staging buffers; memory use is the encoder dictionary plus the staging buffers
+	m_input = gcnew BlockingCollection<array<unsigned __int8>^>(STAGING_BUFFER_COUNT);
+	m_staging = gcnew array<unsigned __int8>(STAGING_BUFFER_SIZE);
+	m_encoding = gcnew array<unsigned __int8>(0);
+	m_cancel = gcnew CancellationTokenSource();
+
+	m_encoder = Task::Factory->StartNew(gcnew Action(this, &LzmaWriter::Encode), TaskCreationOptions::LongRunning);
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter Destructor
+
+LzmaWriter::~LzmaWriter()
+{
+	if(m_disposed) return;
+
+	msclr::lock lock(m_lock);
+
+	try {
+
+		// Hand the final staging buffer to the encoder and signal the end of the input data
+		if(m_stagingpos > 0) QueueStagingBuffer();
+		m_input->CompleteAdding();
+
+		// Wait for the encoder to finish; GetResult() rethrows the original exception on failure
+		m_encoder->GetAwaiter().GetResult();
+
+		// A stream with a known length in the header must have received exactly that much data; if
+		// a write was already rejected for exceeding the length, that exception has been reported
+		if((m_length != System::UInt64::MaxValue) && (!m_overflow) && (static_cast<unsigned __int64>(m_totalin) != m_length))
+			throw gcnew InvalidOperationException("The amount of data written does not match the length specified for the stream");
+	}
+
+	finally {
+
+		// The encoder task is only abandoned when it has failed or the input was completed
+		if(!m_input->IsAddingCompleted) m_input->CompleteAdding();
+		try { m_encoder->Wait(); } catch(Exception^) { /* DO NOTHING */ }
+
+		delete m_input;
+		delete m_cancel;
+
+		if(!m_leaveopen) delete m_stream;		// Optionally dispose of the base stream
+
+		this->!LzmaWriter();
+		m_disposed = true;
+	}
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter Finalizer
+
+LzmaWriter::!LzmaWriter()
+{
+	if(m_handle) { LzmaEnc_Destroy(m_handle, &g_Alloc, &g_BigAlloc); m_handle = nullptr; }
+
+	// Release the unmanaged ISeqInStream and ISeqOutStream structures
+	if(m_seqin) { delete m_seqin; m_seqin = nullptr; }
+	if(m_seqout) { delete m_seqout; m_seqout = nullptr; }
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter::BaseStream::get
+//
+// Accesses the underlying base stream instance
+
+Stream^ LzmaWriter::BaseStream::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return m_stream;
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter::CanRead::get
+//
+// Gets a value indicating whether the current stream supports reading
+
+bool LzmaWriter::CanRead::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return false;
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter::CanSeek::get
+//
+// Gets a value indicating whether the current stream supports seeking
+
+bool LzmaWriter::CanSeek::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return false;
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter::CanWrite::get
+//
+// Gets a value indicating whether the current stream supports writing
+
+bool LzmaWriter::CanWrite::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return m_stream->CanWrite;
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter::DefaultProperties (private, static)
+//
+// Generates the LZMA encoder properties used by the public constructors
+//
+// Arguments:
+//
+//	level		- Compression level
+
+CLzmaEncProps LzmaWriter::DefaultProperties(LzmaCompressionLevel level)
+{
+	CLzmaEncProps				props;			// Encoder properties
+
+	LzmaEncProps_Init(&props);
+	props.level = level;
+
+	return props;
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter::Encode (private)
+//
+// Runs the LZMA encoder against the staged input data on a worker thread
+//
+// Arguments:
+//
+//	NONE
+
+void LzmaWriter::Encode(void)
+{
+	SRes result = LzmaEnc_Encode(m_handle, m_seqout, m_seqin, nullptr, &g_Alloc, &g_BigAlloc);
+
+	// Release any writer waiting to queue input, the encoder will not be reading it
+	if(result != SZ_OK) m_cancel->Cancel();
+
+	// A failure writing to the base stream is reported as the original exception
+	if(m_exception) throw m_exception;
+	if(result != SZ_OK) throw gcnew LzmaException(result);
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter::Flush
+//
+// Clears all buffers for this stream and causes any buffered data to be written
+//
+// Arguments:
+//
+//	NONE
+
+void LzmaWriter::Flush(void)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	msclr::lock lock(m_lock);
+
+	// LZMA has no flush operation; the staged data is handed to the encoder, which writes
+	// compressed data to the base stream as its match finder consumes the input
+	if(m_stagingpos > 0) QueueStagingBuffer();
+
+	msclr::lock streamlock(m_streamlock);
+	m_stream->Flush();
+}
+
+//--------------------------------------------------------------------------
+// LzmaWriter::Length::get
+//
+// Gets the length in bytes of the stream
+
+__int64 LzmaWriter::Length::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter::OnRead (private)
+//
+// Implements ISeqInStream::Read
+//
+// Arguments:
+//
+//	context		- Context pointer (unused)
+//	buffer		- Buffer to write the input data into
+//	size		- Size of the buffer / number of bytes written
+
+SRes LzmaWriter::OnRead(void* context, void* buffer, size_t* size)
+{
+	UNREFERENCED_PARAMETER(context);
+
+	if(*size == 0) return SZ_OK;
+	if(buffer == nullptr) return SZ_ERROR_PARAM;
+
+	// Wait for the next staging buffer once the current one has been consumed; a zero length
+	// read indicates the end of the input data after the writer has been closed
+	while(m_encodingpos == m_encoding->Length) {
+
+		if(!m_input->TryTake(m_encoding, Timeout::Infinite)) { *size = 0; return SZ_OK; }
+		m_encodingpos = 0;
+	}
+
+	int next = static_cast<int>(Math::Min(static_cast<__int64>(*size), static_cast<__int64>(m_encoding->Length - m_encodingpos)));
+	Marshal::Copy(m_encoding, m_encodingpos, IntPtr(buffer), next);
+
+	m_encodingpos += next;
+	*size = next;
+
+	return SZ_OK;
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter::OnWrite (private)
+//
+// Implements ISeqOutStream::Write
+//
+// Arguments:
+//
+//	context		- Context pointer (unused)
+//	buffer		- Buffer to read the output data from
+//	size		- Size of the output data buffer
+
+size_t LzmaWriter::OnWrite(void* context, void const* buffer, size_t size)
+{
+	UNREFERENCED_PARAMETER(context);
+
+	if(size == 0) return 0;
+	if(size > System::Int32::MaxValue) return 0;
+	if(buffer == nullptr) return 0;
+
+	// Create an intermediate buffer in which to copy the compressed data
+	array<unsigned __int8>^ intermediate = gcnew array<unsigned __int8>(static_cast<int>(size));
+	Marshal::Copy(IntPtr(const_cast<void*>(buffer)), intermediate, 0, static_cast<int>(size));
+
+	// Exceptions cannot be allowed to unwind through the encoder, a short write stops it instead
+	try { msclr::lock lock(m_streamlock); m_stream->Write(intermediate, 0, intermediate->Length); }
+	catch(Exception^ ex) { m_exception = ex; return 0; }
+
+	return size;
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter::Position::get
+//
+// Gets the current position within the stream
+
+__int64 LzmaWriter::Position::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	msclr::lock lock(m_lock);
+	return m_totalin + m_stagingpos;
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter::Position::set
+//
+// Sets the current position within the stream
+
+void LzmaWriter::Position::set(__int64 value)
+{
+	UNREFERENCED_PARAMETER(value);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter::QueueStagingBuffer (private)
+//
+// Hands the current staging buffer to the encoder
+//
+// Arguments:
+//
+//	NONE
+
+void LzmaWriter::QueueStagingBuffer(void)
+{
+	msclr::lock lock(m_lock);
+
+	// A partial staging buffer is trimmed to the actual length of the data
+	array<unsigned __int8>^ staging = m_staging;
+	if(m_stagingpos < staging->Length) Array::Resize<unsigned __int8>(staging, m_stagingpos);
+
+	// Waits for room if the encoder is behind; if the encoder has failed the original exception is thrown
+	try { m_input->Add(staging, m_cancel->Token); }
+	catch(OperationCanceledException^) { m_encoder->GetAwaiter().GetResult(); throw; }
+
+	m_totalin += staging->Length;
+
+	// The queued buffer now belongs to the encoder, a new one is needed for the next data
+	if(Object::ReferenceEquals(staging, m_staging)) m_staging = gcnew array<unsigned __int8>(STAGING_BUFFER_SIZE);
+	m_stagingpos = 0;
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter::Read
+//
+// Reads a sequence of bytes from the current stream and advances the position within the stream
+//
+// Arguments:
+//
+//	buffer		- Destination data buffer
+//	offset		- Offset within buffer to begin copying data
+//	count		- Maximum number of bytes to write into the destination buffer
+
+int LzmaWriter::Read(array<unsigned __int8>^ buffer, int offset, int count)
+{
+	UNREFERENCED_PARAMETER(buffer);
+	UNREFERENCED_PARAMETER(offset);
+	UNREFERENCED_PARAMETER(count);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter::Seek
+//
+// Sets the position within the current stream
+//
+// Arguments:
+//
+//	offset		- Byte offset relative to origin
+//	origin		- Reference point used to obtain the new position
+
+__int64 LzmaWriter::Seek(__int64 offset, SeekOrigin origin)
+{
+	UNREFERENCED_PARAMETER(offset);
+	UNREFERENCED_PARAMETER(origin);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter::SetLength
+//
+// Sets the length of the current stream
+//
+// Arguments:
+//
+//	value		- Desired length of the current stream in bytes
+
+void LzmaWriter::SetLength(__int64 value)
+{
+	UNREFERENCED_PARAMETER(value);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter::Write
+//
+// Writes a sequence of bytes to the current stream and advances the current position
+//
+// Arguments:
+//
+//	buffer		- Source data buffer 
+
+void LzmaWriter::Write(array<unsigned __int8>^ buffer)
+{
+	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
+
+	CHECK_DISPOSED(m_disposed);
+	Write(buffer, 0, buffer->Length);
+}
+
+//---------------------------------------------------------------------------
+// LzmaWriter::Write
+//
+// Writes a sequence of bytes to the current stream and advances the current position
+//
+// Arguments:
+//
+//	buffer		- Source data buffer 
+//	offset		- Offset within buffer to begin copying from
+//	count		- Maximum number of bytes to read from the source buffer
+
+void LzmaWriter::Write(array<unsigned __int8>^ buffer, int offset, int count)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
+	if(offset < 0) throw gcnew ArgumentOutOfRangeException("offset");
+	if(count < 0) throw gcnew ArgumentOutOfRangeException("count");
+	if((offset + count) > buffer->Length) throw gcnew ArgumentException("The sum of offset and count is larger than the buffer length");
+
+	msclr::lock lock(m_lock);
+
+	// A stream with a known length in the header cannot accept more data than that
+	if((m_length != System::UInt64::MaxValue) && (static_cast<unsigned __int64>(m_totalin + m_stagingpos + count) > m_length)) {
+
+		m_overflow = true;
+		throw gcnew InvalidOperationException("The amount of data written exceeds the length specified for the stream");
+	}
+
+	// Buffer the input data and hand it to the encoder in staging buffer sized chunks
+	while(count > 0) {
+
+		int next = Math::Min(m_staging->Length - m_stagingpos, count);
+		Array::Copy(buffer, offset, m_staging, m_stagingpos, next);
+
+		m_stagingpos += next;			// Increment length of buffer
+		offset += next;					// Move offset into the source buffer
+		count -= next;					// Decrement bytes remaining
+
+		if(m_stagingpos == m_staging->Length) QueueStagingBuffer();
+	}
+}
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
@@ -0,0 +1,248 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#ifndef __LZMAWRITER_H_
+#define __LZMAWRITER_H_
+#pragma once
+
+#include <LzmaEnc.h>
+#include "LzmaCompressionLevel.h"
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+using namespace System;
+using namespace System::Collections::Concurrent;
+using namespace System::IO;
+using namespace System::Runtime::InteropServices;
+using namespace System::Threading;
+using namespace System::Threading::Tasks;
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// Class LzmaWriter
+//
+// LZMA-based compression stream implementation
+//---------------------------------------------------------------------------
+
+public ref class LzmaWriter : public Stream
+{
+public:
+
+	// Instance Constructors
+	//
+	LzmaWriter(Stream^ stream);
+	LzmaWriter(Stream^ stream, Compression::CompressionLevel level);
+	LzmaWriter(Stream^ stream, bool leaveopen);
+	LzmaWriter(Stream^ stream, Compression::CompressionLevel level, bool leaveopen);
+	LzmaWriter(Stream^ stream, Compression::CompressionLevel level, __int64 length, bool leaveopen);
+
+	//-----------------------------------------------------------------------
+	// Member Functions
+
+	// Flush (Stream)
+	//
+	// Clears all buffers for this stream and causes any buffered data to be written
+	virtual void Flush(void) override;
+
+	// Read (Stream)
+	//
+	// Reads a sequence of bytes from the current stream and advances the position within the stream
+	virtual int Read(array<unsigned __int8>^ buffer, int offset, int count) override;
+
+	// Seek (Stream)
+	//
+	// Sets the position within the current stream
+	virtual __int64 Seek(__int64 offset, SeekOrigin origin) override;
+
+	// SetLength (Stream)
+	//
+	// Sets the length of the current stream
+	virtual void SetLength(__int64 value) override;
+
+	// Write
+	//
+	// Writes a sequence of bytes to the current stream and advances the current position
+	void Write(array<unsigned __int8>^ buffer);
+
+	// Write (Stream)
+	//
+	// Writes a sequence of bytes to the current stream and advances the current position
+	virtual void Write(array<unsigned __int8>^ buffer, int offset, int count) override;
+
+	//-----------------------------------------------------------------------
+	// Properties
+
+	// BaseStream
+	//
+	// Exposes the underlying base stream instance
+	property Stream^ BaseStream
+	{
+		Stream^ get(void);
+	}
+
+	// CanRead (Stream)
+	//
+	// Gets a value indicating whether the current stream supports reading
+	property bool CanRead
+	{
+		virtual bool get(void) override;
+	}
+
+	// CanSeek (Stream)
+	//
+	// Gets a value indicating whether the current stream supports seeking
+	property bool CanSeek
+	{
+		virtual bool get(void) override;
+	}
+
+	// CanWrite (Stream)
+	//
+	// Gets a value indicating whether the current stream supports writing
+	property bool CanWrite
+	{
+		virtual bool get(void) override;
+	}
+
+	// Length (Stream)
+	//
+	// Gets the length in bytes of the stream
+	property __int64 Length
+	{
+		virtual __int64 get(void) override;
+	}
+
+	// Position (Stream)
+	//
+	// Gets or sets the current position within the stream
+	property __int64 Position
+	{
+		virtual __int64 get(void) override;
+		void set(__int64 value) override;
+	}
+
+internal:
+
+	// Instance Constructor
+	//
+	LzmaWriter(Stream^ stream, CLzmaEncProps const& props, unsigned __int64 length, bool leaveopen);
+
+private:
+
+	// Destructor / Finalizer
+	//
+	~LzmaWriter();
+	!LzmaWriter();
+
+	// STAGING_BUFFER_COUNT
+	//
+	// Maximum number of staging buffers waiting for the encoder
+	static const int STAGING_BUFFER_COUNT = 4;
+
+	// STAGING_BUFFER_SIZE
+	//
+	// Size of each staging buffer, in bytes
+	static const int STAGING_BUFFER_SIZE = 65536;
+
+	// OnReadDelegate
+	//
+	// Delegate to provide access to OnRead as an unmanaged __cdecl function
+	[UnmanagedFunctionPointer(CallingConvention::Cdecl)] delegate SRes OnReadDelegate(void*, void*, size_t*);
+
+	// OnReadPointer
+	//
+	// ISeqInStream::Read compatible function declaration
+	using OnReadPointer = SRes(__cdecl*)(void*, void*, size_t*);
+
+	// OnWriteDelegate
+	//
+	// Delegate to provide access to OnWrite as an unmanaged __cdecl function
+	[UnmanagedFunctionPointer(CallingConvention::Cdecl)] delegate size_t OnWriteDelegate(void*, void const*, size_t);
+
+	// OnWritePointer
+	//
+	// ISeqOutStream::Write compatible function pointer
+	using OnWritePointer = size_t(__cdecl*)(void*, void const*, size_t);
+
+	//-----------------------------------------------------------------------
+	// Private Member Functions
+
+	// DefaultProperties (static)
+	//
+	// Generates the LZMA encoder properties used by the public constructors
+	static CLzmaEncProps DefaultProperties(LzmaCompressionLevel level);
+
+	// Encode
+	//
+	// Runs the LZMA encoder against the staged input data on a worker thread
+	void Encode(void);
+
+	// OnRead
+	//
+	// Implements ISeqInStream::Read
+	SRes OnRead(void* context, void* buffer, size_t* size);
+
+	// OnWrite
+	//
+	// Implements ISeqOutStream::Write
+	size_t OnWrite(void* context, void const* buffer, size_t size);
+
+	// QueueStagingBuffer
+	//
+	// Hands the current staging buffer to the encoder
+	void QueueStagingBuffer(void);
+
+	//-----------------------------------------------------------------------
+	// Member Variables
+
+	bool							m_disposed;		// Object disposal flag
+	Stream^							m_stream;		// Base Stream instance
+	bool							m_leaveopen;	// Flag to leave base stream open
+	CLzmaEncHandle					m_handle;		// LZMA encoder handle
+	initonly unsigned __int64		m_length;		// Expected length of the input
+	__int64							m_totalin;		// Total queued input data
+	bool							m_overflow;		// Flag if a write exceeded the length
+	array<unsigned __int8>^			m_staging;		// Current staging buffer
+	int								m_stagingpos;	// Position within the staging buffer
+	BlockingCollection<array<unsigned __int8>^>^	m_input;	// Staged input data
+	array<unsigned __int8>^			m_encoding;		// Buffer being read by the encoder
+	int								m_encodingpos;	// Position within the encoding buffer
+	CancellationTokenSource^		m_cancel;		// Encoder failure cancellation
+	Task^							m_encoder;		// Encoder worker task
+	Exception^						m_exception;	// Exception from the base stream
+	ISeqInStream*					m_seqin;		// ISeqInStream instance
+	ISeqOutStream*					m_seqout;		// ISeqOutStream instance
+	initonly OnReadDelegate^		m_onread;		// OnRead delegate instance
+	initonly OnWriteDelegate^		m_onwrite;		// OnWrite delegate instance
+
+	Object^	m_lock = gcnew Object();		// Synchronization object
+	Object^	m_streamlock = gcnew Object();	// Base stream synchronization object
+};
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
+
+#endif	// __LZMAWRITER_H_
@@ -0,0 +1,165 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "TaskQueue.h"
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// TaskQueue Constructor
+//
+// Arguments:
+//
+//	threads		- Maximum number of operations to execute concurrently
+//	capacity	- Maximum number of pending operations in the queue
+
+generic<typename T>
+TaskQueue<T>::TaskQueue(int threads, int capacity) : m_disposed(false), m_capacity(capacity)
+{
+	if(threads <= 0) throw gcnew ArgumentOutOfRangeException("threads");
+	if(capacity <= 0) throw gcnew ArgumentOutOfRangeException("capacity");
+
+	// The concurrent half of a scheduler pair limits how many of the operations can
+	// be executing at once without having to dedicate threads to this instance
+	m_scheduler = (gcnew ConcurrentExclusiveSchedulerPair(TaskScheduler::Default, threads))->ConcurrentScheduler;
+	m_tasks = gcnew Queue<Task<T>^>(capacity);
+}
+
+//---------------------------------------------------------------------------
+// TaskQueue Destructor
+
+generic<typename T>
+TaskQueue<T>::~TaskQueue()
+{
+	if(m_disposed) return;
+
+	// Operations may still be accessing buffers owned by the caller, they
+	// have to be allowed to complete before this object goes away
+	Clear();
+
+	m_disposed = true;
+}
+
+//---------------------------------------------------------------------------
+// TaskQueue::Clear
+//
+// Waits for and discards all pending operations
+//
+// Arguments:
+//
+//	NONE
+
+generic<typename T>
+void TaskQueue<T>::Clear(void)
+{
+	while(m_tasks->Count > 0) {
+
+		Task<T>^ task = m_tasks->Dequeue();
+
+		// Any exception thrown by a discarded operation is ignored
+		try { task->Wait(); }
+		catch(Exception^) { /* DO NOTHING */ }
+	}
+}
+
+//---------------------------------------------------------------------------
+// TaskQueue::Count::get
+//
+// Gets the number of pending operations in the queue
+
+generic<typename T>
+int TaskQueue<T>::Count::get(void)
+{
+	return m_tasks->Count;
+}
+
+//---------------------------------------------------------------------------
+// TaskQueue::Dequeue
+//
+// Waits for the oldest operation to complete and returns the result
+//
+// Arguments:
+//
+//	NONE
+
+generic<typename T>
+T TaskQueue<T>::Dequeue(void)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	if(m_tasks->Count == 0) throw gcnew InvalidOperationException();
+
+	// GetResult() rethrows the original exception rather than an AggregateException
+	return m_tasks->Dequeue()->GetAwaiter().GetResult();
+}
+
+//---------------------------------------------------------------------------
+// TaskQueue::Enqueue
+//
+// Starts a new operation and adds it to the end of the queue
+//
+// Arguments:
+//
+//	operation	- Delegate to execute asynchronously
+//	state		- State object to pass into the delegate
+
+generic<typename T>
+void TaskQueue<T>::Enqueue(Func<Object^, T>^ operation, Object^ state)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	if(Object::ReferenceEquals(operation, nullptr)) throw gcnew ArgumentNullException("operation");
+	if(m_tasks->Count >= m_capacity) throw gcnew InvalidOperationException();
+
+	m_tasks->Enqueue(Task<T>::Factory->StartNew(operation, state, CancellationToken::None, TaskCreationOptions::None, m_scheduler));
+}
+
+//---------------------------------------------------------------------------
+// TaskQueue::IsEmpty::get
+//
+// Gets a flag indicating if there are no pending operations
+
+generic<typename T>
+bool TaskQueue<T>::IsEmpty::get(void)
+{
+	return m_tasks->Count == 0;
+}
+
+//---------------------------------------------------------------------------
+// TaskQueue::IsFull::get
+//
+// Gets a flag indicating if the queue is at capacity
+
+generic<typename T>
+bool TaskQueue<T>::IsFull::get(void)
+{
+	return m_tasks->Count >= m_capacity;
+}
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
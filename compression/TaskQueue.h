@@ -0,0 +1,119 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#ifndef __TASKQUEUE_H_
+#define __TASKQUEUE_H_
+#pragma once
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Threading;
+using namespace System::Threading::Tasks;
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// Class TaskQueue (internal)
+//
+// Bounded FIFO queue of asynchronous operations.  Operations are executed
+// concurrently on the thread pool with a fixed maximum degree of parallelism,
+// but their results are always dequeued in the order they were enqueued
+//---------------------------------------------------------------------------
+
+generic<typename T>
+ref class TaskQueue
+{
+public:
+
+	// Instance Constructor
+	//
+	TaskQueue(int threads, int capacity);
+
+	//-----------------------------------------------------------------------
+	// Member Functions
+
+	// Clear
+	//
+	// Waits for and discards all pending operations
+	void Clear(void);
+
+	// Dequeue
+	//
+	// Waits for the oldest operation to complete and returns the result
+	T Dequeue(void);
+
+	// Enqueue
+	//
+	// Starts a new operation and adds it to the end of the queue
+	void Enqueue(Func<Object^, T>^ operation, Object^ state);
+
+	//-----------------------------------------------------------------------
+	// Properties
+
+	// Count
+	//
+	// Gets the number of pending operations in the queue
+	property int Count
+	{
+		int get(void);
+	}
+
+	// IsEmpty
+	//
+	// Gets a flag indicating if there are no pending operations
+	property bool IsEmpty
+	{
+		bool get(void);
+	}
+
+	// IsFull
+	//
+	// Gets a flag indicating if the queue is at capacity
+	property bool IsFull
+	{
+		bool get(void);
+	}
+
+private:
+
+	// Destructor
+	//
+	~TaskQueue();
+
+	//-----------------------------------------------------------------------
+	// Member Variables
+
+	bool							m_disposed;		// Object disposal flag
+	initonly int					m_capacity;		// Maximum pending operations
+	initonly TaskScheduler^			m_scheduler;	// Concurrency-limited scheduler
+	initonly Queue<Task<T>^>^		m_tasks;		// Queue of pending operations
+};
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
+
+#endif	// __TASKQUEUE_H_
@@ -24,6 +24,7 @@
 #include "XzEncoder.h"
 
 #include "LzmaException.h"
+#include "XzWriter.h"
 
 // crcinit
 //
@@ -50,7 +51,7 @@ static XzEncoder::XzEncoder()
 //	NONE
 
 XzEncoder::XzEncoder() : m_blocksize(Lzma2BlockSize::Disabled), m_blockthreads(Lzma2ThreadsPerBlock::Default), 
-	m_totalthreads(Lzma2MaximumThreads::Default), m_checkid(XzChecksum::Default)
+	m_totalthreads(Lzma2MaximumThreads::Default), m_checkid(XzChecksum::Default), m_maxpending(0)
 {
 }
 
@@ -213,10 +214,24 @@ void XzEncoder::Encode(Stream^ instream, unsigned __int64 insize, Stream^ outstr
 	lzma2props.blockSize = static_cast<size_t>(static_cast<__int64>(m_blocksize));
 	lzma2props.numBlockThreads = m_blockthreads;
 	lzma2props.numTotalThreads = m_totalthreads;
+
+	// Normalizing the properties replaces the total thread count with the threads used by a single
+	// LZMA2 encoder, so the requested total has to be taken beforehand
+	int totalthreads = lzma2props.numTotalThreads;
   
 	// Normalize the LZMA2 encoder properties
 	Lzma2EncProps_Normalize(&lzma2props);
 
+	// When the total thread count allows for more than one block's worth of threads, the input is cut
+	// into independent XZ blocks that are compressed concurrently by an XzWriter instance
+	if((totalthreads > 0) && (totalthreads / (lzma2props.numBlockThreads * lzma2props.lzmaProps.numThreads) > 1)) {
+
+		lzma2props.numTotalThreads = totalthreads;
+		msclr::auto_handle<XzWriter> writer(gcnew XzWriter(outstream, lzma2props, m_checkid, m_maxpending, true));
+		instream->CopyTo(writer.get());
+		return;
+	}
+
 	// Initialize the XZ encoder properties
 	XzProps_Init(&xzprops);
 	xzprops.lzma2Props = &lzma2props;
@@ -270,6 +285,27 @@ void XzEncoder::Encode(array<unsigned __int8>^ buffer, int offset, int count, St
 	Encode(instream.get(), count, outstream);
 }
 
+//---------------------------------------------------------------------------
+// XzEncoder::MaximumPendingBlocks::get
+//
+// Gets the maximum number of blocks in flight during parallel compression
+
+int XzEncoder::MaximumPendingBlocks::get(void)
+{
+	return m_maxpending;
+}
+
+//---------------------------------------------------------------------------
+// XzEncoder::MaximumPendingBlocks::set
+//
+// Sets the maximum number of blocks in flight during parallel compression
+
+void XzEncoder::MaximumPendingBlocks::set(int value)
+{
+	if(value < 0) throw gcnew ArgumentOutOfRangeException("value");
+	m_maxpending = value;
+}
+
 //---------------------------------------------------------------------------
 // XzEncoder::MaximumThreads::get
 //
@@ -108,6 +108,15 @@ public:
 		void set(XzChecksum value);
 	}
 
+	// MaximumPendingBlocks
+	//
+	// Gets/sets the maximum number of blocks in flight during parallel compression
+	property int MaximumPendingBlocks
+	{
+		int get(void);
+		void set(int value);
+	}
+
 	// MaximumThreads
 	//
 	// Indicates the maximum number of LZMA2 threads
@@ -218,6 +227,7 @@ private:
 	Lzma2ThreadsPerBlock		m_blockthreads;			// Threads per block
 	Lzma2MaximumThreads			m_totalthreads;			// Total LZMA2 threads
 	XzChecksum					m_checkid;				// Checksum type identifier
+	int							m_maxpending;			// Maximum pending blocks
 };
 
 //---------------------------------------------------------------------------
@@ -55,17 +55,47 @@ XzReader::XzReader(Stream^ stream) : XzReader(stream, false)
 }
 
 //---------------------------------------------------------------------------
-// XzReader Constructor (private)
+// XzReader Constructor
 //
 // Arguments:
 //
-//	stream		- The stream the compressed or decompressed data is written to
+//	stream		- The stream the compressed data is read from
 //	leaveopen	- Flag to leave the base stream open after disposal
 
-XzReader::XzReader(Stream^ stream, bool leaveopen) : m_disposed(false), m_stream(stream), m_leaveopen(leaveopen), m_finished(false),
-	m_inpos(0), m_insize(0)
+XzReader::XzReader(Stream^ stream, bool leaveopen) : XzReader(stream, 1, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// XzReader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	threads		- Number of threads to use for decompression (zero = processor count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+XzReader::XzReader(Stream^ stream, int threads, bool leaveopen) : XzReader(stream, threads, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// XzReader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	threads		- Number of threads to use for decompression (zero = processor count)
+//	maxpending	- Maximum number of blocks in flight (zero = twice the thread count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+XzReader::XzReader(Stream^ stream, int threads, int maxpending, bool leaveopen) : m_disposed(false), m_stream(stream), 
+	m_leaveopen(leaveopen), m_finished(false), m_inpos(0), m_insize(0), m_length(0), m_position(0), m_random(false), 
+	m_nextblock(0), m_outpos(0), m_cachesize(0), m_serialblock(-1), m_serialin(0), m_serialout(0)
 {
 	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+	if(threads < 0) throw gcnew ArgumentOutOfRangeException("threads");
+	if(maxpending < 0) throw gcnew ArgumentOutOfRangeException("maxpending");
 
 	// Allocate and construct the CXzUnpacker instance
 	try { m_unpacker = new CXzUnpacker; XzUnpacker_Construct(m_unpacker, &g_Alloc); }
@@ -76,6 +106,30 @@ XzReader::XzReader(Stream^ stream, bool leaveopen) : m_disposed(false), m_stream
 
 	// Initialize the CXzUnpacker instance
 	XzUnpacker_Init(m_unpacker);
+
+	// Zero threads indicates that the number of processors should be used
+	if(threads == 0) threads = Environment::ProcessorCount;
+
+	// When the base stream is seekable the index at the end of each stream locates every block, which
+	// allows random access to the uncompressed data and for the blocks to be decoded in parallel
+	if(stream->CanSeek) m_blocks = ReadIndex();
+	if(m_blocks) {
+
+		m_positions = gcnew array<__int64>(m_blocks->Count);
+		for(int index = 0; index < m_blocks->Count; index++) {
+
+			m_positions[index] = m_length;
+			m_length += m_blocks[index]->UncompressedSize;
+		}
+
+		m_cache = gcnew LinkedList<KeyValuePair<int, array<unsigned __int8>^>>();
+		m_out = gcnew array<unsigned __int8>(0);
+
+		// A stream with a single block gains nothing from parallel decoding; zero pending blocks
+		// indicates twice the thread count
+		if((threads > 1) && (m_blocks->Count > 1))
+			m_pending = gcnew TaskQueue<array<unsigned __int8>^>(threads, (maxpending == 0) ? threads * 2 : maxpending);
+	}
 }
 
 //---------------------------------------------------------------------------
@@ -85,6 +139,9 @@ XzReader::~XzReader()
 {
 	if(m_disposed) return;
 
+	// Wait for and discard any blocks still being decoded
+	if(m_pending) delete m_pending;
+
 	// Destroy the managed input buffer
 	delete m_in;
 	
@@ -101,6 +158,7 @@ XzReader::~XzReader()
 XzReader::!XzReader()
 {
 	if(m_unpacker) { XzUnpacker_Free(m_unpacker); m_unpacker = nullptr; }
+	if(m_serialunpacker) { XzUnpacker_Free(m_serialunpacker); m_serialunpacker = nullptr; }
 }
 
 //---------------------------------------------------------------------------
@@ -114,6 +172,32 @@ Stream^ XzReader::BaseStream::get(void)
 	return m_stream;
 }
 
+//---------------------------------------------------------------------------
+// XzReader::CalculateCrc32 (private, static)
+//
+// Calculates the CRC32 of a range of bytes
+//
+// Arguments:
+//
+//	buffer		- Buffer containing the data
+//	offset		- Offset of the data within the buffer
+//	count		- Length of the data within the buffer
+
+unsigned int XzReader::CalculateCrc32(array<unsigned __int8>^ buffer, int offset, int count)
+{
+	CXzCheck					check;						// CRC32 check state
+	Byte						digest[XZ_CHECK_SIZE_MAX];	// CRC32 digest
+
+	pin_ptr<unsigned __int8> pinbuffer = &buffer[0];
+
+	XzCheck_Init(&check, XZ_CHECK_CRC32);
+	XzCheck_Update(&check, &pinbuffer[offset], count);
+	XzCheck_Final(&check, digest);
+
+	// XzCheck_Final writes the CRC32 in little-endian order
+	return digest[0] | (digest[1] << 8) | (digest[2] << 16) | (static_cast<unsigned int>(digest[3]) << 24);
+}
+
 //---------------------------------------------------------------------------
 // XzReader::CanRead::get
 //
@@ -133,7 +217,7 @@ bool XzReader::CanRead::get(void)
 bool XzReader::CanSeek::get(void)
 {
 	CHECK_DISPOSED(m_disposed);
-	return false;
+	return (m_blocks != nullptr);
 }
 
 //---------------------------------------------------------------------------
@@ -147,6 +231,128 @@ bool XzReader::CanWrite::get(void)
 	return false;
 }
 
+//---------------------------------------------------------------------------
+// XzReader::CreateStreamFooter (private, static)
+//
+// Creates the index and stream footer that wrap a single block into a stream
+//
+// Arguments:
+//
+//	block		- Block to be wrapped into a stream
+
+array<unsigned __int8>^ XzReader::CreateStreamFooter(Block^ block)
+{
+	array<unsigned __int8>^ footer = gcnew array<unsigned __int8>(1 + (MAXIMUM_VARINT_SIZE * 3) + 3 + 4 + XZ_STREAM_FOOTER_SIZE);
+	int length = 1;
+
+	// Index with a single record for the block, padded to a multiple of four bytes
+	length += WriteVarInt(footer, length, 1);
+	length += WriteVarInt(footer, length, block->UnpaddedSize);
+	length += WriteVarInt(footer, length, block->UncompressedSize);
+	length = (length + 3) & ~3;
+
+	Array::Copy(BitConverter::GetBytes(CalculateCrc32(footer, 0, length)), 0, footer, length, 4);
+	length += 4;
+
+	// Stream footer
+	Array::Copy(BitConverter::GetBytes(static_cast<unsigned int>(length / 4) - 1), 0, footer, length + 4, 4);
+	Array::Copy(BitConverter::GetBytes(block->Flags), 0, footer, length + 8, XZ_STREAM_FLAGS_SIZE);
+	Array::Copy(BitConverter::GetBytes(CalculateCrc32(footer, length + 4, 4 + XZ_STREAM_FLAGS_SIZE)), 0, footer, length, 4);
+	footer[length + 10] = XZ_FOOTER_SIG[0];
+	footer[length + 11] = XZ_FOOTER_SIG[1];
+
+	Array::Resize<unsigned __int8>(footer, length + XZ_STREAM_FOOTER_SIZE);
+	return footer;
+}
+
+//---------------------------------------------------------------------------
+// XzReader::CreateStreamHeader (private, static)
+//
+// Creates the stream header that wraps a single block into a stream
+//
+// Arguments:
+//
+//	flags		- Stream flags of the stream containing the block
+
+array<unsigned __int8>^ XzReader::CreateStreamHeader(unsigned short flags)
+{
+	array<unsigned __int8>^ header = gcnew array<unsigned __int8>(XZ_STREAM_HEADER_SIZE);
+
+	// Signature, stream flags and the CRC32 of the stream flags
+	for(int sig = 0; sig < XZ_SIG_SIZE; sig++) header[sig] = XZ_SIG[sig];
+	Array::Copy(BitConverter::GetBytes(flags), 0, header, XZ_SIG_SIZE, XZ_STREAM_FLAGS_SIZE);
+	Array::Copy(BitConverter::GetBytes(CalculateCrc32(header, XZ_SIG_SIZE, XZ_STREAM_FLAGS_SIZE)), 0, header, XZ_SIG_SIZE + XZ_STREAM_FLAGS_SIZE, 4);
+
+	return header;
+}
+
+//---------------------------------------------------------------------------
+// XzReader::DecodeBlock (private)
+//
+// Decodes a single XZ block into a managed byte array
+//
+// Arguments:
+//
+//	state		- Tuple<> of the Block and its compressed data
+
+array<unsigned __int8>^ XzReader::DecodeBlock(Object^ state)
+{
+	CXzUnpacker					unpacker;			// Block unpacker instance
+	ECoderStatus				status;				// Decoder status flag
+
+	Tuple<Block^, array<unsigned __int8>^>^ job = safe_cast<Tuple<Block^, array<unsigned __int8>^>^>(state);
+	Block^ block = job->Item1;
+	array<unsigned __int8>^ data = job->Item2;
+
+	// The block is wrapped in a stream of its own with the original stream flags and a single record
+	// index so that it can be decoded and verified by an independent CXzUnpacker
+	array<unsigned __int8>^ header = CreateStreamHeader(block->Flags);
+	array<unsigned __int8>^ footer = CreateStreamFooter(block);
+
+	array<unsigned __int8>^ in = gcnew array<unsigned __int8>(header->Length + data->Length + footer->Length);
+	Array::Copy(header, 0, in, 0, header->Length);
+	Array::Copy(data, 0, in, header->Length, data->Length);
+	Array::Copy(footer, 0, in, header->Length + data->Length, footer->Length);
+
+	array<unsigned __int8>^ out = gcnew array<unsigned __int8>(static_cast<int>(block->UncompressedSize));
+
+	// Pin both the input and output buffers in memory
+	pin_ptr<unsigned __int8> pinin = &in[0];
+	pin_ptr<unsigned __int8> pinout = &out[0];
+
+	size_t inpos = 0;
+	size_t outpos = 0;
+
+	XzUnpacker_Construct(&unpacker, &g_Alloc);
+
+	try {
+
+		XzUnpacker_Init(&unpacker);
+
+		while(true) {
+
+			// Use local input/output size values, they are modified by XzUnpacker_Code
+			size_t insize = in->Length - inpos;
+			size_t outsize = out->Length - outpos;
+
+			SRes result = XzUnpacker_Code(&unpacker, &pinout[outpos], &outsize, &pinin[inpos], &insize, CODER_FINISH_ANY, &status);
+			if(result != SZ_OK) throw gcnew LzmaException(result);
+
+			inpos += insize;
+			outpos += outsize;
+
+			if((insize == 0) && (outsize == 0)) break;
+		}
+
+		// The block must produce exactly the size recorded in the index and finish the stream
+		if((outpos != static_cast<size_t>(out->Length)) || (!XzUnpacker_IsStreamWasFinished(&unpacker))) throw gcnew InvalidDataException();
+	}
+
+	finally { XzUnpacker_Free(&unpacker); }
+
+	return out;
+}
+
 //---------------------------------------------------------------------------
 // XzReader::Flush
 //
@@ -162,6 +368,74 @@ void XzReader::Flush(void)
 	m_stream->Flush();
 }
 
+//---------------------------------------------------------------------------
+// XzReader::GetBlock (private)
+//
+// Gets the decoded data for a block from the cache or by decoding it
+//
+// Arguments:
+//
+//	index		- Index of the block in the stream index
+
+array<unsigned __int8>^ XzReader::GetBlock(int index)
+{
+	// Recently decoded blocks are kept to serve repeated lookups into the same region
+	for(LinkedListNode<KeyValuePair<int, array<unsigned __int8>^>>^ node = m_cache->First; node != nullptr; node = node->Next) {
+
+		if(node->Value.Key != index) continue;
+
+		m_cache->Remove(node);
+		m_cache->AddFirst(node);
+		return node->Value.Value;
+	}
+
+	array<unsigned __int8>^ out;
+
+	if(m_pending) {
+
+		// Blocks are decoded ahead in order, any other block restarts the decoding queue at that block
+		if(index != (m_nextblock - m_pending->Count)) { m_pending->Clear(); m_nextblock = index; }
+
+		QueueBlocks();
+		out = m_pending->Dequeue();
+	}
+
+	else {
+
+		Block^ block = m_blocks[index];
+		array<unsigned __int8>^ data = ReadStreamBytes(block->Offset, static_cast<int>((block->UnpaddedSize + 3) & ~3));
+		out = DecodeBlock(gcnew Tuple<Block^, array<unsigned __int8>^>(block, data));
+	}
+
+	// Discard the least recently used blocks once the cache is full, the newest block is always kept
+	m_cache->AddFirst(KeyValuePair<int, array<unsigned __int8>^>(index, out));
+	m_cachesize += out->Length;
+
+	while((m_cachesize > BLOCK_CACHE_SIZE) && (m_cache->Count > 1)) {
+
+		m_cachesize -= m_cache->Last->Value.Value->Length;
+		m_cache->RemoveLast();
+	}
+
+	return out;
+}
+
+//---------------------------------------------------------------------------
+// XzReader::IsSerialBlock (private, static)
+//
+// Determines if a block is decoded serially rather than as a whole
+//
+// Arguments:
+//
+//	block		- Block to be checked
+
+bool XzReader::IsSerialBlock(Block^ block)
+{
+	// Empty blocks have nothing to decode and large blocks are not held in memory as a whole
+	return ((block->UncompressedSize == 0) || (block->UncompressedSize > PARALLEL_BLOCK_LIMIT) || 
+		(block->UnpaddedSize > PARALLEL_BLOCK_LIMIT));
+}
+
 //--------------------------------------------------------------------------
 // XzReader::Length::get
 //
@@ -170,7 +444,10 @@ void XzReader::Flush(void)
 __int64 XzReader::Length::get(void)
 {
 	CHECK_DISPOSED(m_disposed);
-	throw gcnew NotSupportedException();
+
+	// The length of the stream is only known when the index could be read
+	if(!m_blocks) throw gcnew NotSupportedException();
+	return m_length;
 }
 
 //---------------------------------------------------------------------------
@@ -181,7 +458,11 @@ __int64 XzReader::Length::get(void)
 __int64 XzReader::Position::get(void)
 {
 	CHECK_DISPOSED(m_disposed);
-	throw gcnew NotSupportedException();
+
+	if(!m_blocks) throw gcnew NotSupportedException();
+
+	msclr::lock lock(m_lock);
+	return m_position;
 }
 
 //---------------------------------------------------------------------------
@@ -191,10 +472,35 @@ __int64 XzReader::Position::get(void)
 
 void XzReader::Position::set(__int64 value)
 {
-	UNREFERENCED_PARAMETER(value);
-
 	CHECK_DISPOSED(m_disposed);
-	throw gcnew NotSupportedException();
+
+	if(value < 0) throw gcnew ArgumentOutOfRangeException("value");
+	Seek(value, SeekOrigin::Begin);
+}
+
+//---------------------------------------------------------------------------
+// XzReader::QueueBlocks (private)
+//
+// Queues blocks for decoding until the decoding queue is full
+//
+// Arguments:
+//
+//	NONE
+
+void XzReader::QueueBlocks(void)
+{
+	msclr::lock lock(m_lock);
+
+	// The compressed data for each block is read here, the base stream is not thread-safe; decoding
+	// ahead stops at a block that is decoded serially
+	while((!m_pending->IsFull) && (m_nextblock < m_blocks->Count) && (!IsSerialBlock(m_blocks[m_nextblock]))) {
+
+		Block^ block = m_blocks[m_nextblock++];
+		array<unsigned __int8>^ data = ReadStreamBytes(block->Offset, static_cast<int>((block->UnpaddedSize + 3) & ~3));
+
+		m_pending->Enqueue(gcnew Func<Object^, array<unsigned __int8>^>(this, &XzReader::DecodeBlock), 
+			gcnew Tuple<Block^, array<unsigned __int8>^>(block, data));
+	}
 }
 
 //---------------------------------------------------------------------------
@@ -224,6 +530,56 @@ int XzReader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 	// If there is no buffer to read into or the stream is already done, return zero
 	if((count == 0) || (m_finished)) return 0;
 
+	// Parallel decompression decodes blocks ahead of the reader and returns them in order, once the
+	// stream has been repositioned the block that contains the current position is decoded on demand
+	if((m_pending) || (m_random)) {
+
+		int read = 0;						// Total bytes read from the stream
+
+		while(count > 0) {
+
+			// Copy data from the current block into the output buffer
+			if(m_outpos < m_out->Length) {
+
+				int next = Math::Min(m_out->Length - m_outpos, count);
+				Array::Copy(m_out, m_outpos, buffer, offset, next);
+
+				m_outpos += next;			// Move offset into the block data
+				m_position += next;			// Move the stream position
+				offset += next;				// Move offset into the output buffer
+				count -= next;				// Decrement the amount of data still to read
+				read += next;				// Increment the amount of data read
+				continue;
+			}
+
+			// Move on to the block that contains the current position
+			if(m_position >= m_length) break;
+
+			int block = Array::BinarySearch(m_positions, m_position);
+			if(block < 0) block = ~block - 1;
+
+			// Empty blocks share their position with the block that follows them
+			while(m_blocks[block]->UncompressedSize == 0) block++;
+
+			__int64 blockoffset = m_position - m_positions[block];
+
+			// Blocks that are too large to be decoded as a whole are decoded serially in chunks
+			if(IsSerialBlock(m_blocks[block])) {
+
+				m_out = ReadSerialBlock(block, blockoffset);
+				m_outpos = static_cast<int>(blockoffset - (m_serialout - m_out->Length));
+			}
+
+			else {
+
+				m_out = GetBlock(block);
+				m_outpos = static_cast<int>(blockoffset);
+			}
+		}
+
+		return read;
+	}
+
 	// Pin both the input and output byte arrays in memory
 	pin_ptr<unsigned __int8> pinin = &m_in[0];
 	pin_ptr<unsigned __int8> pinout = &buffer[0];
@@ -261,9 +617,270 @@ int XzReader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 	// If no input or output was generated on the last call, verify that the stream is finished
 	if((m_finished) && (!XzUnpacker_IsStreamWasFinished(m_unpacker))) throw gcnew InvalidDataException();
 
+	m_position += (count - availout);
 	return (count - availout);
 }
 
+//---------------------------------------------------------------------------
+// XzReader::ReadIndex (private)
+//
+// Reads the block locations from the index of every stream in the base stream
+//
+// Arguments:
+//
+//	NONE
+
+List<XzReader::Block^>^ XzReader::ReadIndex(void)
+{
+	List<Block^>^ blocks = gcnew List<Block^>();
+
+	__int64 start = m_stream->Position;
+	__int64 end = m_stream->Length;
+
+	try {
+
+		// Streams are located from the end of the base stream backwards, each stream footer leads to
+		// its index, which in turn provides the total size of the blocks and the stream header
+		while(end > start) {
+
+			if((end - start) < (XZ_STREAM_HEADER_SIZE + XZ_STREAM_FOOTER_SIZE)) return nullptr;
+			array<unsigned __int8>^ footer = ReadStreamBytes(end - XZ_STREAM_FOOTER_SIZE, XZ_STREAM_FOOTER_SIZE);
+
+			// Stream padding is a multiple of four null bytes that may follow any stream
+			if(BitConverter::ToUInt32(footer, 8) == 0) { end -= 4; continue; }
+
+			if((footer[10] != XZ_FOOTER_SIG[0]) || (footer[11] != XZ_FOOTER_SIG[1])) return nullptr;
+			if(CalculateCrc32(footer, 4, 4 + XZ_STREAM_FLAGS_SIZE) != BitConverter::ToUInt32(footer, 0)) return nullptr;
+
+			unsigned short flags = BitConverter::ToUInt16(footer, 8);
+			__int64 indexsize = (static_cast<__int64>(BitConverter::ToUInt32(footer, 4)) + 1) * 4;
+			if(indexsize > (end - start - XZ_STREAM_HEADER_SIZE - XZ_STREAM_FOOTER_SIZE)) return nullptr;
+
+			array<unsigned __int8>^ index = ReadStreamBytes(end - XZ_STREAM_FOOTER_SIZE - indexsize, static_cast<int>(indexsize));
+			if((index[0] != 0) || (CalculateCrc32(index, 0, index->Length - 4) != BitConverter::ToUInt32(index, index->Length - 4))) return nullptr;
+
+			// Index records are the unpadded and uncompressed size of each block in the stream
+			int offset = 1;
+			unsigned __int64 count = ReadVarInt(index, offset);
+			if(count > static_cast<unsigned __int64>(index->Length)) return nullptr;
+
+			array<unsigned __int64>^ unpadded = gcnew array<unsigned __int64>(static_cast<int>(count));
+			array<unsigned __int64>^ uncompressed = gcnew array<unsigned __int64>(static_cast<int>(count));
+			__int64 blocksize = 0;
+
+			for(int record = 0; record < static_cast<int>(count); record++) {
+
+				unpadded[record] = ReadVarInt(index, offset);
+				uncompressed[record] = ReadVarInt(index, offset);
+
+				// Every block has a header, empty and large blocks are kept and decoded serially
+				if(unpadded[record] == 0) return nullptr;
+
+				blocksize += (unpadded[record] + 3) & ~3;
+				if(offset > index->Length - 4) return nullptr;
+			}
+
+			// Verify the stream header matches the stream footer
+			__int64 streamstart = end - XZ_STREAM_FOOTER_SIZE - indexsize - blocksize - XZ_STREAM_HEADER_SIZE;
+			if(streamstart < start) return nullptr;
+
+			array<unsigned __int8>^ header = ReadStreamBytes(streamstart, XZ_STREAM_HEADER_SIZE);
+			for(int sig = 0; sig < XZ_SIG_SIZE; sig++) if(header[sig] != XZ_SIG[sig]) return nullptr;
+			if(BitConverter::ToUInt16(header, XZ_SIG_SIZE) != flags) return nullptr;
+			if(CalculateCrc32(header, XZ_SIG_SIZE, XZ_STREAM_FLAGS_SIZE) != BitConverter::ToUInt32(header, XZ_SIG_SIZE + XZ_STREAM_FLAGS_SIZE)) return nullptr;
+
+			// Insert this stream's blocks ahead of those of any streams that follow it
+			List<Block^>^ streamblocks = gcnew List<Block^>(static_cast<int>(count));
+			__int64 blockoffset = streamstart + XZ_STREAM_HEADER_SIZE;
+
+			for(int record = 0; record < static_cast<int>(count); record++) {
+
+				streamblocks->Add(gcnew Block(flags, blockoffset, unpadded[record], uncompressed[record]));
+				blockoffset += (unpadded[record] + 3) & ~3;
+			}
+
+			blocks->InsertRange(0, streamblocks);
+			end = streamstart;
+		}
+	}
+
+	// Anything that cannot be parsed is left to the sequential decoder to report
+	catch(InvalidDataException^) { return nullptr; }
+
+	finally { m_stream->Position = start; }
+
+	// Without any blocks there is nothing to seek within or decode in parallel
+	return (blocks->Count > 0) ? blocks : nullptr;
+}
+
+//---------------------------------------------------------------------------
+// XzReader::ReadSerialBlock (private)
+//
+// Decodes a block serially up to the chunk that contains an offset within the block
+//
+// Arguments:
+//
+//	index		- Index of the block in the stream index
+//	offset		- Uncompressed offset within the block
+
+array<unsigned __int8>^ XzReader::ReadSerialBlock(int index, __int64 offset)
+{
+	ECoderStatus				status;				// Decoder status flag
+
+	Block^ block = m_blocks[index];
+	__int64 padded = (block->UnpaddedSize + 3) & ~3;
+
+	// The decoder only moves forward, a different block or an earlier offset restarts it
+	if((index != m_serialblock) || (offset < m_serialout)) {
+
+		if(!m_serialunpacker) {
+
+			try { m_serialunpacker = new CXzUnpacker; XzUnpacker_Construct(m_serialunpacker, &g_Alloc); }
+			catch(Exception^) { throw gcnew OutOfMemoryException(); }
+		}
+
+		XzUnpacker_Init(m_serialunpacker);
+
+		// The block is wrapped in a stream of its own in the same manner as DecodeBlock
+		m_serialheader = CreateStreamHeader(block->Flags);
+		m_serialfooter = CreateStreamFooter(block);
+		m_serialblock = index;
+		m_serialin = 0;
+		m_serialout = 0;
+	}
+
+	__int64 inlength = m_serialheader->Length + padded + m_serialfooter->Length;
+	array<unsigned __int8>^ in = gcnew array<unsigned __int8>(BUFFER_SIZE);
+	array<unsigned __int8>^ out;
+
+	// Chunks that precede the one containing the offset are decoded and discarded
+	do {
+
+		__int64 remaining = block->UncompressedSize - m_serialout;
+		if(remaining <= 0) throw gcnew InvalidDataException();
+
+		out = gcnew array<unsigned __int8>(static_cast<int>(Math::Min(remaining, static_cast<__int64>(SERIAL_CHUNK_SIZE))));
+		bool last = (out->Length == remaining);
+
+		pin_ptr<unsigned __int8> pinin = &in[0];
+		pin_ptr<unsigned __int8> pinout = &out[0];
+		size_t outpos = 0;
+
+		while(true) {
+
+			// Fill the input buffer from the wrapper stream header, the block data and the wrapper footer
+			int length = 0;
+			__int64 position = m_serialin;
+
+			while((length < in->Length) && (position < inlength)) {
+
+				int next = 0;
+
+				if(position < m_serialheader->Length) {
+
+					next = static_cast<int>(Math::Min(m_serialheader->Length - position, static_cast<__int64>(in->Length - length)));
+					Array::Copy(m_serialheader, static_cast<int>(position), in, length, next);
+				}
+
+				else if(position < m_serialheader->Length + padded) {
+
+					m_stream->Position = block->Offset + (position - m_serialheader->Length);
+					next = m_stream->Read(in, length, static_cast<int>(Math::Min(m_serialheader->Length + padded - position, static_cast<__int64>(in->Length - length))));
+					if(next == 0) throw gcnew InvalidDataException();
+				}
+
+				else {
+
+					next = static_cast<int>(Math::Min(inlength - position, static_cast<__int64>(in->Length - length)));
+					Array::Copy(m_serialfooter, static_cast<int>(position - m_serialheader->Length - padded), in, length, next);
+				}
+
+				length += next;
+				position += next;
+			}
+
+			// Use local input/output size values, they are modified by XzUnpacker_Code
+			size_t insize = length;
+			size_t outsize = out->Length - outpos;
+
+			SRes result = XzUnpacker_Code(m_serialunpacker, &pinout[outpos], &outsize, &pinin[0], &insize, CODER_FINISH_ANY, &status);
+			if(result != SZ_OK) throw gcnew LzmaException(result);
+
+			m_serialin += insize;
+			outpos += outsize;
+
+			// The final chunk continues until the wrapper stream has been verified
+			if((outpos == static_cast<size_t>(out->Length)) && (!last)) break;
+			if((insize == 0) && (outsize == 0)) break;
+		}
+
+		// The block must produce exactly the size recorded in the index and finish the stream
+		if(outpos != static_cast<size_t>(out->Length)) throw gcnew InvalidDataException();
+		if((last) && (!XzUnpacker_IsStreamWasFinished(m_serialunpacker))) throw gcnew InvalidDataException();
+
+		m_serialout += out->Length;
+
+	} while(m_serialout <= offset);
+
+	return out;
+}
+
+//---------------------------------------------------------------------------
+// XzReader::ReadStreamBytes (private)
+//
+// Reads an exact range of bytes from the base stream
+//
+// Arguments:
+//
+//	position	- Base stream position to read from
+//	length		- Number of bytes to be read
+
+array<unsigned __int8>^ XzReader::ReadStreamBytes(__int64 position, int length)
+{
+	array<unsigned __int8>^ buffer = gcnew array<unsigned __int8>(length);
+	int offset = 0;
+
+	m_stream->Position = position;
+
+	while(offset < length) {
+
+		int read = m_stream->Read(buffer, offset, length - offset);
+		if(read == 0) throw gcnew InvalidDataException();
+
+		offset += read;
+	}
+
+	return buffer;
+}
+
+//---------------------------------------------------------------------------
+// XzReader::ReadVarInt (private, static)
+//
+// Reads an XZ variable-length integer from a buffer
+//
+// Arguments:
+//
+//	buffer		- Source buffer
+//	offset		- Offset within the buffer; advanced past the integer
+
+unsigned __int64 XzReader::ReadVarInt(array<unsigned __int8>^ buffer, int% offset)
+{
+	unsigned __int64 value = 0;
+
+	// Seven bits are stored in each byte, the high bit indicates that more bytes follow
+	for(int index = 0; index < MAXIMUM_VARINT_SIZE; index++) {
+
+		if(offset >= buffer->Length) break;
+
+		unsigned __int8 next = buffer[offset++];
+		value |= static_cast<unsigned __int64>(next & 0x7F) << (index * 7);
+
+		if((next & 0x80) == 0) return value;
+	}
+
+	throw gcnew InvalidDataException();
+}
+
 //---------------------------------------------------------------------------
 // XzReader::Seek
 //
@@ -276,11 +893,29 @@ int XzReader::Read(array<unsigned __int8>^ buffer, int offset, int count)
 
 __int64 XzReader::Seek(__int64 offset, SeekOrigin origin)
 {
-	UNREFERENCED_PARAMETER(offset);
-	UNREFERENCED_PARAMETER(origin);
-
 	CHECK_DISPOSED(m_disposed);
-	throw gcnew NotSupportedException();
+
+	// Seeking is only supported when the index could be read
+	if(!m_blocks) throw gcnew NotSupportedException();
+
+	msclr::lock lock(m_lock);
+
+	// Convert the offset into an absolute position within the uncompressed data
+	__int64 position = offset;
+	if(origin == SeekOrigin::Current) position += m_position;
+	else if(origin == SeekOrigin::End) position += m_length;
+	else if(origin != SeekOrigin::Begin) throw gcnew ArgumentOutOfRangeException("origin");
+
+	if(position < 0) throw gcnew IOException("An attempt was made to move the position before the beginning of the stream");
+
+	// The block that contains the new position is located on the next read
+	m_position = position;
+	m_out = gcnew array<unsigned __int8>(0);
+	m_outpos = 0;
+	m_random = true;
+	m_finished = false;
+
+	return m_position;
 }
 
 //---------------------------------------------------------------------------
@@ -321,6 +956,47 @@ void XzReader::Write(array<unsigned __int8>^ buffer, int offset, int count)
 	throw gcnew NotSupportedException();
 }
 
+//---------------------------------------------------------------------------
+// XzReader::WriteVarInt (private, static)
+//
+// Writes an XZ variable-length integer into a buffer
+//
+// Arguments:
+//
+//	buffer		- Destination buffer
+//	offset		- Offset within the buffer to write the integer
+//	value		- Value to be written
+
+int XzReader::WriteVarInt(array<unsigned __int8>^ buffer, int offset, unsigned __int64 value)
+{
+	int length = 0;
+
+	// Seven bits are stored in each byte, the high bit indicates that more bytes follow
+	while(value >= 0x80) {
+
+		buffer[offset + length++] = static_cast<unsigned __int8>(value | 0x80);
+		value >>= 7;
+	}
+
+	buffer[offset + length++] = static_cast<unsigned __int8>(value);
+	return length;
+}
+
+//---------------------------------------------------------------------------
+// XzReader::Block Constructor
+//
+// Arguments:
+//
+//	flags				- Stream flags of the stream containing the block
+//	offset				- Base stream offset of the block header
+//	unpaddedsize		- Unpadded size of the block from the index
+//	uncompressedsize	- Uncompressed size of the block from the index
+
+XzReader::Block::Block(unsigned short flags, __int64 offset, __int64 unpaddedsize, __int64 uncompressedsize) :
+	Flags(flags), Offset(offset), UnpaddedSize(unpaddedsize), UncompressedSize(uncompressedsize)
+{
+}
+
 //---------------------------------------------------------------------------
 
 } // zuki::io::compression
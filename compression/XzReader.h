@@ -25,10 +25,12 @@
 #pragma once
 
 #include <Xz.h>
+#include "TaskQueue.h"
 
 #pragma warning(push, 4)				// Enable maximum compiler warnings
 
 using namespace System;
+using namespace System::Collections::Generic;
 using namespace System::IO;
 
 namespace zuki::io::compression {
@@ -47,6 +49,8 @@ public:
 	//
 	XzReader(Stream^ stream);
 	XzReader(Stream^ stream, bool leaveopen);
+	XzReader(Stream^ stream, int threads, bool leaveopen);
+	XzReader(Stream^ stream, int threads, int maxpending, bool leaveopen);
 
 	//-----------------------------------------------------------------------
 	// Member Functions
@@ -130,11 +134,31 @@ public:
 
 private:
 
+	// BLOCK_CACHE_SIZE
+	//
+	// Maximum size of the recently decoded blocks kept in memory, in bytes
+	static const int BLOCK_CACHE_SIZE = (64 << 20);
+
 	// BUFFER_SIZE
 	//
 	// Size of the local input buffer, in bytes
 	static const int BUFFER_SIZE = 65536;
 
+	// MAXIMUM_VARINT_SIZE
+	//
+	// Maximum size of an XZ variable-length integer
+	static const int MAXIMUM_VARINT_SIZE = 9;
+
+	// PARALLEL_BLOCK_LIMIT
+	//
+	// Maximum size of a block that is decoded as a whole, larger blocks are decoded serially
+	static const int PARALLEL_BLOCK_LIMIT = (1 << 28);
+
+	// SERIAL_CHUNK_SIZE
+	//
+	// Size of the decoded chunks of a block that is decoded serially, in bytes
+	static const int SERIAL_CHUNK_SIZE = (4 << 20);
+
 	// Static Constructor
 	//
 	static XzReader();
@@ -144,6 +168,89 @@ private:
 	~XzReader();
 	!XzReader();
 
+	// Block
+	//
+	// Location and sizes of an XZ block as recorded in the stream index
+	ref class Block
+	{
+	public:
+
+		// Instance Constructor
+		//
+		Block(unsigned short flags, __int64 offset, __int64 unpaddedsize, __int64 uncompressedsize);
+
+		//-------------------------------------------------------------------
+		// Fields
+
+		initonly unsigned short		Flags;				// Stream flags
+		initonly __int64			Offset;				// Base stream offset
+		initonly __int64			UnpaddedSize;		// Unpadded block size
+		initonly __int64			UncompressedSize;	// Uncompressed block size
+	};
+
+	//-----------------------------------------------------------------------
+	// Private Member Functions
+
+	// CalculateCrc32 (static)
+	//
+	// Calculates the CRC32 of a range of bytes
+	static unsigned int CalculateCrc32(array<unsigned __int8>^ buffer, int offset, int count);
+
+	// CreateStreamFooter (static)
+	//
+	// Creates the index and stream footer that wrap a single block into a stream
+	static array<unsigned __int8>^ CreateStreamFooter(Block^ block);
+
+	// CreateStreamHeader (static)
+	//
+	// Creates the stream header that wraps a single block into a stream
+	static array<unsigned __int8>^ CreateStreamHeader(unsigned short flags);
+
+	// DecodeBlock
+	//
+	// Decodes a single XZ block into a managed byte array
+	array<unsigned __int8>^ DecodeBlock(Object^ state);
+
+	// GetBlock
+	//
+	// Gets the decoded data for a block from the cache or by decoding it
+	array<unsigned __int8>^ GetBlock(int index);
+
+	// IsSerialBlock (static)
+	//
+	// Determines if a block is decoded serially rather than as a whole
+	static bool IsSerialBlock(Block^ block);
+
+	// QueueBlocks
+	//
+	// Queues blocks for decoding until the decoding queue is full
+	void QueueBlocks(void);
+
+	// ReadIndex
+	//
+	// Reads the block locations from the index of every stream in the base stream
+	List<Block^>^ ReadIndex(void);
+
+	// ReadSerialBlock
+	//
+	// Decodes a block serially up to the chunk that contains an offset within the block
+	array<unsigned __int8>^ ReadSerialBlock(int index, __int64 offset);
+
+	// ReadStreamBytes
+	//
+	// Reads an exact range of bytes from the base stream
+	array<unsigned __int8>^ ReadStreamBytes(__int64 position, int length);
+
+	// ReadVarInt (static)
+	//
+	// Reads an XZ variable-length integer from a buffer
+	static unsigned __int64 ReadVarInt(array<unsigned __int8>^ buffer, int% offset);
+
+	// WriteVarInt (static)
+	//
+	// Writes an XZ variable-length integer into a buffer
+	static int WriteVarInt(array<unsigned __int8>^ buffer, int offset, unsigned __int64 value);
+
 	//-----------------------------------------------------------------------
 	// Member Variables
 
@@ -155,6 +262,23 @@ private:
 	size_t						m_inpos;			// Current position in the buffer
 	size_t						m_insize;			// Size of the input buffer data
 	CXzUnpacker*				m_unpacker;			// XZ unpacker instance
+	List<Block^>^				m_blocks;			// Blocks from the stream index
+	array<__int64>^				m_positions;		// Uncompressed offsets of the blocks
+	__int64						m_length;			// Uncompressed length of the stream
+	__int64						m_position;			// Current uncompressed position
+	bool						m_random;			// Flag if reading blocks by position
+	int							m_nextblock;		// Index of the next block to queue
+	TaskQueue<array<unsigned __int8>^>^	m_pending;	// Pending block decodes
+	array<unsigned __int8>^		m_out;				// Current decoded block
+	int							m_outpos;			// Position within the decoded block
+	LinkedList<KeyValuePair<int, array<unsigned __int8>^>>^	m_cache;	// Recently decoded blocks
+	__int64						m_cachesize;		// Size of the cached blocks
+	CXzUnpacker*				m_serialunpacker;	// Serial block unpacker instance
+	int							m_serialblock;		// Index of the serial block
+	array<unsigned __int8>^		m_serialheader;		// Serial block stream header
+	array<unsigned __int8>^		m_serialfooter;		// Serial block stream footer
+	__int64						m_serialin;			// Serial block input position
+	__int64						m_serialout;		// Serial block output position
 
 	Object^	m_lock = gcnew Object();		// Synchronization object
 };
@@ -0,0 +1,803 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "XzWriter.h"
+
+#include <Alloc.h>
+#include "LzmaException.h"
+
+// crcinit
+//
+// Helper function defined in crcinit.cpp; thunks to CrcGenerateTable
+extern void crcinit(void);
+
+#pragma managed(push, off)
+
+//---------------------------------------------------------------------------
+// BufferInStream
+//
+// ISeqInStream implementation that reads from an unmanaged memory buffer
+
+struct BufferInStream
+{
+	ISeqInStream		vt;				// ISeqInStream interface
+	uint8_t const*		data;			// Pointer to the remaining data
+	size_t				remaining;		// Length of the remaining data
+};
+
+//---------------------------------------------------------------------------
+// BufferInStream_Read
+//
+// Implements ISeqInStream::Read
+//
+// Arguments:
+//
+//	p			- Pointer to the BufferInStream instance
+//	buf			- Buffer to write the input data into
+//	size		- Size of the buffer / number of bytes written
+
+static SRes BufferInStream_Read(void* p, void* buf, size_t* size)
+{
+	BufferInStream* instance = reinterpret_cast<BufferInStream*>(p);
+
+	if(*size > instance->remaining) *size = instance->remaining;
+	if(*size) memcpy(buf, instance->data, *size);
+
+	instance->data += *size;
+	instance->remaining -= *size;
+
+	return SZ_OK;
+}
+
+//---------------------------------------------------------------------------
+// BufferOutStream
+//
+// ISeqOutStream implementation that writes into a fixed unmanaged memory buffer
+
+struct BufferOutStream
+{
+	ISeqOutStream		vt;				// ISeqOutStream interface
+	uint8_t*			data;			// Pointer to the output buffer
+	size_t				capacity;		// Length of the output buffer
+	size_t				written;		// Number of bytes written
+};
+
+//---------------------------------------------------------------------------
+// BufferOutStream_Write
+//
+// Implements ISeqOutStream::Write
+//
+// Arguments:
+//
+//	p			- Pointer to the BufferOutStream instance
+//	buf			- Buffer to read the output data from
+//	size		- Size of the output data buffer
+
+static size_t BufferOutStream_Write(void* p, void const* buf, size_t size)
+{
+	BufferOutStream* instance = reinterpret_cast<BufferOutStream*>(p);
+
+	// A short write is reported back to the encoder as SZ_ERROR_WRITE
+	if(size > (instance->capacity - instance->written)) size = instance->capacity - instance->written;
+	if(size) memcpy(instance->data + instance->written, buf, size);
+
+	instance->written += size;
+	return size;
+}
+
+#pragma managed(pop)
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// XzWriter Static Constructor (private)
+
+static XzWriter::XzWriter()
+{
+	crcinit();							// Initialize the CRC table
+}
+
+//---------------------------------------------------------------------------
+// XzWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+
+XzWriter::XzWriter(Stream^ stream) : XzWriter(stream, DefaultProperties(LzmaCompressionLevel::Default, 1), XzChecksum::Default, 0, false)
+{
+}
+
+//---------------------------------------------------------------------------
+// XzWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	level		- Indicates whether to emphasize speed or compression efficiency
+
+XzWriter::XzWriter(Stream^ stream, Compression::CompressionLevel level) : 
+	XzWriter(stream, DefaultProperties(LzmaCompressionLevel(level), 1), XzChecksum::Default, 0, false)
+{
+}
+
+//---------------------------------------------------------------------------
+// XzWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+XzWriter::XzWriter(Stream^ stream, bool leaveopen) : 
+	XzWriter(stream, DefaultProperties(LzmaCompressionLevel::Default, 1), XzChecksum::Default, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// XzWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	level		- Indicates the level of compression to use
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+XzWriter::XzWriter(Stream^ stream, Compression::CompressionLevel level, bool leaveopen) : 
+	XzWriter(stream, DefaultProperties(LzmaCompressionLevel(level), 1), XzChecksum::Default, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// XzWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	level		- Indicates the level of compression to use
+//	threads		- Number of threads to use for compression (zero = processor count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+XzWriter::XzWriter(Stream^ stream, Compression::CompressionLevel level, int threads, bool leaveopen) : 
+	XzWriter(stream, DefaultProperties(LzmaCompressionLevel(level), threads), XzChecksum::Default, 0, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// XzWriter Constructor (internal)
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	props		- LZMA2 encoder properties
+//	checksum	- Type of check to calculate for each block
+//	maxpending	- Maximum number of blocks in flight (zero = twice the block thread count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+XzWriter::XzWriter(Stream^ stream, CLzma2EncProps const& props, XzChecksum checksum, int maxpending, bool leaveopen) : m_disposed(false), 
+	m_stream(stream), m_leaveopen(leaveopen), m_props(nullptr), m_checkid(static_cast<unsigned int>(checksum)), m_inpos(0), m_totalin(0), 
+	m_blocks(0)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+	if(maxpending < 0) throw gcnew ArgumentOutOfRangeException("maxpending");
+
+	// Allocate and normalize a copy of the LZMA2 encoder properties
+	try { m_props = new CLzma2EncProps(props); }
+	catch(Exception^) { throw gcnew OutOfMemoryException(); }
+
+	// Normalizing the properties replaces the total thread count with the threads used by a single
+	// LZMA2 encoder, so the requested total has to be taken beforehand
+	int totalthreads = m_props->numTotalThreads;
+	Lzma2EncProps_Normalize(m_props);
+
+	// Each XZ block is sized to provide a full LZMA2 block to every thread assigned to it
+	__int64 blocksize = static_cast<__int64>(m_props->blockSize) * Math::Max(m_props->numBlockThreads, 1);
+	m_blocksize = static_cast<int>(Math::Min(blocksize, static_cast<__int64>(MAXIMUM_BLOCK_SIZE)));
+
+	// The threads that remain after each block has been given its own LZMA2 block and match finder
+	// threads are used to compress that many independent XZ blocks concurrently
+	int blockthreads = Math::Max(m_props->numBlockThreads, 1) * Math::Max(m_props->lzmaProps.numThreads, 1);
+	int threads = (totalthreads > 0) ? totalthreads / blockthreads : 1;
+	m_props->numTotalThreads = blockthreads;
+
+	if(threads > 1) m_pending = gcnew TaskQueue<Block^>(threads, (maxpending == 0) ? threads * 2 : maxpending);
+
+	m_in = gcnew array<unsigned __int8>(Math::Min(m_blocksize, INITIAL_BUFFER_SIZE));
+	m_index = gcnew MemoryStream();
+
+	// Write the XZ stream header: signature, stream flags and the CRC32 of the stream flags
+	array<unsigned __int8>^ header = gcnew array<unsigned __int8>(XZ_STREAM_HEADER_SIZE);
+	for(int index = 0; index < XZ_SIG_SIZE; index++) header[index] = XZ_SIG[index];
+	header[XZ_SIG_SIZE + 1] = static_cast<unsigned __int8>(m_checkid);
+
+	WriteCrc32(header, XZ_SIG_SIZE, XZ_STREAM_FLAGS_SIZE, XZ_SIG_SIZE + XZ_STREAM_FLAGS_SIZE);
+	m_stream->Write(header, 0, header->Length);
+}
+
+//---------------------------------------------------------------------------
+// XzWriter Destructor
+
+XzWriter::~XzWriter()
+{
+	if(m_disposed) return;
+
+	msclr::lock lock(m_lock);
+
+	// Compress and write the final block, then wait for any blocks still in flight
+	QueueNextBlock();
+
+	if(m_pending) {
+
+		WritePendingBlocks(true);
+		delete m_pending;
+	}
+
+	WriteIndex();							// Write the index and stream footer
+
+	delete m_index;							// Dispose of the index records
+	delete m_in;							// Dispose of the input buffer
+
+	if(!m_leaveopen) delete m_stream;		// Optionally dispose of the base stream
+
+	this->!XzWriter();
+	m_disposed = true;
+}
+
+//---------------------------------------------------------------------------
+// XzWriter Finalizer
+
+XzWriter::!XzWriter()
+{
+	if(m_props) { delete m_props; m_props = nullptr; }
+}
+
+//---------------------------------------------------------------------------
+// XzWriter::BaseStream::get
+//
+// Accesses the underlying base stream instance
+
+Stream^ XzWriter::BaseStream::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return m_stream;
+}
+
+//---------------------------------------------------------------------------
+// XzWriter::CanRead::get
+//
+// Gets a value indicating whether the current stream supports reading
+
+bool XzWriter::CanRead::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return false;
+}
+
+//---------------------------------------------------------------------------
+// XzWriter::CanSeek::get
+//
+// Gets a value indicating whether the current stream supports seeking
+
+bool XzWriter::CanSeek::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return false;
+}
+
+//---------------------------------------------------------------------------
+// XzWriter::CanWrite::get
+//
+// Gets a value indicating whether the current stream supports writing
+
+bool XzWriter::CanWrite::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return m_stream->CanWrite;
+}
+
+//---------------------------------------------------------------------------
+// XzWriter::CompressBlock (private)
+//
+// Compresses a single block of data into an independent XZ block
+//
+// Arguments:
+//
+//	state		- Uncompressed block data as a managed byte array
+
+XzWriter::Block^ XzWriter::CompressBlock(Object^ state)
+{
+	CXzCheck					check;						// Block check state
+	Byte						digest[XZ_CHECK_SIZE_MAX];	// Block check digest
+	Byte						props = 0;					// LZMA2 properties byte
+
+	array<unsigned __int8>^ in = safe_cast<array<unsigned __int8>^>(state);
+	int checksize = static_cast<int>(XzFlags_GetCheckSize(static_cast<CXzStreamFlags>(m_checkid)));
+
+	// LZMA2 falls back to stored chunks for incompressible data, which costs a few bytes per 64KiB;
+	// the output buffer also has room for the block header, the block padding and the check
+	int capacity = in->Length + (in->Length >> 10) + 64;
+	array<unsigned __int8>^ out = gcnew array<unsigned __int8>(BLOCK_HEADER_RESERVE + capacity + 3 + checksize);
+
+	// Pin both the input and output buffers in memory
+	pin_ptr<unsigned __int8> pinin = &in[0];
+	pin_ptr<unsigned __int8> pinout = &out[0];
+
+	// Each block is encoded with the shared properties, reduced to the size of this block
+	CLzma2EncProps blockprops = *m_props;
+	blockprops.lzmaProps.reduceSize = static_cast<UInt64>(in->Length);
+
+	BufferInStream instream = { { BufferInStream_Read }, pinin, static_cast<size_t>(in->Length) };
+	BufferOutStream outstream = { { BufferOutStream_Write }, &pinout[BLOCK_HEADER_RESERVE], static_cast<size_t>(capacity), 0 };
+
+	CLzma2EncHandle encoder = Lzma2Enc_Create(&g_Alloc, &g_BigAlloc);
+	if(encoder == nullptr) throw gcnew OutOfMemoryException();
+
+	try {
+
+		SRes result = Lzma2Enc_SetProps(encoder, &blockprops);
+		if(result == SZ_OK) {
+
+			props = Lzma2Enc_WriteProperties(encoder);
+			result = Lzma2Enc_Encode(encoder, &outstream.vt, &instream.vt, nullptr);
+		}
+
+		if(result != SZ_OK) throw gcnew LzmaException(result);
+	}
+
+	finally { Lzma2Enc_Destroy(encoder); }
+
+	int packsize = static_cast<int>(outstream.written);
+	int paddedsize = (packsize + 3) & ~3;
+
+	// Calculate the block check from the uncompressed data and append it after the block padding
+	XzCheck_Init(&check, m_checkid);
+	XzCheck_Update(&check, pinin, in->Length);
+	XzCheck_Final(&check, digest);
+	if(checksize) memcpy(&pinout[BLOCK_HEADER_RESERVE + paddedsize], digest, checksize);
+
+	// The block header records both sizes and a single LZMA2 filter, and is placed in the reserved
+	// space immediately ahead of the compressed data
+	array<unsigned __int8>^ header = gcnew array<unsigned __int8>(BLOCK_HEADER_RESERVE);
+	int headersize = 1;
+
+	header[headersize++] = XZ_BF_PACK_SIZE | XZ_BF_UNPACK_SIZE;
+	headersize += WriteVarInt(header, headersize, packsize);
+	headersize += WriteVarInt(header, headersize, in->Length);
+	header[headersize++] = XZ_ID_LZMA2;
+	header[headersize++] = 1;
+	header[headersize++] = props;
+
+	headersize = (headersize + 3) & ~3;
+	header[0] = static_cast<unsigned __int8>(headersize / 4);
+	WriteCrc32(header, 0, headersize, headersize);
+	headersize += CRC32_SIZE;
+
+	int offset = BLOCK_HEADER_RESERVE - headersize;
+	Array::Copy(header, 0, out, offset, headersize);
+
+	return gcnew Block(out, offset, headersize + paddedsize + checksize, headersize + packsize + checksize, in->Length);
+}
+
+//---------------------------------------------------------------------------
+// XzWriter::DefaultProperties (private, static)
+//
+// Generates the LZMA2 encoder properties used by the public constructors
+//
+// Arguments:
+//
+//	level		- Compression level
+//	threads		- Number of threads to use for compression (zero = processor count)
+
+CLzma2EncProps XzWriter::DefaultProperties(LzmaCompressionLevel level, int threads)
+{
+	CLzma2EncProps				props;			// LZMA2 encoder properties
+
+	if(threads < 0) throw gcnew ArgumentOutOfRangeException("threads");
+
+	// Zero threads indicates that the number of processors should be used
+	if(threads == 0) threads = Environment::ProcessorCount;
+
+	Lzma2EncProps_Init(&props);
+
+	// Each block is compressed by a single thread; multiple threads compress multiple blocks
+	props.lzmaProps.level = level;
+	props.lzmaProps.numThreads = 1;
+	props.blockSize = DEFAULT_BLOCK_SIZE;
+	props.numBlockThreads = 1;
+	props.numTotalThreads = threads;
+
+	return props;
+}
+
+//---------------------------------------------------------------------------
+// XzWriter::Flush
+//
+// Clears all buffers for this stream and causes any buffered data to be written
+//
+// Arguments:
+//
+//	NONE
+
+void XzWriter::Flush(void)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	msclr::lock lock(m_lock);
+
+	// End the current block early and wait for all blocks to be written
+	QueueNextBlock();
+	if(m_pending) WritePendingBlocks(true);
+
+	m_stream->Flush();
+}
+
+//--------------------------------------------------------------------------
+// XzWriter::Length::get
+//
+// Gets the length in bytes of the stream
+
+__int64 XzWriter::Length::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// XzWriter::Position::get
+//
+// Gets the current position within the stream
+
+__int64 XzWriter::Position::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	msclr::lock lock(m_lock);
+	return m_totalin + m_inpos;
+}
+
+//---------------------------------------------------------------------------
+// XzWriter::Position::set
+//
+// Sets the current position within the stream
+
+void XzWriter::Position::set(__int64 value)
+{
+	UNREFERENCED_PARAMETER(value);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// XzWriter::QueueNextBlock (private)
+//
+// Queues the contents of the buffer for compression as a single block
+//
+// Arguments:
+//
+//	NONE
+
+void XzWriter::QueueNextBlock(void)
+{
+	msclr::lock lock(m_lock);
+
+	// XZ streams may contain no blocks at all, an empty buffer is never compressed
+	if(m_inpos == 0) return;
+
+	// A partial block is trimmed to the actual length of the data
+	array<unsigned __int8>^ block = m_in;
+	if(m_inpos < block->Length) Array::Resize<unsigned __int8>(block, m_inpos);
+
+	// Without a compression queue the block is compressed and written immediately
+	if(m_pending) {
+
+		// Make room in the queue for the block and start compressing it
+		WritePendingBlocks(false);
+		m_pending->Enqueue(gcnew Func<Object^, Block^>(this, &XzWriter::CompressBlock), block);
+
+		// The queued buffer now belongs to the worker, a new one is needed for the next block
+		if(Object::ReferenceEquals(block, m_in)) m_in = gcnew array<unsigned __int8>(m_blocksize);
+	}
+
+	else WriteBlock(CompressBlock(block));
+
+	m_totalin += block->Length;
+	m_inpos = 0;
+}
+
+//---------------------------------------------------------------------------
+// XzWriter::Read
+//
+// Reads a sequence of bytes from the current stream and advances the position within the stream
+//
+// Arguments:
+//
+//	buffer		- Destination data buffer
+//	offset		- Offset within buffer to begin copying data
+//	count		- Maximum number of bytes to write into the destination buffer
+
+int XzWriter::Read(array<unsigned __int8>^ buffer, int offset, int count)
+{
+	UNREFERENCED_PARAMETER(buffer);
+	UNREFERENCED_PARAMETER(offset);
+	UNREFERENCED_PARAMETER(count);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// XzWriter::Seek
+//
+// Sets the position within the current stream
+//
+// Arguments:
+//
+//	offset		- Byte offset relative to origin
+//	origin		- Reference point used to obtain the new position
+
+__int64 XzWriter::Seek(__int64 offset, SeekOrigin origin)
+{
+	UNREFERENCED_PARAMETER(offset);
+	UNREFERENCED_PARAMETER(origin);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// XzWriter::SetLength
+//
+// Sets the length of the current stream
+//
+// Arguments:
+//
+//	value		- Desired length of the current stream in bytes
+
+void XzWriter::SetLength(__int64 value)
+{
+	UNREFERENCED_PARAMETER(value);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// XzWriter::Write
+//
+// Writes a sequence of bytes to the current stream and advances the current position
+//
+// Arguments:
+//
+//	buffer		- Source data buffer 
+
+void XzWriter::Write(array<unsigned __int8>^ buffer)
+{
+	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
+
+	CHECK_DISPOSED(m_disposed);
+	Write(buffer, 0, buffer->Length);
+}
+
+//---------------------------------------------------------------------------
+// XzWriter::Write
+//
+// Writes a sequence of bytes to the current stream and advances the current position
+//
+// Arguments:
+//
+//	buffer		- Source data buffer 
+//	offset		- Offset within buffer to begin copying from
+//	count		- Maximum number of bytes to read from the source buffer
+
+void XzWriter::Write(array<unsigned __int8>^ buffer, int offset, int count)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
+	if(offset < 0) throw gcnew ArgumentOutOfRangeException("offset");
+	if(count < 0) throw gcnew ArgumentOutOfRangeException("count");
+	if((offset + count) > buffer->Length) throw gcnew ArgumentException("The sum of offset and count is larger than the buffer length");
+
+	msclr::lock lock(m_lock);
+
+	// Buffer the input data and queue it in block-sized chunks
+	while(count > 0) {
+
+		// The input buffer grows toward the block size as it fills so that small streams never allocate a full block
+		if(m_inpos == m_in->Length) Array::Resize<unsigned __int8>(m_in, static_cast<int>(Math::Min(m_in->Length * 2LL, static_cast<__int64>(m_blocksize))));
+
+		int next = Math::Min(m_in->Length - m_inpos, count);
+		Array::Copy(buffer, offset, m_in, m_inpos, next);
+
+		m_inpos += next;				// Increment length of buffer
+		offset += next;					// Move offset into the source buffer
+		count -= next;					// Decrement bytes remaining
+
+		if(m_inpos == m_blocksize) QueueNextBlock();
+	}
+}
+
+//---------------------------------------------------------------------------
+// XzWriter::WriteBlock (private)
+//
+// Writes a compressed block to the base stream and records it in the index
+//
+// Arguments:
+//
+//	block		- Compressed block to be written
+
+void XzWriter::WriteBlock(Block^ block)
+{
+	array<unsigned __int8>^ record = gcnew array<unsigned __int8>(MAXIMUM_VARINT_SIZE * 2);
+
+	msclr::lock lock(m_lock);
+
+	m_stream->Write(block->Data, block->Offset, block->Length);
+
+	// Each index record is the unpadded size and the uncompressed size of the block
+	int length = WriteVarInt(record, 0, block->UnpaddedSize);
+	length += WriteVarInt(record, length, block->UncompressedSize);
+
+	m_index->Write(record, 0, length);
+	m_blocks++;
+}
+
+//---------------------------------------------------------------------------
+// XzWriter::WriteCrc32 (private, static)
+//
+// Calculates the CRC32 of a range of bytes and writes it into the buffer
+//
+// Arguments:
+//
+//	buffer		- Buffer containing the data and the CRC32 destination
+//	offset		- Offset of the data within the buffer
+//	count		- Length of the data within the buffer
+//	destination	- Offset within the buffer to write the CRC32
+
+void XzWriter::WriteCrc32(array<unsigned __int8>^ buffer, int offset, int count, int destination)
+{
+	CXzCheck					check;						// CRC32 check state
+	Byte						digest[XZ_CHECK_SIZE_MAX];	// CRC32 digest
+
+	pin_ptr<unsigned __int8> pinbuffer = &buffer[0];
+
+	// XzCheck_Final writes the CRC32 in the little-endian order required by the container
+	XzCheck_Init(&check, XZ_CHECK_CRC32);
+	XzCheck_Update(&check, &pinbuffer[offset], count);
+	XzCheck_Final(&check, digest);
+
+	memcpy(&pinbuffer[destination], digest, CRC32_SIZE);
+}
+
+//---------------------------------------------------------------------------
+// XzWriter::WriteIndex (private)
+//
+// Writes the XZ index and stream footer to the base stream
+//
+// Arguments:
+//
+//	NONE
+
+void XzWriter::WriteIndex(void)
+{
+	msclr::lock lock(m_lock);
+
+	array<unsigned __int8>^ records = m_index->ToArray();
+
+	// The index is an indicator byte, the number of records, the records, padding and a CRC32
+	array<unsigned __int8>^ index = gcnew array<unsigned __int8>(1 + MAXIMUM_VARINT_SIZE + records->Length + 3 + CRC32_SIZE);
+	int length = 1;
+
+	length += WriteVarInt(index, length, m_blocks);
+	Array::Copy(records, 0, index, length, records->Length);
+	length += records->Length;
+
+	length = (length + 3) & ~3;
+	WriteCrc32(index, 0, length, length);
+	length += CRC32_SIZE;
+
+	m_stream->Write(index, 0, length);
+
+	// The stream footer is a CRC32, the index size in 4-byte units less one, the stream flags and the footer magic
+	array<unsigned __int8>^ footer = gcnew array<unsigned __int8>(XZ_STREAM_FOOTER_SIZE);
+	unsigned int backwardsize = static_cast<unsigned int>(length / 4) - 1;
+
+	footer[4] = static_cast<unsigned __int8>(backwardsize);
+	footer[5] = static_cast<unsigned __int8>(backwardsize >> 8);
+	footer[6] = static_cast<unsigned __int8>(backwardsize >> 16);
+	footer[7] = static_cast<unsigned __int8>(backwardsize >> 24);
+	footer[9] = static_cast<unsigned __int8>(m_checkid);
+	footer[10] = XZ_FOOTER_SIG[0];
+	footer[11] = XZ_FOOTER_SIG[1];
+
+	WriteCrc32(footer, CRC32_SIZE, CRC32_SIZE + XZ_STREAM_FLAGS_SIZE, 0);
+	m_stream->Write(footer, 0, footer->Length);
+}
+
+//---------------------------------------------------------------------------
+// XzWriter::WritePendingBlocks (private)
+//
+// Writes completed blocks from the compression queue to the base stream
+//
+// Arguments:
+//
+//	all			- Flag to write all pending blocks rather than just make room
+
+void XzWriter::WritePendingBlocks(bool all)
+{
+	msclr::lock lock(m_lock);
+
+	// Wait for the oldest block(s) to finish and write them to the output stream in order
+	while((all) ? !m_pending->IsEmpty : m_pending->IsFull) WriteBlock(m_pending->Dequeue());
+}
+
+//---------------------------------------------------------------------------
+// XzWriter::WriteVarInt (private, static)
+//
+// Writes an XZ variable-length integer into a buffer
+//
+// Arguments:
+//
+//	buffer		- Destination buffer
+//	offset		- Offset within the buffer to write the integer
+//	value		- Value to be written
+
+int XzWriter::WriteVarInt(array<unsigned __int8>^ buffer, int offset, unsigned __int64 value)
+{
+	int length = 0;
+
+	// Seven bits are stored in each byte, the high bit indicates that more bytes follow
+	while(value >= 0x80) {
+
+		buffer[offset + length++] = static_cast<unsigned __int8>(value | 0x80);
+		value >>= 7;
+	}
+
+	buffer[offset + length++] = static_cast<unsigned __int8>(value);
+	return length;
+}
+
+//---------------------------------------------------------------------------
+// XzWriter::Block Constructor
+//
+// Arguments:
+//
+//	data				- Buffer containing the compressed block
+//	offset				- Offset of the compressed block within the buffer
+//	length				- Length of the compressed block, including padding and check
+//	unpaddedsize		- Unpadded size of the block for the index
+//	uncompressedsize	- Uncompressed size of the block for the index
+
+XzWriter::Block::Block(array<unsigned __int8>^ data, int offset, int length, __int64 unpaddedsize, __int64 uncompressedsize) :
+	Data(data), Offset(offset), Length(length), UnpaddedSize(unpaddedsize), UncompressedSize(uncompressedsize)
+{
+}
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
@@ -0,0 +1,279 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#ifndef __XZWRITER_H_
+#define __XZWRITER_H_
+#pragma once
+
+#include <Lzma2Enc.h>
+#include <Xz.h>
+#include "LzmaCompressionLevel.h"
+#include "TaskQueue.h"
+#include "XzChecksum.h"
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+using namespace System;
+using namespace System::IO;
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// Class XzWriter
+//
+// XZ-based compression stream implementation
+//---------------------------------------------------------------------------
+
+public ref class XzWriter : public Stream
+{
+public:
+
+	// Instance Constructors
+	//
+	XzWriter(Stream^ stream);
+	XzWriter(Stream^ stream, Compression::CompressionLevel level);
+	XzWriter(Stream^ stream, bool leaveopen);
+	XzWriter(Stream^ stream, Compression::CompressionLevel level, bool leaveopen);
+	XzWriter(Stream^ stream, Compression::CompressionLevel level, int threads, bool leaveopen);
+
+	//-----------------------------------------------------------------------
+	// Member Functions
+
+	// Flush (Stream)
+	//
+	// Clears all buffers for this stream and causes any buffered data to be written
+	virtual void Flush(void) override;
+
+	// Read (Stream)
+	//
+	// Reads a sequence of bytes from the current stream and advances the position within the stream
+	virtual int Read(array<unsigned __int8>^ buffer, int offset, int count) override;
+
+	// Seek (Stream)
+	//
+	// Sets the position within the current stream
+	virtual __int64 Seek(__int64 offset, SeekOrigin origin) override;
+
+	// SetLength (Stream)
+	//
+	// Sets the length of the current stream
+	virtual void SetLength(__int64 value) override;
+
+	// Write
+	//
+	// Writes a sequence of bytes to the current stream and advances the current position
+	void Write(array<unsigned __int8>^ buffer);
+
+	// Write (Stream)
+	//
+	// Writes a sequence of bytes to the current stream and advances the current position
+	virtual void Write(array<unsigned __int8>^ buffer, int offset, int count) override;
+
+	//-----------------------------------------------------------------------
+	// Properties
+
+	// BaseStream
+	//
+	// Exposes the underlying base stream instance
+	property Stream^ BaseStream
+	{
+		Stream^ get(void);
+	}
+
+	// CanRead (Stream)
+	//
+	// Gets a value indicating whether the current stream supports reading
+	property bool CanRead
+	{
+		virtual bool get(void) override;
+	}
+
+	// CanSeek (Stream)
+	//
+	// Gets a value indicating whether the current stream supports seeking
+	property bool CanSeek
+	{
+		virtual bool get(void) override;
+	}
+
+	// CanWrite (Stream)
+	//
+	// Gets a value indicating whether the current stream supports writing
+	property bool CanWrite
+	{
+		virtual bool get(void) override;
+	}
+
+	// Length (Stream)
+	//
+	// Gets the length in bytes of the stream
+	property __int64 Length
+	{
+		virtual __int64 get(void) override;
+	}
+
+	// Position (Stream)
+	//
+	// Gets or sets the current position within the stream
+	property __int64 Position
+	{
+		virtual __int64 get(void) override;
+		void set(__int64 value) override;
+	}
+
+internal:
+
+	// Instance Constructor
+	//
+	XzWriter(Stream^ stream, CLzma2EncProps const& props, XzChecksum checksum, int maxpending, bool leaveopen);
+
+private:
+
+	// Static Constructor
+	//
+	static XzWriter();
+
+	// Destructor / Finalizer
+	//
+	~XzWriter();
+	!XzWriter();
+
+	// BLOCK_HEADER_RESERVE
+	//
+	// Space reserved ahead of the compressed data for the block header
+	static const int BLOCK_HEADER_RESERVE = 32;
+
+	// CRC32_SIZE
+	//
+	// Size of a CRC32 field in the XZ container
+	static const int CRC32_SIZE = 4;
+
+	// DEFAULT_BLOCK_SIZE
+	//
+	// Default LZMA2 block size used by the public constructors
+	static const int DEFAULT_BLOCK_SIZE = (8 << 20);
+
+	// INITIAL_BUFFER_SIZE
+	//
+	// Initial size of the input buffer, in bytes
+	static const int INITIAL_BUFFER_SIZE = 65536;
+
+	// MAXIMUM_BLOCK_SIZE
+	//
+	// Maximum size of a single XZ block
+	static const int MAXIMUM_BLOCK_SIZE = (1 << 30);
+
+	// MAXIMUM_VARINT_SIZE
+	//
+	// Maximum size of an XZ variable-length integer
+	static const int MAXIMUM_VARINT_SIZE = 9;
+
+	// Block
+	//
+	// Compressed XZ block and the information required to index it
+	ref class Block
+	{
+	public:
+
+		// Instance Constructor
+		//
+		Block(array<unsigned __int8>^ data, int offset, int length, __int64 unpaddedsize, __int64 uncompressedsize);
+
+		//-------------------------------------------------------------------
+		// Fields
+
+		initonly array<unsigned __int8>^	Data;				// Block data
+		initonly int						Offset;				// Offset of the block data
+		initonly int						Length;				// Length of the block data
+		initonly __int64					UnpaddedSize;		// Unpadded size of the block
+		initonly __int64					UncompressedSize;	// Uncompressed size of the block
+	};
+
+	//-----------------------------------------------------------------------
+	// Private Member Functions
+
+	// CompressBlock
+	//
+	// Compresses a single block of data into an independent XZ block
+	Block^ CompressBlock(Object^ state);
+
+	// DefaultProperties (static)
+	//
+	// Generates the LZMA2 encoder properties used by the public constructors
+	static CLzma2EncProps DefaultProperties(LzmaCompressionLevel level, int threads);
+
+	// QueueNextBlock
+	//
+	// Queues the contents of the buffer for compression as a single block
+	void QueueNextBlock(void);
+
+	// WriteBlock
+	//
+	// Writes a compressed block to the base stream and records it in the index
+	void WriteBlock(Block^ block);
+
+	// WriteCrc32 (static)
+	//
+	// Calculates the CRC32 of a range of bytes and writes it into the buffer
+	static void WriteCrc32(array<unsigned __int8>^ buffer, int offset, int count, int destination);
+
+	// WriteIndex
+	//
+	// Writes the XZ index and stream footer to the base stream
+	void WriteIndex(void);
+
+	// WritePendingBlocks
+	//
+	// Writes completed blocks from the compression queue to the base stream
+	void WritePendingBlocks(bool all);
+
+	// WriteVarInt (static)
+	//
+	// Writes an XZ variable-length integer into a buffer
+	static int WriteVarInt(array<unsigned __int8>^ buffer, int offset, unsigned __int64 value);
+
+	//-----------------------------------------------------------------------
+	// Member Variables
+
+	bool							m_disposed;		// Object disposal flag
+	Stream^							m_stream;		// Base Stream instance
+	bool							m_leaveopen;	// Flag to leave base stream open
+	CLzma2EncProps*					m_props;		// LZMA2 encoder properties
+	initonly unsigned int			m_checkid;		// Block check type identifier
+	initonly int					m_blocksize;	// Size of each XZ block
+	TaskQueue<Block^>^				m_pending;		// Pending block compressions
+	array<unsigned __int8>^			m_in;			// Input data buffer
+	int								m_inpos;		// Position within the input buffer
+	__int64							m_totalin;		// Total queued input data
+	MemoryStream^					m_index;		// Encoded index records
+	__int64							m_blocks;		// Number of blocks written
+
+	Object^	m_lock = gcnew Object();		// Synchronization object
+};
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
+
+#endif	// __XZWRITER_H_
@@ -0,0 +1,186 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// Zstandard Library
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// 
+// * Neither the name Facebook nor the names of its contributors may be used to
+//   endorse or promote products derived from this software without specific
+//   prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//---------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "ZstdCompressionLevel.h"
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// ZstdCompressionLevel Constructor
+//
+// Arguments:
+//
+//	level		- Compression level to use as an integer
+
+ZstdCompressionLevel::ZstdCompressionLevel(int level) : m_level(level)
+{
+	// Negative levels trade compression ratio for speed, zero selects the library default
+	if((level < ZSTD_minCLevel()) || (level > ZSTD_maxCLevel())) throw gcnew ArgumentOutOfRangeException("level");
+}
+
+//---------------------------------------------------------------------------
+// ZstdCompressionLevel Constructor
+//
+// Arguments:
+//
+//	level		- System::IO::Compression::CompressionLevel to convert
+
+ZstdCompressionLevel::ZstdCompressionLevel(Compression::CompressionLevel level)
+{
+	if(level == Compression::CompressionLevel::Fastest) m_level = 1;
+	else if(level == Compression::CompressionLevel::Optimal) m_level = 19;
+	else throw gcnew ArgumentOutOfRangeException("level");
+}
+
+//---------------------------------------------------------------------------
+// ZstdCompressionLevel::operator == (static)
+
+bool ZstdCompressionLevel::operator==(ZstdCompressionLevel lhs, ZstdCompressionLevel rhs)
+{
+	return lhs.m_level == rhs.m_level;
+}
+
+//---------------------------------------------------------------------------
+// ZstdCompressionLevel::operator != (static)
+
+bool ZstdCompressionLevel::operator!=(ZstdCompressionLevel lhs, ZstdCompressionLevel rhs)
+{
+	return lhs.m_level != rhs.m_level;
+}
+
+//---------------------------------------------------------------------------
+// ZstdCompressionLevel::operator ZstdCompressionLevel (static)
+
+ZstdCompressionLevel::operator ZstdCompressionLevel(int level)
+{
+	return ZstdCompressionLevel(level);
+}
+
+//---------------------------------------------------------------------------
+// ZstdCompressionLevel::operator int (static)
+
+ZstdCompressionLevel::operator int(ZstdCompressionLevel rhs)
+{
+	return rhs.m_level;
+}
+
+//---------------------------------------------------------------------------
+// ZstdCompressionLevel::Equals
+//
+// Compares this ZstdCompressionLevel to another ZstdCompressionLevel
+//
+// Arguments:
+//
+//	rhs		- Right-hand ZstdCompressionLevel to compare against
+
+bool ZstdCompressionLevel::Equals(ZstdCompressionLevel rhs)
+{
+	return (*this == rhs);
+}
+
+//---------------------------------------------------------------------------
+// ZstdCompressionLevel::Equals
+//
+// Overrides Object::Equals()
+//
+// Arguments:
+//
+//	rhs		- Right-hand object instance to compare against
+
+bool ZstdCompressionLevel::Equals(Object^ rhs)
+{
+	if(Object::ReferenceEquals(rhs, nullptr)) return false;
+
+	// Convert the provided object into a ZstdCompressionLevel instance
+	ZstdCompressionLevel^ rhsref = dynamic_cast<ZstdCompressionLevel^>(rhs);
+	if(rhsref == nullptr) return false;
+
+	return (*this == *rhsref);
+}
+
+//---------------------------------------------------------------------------
+// ZstdCompressionLevel::GetHashCode
+//
+// Overrides Object::GetHashCode()
+//
+// Arguments:
+//
+//	NONE
+
+int ZstdCompressionLevel::GetHashCode(void)
+{
+	return m_level.GetHashCode();
+}
+
+//---------------------------------------------------------------------------
+// ZstdCompressionLevel::ToString
+//
+// Overrides Object::ToString()
+//
+// Arguments:
+//
+//	NONE
+
+String^ ZstdCompressionLevel::ToString(void)
+{
+	return m_level.ToString();
+}
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
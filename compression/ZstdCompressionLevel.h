@@ -0,0 +1,151 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// Zstandard Library
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// 
+// * Neither the name Facebook nor the names of its contributors may be used to
+//   endorse or promote products derived from this software without specific
+//   prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//---------------------------------------------------------------------------
+
+#ifndef __ZSTDCOMPRESSIONLEVEL_H_
+#define __ZSTDCOMPRESSIONLEVEL_H_
+#pragma once
+
+#include <zstd.h>
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+using namespace System;
+using namespace System::IO;
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// Class ZstdCompressionLevel
+//
+// Indicates the compression level to use with the Zstandard encoder
+//---------------------------------------------------------------------------
+
+public value class ZstdCompressionLevel
+{
+public:
+
+	// Instance Constructors
+	//
+	ZstdCompressionLevel(int level);
+	ZstdCompressionLevel(Compression::CompressionLevel level);
+
+	//-----------------------------------------------------------------------
+	// Overloaded Operators
+
+	// operator== (static)
+	//
+	static bool operator==(ZstdCompressionLevel lhs, ZstdCompressionLevel rhs);
+
+	// operator!= (static)
+	//
+	static bool operator!=(ZstdCompressionLevel lhs, ZstdCompressionLevel rhs);
+
+	// operator ZstdCompressionLevel (static)
+	//
+	static operator ZstdCompressionLevel(int level);
+
+	//-----------------------------------------------------------------------
+	// Member Functions
+
+	// Equals
+	//
+	// Overrides Object::Equals()
+	virtual bool Equals(Object^ rhs) override;
+
+	// Equals
+	//
+	// Compares this ZstdCompressionLevel to another ZstdCompressionLevel
+	bool Equals(ZstdCompressionLevel rhs);
+
+	// GetHashCode
+	//
+	// Overrides Object::GetHashCode()
+	virtual int GetHashCode(void) override;
+
+	// ToString
+	//
+	// Overrides Object::ToString()
+	virtual String^ ToString(void) override;
+
+	//-----------------------------------------------------------------------
+	// Fields
+
+	static initonly ZstdCompressionLevel Default	= ZstdCompressionLevel(ZSTD_CLEVEL_DEFAULT);
+	static initonly ZstdCompressionLevel Fastest	= ZstdCompressionLevel(1);
+	static initonly ZstdCompressionLevel Optimal	= ZstdCompressionLevel(19);
+
+internal:
+
+	//-----------------------------------------------------------------------
+	// Internal Operators
+
+	// operator int
+	//
+	// Exposes the value as an integer
+	static operator int(ZstdCompressionLevel rhs);
+
+private:
+
+	//-----------------------------------------------------------------------
+	// Member Variables
+
+	int							m_level;		// Underlying compression level
+};
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
+
+#endif	// __ZSTDCOMPRESSIONLEVEL_H_
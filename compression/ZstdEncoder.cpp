@@ -0,0 +1,277 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// Zstandard Library
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// 
+// * Neither the name Facebook nor the names of its contributors may be used to
+//   endorse or promote products derived from this software without specific
+//   prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//---------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "ZstdEncoder.h"
+
+#include "ZstdWriter.h"
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// ZstdEncoder Constructor
+//
+// Arguments:
+//
+//	NONE
+
+ZstdEncoder::ZstdEncoder() : m_level(ZstdCompressionLevel::Default), m_checksum(true), m_threads(1), 
+	m_windowsize(ZstdWindowSize::Default)
+{
+}
+
+//---------------------------------------------------------------------------
+// ZstdEncoder::CompressionLevel::get
+//
+// Gets the encoder compression level value
+
+ZstdCompressionLevel ZstdEncoder::CompressionLevel::get(void)
+{
+	return m_level;
+}
+
+//---------------------------------------------------------------------------
+// ZstdEncoder::CompressionLevel::set
+//
+// Sets the encoder compression level value
+
+void ZstdEncoder::CompressionLevel::set(ZstdCompressionLevel value)
+{
+	m_level = value;
+}
+
+//---------------------------------------------------------------------------
+// ZstdEncoder::ContentChecksum::get
+//
+// Gets a flag indicating if a content checksum should be written
+
+bool ZstdEncoder::ContentChecksum::get(void)
+{
+	return m_checksum;
+}
+
+//---------------------------------------------------------------------------
+// ZstdEncoder::ContentChecksum::set
+//
+// Sets a flag indicating if a content checksum should be written
+
+void ZstdEncoder::ContentChecksum::set(bool value)
+{
+	m_checksum = value;
+}
+
+//---------------------------------------------------------------------------
+// ZstdEncoder::MaximumThreads::get
+//
+// Gets the number of worker threads to use for compression
+
+int ZstdEncoder::MaximumThreads::get(void)
+{
+	return m_threads;
+}
+
+//---------------------------------------------------------------------------
+// ZstdEncoder::MaximumThreads::set
+//
+// Sets the number of worker threads to use for compression
+
+void ZstdEncoder::MaximumThreads::set(int value)
+{
+	if(value < 0) throw gcnew ArgumentOutOfRangeException("value");
+	m_threads = value;
+}
+
+//---------------------------------------------------------------------------
+// ZstdEncoder::WindowSize::get
+//
+// Gets the encoder window size
+
+ZstdWindowSize ZstdEncoder::WindowSize::get(void)
+{
+	return m_windowsize;
+}
+
+//---------------------------------------------------------------------------
+// ZstdEncoder::WindowSize::set
+//
+// Sets the encoder window size
+
+void ZstdEncoder::WindowSize::set(ZstdWindowSize value)
+{
+	m_windowsize = value;
+}
+
+//---------------------------------------------------------------------------
+// ZstdEncoder::Encode
+//
+// Compresses an input stream into an array of bytes
+//
+// Arguments:
+//
+//	instream		- Input stream to be compressed
+
+array<unsigned __int8>^ ZstdEncoder::Encode(Stream^ instream)
+{
+	if(Object::ReferenceEquals(instream, nullptr)) throw gcnew ArgumentNullException("instream");
+
+	msclr::auto_handle<MemoryStream> outstream(gcnew MemoryStream());
+	Encode(instream, outstream.get());
+	
+	return outstream->ToArray();
+}
+
+//---------------------------------------------------------------------------
+// ZstdEncoder::Encode
+//
+// Compresses an input array of bytes
+//
+// Arguments:
+//
+//	buffer			- Input buffer of data to be compressed
+
+array<unsigned __int8>^ ZstdEncoder::Encode(array<unsigned __int8>^ buffer)
+{
+	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
+
+	return Encode(buffer, 0, buffer->Length);
+}
+
+//---------------------------------------------------------------------------
+// ZstdEncoder::Encode
+//
+// Compresses an input array of bytes
+//
+// Arguments:
+//
+//	buffer			- Input buffer of data to be compressed
+//	offset			- Offset within the buffer to begin reading
+//	count			- Maximum number of bytes to read from buffer
+
+array<unsigned __int8>^ ZstdEncoder::Encode(array<unsigned __int8>^ buffer, int offset, int count)
+{
+	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
+
+	msclr::auto_handle<MemoryStream> instream(gcnew MemoryStream(buffer, offset, count, false));
+	msclr::auto_handle<MemoryStream> outstream(gcnew MemoryStream());
+
+	Encode(instream.get(), outstream.get());
+
+	return outstream->ToArray();
+}
+	
+//---------------------------------------------------------------------------
+// ZstdEncoder::Encode
+//
+// Compresses an input stream into an output stream
+//
+// Arguments:
+//
+//	instream		- Input stream to be compressed
+//	outstream		- Output stream to received compressed data
+
+void ZstdEncoder::Encode(Stream^ instream, Stream^ outstream)
+{
+	if(Object::ReferenceEquals(instream, nullptr)) throw gcnew ArgumentNullException("instream");
+	if(Object::ReferenceEquals(outstream, nullptr)) throw gcnew ArgumentNullException("outstream");
+
+	msclr::auto_handle<ZstdWriter> writer(gcnew ZstdWriter(outstream, m_level, m_windowsize, m_checksum, m_threads, true));
+	instream->CopyTo(writer.get());
+}
+
+//---------------------------------------------------------------------------
+// ZstdEncoder::Encode
+//
+// Compresses an input array of bytes into an output stream
+//
+// Arguments:
+//
+//	buffer		- Input byte array to be compressed
+//	outstream	- Output stream to received compressed data
+
+void ZstdEncoder::Encode(array<unsigned __int8>^ buffer, Stream^ outstream)
+{
+	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
+	if(Object::ReferenceEquals(outstream, nullptr)) throw gcnew ArgumentNullException("outstream");
+
+	msclr::auto_handle<ZstdWriter> writer(gcnew ZstdWriter(outstream, m_level, m_windowsize, m_checksum, m_threads, true));
+	writer->Write(buffer, 0, buffer->Length);
+}
+
+//---------------------------------------------------------------------------
+// ZstdEncoder::Encode
+//
+// Compresses an input array of bytes into an output stream
+//
+// Arguments:
+//
+//	buffer		- Input byte array to be compressed
+//	offset		- Offset within the provided buffer to begin reading
+//	count		- Maximum number of bytes from the buffer to be read
+//	outstream	- Output stream to received compressed data
+
+void ZstdEncoder::Encode(array<unsigned __int8>^ buffer, int offset, int count, Stream^ outstream)
+{
+	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
+	if(Object::ReferenceEquals(outstream, nullptr)) throw gcnew ArgumentNullException("outstream");
+
+	msclr::auto_handle<ZstdWriter> writer(gcnew ZstdWriter(outstream, m_level, m_windowsize, m_checksum, m_threads, true));
+	writer->Write(buffer, offset, count);
+}
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
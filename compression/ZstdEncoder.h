@@ -0,0 +1,172 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// Zstandard Library
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// 
+// * Neither the name Facebook nor the names of its contributors may be used to
+//   endorse or promote products derived from this software without specific
+//   prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//---------------------------------------------------------------------------
+
+#ifndef __ZSTDENCODER_H_
+#define __ZSTDENCODER_H_
+#pragma once
+
+#include "Encoder.h"
+#include "ZstdCompressionLevel.h"
+#include "ZstdWindowSize.h"
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+using namespace System;
+using namespace System::IO;
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// Class ZstdEncoder
+//
+// Zstandard compression encoder
+//---------------------------------------------------------------------------
+
+public ref class ZstdEncoder : public Encoder
+{
+public:
+
+	// Instance Constructor
+	//
+	ZstdEncoder();
+
+	//-----------------------------------------------------------------------
+	// Member Functions
+
+	// Encode (Encoder)
+	//
+	// Compresses an input stream into an array of bytes
+	virtual array<unsigned __int8>^ Encode(Stream^ instream);
+
+	// Encode (Encoder)
+	//
+	// Compresses an input array of bytes
+	virtual array<unsigned __int8>^ Encode(array<unsigned __int8>^ buffer);
+
+	// Encode (Encoder)
+	//
+	// Compresses an input array of bytes
+	virtual array<unsigned __int8>^ Encode(array<unsigned __int8>^ buffer, int offset, int count);
+
+	// Encode (Encoder)
+	//
+	// Compresses an input stream into an output stream
+	virtual void Encode(Stream^ instream, Stream^ outstream);
+
+	// Encode (Encoder)
+	//
+	// Compresses an input array of bytes into an output stream
+	virtual void Encode(array<unsigned __int8>^ buffer, Stream^ outstream);
+
+	// Encode (Encoder)
+	//
+	// Compresses an input array of bytes into an output stream
+	virtual void Encode(array<unsigned __int8>^ buffer, int offset, int count, Stream^ outstream);
+
+	//-----------------------------------------------------------------------
+	// Properties
+
+	// CompressionlLevel
+	//
+	// Gets/sets the compression level to use
+	property ZstdCompressionLevel CompressionLevel
+	{
+		ZstdCompressionLevel get(void);
+		void set(ZstdCompressionLevel value);
+	}
+
+	// ContentChecksum
+	//
+	// Gets/sets a flag indicating if a content checksum should be written
+	property bool ContentChecksum
+	{
+		bool get(void);
+		void set(bool value);
+	}
+
+	// MaximumThreads
+	//
+	// Gets/sets the number of worker threads to use for compression
+	property int MaximumThreads
+	{
+		int get(void);
+		void set(int value);
+	}
+
+	// WindowSize
+	//
+	// Gets/sets the encoder window size
+	property ZstdWindowSize WindowSize
+	{
+		ZstdWindowSize get(void);
+		void set(ZstdWindowSize value);
+	}
+
+private:
+
+	//-----------------------------------------------------------------------
+	// Member Variables
+
+	ZstdCompressionLevel		m_level;			// Compression level
+	bool						m_checksum;			// Content checksum flag
+	int							m_threads;			// Number of worker threads
+	ZstdWindowSize				m_windowsize;		// Encoder window size
+};
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
+
+#endif	// __ZSTDENCODER_H_
@@ -0,0 +1,357 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// Zstandard Library
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// 
+// * Neither the name Facebook nor the names of its contributors may be used to
+//   endorse or promote products derived from this software without specific
+//   prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//---------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "ZstdReader.h"
+
+#include "ZstdException.h"
+#include "ZstdWindowSize.h"
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// ZstdReader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+
+ZstdReader::ZstdReader(Stream^ stream) : ZstdReader(stream, false)
+{
+}
+
+//---------------------------------------------------------------------------
+// ZstdReader Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is read from
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+ZstdReader::ZstdReader(Stream^ stream, bool leaveopen) : m_disposed(false), m_stream(stream), m_leaveopen(leaveopen), m_inpos(0), 
+	m_finished(false), m_inavail(0), m_endofstream(false), m_hint(1), m_position(0)
+{
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+
+	// Create the zstd decompression context for this instance
+	m_context = ZSTD_createDCtx();
+	if(m_context == nullptr) throw gcnew OutOfMemoryException();
+
+	// Allocate the managed input buffer for this instance
+	m_in = gcnew array<unsigned __int8>(BUFFER_SIZE);
+
+	// ZstdWriter can produce windows larger than the decoder accepts by default, allow any of them
+	size_t result = ZSTD_DCtx_setParameter(m_context, ZSTD_d_windowLogMax, ZstdWindowSize::Maximum);
+	if(ZSTD_isError(result)) throw gcnew ZstdException(result);
+}
+
+//---------------------------------------------------------------------------
+// ZstdReader Destructor
+
+ZstdReader::~ZstdReader()
+{
+	if(m_disposed) return;
+
+	// Destroy the managed input buffer
+	delete m_in;
+
+	// Optionally dispose of the input stream instance
+	if(!m_leaveopen) delete m_stream;
+	
+	this->!ZstdReader();
+	m_disposed = true;
+}
+
+//---------------------------------------------------------------------------
+// ZstdReader Finalizer
+
+ZstdReader::!ZstdReader()
+{
+	if(m_context == nullptr) return;
+
+	// Release the zstd decompression context
+	ZSTD_freeDCtx(m_context);
+	m_context = nullptr;
+}
+
+//---------------------------------------------------------------------------
+// ZstdReader::BaseStream::get
+//
+// Accesses the underlying base stream instance
+
+Stream^ ZstdReader::BaseStream::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return m_stream;
+}
+
+//---------------------------------------------------------------------------
+// ZstdReader::CanRead::get
+//
+// Gets a value indicating whether the current stream supports reading
+
+bool ZstdReader::CanRead::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return m_stream->CanRead;
+}
+
+//---------------------------------------------------------------------------
+// ZstdReader::CanSeek::get
+//
+// Gets a value indicating whether the current stream supports seeking
+
+bool ZstdReader::CanSeek::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return false;
+}
+
+//---------------------------------------------------------------------------
+// ZstdReader::CanWrite::get
+//
+// Gets a value indicating whether the current stream supports writing
+
+bool ZstdReader::CanWrite::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return false;
+}
+
+//---------------------------------------------------------------------------
+// ZstdReader::Flush
+//
+// Clears all buffers for this stream and causes any buffered data to be written
+//
+// Arguments:
+//
+//	NONE
+
+void ZstdReader::Flush(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	m_stream->Flush();
+}
+
+//--------------------------------------------------------------------------
+// ZstdReader::Length::get
+//
+// Gets the length in bytes of the stream
+
+__int64 ZstdReader::Length::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// ZstdReader::Position::get
+//
+// Gets the current position within the stream
+
+__int64 ZstdReader::Position::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	msclr::lock lock(m_lock);
+	return m_position;
+}
+
+//---------------------------------------------------------------------------
+// ZstdReader::Position::set
+//
+// Sets the current position within the stream
+
+void ZstdReader::Position::set(__int64 value)
+{
+	UNREFERENCED_PARAMETER(value);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// ZstdReader::Read
+//
+// Reads a sequence of bytes from the current stream and advances the position within the stream
+//
+// Arguments:
+//
+//	buffer		- Destination data buffer
+//	offset		- Offset within buffer to begin copying data
+//	count		- Maximum number of bytes to write into the destination buffer
+
+int ZstdReader::Read(array<unsigned __int8>^ buffer, int offset, int count)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
+	if(offset < 0) throw gcnew ArgumentOutOfRangeException("offset");
+	if(count < 0) throw gcnew ArgumentOutOfRangeException("count");
+	if((offset + count) > buffer->Length) throw gcnew ArgumentException("The sum of offset and count is larger than the buffer length");
+
+	msclr::lock lock(m_lock);
+
+	// If there is no buffer to read into or the stream is already done, return zero
+	if((count == 0) || (m_finished)) return 0;
+
+	// Pin the input and output buffers in memory
+	pin_ptr<unsigned __int8> pinin = &m_in[0];
+	pin_ptr<unsigned __int8> pinout = &buffer[0];
+
+	// Copy count into a local value to tally the final bytes read from the stream
+	int availout = count;
+
+	do {
+
+		// If the input buffer was consumed by a previous iteration, refill it
+		if((m_inpos == m_inavail) && (!m_endofstream)) {
+
+			m_inpos = (m_inavail = m_stream->Read(m_in, 0, BUFFER_SIZE)) - m_inavail;
+			if(m_inavail > BUFFER_SIZE) throw gcnew InvalidDataException();
+			m_endofstream = (m_inavail == 0);
+		}
+
+		ZSTD_inBuffer input = { &pinin[m_inpos], m_inavail - m_inpos, 0 };
+		ZSTD_outBuffer output = { &pinout[offset], static_cast<size_t>(availout), 0 };
+
+		// Decompress the next chunk of input data; consecutive frames are decompressed as one stream
+		size_t result = ZSTD_decompressStream(m_context, &output, &input);
+		if(ZSTD_isError(result)) throw gcnew ZstdException(result);
+
+		// Adjust the input buffer parameters
+		m_inpos += input.pos;
+
+		// Adjust the output buffer parameters
+		availout -= static_cast<int>(output.pos);
+		offset += static_cast<int>(output.pos);
+		m_position += output.pos;
+
+		// Zero from the last call that made progress indicates a frame was completed; if the base stream
+		// is exhausted and nothing more can be generated the data must end on a frame boundary
+		if((input.pos > 0) || (output.pos > 0)) m_hint = result;
+		else if(m_endofstream) {
+
+			if(m_hint != 0) throw gcnew InvalidDataException();
+			m_finished = true;
+		}
+
+	} while((!m_finished) && (availout > 0));
+
+	return (count - availout);
+}
+
+//---------------------------------------------------------------------------
+// ZstdReader::Seek
+//
+// Sets the position within the current stream
+//
+// Arguments:
+//
+//	offset		- Byte offset relative to origin
+//	origin		- Reference point used to obtain the new position
+
+__int64 ZstdReader::Seek(__int64 offset, SeekOrigin origin)
+{
+	UNREFERENCED_PARAMETER(offset);
+	UNREFERENCED_PARAMETER(origin);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// ZstdReader::SetLength
+//
+// Sets the length of the current stream
+//
+// Arguments:
+//
+//	value		- Desired length of the current stream in bytes
+
+void ZstdReader::SetLength(__int64 value)
+{
+	UNREFERENCED_PARAMETER(value);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// ZstdReader::Write
+//
+// Writes a sequence of bytes to the current stream and advances the current position
+//
+// Arguments:
+//
+//	buffer		- Source data buffer 
+//	offset		- Offset within buffer to begin copying from
+//	count		- Maximum number of bytes to read from the source buffer
+
+void ZstdReader::Write(array<unsigned __int8>^ buffer, int offset, int count)
+{
+	UNREFERENCED_PARAMETER(buffer);
+	UNREFERENCED_PARAMETER(offset);
+	UNREFERENCED_PARAMETER(count);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
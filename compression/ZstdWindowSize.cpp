@@ -0,0 +1,172 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// Zstandard Library
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// 
+// * Neither the name Facebook nor the names of its contributors may be used to
+//   endorse or promote products derived from this software without specific
+//   prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//---------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "ZstdWindowSize.h"
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// ZstdWindowSize Constructor
+//
+// Arguments:
+//
+//	windowlog	- Base two logarithm of the window size
+
+ZstdWindowSize::ZstdWindowSize(int windowlog) : m_windowlog(windowlog)
+{
+	if(windowlog == 0) return;
+	if((windowlog < ZSTD_WINDOWLOG_MIN) || (windowlog > ZSTD_WINDOWLOG_MAX)) throw gcnew ArgumentOutOfRangeException("windowlog");
+}
+
+//---------------------------------------------------------------------------
+// ZstdWindowSize::operator == (static)
+
+bool ZstdWindowSize::operator==(ZstdWindowSize lhs, ZstdWindowSize rhs)
+{
+	return lhs.m_windowlog == rhs.m_windowlog;
+}
+
+//---------------------------------------------------------------------------
+// ZstdWindowSize::operator != (static)
+
+bool ZstdWindowSize::operator!=(ZstdWindowSize lhs, ZstdWindowSize rhs)
+{
+	return lhs.m_windowlog != rhs.m_windowlog;
+}
+
+//---------------------------------------------------------------------------
+// ZstdWindowSize::operator ZstdWindowSize (static)
+
+ZstdWindowSize::operator ZstdWindowSize(int windowlog)
+{
+	return ZstdWindowSize(windowlog);
+}
+
+//---------------------------------------------------------------------------
+// ZstdWindowSize::operator int (static)
+
+ZstdWindowSize::operator int(ZstdWindowSize rhs)
+{
+	return rhs.m_windowlog;
+}
+
+//---------------------------------------------------------------------------
+// ZstdWindowSize::Equals
+//
+// Compares this ZstdWindowSize to another ZstdWindowSize
+//
+// Arguments:
+//
+//	rhs		- Right-hand ZstdWindowSize to compare against
+
+bool ZstdWindowSize::Equals(ZstdWindowSize rhs)
+{
+	return (*this == rhs);
+}
+
+//---------------------------------------------------------------------------
+// ZstdWindowSize::Equals
+//
+// Overrides Object::Equals()
+//
+// Arguments:
+//
+//	rhs		- Right-hand object instance to compare against
+
+bool ZstdWindowSize::Equals(Object^ rhs)
+{
+	if(Object::ReferenceEquals(rhs, nullptr)) return false;
+
+	// Convert the provided object into a ZstdWindowSize instance
+	ZstdWindowSize^ rhsref = dynamic_cast<ZstdWindowSize^>(rhs);
+	if(rhsref == nullptr) return false;
+
+	return (*this == *rhsref);
+}
+
+//---------------------------------------------------------------------------
+// ZstdWindowSize::GetHashCode
+//
+// Overrides Object::GetHashCode()
+//
+// Arguments:
+//
+//	NONE
+
+int ZstdWindowSize::GetHashCode(void)
+{
+	return m_windowlog.GetHashCode();
+}
+
+//---------------------------------------------------------------------------
+// ZstdWindowSize::ToString
+//
+// Overrides Object::ToString()
+//
+// Arguments:
+//
+//	NONE
+
+String^ ZstdWindowSize::ToString(void)
+{
+	return m_windowlog.ToString();
+}
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)
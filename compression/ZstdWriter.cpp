@@ -0,0 +1,453 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2016 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// Zstandard Library
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+// 
+// * Neither the name Facebook nor the names of its contributors may be used to
+//   endorse or promote products derived from this software without specific
+//   prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//---------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "ZstdWriter.h"
+
+#include "ZstdException.h"
+
+#pragma warning(push, 4)				// Enable maximum compiler warnings
+
+namespace zuki::io::compression {
+
+//---------------------------------------------------------------------------
+// ZstdWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+
+ZstdWriter::ZstdWriter(Stream^ stream) : 
+	ZstdWriter(stream, ZstdCompressionLevel::Default, ZstdWindowSize::Default, true, 1, false)
+{
+}
+
+//---------------------------------------------------------------------------
+// ZstdWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	level		- Indicates whether to emphasize speed or compression efficiency
+
+ZstdWriter::ZstdWriter(Stream^ stream, Compression::CompressionLevel level) : 
+	ZstdWriter(stream, ZstdCompressionLevel(level), ZstdWindowSize::Default, true, 1, false)
+{
+}
+
+//---------------------------------------------------------------------------
+// ZstdWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+ZstdWriter::ZstdWriter(Stream^ stream, bool leaveopen) : 
+	ZstdWriter(stream, ZstdCompressionLevel::Default, ZstdWindowSize::Default, true, 1, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// ZstdWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	level		- Indicates the level of compression to use
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+ZstdWriter::ZstdWriter(Stream^ stream, Compression::CompressionLevel level, bool leaveopen) :
+	ZstdWriter(stream, ZstdCompressionLevel(level), ZstdWindowSize::Default, true, 1, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// ZstdWriter Constructor
+//
+// Arguments:
+//
+//	stream		- The stream the compressed data is written to
+//	level		- Indicates the level of compression to use
+//	threads		- Number of threads to use for compression (zero = processor count)
+//	leaveopen	- Flag to leave the base stream open after disposal
+
+ZstdWriter::ZstdWriter(Stream^ stream, Compression::CompressionLevel level, int threads, bool leaveopen) :
+	ZstdWriter(stream, ZstdCompressionLevel(level), ZstdWindowSize::Default, true, threads, leaveopen)
+{
+}
+
+//---------------------------------------------------------------------------
+// ZstdWriter Constructor (internal)
+//
+// Arguments:
+//
+//	stream			- The stream the compressed data is written to
+//	level			- Indicates the level of compression to use
+//	windowsize		- Window size to use during encoding
+//	checksum		- Flag to append a content checksum to the frame
+//	threads			- Number of threads to use for compression (zero = processor count)
+//	leaveopen		- Flag to leave the base stream open after disposal
+
+ZstdWriter::ZstdWriter(Stream^ stream, ZstdCompressionLevel level, ZstdWindowSize windowsize, bool checksum, int threads, bool leaveopen) : 
+	m_disposed(false), m_stream(stream), m_leaveopen(leaveopen), m_context(nullptr)
+{
+	size_t					result;				// Result from zstd function call
+
+	if(Object::ReferenceEquals(stream, nullptr)) throw gcnew ArgumentNullException("stream");
+	if(threads < 0) throw gcnew ArgumentOutOfRangeException("threads");
+
+	if(threads == 0) threads = Environment::ProcessorCount;
+
+	// Create the zstd compression context for this instance
+	m_context = ZSTD_createCCtx();
+	if(m_context == nullptr) throw gcnew OutOfMemoryException();
+
+	// Allocate the managed output buffer for this instance using the recommended size
+	m_out = gcnew array<unsigned __int8>(static_cast<int>(ZSTD_CStreamOutSize()));
+
+	result = ZSTD_CCtx_setParameter(m_context, ZSTD_c_compressionLevel, level);
+	if(ZSTD_isError(result)) throw gcnew ZstdException(result);
+
+	result = ZSTD_CCtx_setParameter(m_context, ZSTD_c_checksumFlag, (checksum) ? 1 : 0);
+	if(ZSTD_isError(result)) throw gcnew ZstdException(result);
+
+	// A zero window size leaves the selection of the window up to the compression level
+	if(windowsize != ZstdWindowSize::Default) {
+
+		result = ZSTD_CCtx_setParameter(m_context, ZSTD_c_windowLog, windowsize);
+		if(ZSTD_isError(result)) throw gcnew ZstdException(result);
+	}
+
+	// zstd manages its own pool of worker threads; input is divided into jobs that are compressed in
+	// parallel while the calling thread continues to queue data, the output is still a single frame
+	if(threads > 1) {
+
+		result = ZSTD_CCtx_setParameter(m_context, ZSTD_c_nbWorkers, threads);
+		if(ZSTD_isError(result)) throw gcnew ZstdException(result);
+	}
+}
+
+//---------------------------------------------------------------------------
+// ZstdWriter Destructor
+
+ZstdWriter::~ZstdWriter()
+{
+	if(m_disposed) return;
+
+	msclr::lock lock(m_lock);
+
+	// Complete the frame and write out any remaining data
+	ZSTD_inBuffer input = { nullptr, 0, 0 };
+	Compress(&input, ZSTD_e_end);
+
+	// Optionally dispose of the base stream instance
+	if(!m_leaveopen) delete m_stream;
+	
+	this->!ZstdWriter();
+	m_disposed = true;
+}
+
+//---------------------------------------------------------------------------
+// ZstdWriter Finalizer
+
+ZstdWriter::!ZstdWriter()
+{
+	if(m_context == nullptr) return;
+
+	// Release the zstd compression context and any worker threads
+	ZSTD_freeCCtx(m_context);
+	m_context = nullptr;
+}
+
+//---------------------------------------------------------------------------
+// ZstdWriter::BaseStream::get
+//
+// Accesses the underlying base stream instance
+
+Stream^ ZstdWriter::BaseStream::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return m_stream;
+}
+
+//---------------------------------------------------------------------------
+// ZstdWriter::CanRead::get
+//
+// Gets a value indicating whether the current stream supports reading
+
+bool ZstdWriter::CanRead::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return false;
+}
+
+//---------------------------------------------------------------------------
+// ZstdWriter::CanSeek::get
+//
+// Gets a value indicating whether the current stream supports seeking
+
+bool ZstdWriter::CanSeek::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return false;
+}
+
+//---------------------------------------------------------------------------
+// ZstdWriter::CanWrite::get
+//
+// Gets a value indicating whether the current stream supports writing
+
+bool ZstdWriter::CanWrite::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	return m_stream->CanWrite;
+}
+
+//---------------------------------------------------------------------------
+// ZstdWriter::Compress (private)
+//
+// Compresses input data and writes the generated output to the base stream
+//
+// Arguments:
+//
+//	input		- Input buffer to be compressed
+//	directive	- Indicates if the data should be flushed or the frame ended
+
+void ZstdWriter::Compress(ZSTD_inBuffer* input, ZSTD_EndDirective directive)
+{
+	size_t					remaining;			// Data remaining to be flushed
+
+	pin_ptr<unsigned __int8> pinout = &m_out[0];
+
+	do {
+
+		ZSTD_outBuffer output = { pinout, static_cast<size_t>(m_out->Length), 0 };
+
+		// Compress the next chunk of input data; with worker threads this may only queue the input
+		remaining = ZSTD_compressStream2(m_context, &output, input, directive);
+		if(ZSTD_isError(remaining)) throw gcnew ZstdException(remaining);
+
+		if(output.pos > 0) m_stream->Write(m_out, 0, static_cast<int>(output.pos));
+
+	// A flush or end is complete only when nothing remains, otherwise stop when the input is consumed
+	} while((directive == ZSTD_e_continue) ? (input->pos < input->size) : (remaining != 0));
+}
+
+//---------------------------------------------------------------------------
+// ZstdWriter::Flush
+//
+// Clears all buffers for this stream and causes any buffered data to be written
+//
+// Arguments:
+//
+//	NONE
+
+void ZstdWriter::Flush(void)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	msclr::lock lock(m_lock);
+
+	// Flush any buffered input data through the compressor, waiting on workers
+	ZSTD_inBuffer input = { nullptr, 0, 0 };
+	Compress(&input, ZSTD_e_flush);
+
+	m_stream->Flush();
+}
+
+//--------------------------------------------------------------------------
+// ZstdWriter::Length::get
+//
+// Gets the length in bytes of the stream
+
+__int64 ZstdWriter::Length::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// ZstdWriter::Position::get
+//
+// Gets the current position within the stream
+
+__int64 ZstdWriter::Position::get(void)
+{
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// ZstdWriter::Position::set
+//
+// Sets the current position within the stream
+
+void ZstdWriter::Position::set(__int64 value)
+{
+	UNREFERENCED_PARAMETER(value);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// ZstdWriter::Read
+//
+// Reads a sequence of bytes from the current stream and advances the position within the stream
+//
+// Arguments:
+//
+//	buffer		- Destination data buffer
+//	offset		- Offset within buffer to begin copying data
+//	count		- Maximum number of bytes to write into the destination buffer
+
+int ZstdWriter::Read(array<unsigned __int8>^ buffer, int offset, int count)
+{
+	UNREFERENCED_PARAMETER(buffer);
+	UNREFERENCED_PARAMETER(offset);
+	UNREFERENCED_PARAMETER(count);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// ZstdWriter::Seek
+//
+// Sets the position within the current stream
+//
+// Arguments:
+//
+//	offset		- Byte offset relative to origin
+//	origin		- Reference point used to obtain the new position
+
+__int64 ZstdWriter::Seek(__int64 offset, SeekOrigin origin)
+{
+	UNREFERENCED_PARAMETER(offset);
+	UNREFERENCED_PARAMETER(origin);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// ZstdWriter::SetLength
+//
+// Sets the length of the current stream
+//
+// Arguments:
+//
+//	value		- Desired length of the current stream in bytes
+
+void ZstdWriter::SetLength(__int64 value)
+{
+	UNREFERENCED_PARAMETER(value);
+
+	CHECK_DISPOSED(m_disposed);
+	throw gcnew NotSupportedException();
+}
+
+//---------------------------------------------------------------------------
+// ZstdWriter::Write
+//
+// Writes a sequence of bytes to the current stream and advances the current position
+//
+// Arguments:
+//
+//	buffer		- Source data buffer 
+
+void ZstdWriter::Write(array<unsigned __int8>^ buffer)
+{
+	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
+
+	CHECK_DISPOSED(m_disposed);
+	Write(buffer, 0, buffer->Length);
+}
+
+//---------------------------------------------------------------------------
+// ZstdWriter::Write
+//
+// Writes a sequence of bytes to the current stream and advances the current position
+//
+// Arguments:
+//
+//	buffer		- Source data buffer 
+//	offset		- Offset within buffer to begin copying from
+//	count		- Maximum number of bytes to read from the source buffer
+
+void ZstdWriter::Write(array<unsigned __int8>^ buffer, int offset, int count)
+{
+	CHECK_DISPOSED(m_disposed);
+
+	if(Object::ReferenceEquals(buffer, nullptr)) throw gcnew ArgumentNullException("buffer");
+	if(offset < 0) throw gcnew ArgumentOutOfRangeException("offset");
+	if(count < 0) throw gcnew ArgumentOutOfRangeException("count");
+	if((offset + count) > buffer->Length) throw gcnew ArgumentException("The sum of offset and count is larger than the buffer length");
+
+	if(count == 0) return;
+
+	msclr::lock lock(m_lock);
+
+	pin_ptr<unsigned __int8> pinin = &buffer[0];
+
+	// Compress all of the input data; zstd may buffer some or all of it internally
+	ZSTD_inBuffer input = { &pinin[offset], static_cast<size_t>(count), 0 };
+	Compress(&input, ZSTD_e_continue);
+}
+
+//---------------------------------------------------------------------------
+
+} // zuki::io::compression
+
+#pragma warning(pop)